@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <fstream>
+
+namespace sample::debug {
+    bool WriteBenchmarkResults(const std::vector<BenchmarkResult>& results, const std::filesystem::path& resultsPath) {
+        std::error_code error;
+        std::filesystem::create_directories(resultsPath.parent_path(), error);
+        std::ofstream file(resultsPath, std::ios::trunc);
+        for (const BenchmarkResult& result : results) {
+            // Names contain spaces, so the columns are separated by tabs.
+            file << result.Name << '\t' << result.NanosecondsPerOperation << '\t' << result.AllocationsPerOperation << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+} // namespace sample::debug
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include "HeapAllocationCounter.h"
+
+namespace sample::debug {
+    // The harness of the XrUtility microbenchmarks, shared by BasicXrApp and the XrUtilityBench console target.
+    //
+    // Each benchmark repeats a fixed workload, e.g. 1000 poses or a scene of 500 meshes, for at least MinimumRunTime after a
+    // warm-up run, and reports the average time and the heap allocations per operation, where an operation is one element of
+    // the workload. Allocations are only counted with COUNT_HEAP_ALLOCATIONS, see HeapAllocationCounter.
+    struct BenchmarkResult {
+        std::string Name;
+        uint64_t Operations = 0;
+        double NanosecondsPerOperation = 0;
+        double AllocationsPerOperation = 0;
+    };
+
+    constexpr std::chrono::milliseconds MinimumRunTime{200};
+
+    // Keeps the results of a benchmark observable, so that the compiler can't drop the work.
+    inline volatile uint8_t g_benchmarkSink;
+
+    template <typename T>
+    void Consume(const T& value) {
+        g_benchmarkSink = *reinterpret_cast<const volatile uint8_t*>(&value);
+    }
+
+    template <typename TRun>
+    BenchmarkResult Measure(const char* name, uint32_t operationsPerRun, TRun&& run) {
+        // The first run grows the buffers kept across runs and warms the caches, so it isn't measured.
+        run();
+
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        const int64_t minimumTicks = frequency.QuadPart * MinimumRunTime.count() / 1000;
+
+        const ScopedHeapAllocationCounter allocations;
+        LARGE_INTEGER start;
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&start);
+        uint64_t runs = 0;
+        do {
+            run();
+            runs++;
+            QueryPerformanceCounter(&now);
+        } while (now.QuadPart - start.QuadPart < minimumTicks);
+
+        BenchmarkResult result;
+        result.Name = name;
+        result.Operations = runs * operationsPerRun;
+        result.NanosecondsPerOperation = (now.QuadPart - start.QuadPart) * 1e9 / frequency.QuadPart / result.Operations;
+        result.AllocationsPerOperation = static_cast<double>(allocations.Count()) / result.Operations;
+        return result;
+    }
+
+    // Writes the results to resultsPath, one benchmark per line, so that the results of two builds can be compared by a
+    // script. Returns false if the file couldn't be written.
+    bool WriteBenchmarkResults(const std::vector<BenchmarkResult>& results, const std::filesystem::path& resultsPath);
+} // namespace sample::debug
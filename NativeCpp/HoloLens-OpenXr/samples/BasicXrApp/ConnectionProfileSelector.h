@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#ifdef USE_REMOTE_RENDERING
+#include <vector>
+
+namespace sample {
+    // The connection settings the selector switches between.
+    struct ConnectionProfile {
+        const char* Name = "";
+        RR::ServiceRenderMode RenderMode = RR::ServiceRenderMode::Default;
+    };
+
+    // Picks the VM size and the connection profile of the rendering session, and steps down to a cheaper profile when the
+    // remote frames degrade.
+    //
+    // The VM size follows the model complexity: a Premium VM is only requested when the expected polygon count exceeds
+    // what a Standard VM renders. Profiles are ordered from the most to the least demanding. While connected, the
+    // frame statistics are sampled once per SampleIntervalInSeconds; a sample counts as degraded when too few frames were
+    // received, too many were skipped or discarded, or the pose-to-receive latency is too high. After
+    // DegradedSamplesBeforeDowngrade consecutive degraded samples Update asks for a reconnect with the next profile.
+    // The link quality measured this way is kept across connections, so a reconnect starts at the profile the last
+    // connection ended with.
+    class ConnectionProfileSelector {
+    public:
+        static constexpr uint64_t StandardVmMaxPolygonCount = 20000000;
+
+        struct Options {
+            std::vector<ConnectionProfile> Profiles = {
+                {"DepthBasedComposition", RR::ServiceRenderMode::DepthBasedComposition},
+                {"TileBasedComposition", RR::ServiceRenderMode::TileBasedComposition},
+            };
+            uint64_t ExpectedPolygonCount = 0; // Of all models of the scene, 0 if unknown.
+            double SampleIntervalInSeconds = 1.0;
+            int GraceSamples = 5; // Samples ignored after connecting, while the stream settles.
+            int DegradedSamplesBeforeDowngrade = 5;
+            uint32_t MinFramesReceivedPerSample = 45;
+            uint32_t MaxDroppedFramesPerSample = 6; // Skipped and discarded frames.
+            float MaxLatencyPoseToReceiveInSeconds = 0.1f;
+        };
+
+        ConnectionProfileSelector() = default;
+        explicit ConnectionProfileSelector(Options options);
+
+        RR::RenderingSessionVmSize GetVmSize() const;
+
+        const ConnectionProfile& GetProfile() const {
+            return m_options.Profiles[m_profileIndex];
+        }
+
+        // Fills in the connect options of the current profile.
+        void ApplyProfile(RR::RendererInitOptions& init) const;
+
+        // Starts sampling the frame statistics of a connection. Passing null stops sampling, e.g. on disconnect.
+        void Reset(RR::ApiHandle<RR::GraphicsBindingOpenXrD3d11> graphicsBinding);
+
+        // Samples the frame statistics when due. Returns true if the caller should reconnect with the profile that
+        // GetProfile now returns. Call once per frame.
+        bool Update(double nowInSeconds);
+
+    private:
+        bool IsDegraded(const RR::FrameStatistics& statistics) const;
+
+        Options m_options;
+        size_t m_profileIndex = 0;
+        RR::ApiHandle<RR::GraphicsBindingOpenXrD3d11> m_graphicsBinding;
+        double m_nextSampleTime = 0;
+        int m_samplesSinceConnect = 0;
+        int m_degradedSamples = 0;
+    };
+} // namespace sample
+#endif
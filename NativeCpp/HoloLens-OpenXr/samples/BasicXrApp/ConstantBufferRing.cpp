@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "ConstantBufferRing.h"
+
+namespace {
+    constexpr UINT AlignUp(UINT value, UINT alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+} // namespace
+
+namespace sample::dx {
+    ConstantBufferRing::ConstantBufferRing(ID3D11Device* device, UINT bufferSizeInBytes)
+        : m_bufferSizeInBytes(AlignUp(bufferSizeInBytes, AlignmentInBytes)) {
+        m_device.copy_from(device);
+
+        D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+        CHECK_HRCMD(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)));
+        CHECK_MSG(options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer,
+                  "The device doesn't support constant buffer offsetting");
+
+        CreateBuffer();
+    }
+
+    void ConstantBufferRing::BeginFrame() {
+        m_currentBuffer = 0;
+        m_offsetInBytes = 0;
+        m_discardCurrentBuffer = true;
+    }
+
+    ConstantBufferRing::Allocation ConstantBufferRing::Allocate(ID3D11DeviceContext1* context, const void* data, UINT sizeInBytes) {
+        const UINT alignedSize = AlignUp(sizeInBytes, AlignmentInBytes);
+        CHECK_MSG(alignedSize <= m_bufferSizeInBytes, "Constant buffer allocation is larger than the ring buffers");
+
+        if (m_offsetInBytes + alignedSize > m_bufferSizeInBytes) {
+            // Continue in the next buffer, the current one may still be bound.
+            m_currentBuffer++;
+            if (m_currentBuffer == m_buffers.size()) {
+                CreateBuffer();
+            }
+            m_offsetInBytes = 0;
+            m_discardCurrentBuffer = true;
+        }
+
+        ID3D11Buffer* buffer = m_buffers[m_currentBuffer].get();
+        const D3D11_MAP mapType = m_discardCurrentBuffer ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+        m_discardCurrentBuffer = false;
+
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        CHECK_HRCMD(context->Map(buffer, 0, mapType, 0, &mapped));
+        memcpy(static_cast<uint8_t*>(mapped.pData) + m_offsetInBytes, data, sizeInBytes);
+        context->Unmap(buffer, 0);
+
+        Allocation allocation;
+        allocation.Buffer = buffer;
+        allocation.FirstConstant = m_offsetInBytes / 16;
+        allocation.NumConstants = alignedSize / 16;
+        m_offsetInBytes += alignedSize;
+        return allocation;
+    }
+
+    void ConstantBufferRing::CreateBuffer() {
+        const CD3D11_BUFFER_DESC desc(m_bufferSizeInBytes, D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+        winrt::com_ptr<ID3D11Buffer> buffer;
+        CHECK_HRCMD(m_device->CreateBuffer(&desc, nullptr, buffer.put()));
+        m_buffers.push_back(std::move(buffer));
+    }
+} // namespace sample::dx
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <d3d11_1.h>
+
+namespace sample::dx {
+    // Sub-allocates per-draw shader constants from dynamic constant buffers.
+    //
+    // Allocations are appended with D3D11_MAP_WRITE_NO_OVERWRITE and bound by offset through VSSetConstantBuffers1. Each buffer
+    // is mapped with D3D11_MAP_WRITE_DISCARD only for its first allocation in a frame, which makes the driver hand out fresh
+    // memory while the GPU keeps reading the previous frame's constants. The CPU therefore never waits for the GPU.
+    // When a frame needs more constants than one buffer holds, allocation continues in another buffer instead of discarding
+    // the current one, so allocations that are still bound stay valid for the whole frame.
+    class ConstantBufferRing {
+    public:
+        struct Allocation {
+            ID3D11Buffer* Buffer = nullptr;
+            UINT FirstConstant = 0; // In units of 16-byte shader constants.
+            UINT NumConstants = 0;
+        };
+
+        // Requires D3D11.1 constant buffer offsetting, which all feature level 11_1 devices support.
+        explicit ConstantBufferRing(ID3D11Device* device, UINT bufferSizeInBytes = DefaultBufferSizeInBytes);
+
+        // Starts a new frame. Allocations of the previous frame must not be bound for new draws after this.
+        void BeginFrame();
+
+        // Copies the data into the ring. The allocation stays valid until the next BeginFrame.
+        Allocation Allocate(ID3D11DeviceContext1* context, const void* data, UINT sizeInBytes);
+
+        template <typename T>
+        Allocation Allocate(ID3D11DeviceContext1* context, const T& data) {
+            return Allocate(context, &data, sizeof(T));
+        }
+
+        static void VSSetConstantBuffer(ID3D11DeviceContext1* context, UINT slot, const Allocation& allocation) {
+            context->VSSetConstantBuffers1(slot, 1, &allocation.Buffer, &allocation.FirstConstant, &allocation.NumConstants);
+        }
+
+        static void PSSetConstantBuffer(ID3D11DeviceContext1* context, UINT slot, const Allocation& allocation) {
+            context->PSSetConstantBuffers1(slot, 1, &allocation.Buffer, &allocation.FirstConstant, &allocation.NumConstants);
+        }
+
+    private:
+        constexpr static UINT DefaultBufferSizeInBytes = 64 * 1024;
+
+        // Offsets and sizes passed to VSSetConstantBuffers1 must be multiples of 16 constants.
+        constexpr static UINT AlignmentInBytes = 16 * 16;
+
+        void CreateBuffer();
+
+        winrt::com_ptr<ID3D11Device> m_device;
+        std::vector<winrt::com_ptr<ID3D11Buffer>> m_buffers;
+        UINT m_bufferSizeInBytes;
+        size_t m_currentBuffer = 0;
+        UINT m_offsetInBytes = 0;
+        bool m_discardCurrentBuffer = true;
+    };
+} // namespace sample::dx
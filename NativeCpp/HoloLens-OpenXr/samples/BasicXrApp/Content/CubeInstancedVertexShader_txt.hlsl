@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "CubeShaderShared_txt.hlsl"
+
+// Each cube is drawn as ViewCount consecutive instances, one per view in the texture array.
+VSOutput main(VSInput input) {
+    VSOutput output;
+    const uint viewId = input.instId % ViewCount;
+    const float4x4 model = Models[input.instId / ViewCount];
+    output.Pos = mul(mul(float4(input.Pos, 1), model), ViewProjection[viewId]);
+    output.Color = input.Color;
+    output.viewId = viewId;
+    return output;
+}
@@ -0,0 +1,8 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "CubeShaderShared_txt.hlsl"
+
+float4 main(VSOutput input) : SV_TARGET {
+    return float4(input.Color, 1);
+}
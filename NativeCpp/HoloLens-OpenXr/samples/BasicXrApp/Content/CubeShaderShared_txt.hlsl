@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+// Declarations shared by the cube shaders. Must match the constant buffer structs in CubeGraphics.cpp.
+struct VSOutput {
+    float4 Pos : SV_POSITION;
+    float3 Color : COLOR0;
+    uint viewId : SV_RenderTargetArrayIndex;
+};
+struct VSInput {
+    float3 Pos : POSITION;
+    float3 Color : COLOR0;
+    uint instId : SV_InstanceID;
+};
+cbuffer ModelConstantBuffer : register(b0) {
+    float4x4 Model;
+};
+cbuffer ViewProjectionConstantBuffer : register(b1) {
+    float4x4 ViewProjection[2];
+};
+cbuffer InstancingConstantBuffer : register(b2) {
+    uint ViewCount;
+};
+StructuredBuffer<float4x4> Models : register(t0);
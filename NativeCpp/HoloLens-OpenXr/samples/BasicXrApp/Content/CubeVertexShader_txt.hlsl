@@ -0,0 +1,12 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "CubeShaderShared_txt.hlsl"
+
+VSOutput main(VSInput input) {
+    VSOutput output;
+    output.Pos = mul(mul(float4(input.Pos, 1), Model), ViewProjection[input.instId]);
+    output.Color = input.Color;
+    output.viewId = input.instId;
+    return output;
+}
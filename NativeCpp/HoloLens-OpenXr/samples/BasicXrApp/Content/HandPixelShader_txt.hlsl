@@ -0,0 +1,8 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+// Hands are drawn in transparent black, which shows the real hand on an additive display, and write their depth, so that
+// everything drawn behind them afterwards fails the depth test.
+float4 main() : SV_TARGET {
+    return float4(0, 0, 0, 0);
+}
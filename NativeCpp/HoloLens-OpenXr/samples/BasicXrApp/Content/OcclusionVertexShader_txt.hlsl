@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "CubeShaderShared_txt.hlsl"
+
+// Environment meshes only have positions. They are drawn without a pixel shader, so only their depth is written.
+struct OcclusionVSInput {
+    float3 Pos : POSITION;
+    uint instId : SV_InstanceID;
+};
+struct OcclusionVSOutput {
+    float4 Pos : SV_POSITION;
+    uint viewId : SV_RenderTargetArrayIndex;
+};
+
+OcclusionVSOutput main(OcclusionVSInput input) {
+    OcclusionVSOutput output;
+    output.Pos = mul(mul(float4(input.Pos, 1), Model), ViewProjection[input.instId]);
+    output.viewId = input.instId;
+    return output;
+}
@@ -11,9 +11,8 @@
 
 #include "pch.h"
 
-#pragma optimize("", off)
-
 #include "StatusDisplay.h"
+#include "../ConstantBufferRing.h"
 
 #include <shaders\GeometryShader_txt.h>
 #include <shaders\PixelShader_txt.h>
@@ -46,10 +45,22 @@ StatusDisplay::StatusDisplay(ID3D11Device* device) {
     // Initialize the DirectWrite Factory.
     winrt::check_hresult(DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED, __uuidof(IDWriteFactory2), &m_dwriteFactory));
 
+    // Text formats don't depend on the device and are used by the layout thread, so they are created once up front.
+    CreateFonts();
+
     CreateDeviceDependentResources(device);
+
+    m_layoutThread = std::thread([this] { LayoutThread(); });
 }
 
 StatusDisplay::~StatusDisplay() {
+    {
+        std::scoped_lock lock(m_lineMutex);
+        m_stopLayoutThread = true;
+    }
+    m_linesChanged.notify_one();
+    m_layoutThread.join();
+
     ReleaseDeviceDependentResources();
 }
 
@@ -62,23 +73,30 @@ void StatusDisplay::Update() {
 }
 
 // Renders a frame to the screen.
-void StatusDisplay::Render(ID3D11DeviceContext* context) {
+void StatusDisplay::Render(ID3D11DeviceContext1* context, sample::dx::ConstantBufferRing& constantBufferRing) {
     // Loading is asynchronous. Resources must be created before drawing can occur.
     if ((!m_textEnabled)) {
         return;
     }
 
-    // First render all text using direct2D
-    context->ClearRenderTargetView(m_textRenderTarget.get(), DirectX::Colors::Transparent);
+    // Pick up the most recent set of lines published by the layout thread, if any. This never blocks.
+    if (m_readyLineSet.load(std::memory_order_relaxed) & NewLineSetBit) {
+        m_frontLineSet = m_readyLineSet.exchange(m_frontLineSet) & ~NewLineSetBit;
+        m_textureDirty = true;
+    }
 
-    m_d2dTextRenderTarget->BeginDraw();
+    // First render all text using direct2D, but only if the lines changed since the text texture was last rasterized.
+    if (m_textureDirty) {
+        const std::vector<RuntimeLine>& lines = m_lineSets[m_frontLineSet];
 
-    {
-        std::scoped_lock lock(m_lineMutex);
-        if (m_lines.size() > 0) {
-            float top = m_lines[0].metrics.height;
+        context->ClearRenderTargetView(m_textRenderTarget.get(), DirectX::Colors::Transparent);
+
+        m_d2dTextRenderTarget->BeginDraw();
+
+        if (lines.size() > 0) {
+            float top = lines[0].metrics.height;
 
-            for (auto& line : m_lines) {
+            for (auto& line : lines) {
                 if (line.alignBottom) {
                     top = TEXTURE_HEIGHT - line.metrics.height;
                 }
@@ -86,13 +104,15 @@ void StatusDisplay::Render(ID3D11DeviceContext* context) {
                 top += line.metrics.height * line.lineHeightMultiplier;
             }
         }
-    }
 
-    // Ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
-    // is lost. It will be handled during the next call to Present.
-    const HRESULT hr = m_d2dTextRenderTarget->EndDraw();
-    if (hr != D2DERR_RECREATE_TARGET) {
-        winrt::check_hresult(hr);
+        // Ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
+        // is lost. It will be handled during the next call to Present. Keep the texture
+        // dirty in that case so that the lines are rasterized again.
+        const HRESULT hr = m_d2dTextRenderTarget->EndDraw();
+        if (hr != D2DERR_RECREATE_TARGET) {
+            winrt::check_hresult(hr);
+            m_textureDirty = false;
+        }
     }
 
     // Now render the quads into 3d space
@@ -110,8 +130,7 @@ void StatusDisplay::Render(ID3D11DeviceContext* context) {
     context->VSSetShader(m_vertexShader.get(), nullptr, 0);
 
     // Apply the model constant buffer to the vertex shader.
-    pBufferToSet = m_modelConstantBuffer.get();
-    context->VSSetConstantBuffers(0, 1, &pBufferToSet);
+    sample::dx::ConstantBufferRing::VSSetConstantBuffer(context, 0, constantBufferRing.Allocate(context, m_modelConstantBufferDataText));
 
     // On devices that do not support the D3D11_FEATURE_D3D11_OPTIONS3::
     // VPAndRTArrayIndexFromAnyShaderFeedingRasterizer optional feature,
@@ -131,8 +150,6 @@ void StatusDisplay::Render(ID3D11DeviceContext* context) {
     ID3D11SamplerState* pSamplerToSet = m_textSamplerState.get();
     context->PSSetSamplers(0, 1, &pSamplerToSet);
 
-    context->UpdateSubresource(m_modelConstantBuffer.get(), 0, nullptr, &m_modelConstantBufferDataText, 0, 0);
-
     // Draw the text.
     context->DrawIndexedInstanced(m_indexCount, 2, 0, 0, 0);
 
@@ -147,29 +164,7 @@ void StatusDisplay::Render(ID3D11DeviceContext* context) {
 void StatusDisplay::CreateDeviceDependentResources(ID3D11Device* device) {
     CD3D11_SAMPLER_DESC desc(D3D11_DEFAULT);
 
-    CD3D11_TEXTURE2D_DESC textureDesc(
-        DXGI_FORMAT_B8G8R8A8_UNORM, TEXTURE_WIDTH, TEXTURE_HEIGHT, 1, 1, D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET);
-
-    m_textTexture = nullptr;
-    device->CreateTexture2D(&textureDesc, nullptr, m_textTexture.put());
-
-    m_textShaderResourceView = nullptr;
-    device->CreateShaderResourceView(m_textTexture.get(), nullptr, m_textShaderResourceView.put());
-
-    m_textRenderTarget = nullptr;
-    device->CreateRenderTargetView(m_textTexture.get(), nullptr, m_textRenderTarget.put());
-
-    D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
-        D2D1_RENDER_TARGET_TYPE_DEFAULT, D2D1::PixelFormat(DXGI_FORMAT_UNKNOWN, D2D1_ALPHA_MODE_PREMULTIPLIED), 96, 96);
-
-    winrt::com_ptr<IDXGISurface> dxgiSurface;
-    m_textTexture.as(dxgiSurface);
-
-    m_d2dTextRenderTarget = nullptr;
-    winrt::check_hresult(m_d2dFactory->CreateDxgiSurfaceRenderTarget(dxgiSurface.get(), &props, m_d2dTextRenderTarget.put()));
-
-    CreateFonts();
-    CreateBrushes();
+    CreateTextTexture(device);
 
     m_usingVprtShaders = false;
     {
@@ -198,9 +193,6 @@ void StatusDisplay::CreateDeviceDependentResources(ID3D11Device* device) {
 
     winrt::check_hresult(device->CreatePixelShader(PixelShader_txt, sizeof(PixelShader_txt), nullptr, m_pixelShader.put()));
 
-    const CD3D11_BUFFER_DESC constantBufferDesc(sizeof(ModelConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
-    winrt::check_hresult(device->CreateBuffer(&constantBufferDesc, nullptr, m_modelConstantBuffer.put()));
-
     if (!m_usingVprtShaders) {
         winrt::check_hresult(device->CreateGeometryShader(GeometryShader_txt, sizeof(GeometryShader_txt), nullptr, m_geometryShader.put()));
     }
@@ -274,6 +266,54 @@ void StatusDisplay::CreateDeviceDependentResources(ID3D11Device* device) {
     winrt::check_hresult(device->CreateBlendState(&blendStateDesc, m_textAlphaBlendState.put()));
 }
 
+void StatusDisplay::SetTextTextureScale(float scale) {
+    if (scale == m_textTextureScale) {
+        return;
+    }
+
+    m_textTextureScale = scale;
+    winrt::com_ptr<ID3D11Device> device;
+    m_textTexture->GetDevice(device.put());
+    CreateTextTexture(device.get());
+}
+
+uint64_t StatusDisplay::GetTextTextureBytes() const {
+    D3D11_TEXTURE2D_DESC textureDesc;
+    m_textTexture->GetDesc(&textureDesc);
+    return uint64_t{textureDesc.Width} * textureDesc.Height * 4; // DXGI_FORMAT_B8G8R8A8_UNORM
+}
+
+void StatusDisplay::CreateTextTexture(ID3D11Device* device) {
+    // The text is laid out in DIPs on a TEXTURE_WIDTH x TEXTURE_HEIGHT page. A scaled texture keeps the page and only changes
+    // the DPI, so the text looks the same apart from its sharpness.
+    const UINT width = static_cast<UINT>(TEXTURE_WIDTH * m_textTextureScale);
+    const UINT height = static_cast<UINT>(TEXTURE_HEIGHT * m_textTextureScale);
+    CD3D11_TEXTURE2D_DESC textureDesc(
+        DXGI_FORMAT_B8G8R8A8_UNORM, width, height, 1, 1, D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET);
+
+    // Release the previous texture first, so that both don't hold memory at the same time.
+    m_d2dTextRenderTarget = nullptr;
+    m_textRenderTarget = nullptr;
+    m_textShaderResourceView = nullptr;
+    m_textTexture = nullptr;
+    winrt::check_hresult(device->CreateTexture2D(&textureDesc, nullptr, m_textTexture.put()));
+    winrt::check_hresult(device->CreateShaderResourceView(m_textTexture.get(), nullptr, m_textShaderResourceView.put()));
+    winrt::check_hresult(device->CreateRenderTargetView(m_textTexture.get(), nullptr, m_textRenderTarget.put()));
+
+    const float dpi = 96 * m_textTextureScale;
+    D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
+        D2D1_RENDER_TARGET_TYPE_DEFAULT, D2D1::PixelFormat(DXGI_FORMAT_UNKNOWN, D2D1_ALPHA_MODE_PREMULTIPLIED), dpi, dpi);
+
+    winrt::com_ptr<IDXGISurface> dxgiSurface;
+    m_textTexture.as(dxgiSurface);
+    winrt::check_hresult(m_d2dFactory->CreateDxgiSurfaceRenderTarget(dxgiSurface.get(), &props, m_d2dTextRenderTarget.put()));
+
+    CreateBrushes();
+
+    // The text texture was recreated and needs to be rasterized again.
+    m_textureDirty = true;
+}
+
 void StatusDisplay::ReleaseDeviceDependentResources() {
     m_usingVprtShaders = false;
 
@@ -282,8 +322,6 @@ void StatusDisplay::ReleaseDeviceDependentResources() {
     m_pixelShader = nullptr;
     m_geometryShader = nullptr;
 
-    m_modelConstantBuffer = nullptr;
-
     m_vertexBufferText = nullptr;
     m_indexBuffer = nullptr;
 
@@ -293,14 +331,16 @@ void StatusDisplay::ReleaseDeviceDependentResources() {
     for (size_t i = 0; i < ARRAYSIZE(m_brushes); i++) {
         m_brushes[i] = nullptr;
     }
-    for (size_t i = 0; i < ARRAYSIZE(m_textFormats); i++) {
-        m_textFormats[i] = nullptr;
-    }
 }
 
+// The line API only records the requested lines and wakes up the layout thread. Text layouts are created on the
+// layout thread, so callers never wait on DirectWrite and the render thread never waits on callers.
 void StatusDisplay::ClearLines() {
     std::scoped_lock lock(m_lineMutex);
-    m_lines.resize(0);
+    if (!m_lines.empty()) {
+        m_lines.clear();
+        NotifyLinesChanged();
+    }
 }
 
 void StatusDisplay::SetLines(winrt::array_view<Line> lines) {
@@ -310,25 +350,26 @@ void StatusDisplay::SetLines(winrt::array_view<Line> lines) {
 
     for (uint32_t i = 0; i < numLines; i++) {
         assert((!lines[i].alignBottom || i == numLines - 1) && "Only the last line can use alignBottom = true");
-        UpdateLineInternal(m_lines[i], lines[i]);
+        m_lines[i] = lines[i];
     }
+    NotifyLinesChanged();
 }
 
 void StatusDisplay::UpdateLineText(size_t index, std::wstring text) {
     std::scoped_lock lock(m_lineMutex);
     assert(index < m_lines.size() && "Line index out of bounds");
 
-    auto& runtimeLine = m_lines[index];
-
-    Line line = {std::move(text), runtimeLine.format, runtimeLine.color, runtimeLine.lineHeightMultiplier};
-    UpdateLineInternal(runtimeLine, line);
+    if (m_lines[index].text != text) {
+        m_lines[index].text = std::move(text);
+        NotifyLinesChanged();
+    }
 }
 
 size_t StatusDisplay::AddLine(const Line& line) {
     std::scoped_lock lock(m_lineMutex);
     auto newIndex = m_lines.size();
-    m_lines.resize(newIndex + 1);
-    UpdateLineInternal(m_lines[newIndex], line);
+    m_lines.push_back(line);
+    NotifyLinesChanged();
     return newIndex;
 }
 
@@ -337,6 +378,49 @@ bool StatusDisplay::HasLine(size_t index) {
     return index < m_lines.size();
 }
 
+// Must be called with m_lineMutex held.
+void StatusDisplay::NotifyLinesChanged() {
+    m_lineGeneration++;
+    m_linesChanged.notify_one();
+}
+
+// Creates text layouts for the requested lines and publishes them to the render thread.
+void StatusDisplay::LayoutThread() {
+    uint64_t layoutGeneration = 0;
+    std::vector<Line> lines;
+
+    // Runtime lines of the last published set. Layouts are only recreated for lines whose text or format changed.
+    std::vector<RuntimeLine> runtimeLines;
+
+    for (;;) {
+        {
+            std::unique_lock lock(m_lineMutex);
+            m_linesChanged.wait(lock, [&] { return m_stopLayoutThread || m_lineGeneration != layoutGeneration; });
+            if (m_stopLayoutThread) {
+                return;
+            }
+            lines = m_lines;
+            layoutGeneration = m_lineGeneration;
+        }
+
+        try {
+            bool changed = runtimeLines.size() != lines.size();
+            runtimeLines.resize(lines.size());
+            for (size_t i = 0; i < lines.size(); i++) {
+                changed |= UpdateLineInternal(runtimeLines[i], lines[i]);
+            }
+
+            if (changed) {
+                // Fill the back set and swap it with the ready set. Render swaps the ready set with its front set.
+                m_lineSets[m_backLineSet] = runtimeLines;
+                m_backLineSet = m_readyLineSet.exchange(m_backLineSet | NewLineSetBit) & ~NewLineSetBit;
+            }
+        } catch (const winrt::hresult_error& error) {
+            DEBUG_PRINT("Failed to create status text layout: 0x%08x", static_cast<uint32_t>(error.code()));
+        }
+    }
+}
+
 void StatusDisplay::CreateFonts() {
     // Create Large font
     m_textFormats[Large] = nullptr;
@@ -394,11 +478,13 @@ void StatusDisplay::CreateBrushes() {
     winrt::check_hresult(m_d2dTextRenderTarget->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Green), m_brushes[Green].put()));
 }
 
-void StatusDisplay::UpdateLineInternal(RuntimeLine& runtimeLine, const Line& line) {
+// Returns true if the line changed and the text texture needs to be rasterized again.
+bool StatusDisplay::UpdateLineInternal(RuntimeLine& runtimeLine, const Line& line) {
     assert(line.format >= 0 && line.format < TextFormatCount && "Line text format out of bounds");
     assert(line.color >= 0 && line.color < TextColorCount && "Line text color out of bounds");
 
-    if (line.format != runtimeLine.format || line.text != runtimeLine.text) {
+    bool changed = false;
+    if (runtimeLine.layout == nullptr || line.format != runtimeLine.format || line.text != runtimeLine.text) {
         runtimeLine.format = line.format;
         runtimeLine.text = line.text;
 
@@ -411,11 +497,16 @@ void StatusDisplay::UpdateLineInternal(RuntimeLine& runtimeLine, const Line& lin
                                                                runtimeLine.layout.put()));
 
         winrt::check_hresult(runtimeLine.layout->GetMetrics(&runtimeLine.metrics));
+        changed = true;
     }
 
+    changed |= runtimeLine.color != line.color || runtimeLine.lineHeightMultiplier != line.lineHeightMultiplier ||
+               runtimeLine.alignBottom != line.alignBottom;
+
     runtimeLine.color = line.color;
     runtimeLine.lineHeightMultiplier = line.lineHeightMultiplier;
     runtimeLine.alignBottom = line.alignBottom;
+    return changed;
 }
 
 // This function uses a SpatialPointerPose to position the world-locked hologram
@@ -13,6 +13,8 @@
 
 #include "ShaderStructures.h"
 
+#include <condition_variable>
+#include <mutex>
 #include <string>
 
 #include <DWrite.h>
@@ -23,6 +25,10 @@
 
 using namespace HolographicApp;
 
+namespace sample::dx {
+    class ConstantBufferRing;
+}
+
 class StatusDisplay {
 public:
     // Available text formats
@@ -59,7 +65,7 @@ public:
 
     void Update();
 
-    void Render(ID3D11DeviceContext* deviceContext);
+    void Render(ID3D11DeviceContext1* deviceContext, sample::dx::ConstantBufferRing& constantBufferRing);
 
     void CreateDeviceDependentResources(ID3D11Device* device);
     void ReleaseDeviceDependentResources();
@@ -86,6 +92,13 @@ public:
     // Repositions the status display
     void PositionDisplay(const XrPosef& pose);
 
+    // Rasterizes the text into a texture of the given fraction of the full size, e.g. to save video memory. The text keeps
+    // its size and layout but is less sharp.
+    void SetTextTextureScale(float scale);
+
+    // Video memory held by the text texture.
+    uint64_t GetTextTextureBytes() const;
+
 private:
     // Runtime representation of a text line.
     struct RuntimeLine {
@@ -100,7 +113,10 @@ private:
 
     void CreateFonts();
     void CreateBrushes();
-    void UpdateLineInternal(RuntimeLine& runtimLine, const Line& line);
+    void CreateTextTexture(ID3D11Device* device);
+    bool UpdateLineInternal(RuntimeLine& runtimLine, const Line& line);
+    void NotifyLinesChanged();
+    void LayoutThread();
 
     Microsoft::WRL::ComPtr<ID2D1Factory2> m_d2dFactory;
     Microsoft::WRL::ComPtr<IDWriteFactory2> m_dwriteFactory;
@@ -108,14 +124,35 @@ private:
 
     winrt::com_ptr<ID2D1SolidColorBrush> m_brushes[TextColorCount] = {};
     winrt::com_ptr<IDWriteTextFormat> m_textFormats[TextFormatCount] = {};
-    std::vector<RuntimeLine> m_lines;
+
+    // Lines requested through the public line API, guarded by m_lineMutex.
+    // Render never takes this mutex, it's only shared between callers of the line API and the layout thread.
+    std::vector<Line> m_lines;
     std::mutex m_lineMutex;
+    std::condition_variable m_linesChanged;
+    uint64_t m_lineGeneration = 0;
+    bool m_stopLayoutThread = false;
+    std::thread m_layoutThread;
+
+    // Lock-free hand-off of laid out lines from the layout thread to the render thread.
+    // The layout thread owns the back set and the render thread owns the front set. The remaining set is the ready set,
+    // which either side swaps with its own set using a single atomic exchange. NewLineSetBit marks a ready set not yet
+    // picked up by Render.
+    static constexpr uint32_t NewLineSetBit = 0x4;
+    std::vector<RuntimeLine> m_lineSets[3];
+    std::atomic<uint32_t> m_readyLineSet{1};
+    uint32_t m_backLineSet = 0;  // Only accessed by the layout thread.
+    uint32_t m_frontLineSet = 2; // Only accessed by the render thread.
+
+    // Set when the text texture needs to be rasterized again. Only accessed by the render thread.
+    bool m_textureDirty = true;
 
     // Resources related to text rendering.
     winrt::com_ptr<ID3D11Texture2D> m_textTexture;
     winrt::com_ptr<ID3D11ShaderResourceView> m_textShaderResourceView;
     winrt::com_ptr<ID3D11RenderTargetView> m_textRenderTarget;
     winrt::com_ptr<ID2D1RenderTarget> m_d2dTextRenderTarget;
+    float m_textTextureScale = 1.0f;
 
     // Direct3D resources for quad geometry.
     winrt::com_ptr<ID3D11InputLayout> m_inputLayout;
@@ -124,7 +161,6 @@ private:
     winrt::com_ptr<ID3D11VertexShader> m_vertexShader;
     winrt::com_ptr<ID3D11GeometryShader> m_geometryShader;
     winrt::com_ptr<ID3D11PixelShader> m_pixelShader;
-    winrt::com_ptr<ID3D11Buffer> m_modelConstantBuffer;
 
     winrt::com_ptr<ID3D11SamplerState> m_textSamplerState;
     winrt::com_ptr<ID3D11BlendState> m_textAlphaBlendState;
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+// The hidden triangles of all views in one draw, each vertex carrying its view index. Must match VisibilityMaskConstantBuffer
+// and VisibilityMaskVertex in CubeGraphics.cpp.
+cbuffer VisibilityMaskConstantBuffer : register(b0) {
+    float4x4 Projection[2];
+    float MaskDepth; // The nearest depth, so that everything drawn afterwards with a depth test fails on these pixels.
+};
+struct VisibilityMaskVSInput {
+    float2 Pos : POSITION; // In view space on the z = -1 plane.
+    uint viewId : VIEWINDEX;
+};
+struct VisibilityMaskVSOutput {
+    float4 Pos : SV_POSITION;
+    uint viewId : SV_RenderTargetArrayIndex;
+};
+
+VisibilityMaskVSOutput main(VisibilityMaskVSInput input) {
+    VisibilityMaskVSOutput output;
+    output.Pos = mul(float4(input.Pos, -1, 1), Projection[input.viewId]);
+    output.Pos.z = MaskDepth * output.Pos.w;
+    output.viewId = input.viewId;
+    return output;
+}
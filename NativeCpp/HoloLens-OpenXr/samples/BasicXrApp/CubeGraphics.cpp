@@ -4,7 +4,16 @@
 
 #include "pch.h"
 #include "OpenXrProgram.h"
+#include "ConstantBufferRing.h"
 #include "DxUtility.h"
+#include "RenderJobs.h"
+
+#include <shaders\CubeInstancedVertexShader_txt.h>
+#include <shaders\CubePixelShader_txt.h>
+#include <shaders\CubeVertexShader_txt.h>
+#include <shaders\HandPixelShader_txt.h>
+#include <shaders\OcclusionVertexShader_txt.h>
+#include <shaders\VisibilityMaskVertexShader_txt.h>
 
 namespace {
     namespace CubeShader {
@@ -59,47 +68,44 @@ namespace {
             DirectX::XMFLOAT4X4 ViewProjection[2];
         };
 
+        struct InstancingConstantBuffer {
+            uint32_t ViewCount;
+            uint32_t Padding[3];
+        };
+
         constexpr uint32_t MaxViewInstance = 2;
 
-        // Separate entrypoints for the vertex and pixel shader functions.
-        constexpr char ShaderHlsl[] = R"_(
-            struct VSOutput {
-                float4 Pos : SV_POSITION;
-                float3 Color : COLOR0;
-                uint viewId : SV_RenderTargetArrayIndex;
-            };
-            struct VSInput {
-                float3 Pos : POSITION;
-                float3 Color : COLOR0;
-                uint instId : SV_InstanceID;
-            };
-            cbuffer ModelConstantBuffer : register(b0) {
-                float4x4 Model;
-            };
-            cbuffer ViewProjectionConstantBuffer : register(b1) {
-                float4x4 ViewProjection[2];
-            };
+        struct VisibilityMaskVertex {
+            XrVector2f Position;
+            uint32_t ViewIndex;
+        };
 
-            VSOutput MainVS(VSInput input) {
-                VSOutput output;
-                output.Pos = mul(mul(float4(input.Pos, 1), Model), ViewProjection[input.instId]);
-                output.Color = input.Color;
-                output.viewId = input.instId;
-                return output;
-            }
+        struct VisibilityMaskConstantBuffer {
+            DirectX::XMFLOAT4X4 Projection[MaxViewInstance];
+            float MaskDepth;
+            float Padding[3];
+        };
 
-            float4 MainPS(VSOutput input) : SV_TARGET {
-                return float4(input.Color, 1);
-            }
-            )_";
+        // Initial number of model transforms the instance buffer holds. It grows geometrically when more cubes are visible.
+        constexpr uint32_t InitialInstanceCapacity = 16;
 
+        // XrHandMeshVertexMSFT is a position followed by a normal.
+        constexpr UINT HandMeshVertexStride = 2 * sizeof(XrVector3f);
+
+        // Worker threads recording local passes into deferred contexts.
+        constexpr uint32_t RenderWorkerCount = 2;
     } // namespace CubeShader
 
     struct CubeGraphics : sample::IGraphicsPluginD3D11 {
+        explicit CubeGraphics(sample::CubeDrawMode drawMode)
+            : m_drawMode(drawMode) {
+        }
+
         ID3D11Device* InitializeDevice(LUID adapterLuid, const std::vector<D3D_FEATURE_LEVEL>& featureLevels) override {
             const winrt::com_ptr<IDXGIAdapter1> adapter = sample::dx::GetAdapter(adapterLuid);
 
             sample::dx::CreateD3D11DeviceAndContext(adapter.get(), featureLevels, m_device.put(), m_deviceContext.put());
+            m_deviceContext1 = m_deviceContext.as<ID3D11DeviceContext1>();
 
             InitializeD3DResources();
 
@@ -107,13 +113,11 @@ namespace {
         }
 
         void InitializeD3DResources() {
-            const winrt::com_ptr<ID3DBlob> vertexShaderBytes = sample::dx::CompileShader(CubeShader::ShaderHlsl, "MainVS", "vs_5_0");
+            // The shaders in Content\Cube*_txt.hlsl are compiled at build time, so creating them doesn't compile anything.
+            CHECK_HRCMD(m_device->CreateVertexShader(CubeVertexShader_txt, sizeof(CubeVertexShader_txt), nullptr, m_vertexShader.put()));
             CHECK_HRCMD(m_device->CreateVertexShader(
-                vertexShaderBytes->GetBufferPointer(), vertexShaderBytes->GetBufferSize(), nullptr, m_vertexShader.put()));
-
-            const winrt::com_ptr<ID3DBlob> pixelShaderBytes = sample::dx::CompileShader(CubeShader::ShaderHlsl, "MainPS", "ps_5_0");
-            CHECK_HRCMD(m_device->CreatePixelShader(
-                pixelShaderBytes->GetBufferPointer(), pixelShaderBytes->GetBufferSize(), nullptr, m_pixelShader.put()));
+                CubeInstancedVertexShader_txt, sizeof(CubeInstancedVertexShader_txt), nullptr, m_instancedVertexShader.put()));
+            CHECK_HRCMD(m_device->CreatePixelShader(CubePixelShader_txt, sizeof(CubePixelShader_txt), nullptr, m_pixelShader.put()));
 
             const D3D11_INPUT_ELEMENT_DESC vertexDesc[] = {
                 {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
@@ -122,16 +126,62 @@ namespace {
 
             CHECK_HRCMD(m_device->CreateInputLayout(vertexDesc,
                                                     (UINT)std::size(vertexDesc),
-                                                    vertexShaderBytes->GetBufferPointer(),
-                                                    vertexShaderBytes->GetBufferSize(),
+                                                    CubeVertexShader_txt,
+                                                    sizeof(CubeVertexShader_txt),
                                                     m_inputLayout.put()));
 
-            const CD3D11_BUFFER_DESC modelConstantBufferDesc(sizeof(CubeShader::ModelConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
-            CHECK_HRCMD(m_device->CreateBuffer(&modelConstantBufferDesc, nullptr, m_modelCBuffer.put()));
-
-            const CD3D11_BUFFER_DESC viewProjectionConstantBufferDesc(sizeof(CubeShader::ViewProjectionConstantBuffer),
-                                                                      D3D11_BIND_CONSTANT_BUFFER);
-            CHECK_HRCMD(m_device->CreateBuffer(&viewProjectionConstantBufferDesc, nullptr, m_viewProjectionCBuffer.put()));
+            // Environment meshes are drawn depth-only from positions, from both sides since their winding isn't known.
+            CHECK_HRCMD(m_device->CreateVertexShader(
+                OcclusionVertexShader_txt, sizeof(OcclusionVertexShader_txt), nullptr, m_occlusionVertexShader.put()));
+            const D3D11_INPUT_ELEMENT_DESC occlusionVertexDesc[] = {
+                {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+            };
+            CHECK_HRCMD(m_device->CreateInputLayout(occlusionVertexDesc,
+                                                    (UINT)std::size(occlusionVertexDesc),
+                                                    OcclusionVertexShader_txt,
+                                                    sizeof(OcclusionVertexShader_txt),
+                                                    m_occlusionInputLayout.put()));
+            CD3D11_RASTERIZER_DESC occlusionRasterizerDesc(CD3D11_DEFAULT{});
+            occlusionRasterizerDesc.CullMode = D3D11_CULL_NONE;
+            CHECK_HRCMD(m_device->CreateRasterizerState(&occlusionRasterizerDesc, m_occlusionRasterizerState.put()));
+            m_occlusionMeshes.clear(); // Their buffers belong to a previous device.
+
+            // Hand meshes reuse the position-only input of the environment meshes, but also write their color.
+            CHECK_HRCMD(m_device->CreatePixelShader(HandPixelShader_txt, sizeof(HandPixelShader_txt), nullptr, m_handPixelShader.put()));
+            m_handMeshes.clear();
+
+            // The hidden pixels of each view only get depth, drawn over whatever the depth buffer holds.
+            CHECK_HRCMD(m_device->CreateVertexShader(
+                VisibilityMaskVertexShader_txt, sizeof(VisibilityMaskVertexShader_txt), nullptr, m_visibilityMaskVertexShader.put()));
+            const D3D11_INPUT_ELEMENT_DESC visibilityMaskVertexDesc[] = {
+                {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+                {"VIEWINDEX", 0, DXGI_FORMAT_R32_UINT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+            };
+            CHECK_HRCMD(m_device->CreateInputLayout(visibilityMaskVertexDesc,
+                                                    (UINT)std::size(visibilityMaskVertexDesc),
+                                                    VisibilityMaskVertexShader_txt,
+                                                    sizeof(VisibilityMaskVertexShader_txt),
+                                                    m_visibilityMaskInputLayout.put()));
+            CD3D11_DEPTH_STENCIL_DESC visibilityMaskDepthStencilDesc(CD3D11_DEFAULT{});
+            visibilityMaskDepthStencilDesc.DepthFunc = D3D11_COMPARISON_ALWAYS;
+            CHECK_HRCMD(m_device->CreateDepthStencilState(&visibilityMaskDepthStencilDesc, m_visibilityMaskDepthStencilState.put()));
+            m_visibilityMaskVertexBuffer = nullptr;
+            m_visibilityMaskIndexBuffer = nullptr;
+            m_visibilityMaskIndexCount = 0;
+
+            // Per-view and per-cube constants change every frame and are sub-allocated from one ring.
+            m_constantBufferRing = std::make_unique<sample::dx::ConstantBufferRing>(m_device.get());
+
+            const CD3D11_BUFFER_DESC instancingConstantBufferDesc(sizeof(CubeShader::InstancingConstantBuffer),
+                                                                  D3D11_BIND_CONSTANT_BUFFER);
+            CHECK_HRCMD(m_device->CreateBuffer(&instancingConstantBufferDesc, nullptr, m_instancingCBuffer.put()));
+
+            // InitializeDevice is called again on session restart, so drop any buffer created on a previous device.
+            m_instanceBuffer = nullptr;
+            m_instanceBufferView = nullptr;
+            m_instanceCapacity = 0;
+            m_instancingViewCount = 0;
+            EnsureInstanceBufferCapacity(CubeShader::InitialInstanceCapacity);
 
             const D3D11_SUBRESOURCE_DATA vertexBufferData{CubeShader::c_cubeVertices};
             const CD3D11_BUFFER_DESC vertexBufferDesc(sizeof(CubeShader::c_cubeVertices), D3D11_BIND_VERTEX_BUFFER);
@@ -151,6 +201,13 @@ namespace {
             depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
             depthStencilDesc.DepthFunc = D3D11_COMPARISON_GREATER;
             CHECK_HRCMD(m_device->CreateDepthStencilState(&depthStencilDesc, m_reversedZDepthNoStencilTest.put()));
+
+            // The cubes are recorded on a worker thread while the render thread blits the remote frame, if the driver records
+            // command lists natively. Otherwise they are drawn on the immediate context after the blit.
+            m_renderJobs = nullptr;
+            if (sample::dx::RenderJobs::IsWorthwhile(m_device.get())) {
+                m_renderJobs = std::make_unique<sample::dx::RenderJobs>(m_device.get(), CubeShader::RenderWorkerCount);
+            }
         }
 
         const std::vector<DXGI_FORMAT>& SupportedColorFormats() const override {
@@ -173,6 +230,176 @@ namespace {
             return SupportedDepthFormats;
         }
 
+        winrt::com_ptr<ID3D11RenderTargetView> CreateRenderTargetView(ID3D11Texture2D* colorTexture,
+                                                                      DXGI_FORMAT colorSwapchainFormat) override {
+            // Create RenderTargetView with the original swapchain format (swapchain image is typeless).
+            winrt::com_ptr<ID3D11RenderTargetView> renderTargetView;
+            const CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(D3D11_RTV_DIMENSION_TEXTURE2DARRAY, colorSwapchainFormat);
+            CHECK_HRCMD(m_device->CreateRenderTargetView(colorTexture, &renderTargetViewDesc, renderTargetView.put()));
+            return renderTargetView;
+        }
+
+        winrt::com_ptr<ID3D11DepthStencilView> CreateDepthStencilView(ID3D11Texture2D* depthTexture,
+                                                                      DXGI_FORMAT depthSwapchainFormat) override {
+            // Create a DepthStencilView with the original swapchain format (swapchain image is typeless)
+            winrt::com_ptr<ID3D11DepthStencilView> depthStencilView;
+            const CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(D3D11_DSV_DIMENSION_TEXTURE2DARRAY, depthSwapchainFormat);
+            CHECK_HRCMD(m_device->CreateDepthStencilView(depthTexture, &depthStencilViewDesc, depthStencilView.put()));
+            return depthStencilView;
+        }
+
+        void SetOcclusionMeshes(const std::vector<sample::OcclusionMesh>& meshes) override {
+            // Keep the buffers of meshes that are unchanged, the environment mostly changes in small parts.
+            std::unordered_map<const void*, OcclusionMeshBuffers> previous;
+            for (OcclusionMeshBuffers& buffers : m_occlusionMeshes) {
+                const void* owner = buffers.Owner.get();
+                previous.emplace(owner, std::move(buffers));
+            }
+
+            m_occlusionMeshes.clear();
+            m_occlusionMeshes.reserve(meshes.size());
+            for (const sample::OcclusionMesh& mesh : meshes) {
+                if (mesh.VertexCount == 0 || mesh.IndexCount == 0) {
+                    continue;
+                }
+
+                OcclusionMeshBuffers buffers;
+                const auto it = previous.find(mesh.Owner.get());
+                if (it != previous.end()) {
+                    buffers = std::move(it->second);
+                } else {
+                    buffers.Owner = mesh.Owner;
+                    buffers.IndexCount = mesh.IndexCount;
+
+                    const D3D11_SUBRESOURCE_DATA vertexBufferData{mesh.Vertices};
+                    const CD3D11_BUFFER_DESC vertexBufferDesc(
+                        mesh.VertexCount * sizeof(XrVector3f), D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_IMMUTABLE);
+                    CHECK_HRCMD(m_device->CreateBuffer(&vertexBufferDesc, &vertexBufferData, buffers.VertexBuffer.put()));
+
+                    const D3D11_SUBRESOURCE_DATA indexBufferData{mesh.Indices};
+                    const CD3D11_BUFFER_DESC indexBufferDesc(
+                        mesh.IndexCount * sizeof(uint32_t), D3D11_BIND_INDEX_BUFFER, D3D11_USAGE_IMMUTABLE);
+                    CHECK_HRCMD(m_device->CreateBuffer(&indexBufferDesc, &indexBufferData, buffers.IndexBuffer.put()));
+                }
+
+                // Transpose for shader usage.
+                DirectX::XMStoreFloat4x4(&buffers.Model.Model, DirectX::XMMatrixTranspose(xr::math::LoadXrPose(mesh.PoseInAppSpace)));
+                m_occlusionMeshes.push_back(std::move(buffers));
+            }
+        }
+
+        void SetVisibilityMasks(const std::vector<sample::VisibilityMask>& masks) override {
+            CHECK(masks.size() <= CubeShader::MaxViewInstance);
+
+            // All views go into one buffer, so that a single draw covers both array slices.
+            std::vector<CubeShader::VisibilityMaskVertex> vertices;
+            std::vector<uint32_t> indices;
+            for (uint32_t viewIndex = 0; viewIndex < (uint32_t)masks.size(); viewIndex++) {
+                const uint32_t baseVertex = (uint32_t)vertices.size();
+                for (const XrVector2f& position : masks[viewIndex].Vertices) {
+                    vertices.push_back({position, viewIndex});
+                }
+                for (const uint32_t index : masks[viewIndex].Indices) {
+                    indices.push_back(baseVertex + index);
+                }
+            }
+
+            m_visibilityMaskVertexBuffer = nullptr;
+            m_visibilityMaskIndexBuffer = nullptr;
+            m_visibilityMaskIndexCount = 0;
+            if (indices.empty()) {
+                return;
+            }
+
+            const D3D11_SUBRESOURCE_DATA vertexBufferData{vertices.data()};
+            const CD3D11_BUFFER_DESC vertexBufferDesc(
+                (UINT)(vertices.size() * sizeof(CubeShader::VisibilityMaskVertex)), D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_IMMUTABLE);
+            CHECK_HRCMD(m_device->CreateBuffer(&vertexBufferDesc, &vertexBufferData, m_visibilityMaskVertexBuffer.put()));
+
+            const D3D11_SUBRESOURCE_DATA indexBufferData{indices.data()};
+            const CD3D11_BUFFER_DESC indexBufferDesc(
+                (UINT)(indices.size() * sizeof(uint32_t)), D3D11_BIND_INDEX_BUFFER, D3D11_USAGE_IMMUTABLE);
+            CHECK_HRCMD(m_device->CreateBuffer(&indexBufferDesc, &indexBufferData, m_visibilityMaskIndexBuffer.put()));
+            m_visibilityMaskIndexCount = (uint32_t)indices.size();
+        }
+
+        void RenderVisibilityMask(ID3D11DeviceContext1* context, sample::dx::ConstantBufferRing& constantBufferRing) override {
+            if (m_visibilityMaskIndexCount == 0) {
+                return;
+            }
+
+            m_visibilityMaskCBufferData.MaskDepth = m_cubePass.ReversedZ ? 1.f : 0.f;
+            sample::dx::ConstantBufferRing::VSSetConstantBuffer(
+                context, 0, constantBufferRing.Allocate(context, m_visibilityMaskCBufferData));
+
+            context->OMSetDepthStencilState(m_visibilityMaskDepthStencilState.get(), 0);
+            context->RSSetState(m_occlusionRasterizerState.get()); // The winding of the hidden triangles isn't specified.
+            context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            context->IASetInputLayout(m_visibilityMaskInputLayout.get());
+            context->VSSetShader(m_visibilityMaskVertexShader.get(), nullptr, 0);
+            context->PSSetShader(nullptr, nullptr, 0);
+
+            const UINT strides[] = {sizeof(CubeShader::VisibilityMaskVertex)};
+            const UINT offsets[] = {0};
+            ID3D11Buffer* vertexBuffers[] = {m_visibilityMaskVertexBuffer.get()};
+            context->IASetVertexBuffers(0, (UINT)std::size(vertexBuffers), vertexBuffers, strides, offsets);
+            context->IASetIndexBuffer(m_visibilityMaskIndexBuffer.get(), DXGI_FORMAT_R32_UINT, 0);
+            context->DrawIndexed(m_visibilityMaskIndexCount, 0, 0);
+
+            context->RSSetState(nullptr);
+            context->OMSetDepthStencilState(m_cubePass.ReversedZ ? m_reversedZDepthNoStencilTest.get() : nullptr, 0);
+        }
+
+#if XR_MSFT_hand_tracking_mesh
+        void SetHandMeshes(const std::vector<sample::HandMesh>& hands) override {
+            m_handMeshes.resize(hands.size()); // The hand count doesn't change, so this only allocates once.
+            for (size_t k = 0; k < hands.size(); k++) {
+                const sample::HandMesh& hand = hands[k];
+                HandMeshBuffers& buffers = m_handMeshes[k];
+                if (hand.VertexCount == 0 || hand.IndexCount == 0) {
+                    // The change flags of the frames in which the hand isn't drawn are not seen, so upload everything next time.
+                    buffers.IndexCount = 0;
+                    continue;
+                }
+
+                const bool wasDrawn = buffers.IndexCount > 0;
+                if (hand.VerticesChanged || !wasDrawn) {
+                    UploadDynamicBuffer(buffers.VertexBuffer,
+                                        buffers.VertexBufferSize,
+                                        D3D11_BIND_VERTEX_BUFFER,
+                                        hand.Vertices,
+                                        hand.VertexCount * sizeof(XrHandMeshVertexMSFT));
+                }
+                if (hand.IndicesChanged || !wasDrawn) {
+                    UploadDynamicBuffer(buffers.IndexBuffer,
+                                        buffers.IndexBufferSize,
+                                        D3D11_BIND_INDEX_BUFFER,
+                                        hand.Indices,
+                                        hand.IndexCount * sizeof(uint32_t));
+                }
+
+                buffers.IndexCount = hand.IndexCount;
+                DirectX::XMStoreFloat4x4(&buffers.Model.Model, DirectX::XMMatrixTranspose(xr::math::LoadXrPose(hand.PoseInAppSpace)));
+            }
+        }
+#endif
+
+        void PrepareView(const std::vector<xr::math::ViewProjection>& viewProjections) override {
+            const uint32_t viewInstanceCount = (uint32_t)viewProjections.size();
+            CHECK_MSG(viewInstanceCount <= CubeShader::MaxViewInstance,
+                      "Sample shader supports 2 or fewer view instances. Adjust shader to accommodate more.")
+
+            for (uint32_t k = 0; k < viewInstanceCount; k++) {
+                const DirectX::XMMATRIX spaceToView = xr::math::LoadInvertedXrPose(viewProjections[k].Pose);
+                const DirectX::XMMATRIX projectionMatrix = m_projectionCaches[k].Get(viewProjections[k].Fov, viewProjections[k].NearFar);
+
+                // Set view projection matrix for each view, transpose for shader usage.
+                DirectX::XMStoreFloat4x4(&m_viewProjectionCBufferData.ViewProjection[k],
+                                         DirectX::XMMatrixTranspose(spaceToView * projectionMatrix));
+                DirectX::XMStoreFloat4x4(&m_visibilityMaskCBufferData.Projection[k], DirectX::XMMatrixTranspose(projectionMatrix));
+            }
+        }
+
         void RenderView(
 #ifdef USE_REMOTE_RENDERING
             sample::IOpenXrProgram* program,
@@ -180,101 +407,330 @@ namespace {
             const XrRect2Di& imageRect,
             const float renderTargetClearColor[4],
             const std::vector<xr::math::ViewProjection>& viewProjections,
-            DXGI_FORMAT colorSwapchainFormat,
-            ID3D11Texture2D* colorTexture,
-            DXGI_FORMAT depthSwapchainFormat,
-            ID3D11Texture2D* depthTexture,
+            ID3D11RenderTargetView* renderTargetView,
+            ID3D11DepthStencilView* depthStencilView,
             const std::vector<const sample::Cube*>& cubes) override {
             const uint32_t viewInstanceCount = (uint32_t)viewProjections.size();
             CHECK_MSG(viewInstanceCount <= CubeShader::MaxViewInstance,
                       "Sample shader supports 2 or fewer view instances. Adjust shader to accommodate more.")
 
-            CD3D11_VIEWPORT viewport(
+            m_cubePass.Viewport = CD3D11_VIEWPORT(
                 (float)imageRect.offset.x, (float)imageRect.offset.y, (float)imageRect.extent.width, (float)imageRect.extent.height);
-            m_deviceContext->RSSetViewports(1, &viewport);
+            m_cubePass.RenderTargetView = renderTargetView;
+            m_cubePass.DepthStencilView = depthStencilView;
+            m_cubePass.ReversedZ = xr::math::IsReversedZ(viewProjections[0].NearFar);
+            m_cubePass.ViewInstanceCount = viewInstanceCount;
+            m_cubePass.Cubes = &cubes;
+
+            // The cube pass doesn't depend on the remote frame, so it is recorded while the remote frame is blitted.
+            if (m_renderJobs) {
+                m_renderJobs->Add([this](ID3D11DeviceContext1* context, sample::dx::ConstantBufferRing& constantBufferRing) {
+                    RecordCubePass(context, constantBufferRing);
+                });
+            }
 
-            // Create RenderTargetView with the original swapchain format (swapchain image is typeless).
-            winrt::com_ptr<ID3D11RenderTargetView> renderTargetView;
-            const CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(D3D11_RTV_DIMENSION_TEXTURE2DARRAY, colorSwapchainFormat);
-            CHECK_HRCMD(m_device->CreateRenderTargetView(colorTexture, &renderTargetViewDesc, renderTargetView.put()));
+            m_deviceContext->RSSetViewports(1, &m_cubePass.Viewport);
 
-            // Create a DepthStencilView with the original swapchain format (swapchain image is typeless)
-            winrt::com_ptr<ID3D11DepthStencilView> depthStencilView;
-            CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(D3D11_DSV_DIMENSION_TEXTURE2DARRAY, depthSwapchainFormat);
-            CHECK_HRCMD(m_device->CreateDepthStencilView(depthTexture, &depthStencilViewDesc, depthStencilView.put()));
-
-            const bool reversedZ = viewProjections[0].NearFar.Near > viewProjections[0].NearFar.Far;
-            const float depthClearValue = reversedZ ? 0.f : 1.f;
+            const float depthClearValue = m_cubePass.ReversedZ ? 0.f : 1.f;
 
             // Clear swapchain and depth buffer. NOTE: This will clear the entire render target view, not just the specified view.
-            m_deviceContext->ClearRenderTargetView(renderTargetView.get(), renderTargetClearColor);
-            m_deviceContext->ClearDepthStencilView(depthStencilView.get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depthClearValue, 0);
-            m_deviceContext->OMSetDepthStencilState(reversedZ ? m_reversedZDepthNoStencilTest.get() : nullptr, 0);
+            m_deviceContext->ClearRenderTargetView(renderTargetView, renderTargetClearColor);
+            m_deviceContext->ClearDepthStencilView(depthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depthClearValue, 0);
+            m_deviceContext->OMSetDepthStencilState(m_cubePass.ReversedZ ? m_reversedZDepthNoStencilTest.get() : nullptr, 0);
 
-            ID3D11RenderTargetView* renderTargets[] = {renderTargetView.get()};
-            m_deviceContext->OMSetRenderTargets((UINT)std::size(renderTargets), renderTargets, depthStencilView.get());
+            ID3D11RenderTargetView* renderTargets[] = {renderTargetView};
+            m_deviceContext->OMSetRenderTargets((UINT)std::size(renderTargets), renderTargets, depthStencilView);
 
-            CubeShader::ViewProjectionConstantBuffer viewProjectionCBufferData{};
+            // Everything drawn for this view on the immediate context, including the remote rendering content, allocates its
+            // constants after this.
+            m_constantBufferRing->BeginFrame();
 
-            for (uint32_t k = 0; k < viewInstanceCount; k++) {
-                const DirectX::XMMATRIX spaceToView = xr::math::LoadInvertedXrPose(viewProjections[k].Pose);
-                const DirectX::XMMATRIX projectionMatrix = ComposeProjectionMatrix(viewProjections[k].Fov, viewProjections[k].NearFar);
-
-                // Set view projection matrix for each view, transpose for shader usage.
-                DirectX::XMStoreFloat4x4(&viewProjectionCBufferData.ViewProjection[k],
-                                         DirectX::XMMatrixTranspose(spaceToView * projectionMatrix));
-            }
-            m_deviceContext->UpdateSubresource(m_viewProjectionCBuffer.get(), 0, nullptr, &viewProjectionCBufferData, 0, 0);
+            // Everything drawn after this with the depth test, including the cube pass recorded by a worker, skips the hidden pixels.
+            RenderVisibilityMask(m_deviceContext1.get(), *m_constantBufferRing);
 
 #ifdef USE_REMOTE_RENDERING
-            ID3D11Buffer* const cb[] = {m_viewProjectionCBuffer.get()};
-            m_deviceContext->VSSetConstantBuffers(1, (UINT)std::size(cb), cb);
-            program->RenderARR(m_deviceContext.get());
+            // The view projection matrices were computed in PrepareView.
+            sample::dx::ConstantBufferRing::VSSetConstantBuffer(
+                m_deviceContext1.get(), 1, m_constantBufferRing->Allocate(m_deviceContext1.get(), m_viewProjectionCBufferData));
+
+            program->RenderARR(m_deviceContext1.get(), *m_constantBufferRing);
 #endif
 
-            ID3D11Buffer* const constantBuffers[] = {m_modelCBuffer.get(), m_viewProjectionCBuffer.get()};
-            m_deviceContext->VSSetConstantBuffers(0, (UINT)std::size(constantBuffers), constantBuffers);
-            m_deviceContext->VSSetShader(m_vertexShader.get(), nullptr, 0);
-            m_deviceContext->PSSetShader(m_pixelShader.get(), nullptr, 0);
+            // The blit wrote the remote depth into the depth buffer. The cube pass binds the depth test again, so the local content
+            // is depth tested against it and merges its own depth into it. The combined depth is what the runtime reprojects with.
+            if (m_renderJobs) {
+                m_renderJobs->ExecuteInOrder(m_deviceContext.get());
+            } else {
+                RecordCubePass(m_deviceContext1.get(), *m_constantBufferRing);
+            }
+            m_cubePass.Cubes = nullptr;
+        }
+
+    private:
+        // Everything the cube pass needs, set by RenderView so that the pass can be recorded on a worker thread.
+        struct CubePass {
+            D3D11_VIEWPORT Viewport{};
+            ID3D11RenderTargetView* RenderTargetView = nullptr;
+            ID3D11DepthStencilView* DepthStencilView = nullptr;
+            bool ReversedZ = false;
+            uint32_t ViewInstanceCount = 0;
+            const std::vector<const sample::Cube*>* Cubes = nullptr;
+        };
+
+        // Binds all state the cubes need, so it works on a deferred context as well as after the remote frame blit.
+        void RecordCubePass(ID3D11DeviceContext1* context, sample::dx::ConstantBufferRing& constantBufferRing) {
+            context->RSSetViewports(1, &m_cubePass.Viewport);
+            context->OMSetDepthStencilState(m_cubePass.ReversedZ ? m_reversedZDepthNoStencilTest.get() : nullptr, 0);
+            ID3D11RenderTargetView* renderTargets[] = {m_cubePass.RenderTargetView};
+            context->OMSetRenderTargets((UINT)std::size(renderTargets), renderTargets, m_cubePass.DepthStencilView);
+            context->OMSetBlendState(nullptr, nullptr, 0xffffffff);
+
+            // The view projection matrices were computed in PrepareView.
+            sample::dx::ConstantBufferRing::VSSetConstantBuffer(
+                context, 1, constantBufferRing.Allocate(context, m_viewProjectionCBufferData));
+            context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+            RenderOcclusionMeshes(context, constantBufferRing, m_cubePass.ViewInstanceCount);
+            RenderHandMeshes(context, constantBufferRing, m_cubePass.ViewInstanceCount);
+
+            context->RSSetState(nullptr);
+            context->VSSetShader(m_vertexShader.get(), nullptr, 0);
+            context->PSSetShader(m_pixelShader.get(), nullptr, 0);
 
             // Set cube primitive data.
             const UINT strides[] = {sizeof(CubeShader::Vertex)};
             const UINT offsets[] = {0};
             ID3D11Buffer* vertexBuffers[] = {m_cubeVertexBuffer.get()};
-            m_deviceContext->IASetVertexBuffers(0, (UINT)std::size(vertexBuffers), vertexBuffers, strides, offsets);
-            m_deviceContext->IASetIndexBuffer(m_cubeIndexBuffer.get(), DXGI_FORMAT_R16_UINT, 0);
-            m_deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-            m_deviceContext->IASetInputLayout(m_inputLayout.get());
+            context->IASetVertexBuffers(0, (UINT)std::size(vertexBuffers), vertexBuffers, strides, offsets);
+            context->IASetIndexBuffer(m_cubeIndexBuffer.get(), DXGI_FORMAT_R16_UINT, 0);
+            context->IASetInputLayout(m_inputLayout.get());
+
+            if (m_drawMode == sample::CubeDrawMode::Instanced) {
+                RenderCubesInstanced(context, m_cubePass.ViewInstanceCount, *m_cubePass.Cubes);
+            } else {
+                RenderCubesPerCube(context, constantBufferRing, m_cubePass.ViewInstanceCount, *m_cubePass.Cubes);
+            }
+        }
+
+        // Draws the environment meshes into the depth buffer only, before the cubes.
+        void RenderOcclusionMeshes(ID3D11DeviceContext1* context,
+                                   sample::dx::ConstantBufferRing& constantBufferRing,
+                                   uint32_t viewInstanceCount) {
+            if (m_occlusionMeshes.empty()) {
+                return;
+            }
+
+            context->RSSetState(m_occlusionRasterizerState.get());
+            context->IASetInputLayout(m_occlusionInputLayout.get());
+            context->VSSetShader(m_occlusionVertexShader.get(), nullptr, 0);
+            context->PSSetShader(nullptr, nullptr, 0);
 
+            const UINT strides[] = {sizeof(XrVector3f)};
+            const UINT offsets[] = {0};
+            for (const OcclusionMeshBuffers& mesh : m_occlusionMeshes) {
+                sample::dx::ConstantBufferRing::VSSetConstantBuffer(context, 0, constantBufferRing.Allocate(context, mesh.Model));
+
+                ID3D11Buffer* vertexBuffers[] = {mesh.VertexBuffer.get()};
+                context->IASetVertexBuffers(0, (UINT)std::size(vertexBuffers), vertexBuffers, strides, offsets);
+                context->IASetIndexBuffer(mesh.IndexBuffer.get(), DXGI_FORMAT_R32_UINT, 0);
+                context->DrawIndexedInstanced(mesh.IndexCount, viewInstanceCount, 0, 0, 0);
+            }
+        }
+
+        // Draws the tracked hands after the remote frame and before the cubes, so they hide the remote content and the cubes
+        // behind them. The hand mesh vertices start with their position, so the environment mesh input layout reads them too.
+        void RenderHandMeshes(ID3D11DeviceContext1* context,
+                              sample::dx::ConstantBufferRing& constantBufferRing,
+                              uint32_t viewInstanceCount) {
+            bool stateBound = false;
+            for (const HandMeshBuffers& hand : m_handMeshes) {
+                if (hand.IndexCount == 0) {
+                    continue;
+                }
+
+                if (!stateBound) {
+                    context->RSSetState(m_occlusionRasterizerState.get());
+                    context->IASetInputLayout(m_occlusionInputLayout.get());
+                    context->VSSetShader(m_occlusionVertexShader.get(), nullptr, 0);
+                    context->PSSetShader(m_handPixelShader.get(), nullptr, 0);
+                    stateBound = true;
+                }
+
+                sample::dx::ConstantBufferRing::VSSetConstantBuffer(context, 0, constantBufferRing.Allocate(context, hand.Model));
+
+                const UINT strides[] = {CubeShader::HandMeshVertexStride};
+                const UINT offsets[] = {0};
+                ID3D11Buffer* vertexBuffers[] = {hand.VertexBuffer.get()};
+                context->IASetVertexBuffers(0, (UINT)std::size(vertexBuffers), vertexBuffers, strides, offsets);
+                context->IASetIndexBuffer(hand.IndexBuffer.get(), DXGI_FORMAT_R32_UINT, 0);
+                context->DrawIndexedInstanced(hand.IndexCount, viewInstanceCount, 0, 0, 0);
+            }
+        }
+
+        // Writes the data into a dynamic buffer, replacing the buffer with a larger one if it doesn't fit.
+        void UploadDynamicBuffer(
+            winrt::com_ptr<ID3D11Buffer>& buffer, uint32_t& bufferSize, UINT bindFlags, const void* data, uint32_t size) {
+            if (buffer == nullptr || size > bufferSize) {
+                const CD3D11_BUFFER_DESC bufferDesc(size, bindFlags, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+                buffer = nullptr;
+                CHECK_HRCMD(m_device->CreateBuffer(&bufferDesc, nullptr, buffer.put()));
+                bufferSize = size;
+            }
+
+            D3D11_MAPPED_SUBRESOURCE mapped{};
+            CHECK_HRCMD(m_deviceContext->Map(buffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+            memcpy(mapped.pData, data, size);
+            m_deviceContext->Unmap(buffer.get(), 0);
+        }
+
+        static DirectX::XMMATRIX ComputeModelMatrix(const sample::Cube& cube) {
+            // Compute the model transform for the cube, transpose for shader usage.
+            const DirectX::XMMATRIX scaleMatrix = DirectX::XMMatrixScaling(cube.Scale.x, cube.Scale.y, cube.Scale.z);
+            return DirectX::XMMatrixTranspose(scaleMatrix * xr::math::LoadXrPose(cube.PoseInAppSpace));
+        }
+
+        void RenderCubesPerCube(ID3D11DeviceContext1* context,
+                                sample::dx::ConstantBufferRing& constantBufferRing,
+                                uint32_t viewInstanceCount,
+                                const std::vector<const sample::Cube*>& cubes) {
             // Render each cube
             for (const sample::Cube* cube : cubes) {
-                // Compute and update the model transform for each cube, transpose for shader usage.
                 CubeShader::ModelConstantBuffer model;
-                const DirectX::XMMATRIX scaleMatrix = DirectX::XMMatrixScaling(cube->Scale.x, cube->Scale.y, cube->Scale.z);
-                DirectX::XMStoreFloat4x4(&model.Model, DirectX::XMMatrixTranspose(scaleMatrix * xr::math::LoadXrPose(cube->PoseInAppSpace)));
-                m_deviceContext->UpdateSubresource(m_modelCBuffer.get(), 0, nullptr, &model, 0, 0);
+                DirectX::XMStoreFloat4x4(&model.Model, ComputeModelMatrix(*cube));
+                sample::dx::ConstantBufferRing::VSSetConstantBuffer(context, 0, constantBufferRing.Allocate(context, model));
 
                 // Draw the cube.
-                m_deviceContext->DrawIndexedInstanced((UINT)std::size(CubeShader::c_cubeIndices), viewInstanceCount, 0, 0, 0);
+                context->DrawIndexedInstanced((UINT)std::size(CubeShader::c_cubeIndices), viewInstanceCount, 0, 0, 0);
             }
         }
 
-    private:
+        void RenderCubesInstanced(ID3D11DeviceContext1* context,
+                                  uint32_t viewInstanceCount,
+                                  const std::vector<const sample::Cube*>& cubes) {
+            if (cubes.empty()) {
+                return;
+            }
+
+            const uint32_t cubeCount = (uint32_t)cubes.size();
+            EnsureInstanceBufferCapacity(cubeCount);
+
+            // Gather the cube poses and scales so that all model transforms are computed in one batch.
+            m_instancePoses.resize(cubeCount);
+            m_instanceScales.resize(cubeCount);
+            for (uint32_t i = 0; i < cubeCount; i++) {
+                m_instancePoses[i] = cubes[i]->PoseInAppSpace;
+                m_instanceScales[i] = cubes[i]->Scale;
+            }
+
+            // Write all model transforms for this frame into the instance buffer, transposed for shader usage.
+            D3D11_MAPPED_SUBRESOURCE mapped{};
+            CHECK_HRCMD(context->Map(m_instanceBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+            DirectX::XMFLOAT4X4* models = reinterpret_cast<DirectX::XMFLOAT4X4*>(mapped.pData);
+            xr::math::StoreXrPoseMatrices(models, m_instancePoses.data(), cubeCount, m_instanceScales.data(), true /*transpose*/);
+            context->Unmap(m_instanceBuffer.get(), 0);
+
+            // The view count is stable for the whole session, so the constant buffer is rarely touched.
+            if (m_instancingViewCount != viewInstanceCount) {
+                const CubeShader::InstancingConstantBuffer instancing{viewInstanceCount};
+                context->UpdateSubresource(m_instancingCBuffer.get(), 0, nullptr, &instancing, 0, 0);
+                m_instancingViewCount = viewInstanceCount;
+            }
+
+            ID3D11Buffer* const instancingConstantBuffers[] = {m_instancingCBuffer.get()};
+            context->VSSetConstantBuffers(2, (UINT)std::size(instancingConstantBuffers), instancingConstantBuffers);
+            ID3D11ShaderResourceView* const shaderResources[] = {m_instanceBufferView.get()};
+            context->VSSetShaderResources(0, (UINT)std::size(shaderResources), shaderResources);
+            context->VSSetShader(m_instancedVertexShader.get(), nullptr, 0);
+
+            // Draw all cubes with one call, each cube being viewInstanceCount consecutive instances.
+            context->DrawIndexedInstanced((UINT)std::size(CubeShader::c_cubeIndices), cubeCount * viewInstanceCount, 0, 0, 0);
+
+            ID3D11ShaderResourceView* const nullShaderResources[] = {nullptr};
+            context->VSSetShaderResources(0, (UINT)std::size(nullShaderResources), nullShaderResources);
+        }
+
+        void EnsureInstanceBufferCapacity(uint32_t instanceCount) {
+            if (m_instanceBuffer != nullptr && instanceCount <= m_instanceCapacity) {
+                return;
+            }
+
+            const uint32_t capacity = std::max(instanceCount, m_instanceCapacity * 2);
+
+            CD3D11_BUFFER_DESC instanceBufferDesc(capacity * sizeof(DirectX::XMFLOAT4X4),
+                                                  D3D11_BIND_SHADER_RESOURCE,
+                                                  D3D11_USAGE_DYNAMIC,
+                                                  D3D11_CPU_ACCESS_WRITE,
+                                                  D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+                                                  sizeof(DirectX::XMFLOAT4X4));
+            winrt::com_ptr<ID3D11Buffer> instanceBuffer;
+            CHECK_HRCMD(m_device->CreateBuffer(&instanceBufferDesc, nullptr, instanceBuffer.put()));
+
+            const CD3D11_SHADER_RESOURCE_VIEW_DESC instanceBufferViewDesc(
+                instanceBuffer.get(), DXGI_FORMAT_UNKNOWN, 0 /*firstElement*/, capacity);
+            winrt::com_ptr<ID3D11ShaderResourceView> instanceBufferView;
+            CHECK_HRCMD(m_device->CreateShaderResourceView(instanceBuffer.get(), &instanceBufferViewDesc, instanceBufferView.put()));
+
+            m_instanceBuffer = std::move(instanceBuffer);
+            m_instanceBufferView = std::move(instanceBufferView);
+            m_instanceCapacity = capacity;
+        }
+
+        const sample::CubeDrawMode m_drawMode;
         winrt::com_ptr<ID3D11Device> m_device;
         winrt::com_ptr<ID3D11DeviceContext> m_deviceContext;
+        winrt::com_ptr<ID3D11DeviceContext1> m_deviceContext1;
+        std::unique_ptr<sample::dx::ConstantBufferRing> m_constantBufferRing;
         winrt::com_ptr<ID3D11VertexShader> m_vertexShader;
+        winrt::com_ptr<ID3D11VertexShader> m_instancedVertexShader;
         winrt::com_ptr<ID3D11PixelShader> m_pixelShader;
         winrt::com_ptr<ID3D11InputLayout> m_inputLayout;
-        winrt::com_ptr<ID3D11Buffer> m_modelCBuffer;
-        winrt::com_ptr<ID3D11Buffer> m_viewProjectionCBuffer;
         winrt::com_ptr<ID3D11Buffer> m_cubeVertexBuffer;
         winrt::com_ptr<ID3D11Buffer> m_cubeIndexBuffer;
+        winrt::com_ptr<ID3D11Buffer> m_instancingCBuffer;
+        winrt::com_ptr<ID3D11Buffer> m_instanceBuffer;
+        winrt::com_ptr<ID3D11ShaderResourceView> m_instanceBufferView;
+        uint32_t m_instanceCapacity{0};
+        uint32_t m_instancingViewCount{0};
+        std::array<xr::math::ProjectionMatrixCache, CubeShader::MaxViewInstance> m_projectionCaches;
+        CubeShader::ViewProjectionConstantBuffer m_viewProjectionCBufferData{};
+        std::vector<XrPosef> m_instancePoses;    // Reused every frame, only grows with the number of cubes.
+        std::vector<XrVector3f> m_instanceScales; // Reused every frame, only grows with the number of cubes.
         winrt::com_ptr<ID3D11DepthStencilState> m_reversedZDepthNoStencilTest;
+        winrt::com_ptr<ID3D11VertexShader> m_occlusionVertexShader;
+        winrt::com_ptr<ID3D11InputLayout> m_occlusionInputLayout;
+        winrt::com_ptr<ID3D11RasterizerState> m_occlusionRasterizerState;
+        struct OcclusionMeshBuffers {
+            std::shared_ptr<const void> Owner; // Keeps the owner alive, so that its address is not reused by another mesh.
+            winrt::com_ptr<ID3D11Buffer> VertexBuffer;
+            winrt::com_ptr<ID3D11Buffer> IndexBuffer;
+            uint32_t IndexCount{0};
+            CubeShader::ModelConstantBuffer Model{};
+        };
+        std::vector<OcclusionMeshBuffers> m_occlusionMeshes;
+        winrt::com_ptr<ID3D11PixelShader> m_handPixelShader;
+        struct HandMeshBuffers {
+            winrt::com_ptr<ID3D11Buffer> VertexBuffer; // Dynamic, only written when the hand mesh changed.
+            winrt::com_ptr<ID3D11Buffer> IndexBuffer;
+            uint32_t VertexBufferSize{0};
+            uint32_t IndexBufferSize{0};
+            uint32_t IndexCount{0}; // 0 if the hand is not drawn.
+            CubeShader::ModelConstantBuffer Model{};
+        };
+        std::vector<HandMeshBuffers> m_handMeshes;
+        winrt::com_ptr<ID3D11VertexShader> m_visibilityMaskVertexShader;
+        winrt::com_ptr<ID3D11InputLayout> m_visibilityMaskInputLayout;
+        winrt::com_ptr<ID3D11DepthStencilState> m_visibilityMaskDepthStencilState;
+        winrt::com_ptr<ID3D11Buffer> m_visibilityMaskVertexBuffer;
+        winrt::com_ptr<ID3D11Buffer> m_visibilityMaskIndexBuffer;
+        uint32_t m_visibilityMaskIndexCount{0};
+        CubeShader::VisibilityMaskConstantBuffer m_visibilityMaskCBufferData{};
+        std::unique_ptr<sample::dx::RenderJobs> m_renderJobs; // Null if the cubes are drawn on the immediate context.
+        CubePass m_cubePass;
     };
 } // namespace
 
 namespace sample {
-    std::unique_ptr<sample::IGraphicsPluginD3D11> CreateCubeGraphics() {
-        return std::make_unique<CubeGraphics>();
+    std::unique_ptr<sample::IGraphicsPluginD3D11> CreateCubeGraphics(CubeDrawMode drawMode) {
+        return std::make_unique<CubeGraphics>(drawMode);
     }
 } // namespace sample
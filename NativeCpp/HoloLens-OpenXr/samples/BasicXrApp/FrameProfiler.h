@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace sample::debug {
+    // The stages of a frame measured by the FrameProfiler. Stages may nest, e.g. RenderView includes BlitRemoteFrame and StatusDisplay.
+    enum class FrameStage : uint32_t {
+        Update,          // PollActions and the remote rendering update, before the frame wait.
+        WaitFrame,       // xrWaitFrame and xrBeginFrame.
+        WaitSwapchain,   // xrWaitSwapchainImage of the color and depth images, which blocks while the GPU is behind.
+        RenderView,      // Rendering the projection layer into the swapchain images.
+        BlitRemoteFrame, // Blitting the remote frame into the render target.
+        StatusDisplay,   // Drawing the status display.
+        EndFrame,        // xrEndFrame.
+        Count
+    };
+
+    // Keeps the most recent samples of a measurement and computes percentiles over them.
+    class RollingPercentiles {
+    public:
+        constexpr static uint32_t Capacity = 512;
+
+        struct Summary {
+            uint32_t Count = 0;
+            float P50 = 0;
+            float P95 = 0;
+            float P99 = 0;
+        };
+
+        void Add(float value) {
+            m_samples[m_next] = value;
+            m_next = (m_next + 1) % Capacity;
+            m_count = std::min(m_count + 1, Capacity);
+        }
+
+        Summary Compute() const;
+
+    private:
+        std::array<float, Capacity> m_samples{};
+        uint32_t m_next = 0;
+        uint32_t m_count = 0;
+    };
+
+    // Measures the CPU time of each frame stage with QueryPerformanceCounter and the GPU time of the rendering stages with
+    // D3D11 timestamp queries. GPU results are read back a few frames later without stalling; frames whose queries are not
+    // ready when their slot is reused are dropped.
+    //
+    // Every stage sample is written as an ETW event of the "Microsoft.Azure.RemoteRendering.Samples" TraceLogging provider,
+    // which Tools/ETLProfiles/AzureRemoteRenderingNetworkProfiling.wprp records next to the ARR network events. Percentiles
+    // over a rolling window are printed to the debug output periodically.
+    //
+    // The profiler does not allocate after construction, so it can be used inside the steady-state frame loop.
+    class FrameProfiler {
+    public:
+        constexpr static uint32_t ReportIntervalInFrames = 300;
+
+        explicit FrameProfiler(ID3D11Device* device);
+        ~FrameProfiler();
+
+        FrameProfiler(const FrameProfiler&) = delete;
+        FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+        void BeginFrame();
+        void EndFrame();
+
+        void BeginStage(FrameStage stage);
+        void EndStage(FrameStage stage);
+
+        // Tags the current frame with the reprojection mode its projection layer requested. The name must be a string literal.
+        // Written as an ETW event with the frame, and the share of each mode is part of the periodic report.
+        void SetReprojectionMode(const char* name);
+
+        // The index of the frame between the current BeginFrame and EndFrame calls.
+        uint64_t GetFrameIndex() const {
+            return m_frameIndex;
+        }
+
+        // The GPU time of a stage in the most recent frame whose queries were resolved, which lags the current frame by up to
+        // FramesInFlight frames. Returns false if no frame was resolved yet or the stage didn't run in that frame.
+        bool TryGetLatestGpuMilliseconds(FrameStage stage, uint64_t& frameIndex, float& milliseconds) const;
+
+        class ScopedStage {
+        public:
+            ScopedStage(FrameProfiler& profiler, FrameStage stage)
+                : m_profiler(profiler)
+                , m_stage(stage) {
+                m_profiler.BeginStage(m_stage);
+            }
+
+            ~ScopedStage() {
+                m_profiler.EndStage(m_stage);
+            }
+
+        private:
+            FrameProfiler& m_profiler;
+            const FrameStage m_stage;
+        };
+
+    private:
+        constexpr static uint32_t FramesInFlight = 4;
+        constexpr static uint32_t MaxGpuStagesPerFrame = 16;
+        constexpr static uint32_t StageCount = static_cast<uint32_t>(FrameStage::Count);
+        constexpr static uint32_t MaxReprojectionModes = 8;
+
+        struct GpuStage {
+            FrameStage Stage = FrameStage::Update;
+            winrt::com_ptr<ID3D11Query> Begin;
+            winrt::com_ptr<ID3D11Query> End;
+        };
+
+        struct GpuFrame {
+            winrt::com_ptr<ID3D11Query> Disjoint;
+            std::array<GpuStage, MaxGpuStagesPerFrame> Stages;
+            uint32_t StageCount = 0;
+            uint64_t FrameIndex = 0;
+            bool Pending = false;
+        };
+
+        bool TryResolve(GpuFrame& frame);
+        void Report();
+
+        winrt::com_ptr<ID3D11DeviceContext> m_context;
+        std::array<GpuFrame, FramesInFlight> m_gpuFrames;
+        GpuFrame* m_currentGpuFrame = nullptr;
+
+        double m_millisecondsPerTick = 0;
+        uint64_t m_frameIndex = 0;
+        std::array<int64_t, StageCount> m_stageStartTicks{};
+        std::array<int64_t, StageCount> m_stageTicks{};
+        std::array<uint32_t, StageCount> m_openGpuStage{};
+
+        std::array<RollingPercentiles, StageCount> m_cpuMilliseconds;
+        std::array<RollingPercentiles, StageCount> m_gpuMilliseconds;
+        std::array<float, StageCount> m_latestGpuMilliseconds{};
+        std::array<bool, StageCount> m_latestGpuStageMeasured{};
+        uint64_t m_latestGpuFrameIndex = 0;
+        bool m_hasLatestGpuFrame = false;
+        uint64_t m_droppedGpuFrames = 0;
+
+        const char* m_frameReprojectionMode = nullptr;
+        struct ReprojectionModeCount {
+            const char* Name = nullptr;
+            uint32_t Frames = 0;
+        };
+        std::array<ReprojectionModeCount, MaxReprojectionModes> m_reprojectionModeCounts{}; // Since the last report.
+    };
+} // namespace sample::debug
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "GpuMemoryGovernor.h"
+
+namespace {
+    constexpr double BytesPerMegabyte = 1024.0 * 1024.0;
+
+    constexpr const char* c_subsystemNames[] = {"Swapchains", "Scene meshes", "Status display"};
+    static_assert(std::size(c_subsystemNames) == static_cast<size_t>(sample::GpuMemoryGovernor::Subsystem::Count));
+} // namespace
+
+namespace sample {
+    GpuMemoryGovernor::GpuMemoryGovernor(ID3D11Device* device)
+        : GpuMemoryGovernor(device, Options{}) {
+    }
+
+    GpuMemoryGovernor::GpuMemoryGovernor(ID3D11Device* device, const Options& options)
+        : m_options(options) {
+        CHECK_HRCMD(device->QueryInterface(winrt::guid_of<IDXGIDevice3>(), m_dxgiDevice.put_void()));
+        device->GetImmediateContext(m_context.put());
+
+        winrt::com_ptr<IDXGIAdapter> adapter;
+        CHECK_HRCMD(m_dxgiDevice->GetAdapter(adapter.put()));
+        m_adapter = adapter.as<IDXGIAdapter3>();
+
+        // Without the notification the usage is still polled.
+        m_budgetChangedEvent.attach(CreateEventEx(nullptr, nullptr, 0, EVENT_MODIFY_STATE | SYNCHRONIZE));
+        if (m_budgetChangedEvent &&
+            FAILED(m_adapter->RegisterVideoMemoryBudgetChangeNotificationEvent(m_budgetChangedEvent.get(), &m_budgetChangedCookie))) {
+            m_budgetChangedEvent.close();
+        }
+    }
+
+    GpuMemoryGovernor::~GpuMemoryGovernor() {
+        if (m_budgetChangedEvent) {
+            m_adapter->UnregisterVideoMemoryBudgetChangeNotification(m_budgetChangedCookie);
+        }
+    }
+
+    bool GpuMemoryGovernor::Update() {
+        const auto now = std::chrono::steady_clock::now();
+        const bool budgetChanged = m_budgetChangedEvent && WaitForSingleObject(m_budgetChangedEvent.get(), 0) == WAIT_OBJECT_0;
+        if (!budgetChanged && now < m_nextPollTime) {
+            return false;
+        }
+        m_nextPollTime = now + m_options.PollInterval;
+
+        CHECK_HRCMD(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &m_memoryInfo));
+        if (m_memoryInfo.Budget == 0) {
+            return false;
+        }
+
+        const double usage = static_cast<double>(m_memoryInfo.CurrentUsage) / static_cast<double>(m_memoryInfo.Budget);
+        if (usage > m_options.StepDownThreshold) {
+            m_belowStepUpThresholdSince.reset();
+            if (m_level == Level::Minimal || now - m_lastLevelChangeTime < m_options.SettleTime) {
+                return false;
+            }
+
+            Trim();
+            m_level = static_cast<Level>(static_cast<int>(m_level) + 1);
+            m_lastLevelChangeTime = now;
+            Report("over budget");
+            return true;
+        }
+
+        if (usage >= m_options.StepUpThreshold || m_level == Level::Normal) {
+            m_belowStepUpThresholdSince.reset();
+            return false;
+        }
+
+        if (!m_belowStepUpThresholdSince.has_value()) {
+            m_belowStepUpThresholdSince = now;
+        } else if (now - m_belowStepUpThresholdSince.value() >= m_options.StepUpDelay) {
+            m_level = static_cast<Level>(static_cast<int>(m_level) - 1);
+            m_lastLevelChangeTime = now;
+            m_belowStepUpThresholdSince.reset();
+            Report("within budget");
+            return true;
+        }
+        return false;
+    }
+
+    const char* GpuMemoryGovernor::ToString(Level level) {
+        switch (level) {
+        case Level::Normal:
+            return "Normal";
+        case Level::Reduced:
+            return "Reduced";
+        case Level::Minimal:
+            return "Minimal";
+        }
+        return "Unknown";
+    }
+
+    void GpuMemoryGovernor::Trim() {
+        // Trim requires the device context to hold no references to resources, and every frame binds its state again.
+        m_context->ClearState();
+        m_dxgiDevice->Trim();
+    }
+
+    void GpuMemoryGovernor::Report(const char* reason) const {
+        DEBUG_PRINT("GPU memory %s: %.1f of %.1f MB used, level %s.",
+                    reason,
+                    m_memoryInfo.CurrentUsage / BytesPerMegabyte,
+                    m_memoryInfo.Budget / BytesPerMegabyte,
+                    ToString(m_level));
+
+        uint64_t reported = 0;
+        for (size_t i = 0; i < m_usage.size(); i++) {
+            DEBUG_PRINT("  %-16s %8.1f MB", c_subsystemNames[i], m_usage[i] / BytesPerMegabyte);
+            reported += m_usage[i];
+        }
+        const uint64_t other = m_memoryInfo.CurrentUsage > reported ? m_memoryInfo.CurrentUsage - reported : 0;
+        DEBUG_PRINT("  %-16s %8.1f MB", "Other", other / BytesPerMegabyte); // Includes the remote frames and the driver.
+    }
+} // namespace sample
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <dxgi1_4.h>
+#include <optional>
+
+namespace sample {
+    // Watches the local video memory budget of the adapter, so that the app steps down to cheaper modes before the OS
+    // terminates it for exceeding the budget, e.g. when the local content and the decode surfaces of the remote frames grow.
+    //
+    // The usage is queried with IDXGIAdapter3::QueryVideoMemoryInfo every PollInterval, and right away when the OS signals a
+    // budget change. Above StepDownThreshold of the budget, the governor trims the driver's internal allocations and lowers
+    // the level by one; it waits SettleTime before it lowers it again, so the app has time to release memory. The level goes
+    // back up by one only after the usage stayed below StepUpThreshold for StepUpDelay.
+    //
+    // Subsystems report what they allocate with SetUsage. The report is logged with every level change.
+    class GpuMemoryGovernor {
+    public:
+        enum class Level {
+            Normal,
+            Reduced, // Smaller textures and less scene detail.
+            Minimal, // Optional features that hold video memory are off.
+        };
+
+        enum class Subsystem {
+            Swapchains,
+            SceneMeshes,
+            StatusDisplay,
+            Count,
+        };
+
+        struct Options {
+            std::chrono::milliseconds PollInterval{1000};
+            std::chrono::milliseconds SettleTime{3000};
+            std::chrono::milliseconds StepUpDelay{10000};
+            float StepDownThreshold = 0.9f; // Fractions of the budget.
+            float StepUpThreshold = 0.7f;
+        };
+
+        explicit GpuMemoryGovernor(ID3D11Device* device);
+        GpuMemoryGovernor(ID3D11Device* device, const Options& options);
+        ~GpuMemoryGovernor();
+
+        GpuMemoryGovernor(const GpuMemoryGovernor&) = delete;
+        GpuMemoryGovernor& operator=(const GpuMemoryGovernor&) = delete;
+
+        // Queries the usage if due. Returns true if the level changed. Call at the start of a frame, since trimming clears the
+        // state of the immediate context.
+        bool Update();
+
+        Level GetLevel() const {
+            return m_level;
+        }
+
+        void SetUsage(Subsystem subsystem, uint64_t bytes) {
+            m_usage[static_cast<size_t>(subsystem)] = bytes;
+        }
+
+        static const char* ToString(Level level);
+
+    private:
+        void Trim();
+        void Report(const char* reason) const;
+
+        const Options m_options;
+        winrt::com_ptr<IDXGIAdapter3> m_adapter;
+        winrt::com_ptr<IDXGIDevice3> m_dxgiDevice;
+        winrt::com_ptr<ID3D11DeviceContext> m_context;
+        winrt::handle m_budgetChangedEvent;
+        DWORD m_budgetChangedCookie{0};
+
+        Level m_level{Level::Normal};
+        DXGI_QUERY_VIDEO_MEMORY_INFO m_memoryInfo{};
+        std::array<uint64_t, static_cast<size_t>(Subsystem::Count)> m_usage{};
+        std::chrono::steady_clock::time_point m_nextPollTime{};
+        std::chrono::steady_clock::time_point m_lastLevelChangeTime{};
+        std::optional<std::chrono::steady_clock::time_point> m_belowStepUpThresholdSince;
+    };
+} // namespace sample
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "HandMeshTracker.h"
+
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+namespace {
+    XrSystemHandTrackingMeshPropertiesMSFT GetHandMeshProperties(XrInstance instance, XrSystemId systemId, bool* handTracking) {
+        XrSystemHandTrackingMeshPropertiesMSFT meshProperties{XR_TYPE_SYSTEM_HAND_TRACKING_MESH_PROPERTIES_MSFT};
+        XrSystemHandTrackingPropertiesEXT trackingProperties{XR_TYPE_SYSTEM_HAND_TRACKING_PROPERTIES_EXT, &meshProperties};
+        XrSystemProperties systemProperties{XR_TYPE_SYSTEM_PROPERTIES, &trackingProperties};
+        CHECK_XRCMD(xrGetSystemProperties(instance, systemId, &systemProperties));
+        *handTracking = trackingProperties.supportsHandTracking;
+        return meshProperties;
+    }
+} // namespace
+
+namespace sample {
+    bool HandMeshTracker::IsSupported(XrInstance instance, XrSystemId systemId) {
+        bool handTracking = false;
+        const XrSystemHandTrackingMeshPropertiesMSFT properties = GetHandMeshProperties(instance, systemId, &handTracking);
+        return handTracking && properties.supportsHandTrackingMesh && properties.maxHandMeshIndexCount > 0 &&
+               properties.maxHandMeshVertexCount > 0;
+    }
+
+    void HandMeshTracker::Initialize(const xr::ExtensionDispatchTable& extensions,
+                                     XrInstance instance,
+                                     XrSystemId systemId,
+                                     XrSession session) {
+        CHECK(!IsInitialized());
+        m_extensions = &extensions;
+
+        bool handTracking = false;
+        const XrSystemHandTrackingMeshPropertiesMSFT properties = GetHandMeshProperties(instance, systemId, &handTracking);
+        CHECK(handTracking && properties.supportsHandTrackingMesh);
+
+        const XrHandEXT handTypes[HandCount] = {XR_HAND_LEFT_EXT, XR_HAND_RIGHT_EXT};
+        for (uint32_t k = 0; k < HandCount; k++) {
+            Hand& hand = m_hands[k];
+
+            XrHandTrackerCreateInfoEXT trackerCreateInfo{XR_TYPE_HAND_TRACKER_CREATE_INFO_EXT};
+            trackerCreateInfo.hand = handTypes[k];
+            trackerCreateInfo.handJointSet = XR_HAND_JOINT_SET_DEFAULT_EXT;
+            CHECK_XRCMD(
+                extensions.xrCreateHandTrackerEXT(session, &trackerCreateInfo, hand.Tracker.Put(extensions.xrDestroyHandTrackerEXT)));
+
+            XrHandMeshSpaceCreateInfoMSFT meshSpaceCreateInfo{XR_TYPE_HAND_MESH_SPACE_CREATE_INFO_MSFT};
+            meshSpaceCreateInfo.handPoseType = XR_HAND_POSE_TYPE_TRACKED_MSFT;
+            meshSpaceCreateInfo.poseInHandMeshSpace = xr::math::Pose::Identity();
+            CHECK_XRCMD(extensions.xrCreateHandMeshSpaceMSFT(hand.Tracker.Get(), &meshSpaceCreateInfo, hand.MeshSpace.Put()));
+
+            // The buffers keep their size for the whole session, xrUpdateHandMeshMSFT only writes into them.
+            hand.Indices.resize(properties.maxHandMeshIndexCount);
+            hand.Vertices.resize(properties.maxHandMeshVertexCount);
+            hand.Mesh = {XR_TYPE_HAND_MESH_MSFT};
+            hand.Mesh.indexBuffer.indexCapacityInput = properties.maxHandMeshIndexCount;
+            hand.Mesh.indexBuffer.indices = hand.Indices.data();
+            hand.Mesh.vertexBuffer.vertexCapacityInput = properties.maxHandMeshVertexCount;
+            hand.Mesh.vertexBuffer.vertices = hand.Vertices.data();
+        }
+    }
+
+    void HandMeshTracker::Reset() {
+        for (Hand& hand : m_hands) {
+            // The mesh space belongs to the hand tracker, so it's destroyed first.
+            hand.MeshSpace.Reset();
+            hand.Tracker.Reset();
+            hand.LocationIndex = xr::SpaceLocator::InvalidIndex;
+        }
+        for (sample::HandMesh& mesh : m_meshes) {
+            mesh = {};
+        }
+        m_extensions = nullptr;
+    }
+
+    void HandMeshTracker::Update(XrTime time) {
+        if (!IsInitialized()) {
+            return;
+        }
+
+        for (Hand& hand : m_hands) {
+            XrHandMeshUpdateInfoMSFT updateInfo{XR_TYPE_HAND_MESH_UPDATE_INFO_MSFT};
+            updateInfo.time = time;
+            updateInfo.handPoseType = XR_HAND_POSE_TYPE_TRACKED_MSFT;
+            CHECK_XRCMD(m_extensions->xrUpdateHandMeshMSFT(hand.Tracker.Get(), &updateInfo, &hand.Mesh));
+        }
+    }
+
+    void HandMeshTracker::AddSpaces(xr::SpaceLocator& spaceLocator) {
+        for (Hand& hand : m_hands) {
+            hand.LocationIndex = hand.Mesh.isActive ? spaceLocator.Add(hand.MeshSpace.Get()) : xr::SpaceLocator::InvalidIndex;
+        }
+    }
+
+    const std::vector<sample::HandMesh>& HandMeshTracker::GetMeshes(const xr::SpaceLocator& spaceLocator) {
+        for (uint32_t k = 0; k < HandCount; k++) {
+            const Hand& hand = m_hands[k];
+            sample::HandMesh& mesh = m_meshes[k];
+
+            const XrSpaceLocation* location = spaceLocator.TryGetLocation(hand.LocationIndex);
+            if (location == nullptr || !xr::math::Pose::IsPoseValid(*location)) {
+                mesh.VertexCount = mesh.IndexCount = 0;
+                continue;
+            }
+
+            // The buffers always hold the latest mesh, the flags only tell whether it differs from the previous update.
+            mesh.Vertices = hand.Vertices.data();
+            mesh.VertexCount = hand.Mesh.vertexBuffer.vertexCountOutput;
+            mesh.VerticesChanged = hand.Mesh.vertexBufferChanged;
+            mesh.Indices = hand.Indices.data();
+            mesh.IndexCount = hand.Mesh.indexBuffer.indexCountOutput;
+            mesh.IndicesChanged = hand.Mesh.indexBufferChanged;
+            mesh.PoseInAppSpace = location->pose;
+        }
+        return m_meshes;
+    }
+} // namespace sample
+#endif
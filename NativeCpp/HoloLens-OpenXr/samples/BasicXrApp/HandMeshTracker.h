@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+#include <array>
+#include "OpenXrProgram.h"
+
+namespace sample {
+    // Tracks the meshes of both hands, so that the graphics plugin can draw them as occluders in front of the holograms.
+    //
+    // The mesh buffers of each hand are allocated once at the maximum size the system reports, and xrUpdateHandMeshMSFT
+    // writes into them in place, so tracking never allocates in the frame loop. The runtime reports which buffers it changed,
+    // and the resulting HandMesh entries pass that on, so the GPU buffers are only written when the mesh actually changed.
+    class HandMeshTracker {
+    public:
+        constexpr static uint32_t HandCount = 2;
+
+        // Returns false if the system doesn't track hand meshes. The hand tracking extensions must be enabled.
+        static bool IsSupported(XrInstance instance, XrSystemId systemId);
+
+        // Creates the hand trackers and hand mesh spaces of a new session.
+        void Initialize(const xr::ExtensionDispatchTable& extensions, XrInstance instance, XrSystemId systemId, XrSession session);
+
+        // Releases all handles of the session.
+        void Reset();
+
+        bool IsInitialized() const noexcept {
+            return m_hands[0].Tracker;
+        }
+
+        // Updates the hand meshes for the given time. Call once per frame, before the mesh spaces are added for locating.
+        void Update(XrTime time);
+
+        // Adds the hand mesh spaces to the frame's space locator, in the order GetMeshes expects them.
+        void AddSpaces(xr::SpaceLocator& spaceLocator);
+
+        // Returns one entry per hand with the located meshes; hands that are not tracked have no vertices.
+        const std::vector<sample::HandMesh>& GetMeshes(const xr::SpaceLocator& spaceLocator);
+
+    private:
+        struct Hand {
+            xr::HandTrackerHandle Tracker;
+            xr::SpaceHandle MeshSpace; // Declared after the tracker, so it is destroyed first.
+            XrHandMeshMSFT Mesh{XR_TYPE_HAND_MESH_MSFT};
+            std::vector<uint32_t> Indices;
+            std::vector<XrHandMeshVertexMSFT> Vertices;
+            uint32_t LocationIndex{xr::SpaceLocator::InvalidIndex};
+        };
+
+        const xr::ExtensionDispatchTable* m_extensions{nullptr};
+        std::array<Hand, HandCount> m_hands;
+        std::vector<sample::HandMesh> m_meshes = std::vector<sample::HandMesh>(HandCount);
+    };
+} // namespace sample
+#endif
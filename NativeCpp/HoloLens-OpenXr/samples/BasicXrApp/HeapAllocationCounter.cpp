@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "HeapAllocationCounter.h"
+
+#ifdef COUNT_HEAP_ALLOCATIONS
+namespace {
+    thread_local uint64_t t_heapAllocationCount = 0;
+    thread_local uint64_t t_uncountedHeapAllocationCount = 0;
+    thread_local uint32_t t_uncountedScopeDepth = 0;
+}
+
+// Replace the global allocation functions to count allocations per thread.
+// The array and nothrow forms of operator new forward to this one in the MSVC runtime.
+void* __cdecl operator new(size_t size) {
+    (t_uncountedScopeDepth > 0 ? t_uncountedHeapAllocationCount : t_heapAllocationCount)++;
+    if (void* ptr = malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void __cdecl operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void __cdecl operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+#endif
+
+namespace sample::debug {
+    uint64_t GetThreadHeapAllocationCount() {
+#ifdef COUNT_HEAP_ALLOCATIONS
+        return t_heapAllocationCount;
+#else
+        return 0;
+#endif
+    }
+
+    uint64_t GetThreadUncountedHeapAllocationCount() {
+#ifdef COUNT_HEAP_ALLOCATIONS
+        return t_uncountedHeapAllocationCount;
+#else
+        return 0;
+#endif
+    }
+
+    void EnterUncountedHeapAllocationScope() {
+#ifdef COUNT_HEAP_ALLOCATIONS
+        t_uncountedScopeDepth++;
+#endif
+    }
+
+    void LeaveUncountedHeapAllocationScope() {
+#ifdef COUNT_HEAP_ALLOCATIONS
+        t_uncountedScopeDepth--;
+#endif
+    }
+} // namespace sample::debug
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+// Allocations are counted in debug builds, and in release builds that define COUNT_HEAP_ALLOCATIONS, e.g. XrUtilityBench.
+#if defined(_DEBUG) && !defined(COUNT_HEAP_ALLOCATIONS)
+#define COUNT_HEAP_ALLOCATIONS
+#endif
+
+namespace sample::debug {
+    // Returns the number of heap allocations made through global operator new by the calling thread, outside of
+    // ScopedUncountedHeapAllocations. Without COUNT_HEAP_ALLOCATIONS this always returns 0.
+    uint64_t GetThreadHeapAllocationCount();
+
+    // Returns the number of heap allocations the calling thread made inside of ScopedUncountedHeapAllocations.
+    uint64_t GetThreadUncountedHeapAllocationCount();
+
+    void EnterUncountedHeapAllocationScope();
+    void LeaveUncountedHeapAllocationScope();
+
+    // Counts the heap allocations made by the calling thread since construction.
+    class ScopedHeapAllocationCounter {
+    public:
+        ScopedHeapAllocationCounter()
+            : m_startCount(GetThreadHeapAllocationCount())
+            , m_startUncountedCount(GetThreadUncountedHeapAllocationCount()) {
+        }
+
+        uint64_t Count() const {
+            return GetThreadHeapAllocationCount() - m_startCount;
+        }
+
+        // The allocations made inside of ScopedUncountedHeapAllocations since construction, which Count leaves out.
+        uint64_t UncountedCount() const {
+            return GetThreadUncountedHeapAllocationCount() - m_startUncountedCount;
+        }
+
+    private:
+        const uint64_t m_startCount;
+        const uint64_t m_startUncountedCount;
+    };
+
+    // Moves the heap allocations made by the calling thread until destruction from GetThreadHeapAllocationCount to
+    // GetThreadUncountedHeapAllocationCount, e.g. for calls into libraries whose allocations the sample doesn't control.
+    class ScopedUncountedHeapAllocations {
+    public:
+        ScopedUncountedHeapAllocations() {
+            EnterUncountedHeapAllocationScope();
+        }
+
+        ~ScopedUncountedHeapAllocations() {
+            LeaveUncountedHeapAllocationScope();
+        }
+
+        ScopedUncountedHeapAllocations(const ScopedUncountedHeapAllocations&) = delete;
+        ScopedUncountedHeapAllocations& operator=(const ScopedUncountedHeapAllocations&) = delete;
+    };
+} // namespace sample::debug
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "InputLatencyProbe.h"
+
+#include <TraceLoggingProvider.h>
+
+// Defined and registered in FrameProfiler.cpp.
+TRACELOGGING_DECLARE_PROVIDER(g_sampleTraceProvider);
+
+namespace sample::debug {
+    void InputLatencyProbe::TagInput(XrTime inputTime, bool remote) {
+        if (m_pendingCount == MaxPendingEvents) {
+            m_droppedEvents++;
+            return;
+        }
+        m_pending[m_pendingCount++] = {inputTime, 0, remote, false};
+    }
+
+    void InputLatencyProbe::OnFrameSubmitted(XrTime displayTime) {
+        for (uint32_t i = 0; i < m_pendingCount; i++) {
+            PendingEvent& event = m_pending[i];
+            if (event.Submitted) {
+                continue;
+            }
+            event.Submitted = true;
+            event.LocalMilliseconds = static_cast<float>((displayTime - event.InputTime) / 1'000'000.0);
+            Record("Local", event.LocalMilliseconds, m_localMilliseconds);
+        }
+        RemoveCompleted();
+    }
+
+    void InputLatencyProbe::OnRemoteRoundTrip(float roundTripSeconds) {
+        for (uint32_t i = 0; i < m_pendingCount; i++) {
+            PendingEvent& event = m_pending[i];
+            if (event.Remote && event.Submitted) {
+                Record("Remote", event.LocalMilliseconds + roundTripSeconds * 1000.0f, m_remoteMilliseconds);
+                event.Remote = false;
+            }
+        }
+        RemoveCompleted();
+    }
+
+    void InputLatencyProbe::Record(const char* kind, float milliseconds, RollingPercentiles& percentiles) {
+        percentiles.Add(milliseconds);
+        TraceLoggingWrite(g_sampleTraceProvider,
+                          "InputLatency",
+                          TraceLoggingString(kind, "Kind"),
+                          TraceLoggingFloat32(milliseconds, "Milliseconds"));
+
+        if (++m_eventsSinceReport == ReportIntervalInEvents) {
+            m_eventsSinceReport = 0;
+            Report();
+        }
+    }
+
+    void InputLatencyProbe::Report() {
+        const RollingPercentiles::Summary local = m_localMilliseconds.Compute();
+        const RollingPercentiles::Summary remote = m_remoteMilliseconds.Compute();
+        DEBUG_PRINT("Input latency in ms (p50 / p95 / p99), %llu events dropped:", m_droppedEvents);
+        DEBUG_PRINT("  Local  %6.2f / %6.2f / %6.2f of %u events", local.P50, local.P95, local.P99, local.Count);
+        if (remote.Count > 0) {
+            DEBUG_PRINT("  Remote %6.2f / %6.2f / %6.2f of %u events", remote.P50, remote.P95, remote.P99, remote.Count);
+        }
+    }
+
+    void InputLatencyProbe::RemoveCompleted() {
+        const auto end = std::remove_if(m_pending.begin(), m_pending.begin() + m_pendingCount, [](const PendingEvent& event) {
+            return event.Submitted && !event.Remote;
+        });
+        m_pendingCount = static_cast<uint32_t>(end - m_pending.begin());
+    }
+} // namespace sample::debug
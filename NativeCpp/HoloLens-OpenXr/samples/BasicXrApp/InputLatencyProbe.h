@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "FrameProfiler.h"
+
+namespace sample::debug {
+    // Measures how long it takes from an input event until a displayed frame reflects it.
+    //
+    // Input events are tagged with the XrTime at which the input happened, e.g. the lastChangeTime of an action state. The
+    // first frame submitted with xrEndFrame after the event reflects it locally, its predicted display time minus the input
+    // time is the input-to-photon latency. For remote content, the change still has to reach the server and come back in a
+    // remote frame: the remote latency adds the pose-to-receive and receive-to-present latencies of the remote frames
+    // displayed at that time, as reported by the ARR frame statistics.
+    //
+    // Every sample is written as an ETW event of the "Microsoft.Azure.RemoteRendering.Samples" TraceLogging provider, so the
+    // full distribution can be exported with Tools/ETLProfiles/AzureRemoteRenderingNetworkProfiling.wprp. Percentiles over
+    // a rolling window are printed to the debug output every ReportIntervalInEvents events.
+    //
+    // The probe does not allocate, events tagged while MaxPendingEvents are in flight are dropped.
+    class InputLatencyProbe {
+    public:
+        constexpr static uint32_t MaxPendingEvents = 16;
+        constexpr static uint32_t ReportIntervalInEvents = 20;
+
+        // Tags an input event. Remote events are also measured through the remote round trip.
+        void TagInput(XrTime inputTime, bool remote);
+
+        // Called after xrEndFrame submitted a frame with the given predicted display time.
+        void OnFrameSubmitted(XrTime displayTime);
+
+        // The server-side latency of the remote frames currently displayed, from the latest ARR frame statistics.
+        void OnRemoteRoundTrip(float roundTripSeconds);
+
+        // Drops the events in flight, e.g. when the remote connection is lost before they were measured.
+        void Reset() {
+            m_pendingCount = 0;
+        }
+
+    private:
+        struct PendingEvent {
+            XrTime InputTime = 0;
+            float LocalMilliseconds = 0; // Set once the event was submitted.
+            bool Remote = false;
+            bool Submitted = false;
+        };
+
+        void Record(const char* kind, float milliseconds, RollingPercentiles& percentiles);
+        void Report();
+        void RemoveCompleted();
+
+        std::array<PendingEvent, MaxPendingEvents> m_pending{};
+        uint32_t m_pendingCount = 0;
+        uint64_t m_droppedEvents = 0;
+        uint32_t m_eventsSinceReport = 0;
+        RollingPercentiles m_localMilliseconds;
+        RollingPercentiles m_remoteMilliseconds;
+    };
+} // namespace sample::debug
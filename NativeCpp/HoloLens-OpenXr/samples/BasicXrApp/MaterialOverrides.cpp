@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#ifdef USE_REMOTE_RENDERING
+#include "OpenXrProgram.h"
+#include "MaterialOverrides.h"
+
+namespace {
+    template <typename TFlags>
+    bool HasFlag(TFlags flags, TFlags flag) {
+        return (static_cast<uint32_t>(flags) & static_cast<uint32_t>(flag)) != 0;
+    }
+
+    template <typename TFlags>
+    TFlags SetFlag(TFlags flags, TFlags flag, bool enabled) {
+        const uint32_t bits = enabled ? static_cast<uint32_t>(flags) | static_cast<uint32_t>(flag)
+                                      : static_cast<uint32_t>(flags) & ~static_cast<uint32_t>(flag);
+        return static_cast<TFlags>(bits);
+    }
+
+    bool IsSameColor(const RR::Color4& a, const RR::Color4& b) {
+        return a.R == b.R && a.G == b.G && a.B == b.B && a.A == b.A;
+    }
+
+    // Collects the materials used by the meshes of the entity and its descendants, each material once.
+    void CollectMaterials(const RR::ApiHandle<RR::Entity>& entity, std::vector<RR::ApiHandle<RR::Material>>& materials) {
+        if (const RR::ApiHandle<RR::MeshComponent> meshComponent = entity->FindComponentOfType<RR::MeshComponent>()) {
+            std::vector<RR::ApiHandle<RR::Material>> used;
+            meshComponent->GetUsedMaterials(used);
+            for (RR::ApiHandle<RR::Material>& material : used) {
+                if (material != nullptr && std::find(materials.begin(), materials.end(), material) == materials.end()) {
+                    materials.push_back(std::move(material));
+                }
+            }
+        }
+
+        std::vector<RR::ApiHandle<RR::Entity>> children;
+        entity->GetChildren(children);
+        for (const RR::ApiHandle<RR::Entity>& child : children) {
+            CollectMaterials(child, materials);
+        }
+    }
+} // namespace
+
+namespace sample {
+    void MaterialOverrideSet::Reset() {
+        m_materials.clear();
+    }
+
+    void MaterialOverrideSet::SetModel(const std::string& key, RR::ApiHandle<RR::Entity> root) {
+        // The materials of a replaced model are destroyed with it, so they aren't restored.
+        auto belongsToModel = [&](const MaterialState& state) { return state.ModelKey == key; };
+        m_materials.erase(std::remove_if(m_materials.begin(), m_materials.end(), belongsToModel), m_materials.end());
+        if (root == nullptr) {
+            return;
+        }
+
+        std::vector<RR::ApiHandle<RR::Material>> materials;
+        CollectMaterials(root, materials);
+        for (RR::ApiHandle<RR::Material>& material : materials) {
+            MaterialState& state = m_materials.emplace_back();
+            state.ModelKey = key;
+            state.Name = material->GetName();
+            state.Original = state.Sent = ReadValues(material);
+            state.Material = std::move(material);
+        }
+        m_changed = !m_overrides.empty();
+    }
+
+    void MaterialOverrideSet::SetOverrides(std::vector<MaterialOverride> overrides) {
+        m_overrides = std::move(overrides);
+        m_overrideRegexes.clear();
+        for (const MaterialOverride& materialOverride : m_overrides) {
+            std::optional<std::regex>& regex = m_overrideRegexes.emplace_back();
+            if (materialOverride.NameMatching == MaterialOverride::Matching::Regex) {
+                regex.emplace(materialOverride.Name, std::regex::ECMAScript | std::regex::optimize);
+            }
+        }
+        m_changed = true;
+    }
+
+    size_t MaterialOverrideSet::Update() {
+        if (!m_changed) {
+            return 0;
+        }
+        m_changed = false;
+
+        size_t changeCount = 0;
+        for (MaterialState& state : m_materials) {
+            const MaterialValues wanted = GetWantedValues(state);
+            changeCount += WriteChangedValues(state.Material, state.Sent, wanted);
+            state.Sent = wanted;
+        }
+        if (changeCount > 0) {
+            DEBUG_PRINT("Changed %zu material properties for %zu overrides.", changeCount, m_overrides.size());
+        }
+        return changeCount;
+    }
+
+    MaterialOverrideSet::MaterialValues MaterialOverrideSet::ReadValues(const RR::ApiHandle<RR::Material>& material) {
+        MaterialValues values;
+        if (material->GetMaterialSubType() == RR::MaterialType::Pbr) {
+            const RR::ApiHandle<RR::PbrMaterial> pbr = material.as<RR::PbrMaterial>();
+            const RR::PbrMaterialFeatures flags = pbr->GetPbrFlags();
+            values.AlbedoColor = pbr->GetAlbedoColor();
+            values.Roughness = pbr->GetRoughness();
+            values.Metalness = pbr->GetMetalness();
+            values.AlphaClipThreshold = pbr->GetAlphaClipThreshold();
+            values.Transparent = HasFlag(flags, RR::PbrMaterialFeatures::TransparentMaterial);
+            values.AlphaClipEnabled = HasFlag(flags, RR::PbrMaterialFeatures::AlphaClipped);
+            values.UseVertexColor = HasFlag(flags, RR::PbrMaterialFeatures::UseVertexColor);
+            values.IsDoubleSided = HasFlag(flags, RR::PbrMaterialFeatures::DoubleSided);
+        } else if (material->GetMaterialSubType() == RR::MaterialType::Color) {
+            const RR::ApiHandle<RR::ColorMaterial> color = material.as<RR::ColorMaterial>();
+            const RR::ColorMaterialFeatures flags = color->GetColorFlags();
+            values.AlbedoColor = color->GetAlbedoColor();
+            values.AlphaClipThreshold = color->GetAlphaClipThreshold();
+            values.Transparent = color->GetColorTransparencyMode() != RR::ColorTransparencyMode::Opaque;
+            values.AlphaClipEnabled = HasFlag(flags, RR::ColorMaterialFeatures::AlphaClipped);
+            values.UseVertexColor = HasFlag(flags, RR::ColorMaterialFeatures::UseVertexColor);
+            values.IsDoubleSided = HasFlag(flags, RR::ColorMaterialFeatures::DoubleSided);
+        }
+        return values;
+    }
+
+    size_t MaterialOverrideSet::WriteChangedValues(const RR::ApiHandle<RR::Material>& material,
+                                                   const MaterialValues& from,
+                                                   const MaterialValues& to) {
+        size_t changeCount = 0;
+        auto changed = [&](bool differs) {
+            changeCount += differs ? 1 : 0;
+            return differs;
+        };
+        const bool transparencyChanged = from.Transparent != to.Transparent;
+        const bool featuresChanged = from.AlphaClipEnabled != to.AlphaClipEnabled || from.UseVertexColor != to.UseVertexColor ||
+                                     from.IsDoubleSided != to.IsDoubleSided;
+
+        if (material->GetMaterialSubType() == RR::MaterialType::Pbr) {
+            const RR::ApiHandle<RR::PbrMaterial> pbr = material.as<RR::PbrMaterial>();
+            if (changed(!IsSameColor(from.AlbedoColor, to.AlbedoColor))) {
+                pbr->SetAlbedoColor(to.AlbedoColor);
+            }
+            if (changed(from.Roughness != to.Roughness)) {
+                pbr->SetRoughness(to.Roughness);
+            }
+            if (changed(from.Metalness != to.Metalness)) {
+                pbr->SetMetalness(to.Metalness);
+            }
+            if (changed(from.AlphaClipThreshold != to.AlphaClipThreshold)) {
+                pbr->SetAlphaClipThreshold(to.AlphaClipThreshold);
+            }
+            if (changed(transparencyChanged || featuresChanged)) {
+                RR::PbrMaterialFeatures flags = pbr->GetPbrFlags();
+                flags = SetFlag(flags, RR::PbrMaterialFeatures::TransparentMaterial, to.Transparent);
+                flags = SetFlag(flags, RR::PbrMaterialFeatures::AlphaClipped, to.AlphaClipEnabled);
+                flags = SetFlag(flags, RR::PbrMaterialFeatures::UseVertexColor, to.UseVertexColor);
+                flags = SetFlag(flags, RR::PbrMaterialFeatures::DoubleSided, to.IsDoubleSided);
+                pbr->SetPbrFlags(flags);
+            }
+        } else if (material->GetMaterialSubType() == RR::MaterialType::Color) {
+            const RR::ApiHandle<RR::ColorMaterial> color = material.as<RR::ColorMaterial>();
+            if (changed(!IsSameColor(from.AlbedoColor, to.AlbedoColor))) {
+                color->SetAlbedoColor(to.AlbedoColor);
+            }
+            if (changed(from.AlphaClipThreshold != to.AlphaClipThreshold)) {
+                color->SetAlphaClipThreshold(to.AlphaClipThreshold);
+            }
+            if (changed(transparencyChanged)) {
+                // Color materials set the transparency as a mode instead of a feature flag.
+                color->SetColorTransparencyMode(to.Transparent ? RR::ColorTransparencyMode::AlphaBlended
+                                                               : RR::ColorTransparencyMode::Opaque);
+            }
+            if (changed(featuresChanged)) {
+                RR::ColorMaterialFeatures flags = color->GetColorFlags();
+                flags = SetFlag(flags, RR::ColorMaterialFeatures::AlphaClipped, to.AlphaClipEnabled);
+                flags = SetFlag(flags, RR::ColorMaterialFeatures::UseVertexColor, to.UseVertexColor);
+                flags = SetFlag(flags, RR::ColorMaterialFeatures::DoubleSided, to.IsDoubleSided);
+                color->SetColorFlags(flags);
+            }
+        }
+        return changeCount;
+    }
+
+    MaterialOverrideSet::MaterialValues MaterialOverrideSet::GetWantedValues(const MaterialState& state) const {
+        MaterialValues values = state.Original;
+        for (size_t i = 0; i < m_overrides.size(); i++) {
+            if (!Matches(i, state.Name)) {
+                continue;
+            }
+
+            const MaterialOverride& materialOverride = m_overrides[i];
+            if (materialOverride.AlbedoColor.has_value()) {
+                const std::array<float, 3>& rgb = materialOverride.AlbedoColor.value();
+                values.AlbedoColor.R = rgb[0];
+                values.AlbedoColor.G = rgb[1];
+                values.AlbedoColor.B = rgb[2];
+            }
+            values.AlbedoColor.A = materialOverride.AlbedoAlpha.value_or(values.AlbedoColor.A);
+            values.Roughness = materialOverride.Roughness.value_or(values.Roughness);
+            values.Metalness = materialOverride.Metalness.value_or(values.Metalness);
+            values.AlphaClipThreshold = materialOverride.AlphaClipThreshold.value_or(values.AlphaClipThreshold);
+            values.Transparent = materialOverride.Transparent.value_or(values.Transparent);
+            values.AlphaClipEnabled = materialOverride.AlphaClipEnabled.value_or(values.AlphaClipEnabled);
+            values.UseVertexColor = materialOverride.UseVertexColor.value_or(values.UseVertexColor);
+            values.IsDoubleSided = materialOverride.IsDoubleSided.value_or(values.IsDoubleSided);
+        }
+        return values;
+    }
+
+    bool MaterialOverrideSet::Matches(size_t overrideIndex, const std::string& materialName) const {
+        const std::optional<std::regex>& regex = m_overrideRegexes[overrideIndex];
+        return regex.has_value() ? std::regex_match(materialName, regex.value()) : materialName == m_overrides[overrideIndex].Name;
+    }
+} // namespace sample
+#endif
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#ifdef USE_REMOTE_RENDERING
+#include <optional>
+#include <regex>
+
+namespace sample {
+    // One entry of JsonSchemas/MaterialOverridesSchema.json, applied to the materials of loaded models at runtime. Unset values
+    // keep the value of the converted model.
+    //
+    // "unlit" and "ignoreTextureMaps" change how a material is converted and aren't available at runtime.
+    struct MaterialOverride {
+        enum class Matching {
+            Exact,
+            Regex,
+        };
+
+        std::string Name;
+        Matching NameMatching{Matching::Exact};
+
+        std::optional<float> Roughness;
+        std::optional<float> Metalness;
+
+        // The "colorOrAlpha" of the schema, of which the color and the alpha can be given independently.
+        std::optional<std::array<float, 3>> AlbedoColor; // r, g, b
+        std::optional<float> AlbedoAlpha;
+
+        std::optional<bool> Transparent;
+        std::optional<bool> AlphaClipEnabled;
+        std::optional<float> AlphaClipThreshold;
+        std::optional<bool> UseVertexColor;
+        std::optional<bool> IsDoubleSided;
+    };
+
+    // Applies a whole set of material overrides, e.g. to highlight a group of parts, with all changes in one frame.
+    //
+    // SetOverrides only replaces the wanted set. Update compares the values the set gives every material of the loaded models
+    // with the values sent last, and changes only the properties that differ. All changes are made before the same connection
+    // update, so the server receives them together and shows them in the same frame. Removing an override restores the values
+    // the material had when its model was added.
+    //
+    // Overrides are applied in order, so a later entry wins over an earlier one for the same property.
+    class MaterialOverrideSet {
+    public:
+        // Drops all models, e.g. when the connection is lost. The overrides are kept for the models added next.
+        void Reset();
+
+        // Adds the materials of the model under root, replacing the model previously set under the key, e.g. when the full
+        // version of a model replaces the coarse one.
+        void SetModel(const std::string& key, RR::ApiHandle<RR::Entity> root);
+
+        void SetOverrides(std::vector<MaterialOverride> overrides);
+
+        // Sends the changed material properties. Call once per frame before the connection update. Returns the number of
+        // properties changed.
+        size_t Update();
+
+    private:
+        // The properties that overrides can change. ColorMaterial has no roughness and metalness.
+        struct MaterialValues {
+            RR::Color4 AlbedoColor{1, 1, 1, 1};
+            float Roughness{0};
+            float Metalness{0};
+            float AlphaClipThreshold{0};
+            bool Transparent{false};
+            bool AlphaClipEnabled{false};
+            bool UseVertexColor{false};
+            bool IsDoubleSided{false};
+        };
+
+        struct MaterialState {
+            std::string ModelKey;
+            RR::ApiHandle<RR::Material> Material;
+            std::string Name;
+            MaterialValues Original;
+            MaterialValues Sent;
+        };
+
+        static MaterialValues ReadValues(const RR::ApiHandle<RR::Material>& material);
+        static size_t WriteChangedValues(const RR::ApiHandle<RR::Material>& material, const MaterialValues& from, const MaterialValues& to);
+        MaterialValues GetWantedValues(const MaterialState& state) const;
+        bool Matches(size_t overrideIndex, const std::string& materialName) const;
+
+        std::vector<MaterialState> m_materials;
+        std::vector<MaterialOverride> m_overrides;
+        std::vector<std::optional<std::regex>> m_overrideRegexes; // Set for the overrides matching by regex.
+        bool m_changed{false};
+    };
+} // namespace sample
+#endif
@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#ifdef USE_REMOTE_RENDERING
+#include "OpenXrProgram.h"
+#include "ModelLoadQueue.h"
+
+namespace {
+    double DistanceSquared(const RR::Double3& a, const RR::Double3& b) {
+        const double dx = a.X - b.X;
+        const double dy = a.Y - b.Y;
+        const double dz = a.Z - b.Z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+} // namespace
+
+namespace sample {
+    ModelLoadQueue::ModelLoadQueue(uint32_t maxConcurrentLoads)
+        : m_maxConcurrentLoads(std::max(maxConcurrentLoads, 1u)) {
+    }
+
+    void ModelLoadQueue::Reset(RR::ApiHandle<RR::RenderingConnection> connection, ChangedCallback onChanged, LoadedCallback onLoaded) {
+        m_connection = std::move(connection);
+        m_onChanged = std::move(onChanged);
+        m_onLoaded = std::move(onLoaded);
+        m_models.clear();
+        m_loadsInFlight = 0;
+        m_finishedCount = 0;
+        m_visibleCount = 0;
+        m_generation++;
+    }
+
+    void ModelLoadQueue::Enqueue(ModelRequest request) {
+        ModelLoad& load = m_models.emplace_back();
+        load.Request = std::move(request);
+        StartPendingLoads();
+    }
+
+    float ModelLoadQueue::GetProgress() const {
+        if (m_models.empty()) {
+            return 1.f;
+        }
+
+        float progress = 0.f;
+        for (const ModelLoad& load : m_models) {
+            progress += load.Finished ? 1.f : load.Progress;
+        }
+        return progress / m_models.size();
+    }
+
+    RR::Result ModelLoadQueue::GetResult() const {
+        for (const ModelLoad& load : m_models) {
+            if (load.Finished && load.Result != RR::Result::Success) {
+                return load.Result;
+            }
+        }
+        return RR::Result::Success;
+    }
+
+    void ModelLoadQueue::StartPendingLoads() {
+        while (m_connection != nullptr && m_loadsInFlight < m_maxConcurrentLoads) {
+            bool coarse = true;
+            size_t index = SelectNextPending(coarse);
+            if (index == m_models.size()) {
+                coarse = false;
+                index = SelectNextPending(coarse);
+            }
+            if (index == m_models.size()) {
+                break;
+            }
+            StartLoad(index, coarse);
+        }
+    }
+
+    size_t ModelLoadQueue::SelectNextPending(bool coarse) const {
+        size_t best = m_models.size();
+        double bestDistance = 0;
+        for (size_t i = 0; i < m_models.size(); i++) {
+            const ModelLoad& load = m_models[i];
+            const ModelRequest& request = load.Request;
+            const bool pending =
+                coarse ? !load.CoarseStarted && !load.Started && !request.CoarseModelUri.empty() : !load.Started;
+            if (!pending) {
+                continue;
+            }
+
+            const double distance = DistanceSquared(request.Position, m_viewerPosition);
+            if (best == m_models.size() || request.Priority > m_models[best].Request.Priority ||
+                (request.Priority == m_models[best].Request.Priority && distance < bestDistance)) {
+                best = i;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+
+    void ModelLoadQueue::StartLoad(size_t index, bool coarse) {
+        ModelLoad& load = m_models[index];
+        (coarse ? load.CoarseStarted : load.Started) = true;
+        m_loadsInFlight++;
+
+        RR::LoadModelFromSasOptions params;
+        params.ModelUri = (coarse ? load.Request.CoarseModelUri : load.Request.ModelUri).c_str();
+        params.Parent = load.Request.Parent;
+
+        // The loads vector only grows while the generation is unchanged, so indices stay valid in the callbacks.
+        m_connection->LoadModelFromSasAsync(
+            params,
+            // completed callback
+            [this, index, coarse, generation = m_generation](RR::Status status, RR::ApiHandle<RR::LoadModelResult> result) {
+                if (generation == m_generation) {
+                    OnLoadCompleted(index, coarse, status, std::move(result));
+                }
+            },
+            // progress update callback
+            [this, index, coarse, generation = m_generation](float progress) {
+                // The progress of the coarse version is not reported, it is small compared to the full model.
+                if (generation != m_generation || coarse) {
+                    return;
+                }
+
+                m_models[index].Progress = progress;
+                if (m_onChanged) {
+                    m_onChanged();
+                }
+            });
+    }
+
+    void ModelLoadQueue::OnLoadCompleted(size_t index, bool coarse, RR::Status status, RR::ApiHandle<RR::LoadModelResult> result) {
+        ModelLoad& load = m_models[index];
+        const RR::Result loadResult = RR::StatusToResult(status);
+        m_loadsInFlight--;
+
+        bool loaded = false;
+        if (coarse) {
+            // A failed coarse version only delays the first appearance of the part, it is not reported as an error.
+            load.CoarseFinished = true;
+            if (loadResult == RR::Result::Success) {
+                if (load.Finished && load.Root != nullptr) {
+                    // The full model overtook the coarse version.
+                    result->GetRoot()->Destroy();
+                } else {
+                    load.CoarseRoot = result->GetRoot();
+                    load.CoarseRoot->SetPosition(load.Request.Position);
+                    m_visibleCount++;
+                    loaded = true;
+                }
+            }
+        } else {
+            load.Result = loadResult;
+            load.Finished = true;
+            load.Progress = 1.f;
+            m_finishedCount++;
+
+            if (load.Result == RR::Result::Success) {
+                load.Root = result->GetRoot();
+                load.Root->SetPosition(load.Request.Position);
+                if (load.CoarseRoot != nullptr) {
+                    load.CoarseRoot->Destroy();
+                    load.CoarseRoot = nullptr;
+                } else {
+                    m_visibleCount++;
+                }
+                loaded = true;
+            }
+        }
+
+        StartPendingLoads();
+        if (loaded && m_onLoaded) {
+            m_onLoaded(load, coarse);
+        }
+        if (m_onChanged) {
+            m_onChanged();
+        }
+    }
+} // namespace sample
+#endif
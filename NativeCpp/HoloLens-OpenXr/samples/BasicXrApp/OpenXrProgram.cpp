@@ -6,6 +6,33 @@
 #include "OpenXrProgram.h"
 
 #include "DxUtility.h"
+#include "FrameProfiler.h"
+#include "GpuMemoryGovernor.h"
+#include "HandMeshTracker.h"
+#include "HeapAllocationCounter.h"
+#include "InputLatencyProbe.h"
+#include "PoseTrace.h"
+#include "RenderScaleController.h"
+#include "ReprojectionPolicy.h"
+#include "SceneCache.h"
+#include "SpatialAnchorStore.h"
+#include "StartupGraph.h"
+#include "SystemCapabilities.h"
+#include "XrUtilityBenchmarks.h"
+
+#if XR_MSFT_scene_understanding_preview3
+#include <XrUtility/XrSceneUnderstandingService.hpp>
+#include <XrUtility/XrSceneUnderstandingSpatialIndex.hpp>
+#endif
+
+// Cached scenes are keyed by persisted anchors, the only thing the next launch recognizes the room by.
+#define SCENE_CACHE_SUPPORTED (XR_MSFT_scene_understanding_serialization_preview && XR_MSFT_spatial_anchor_persistence_preview)
+#if SCENE_CACHE_SUPPORTED
+#include <future>
+#endif
+
+#include <functional>
+#include <mutex>
 
 // wchar_t conversion
 #include <codecvt>
@@ -13,11 +40,21 @@
 
 #ifdef USE_REMOTE_RENDERING
 #include "Content/StatusDisplay.h"
+#include "ConnectionProfileSelector.h"
+#include "MaterialOverrides.h"
+#include "ModelLoadQueue.h"
+#include "RegionProbe.h"
+#include "SessionPool.h"
+#include "SessionReadinessWatcher.h"
+#include "SpatialQueryBroker.h"
 #include <AzureRemoteRendering.inl>
 #include <RemoteRenderingExtensions.h>
 #endif
 
 namespace {
+    using sample::debug::FrameStage;
+    using sample::debug::PoseTraceMode;
+
     struct ImplementOpenXrProgram : sample::IOpenXrProgram {
         ImplementOpenXrProgram(std::string applicationName, std::unique_ptr<sample::IGraphicsPluginD3D11> graphicsPlugin)
             : m_applicationName(std::move(applicationName))
@@ -26,7 +63,11 @@ namespace {
 
 #ifdef USE_REMOTE_RENDERING
         ~ImplementOpenXrProgram() {
+            m_sessionReadinessWatcher.Stop();
+            m_sessionPool = nullptr;
+            m_frameStatisticsMonitor.Reset(nullptr, nullptr);
             if (m_renderingSession != nullptr) {
+                m_reconnectPending = false;
                 m_renderingSession->Disconnect();
                 m_renderingSession = nullptr;
             }
@@ -38,16 +79,15 @@ namespace {
 #endif
 
         void Run() override {
-#ifdef USE_REMOTE_RENDERING
-            InitARR();
-#endif
-            CreateInstance();
-            CreateActions();
+            RunStartup();
 
             bool requestRestart = false;
             do {
-                InitializeSystem();
-                InitializeSession();
+                // The first system and session are created by RunStartup, later ones after a session restart.
+                if (m_session.Get() == XR_NULL_HANDLE) {
+                    InitializeSystem();
+                    InitializeSession();
+                }
 
                 while (true) {
                     bool exitRenderLoop = false;
@@ -57,11 +97,24 @@ namespace {
                     }
 
                     if (m_sessionRunning) {
-                        PollActions();
+                        m_frameProfiler->BeginFrame();
+                        {
+                            const sample::debug::FrameProfiler::ScopedStage updateStage(*m_frameProfiler, FrameStage::Update);
+                            if (m_gpuMemoryGovernor->Update()) {
+                                ApplyGpuMemoryLevel();
+                            }
+                            if (m_poseTracePlayer && !m_poseTracePlayer->Advance()) {
+                                // The player reported its measurements, the replay ends the session like the recorded one.
+                                m_poseTracePlayer.reset();
+                                CHECK_XRCMD(xrRequestExitSession(m_session.Get()));
+                            }
+                            PollActions();
 #ifdef USE_REMOTE_RENDERING
-                        UpdateARR();
+                            UpdateARR();
 #endif
+                        }
                         RenderFrame();
+                        m_frameProfiler->EndFrame();
                     } else {
                         // Throttle loop since xrWaitFrame won't be called.
                         using namespace std::chrono_literals;
@@ -73,9 +126,53 @@ namespace {
                     PrepareSessionRestart();
                 }
             } while (requestRestart);
+
+#if XR_MSFT_spatial_anchor_persistence_preview
+            // Persist the holograms placed since the last session restart.
+            m_anchorStore.Disconnect();
+#endif
+            m_poseTraceRecorder.reset(); // Completes the trace.
         }
 
     private:
+        void RunStartup() {
+            using Thread = sample::StartupGraph::Thread;
+            sample::StartupGraph startup;
+            std::vector<sample::StartupGraph::TaskId> instanceDependencies;
+
+#ifdef USE_REMOTE_RENDERING
+            // ARR sets up the holographic remoting runtime that the OpenXR instance is created with, so it has to start first.
+            // Probing the regions, creating the client and finding a rendering session only talk to the network and overlap with
+            // the XR setup.
+            const auto startupArr = startup.Add("StartupRemoteRendering", Thread::Main, {}, [this] { StartupARR(); });
+            const auto selectRegion = startup.Add("SelectRemoteRenderingRegion", Thread::Worker, {}, [this] {
+                m_renderingRegion = sample::RegionProbe().SelectRegion();
+            });
+            const auto createClient =
+                startup.Add("CreateRemoteRenderingClient", Thread::Worker, {startupArr, selectRegion}, [this] { CreateARRClient(); });
+            startup.Add("AcquireRenderingSession", Thread::Worker, {createClient}, [this] { AcquireARRSession(); });
+            instanceDependencies.push_back(startupArr);
+#endif
+
+            if (m_poseTraceMode != PoseTraceMode::Off) {
+                startup.Add("OpenPoseTrace", Thread::Worker, {}, [this] { OpenPoseTrace(); });
+            }
+
+            const auto createInstance = startup.Add("CreateInstance", Thread::Main, instanceDependencies, [this] { CreateInstance(); });
+            const auto createActions = startup.Add("CreateActions", Thread::Main, {createInstance}, [this] { CreateActions(); });
+            const auto initializeSystem = startup.Add("InitializeSystem", Thread::Main, {createInstance}, [this] { InitializeSystem(); });
+            const auto initializeSession =
+                startup.Add("InitializeSession", Thread::Main, {createActions, initializeSystem}, [this] { InitializeSession(); });
+            if (m_runXrUtilityBenchmarks) {
+                // After the XR setup, so that the benchmarks don't compete with it for the main thread.
+                startup.Add("RunXrUtilityBenchmarks", Thread::Main, {initializeSession}, [this] {
+                    sample::debug::RunXrUtilityBenchmarks(m_instance.Get(), m_benchmarkResultsPath);
+                });
+            }
+
+            startup.Run();
+        }
+
         void CreateInstance() {
             CHECK(m_instance.Get() == XR_NULL_HANDLE);
 
@@ -126,6 +223,41 @@ namespace {
             m_optionalExtensions.DepthExtensionSupported = EnableExtensionIfSupported(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME);
             m_optionalExtensions.UnboundedRefSpaceSupported = EnableExtensionIfSupported(XR_MSFT_UNBOUNDED_REFERENCE_SPACE_EXTENSION_NAME);
             m_optionalExtensions.SpatialAnchorSupported = EnableExtensionIfSupported(XR_MSFT_SPATIAL_ANCHOR_EXTENSION_NAME);
+            m_optionalExtensions.ReprojectionModeSupported =
+                EnableExtensionIfSupported(XR_MSFT_COMPOSITION_LAYER_REPROJECTION_PREVIEW_EXTENSION_NAME);
+#if XR_KHR_locate_spaces
+            // Allows locating all hologram spaces with a single call per frame, see xr::SpaceLocator.
+            EnableExtensionIfSupported(XR_KHR_LOCATE_SPACES_EXTENSION_NAME);
+#endif
+#if XR_KHR_visibility_mask
+            // Lets the local content skip the pixels the display never shows, see UpdateVisibilityMasks.
+            m_optionalExtensions.VisibilityMaskSupported = EnableExtensionIfSupported(XR_KHR_VISIBILITY_MASK_EXTENSION_NAME);
+#endif
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+            // Lets the user's hands hide the holograms behind them, see HandMeshTracker.
+            if (EnableExtensionIfSupported(XR_EXT_HAND_TRACKING_EXTENSION_NAME)) {
+                m_optionalExtensions.HandTrackingMeshSupported = EnableExtensionIfSupported(XR_MSFT_HAND_TRACKING_MESH_EXTENSION_NAME);
+            }
+#endif
+#if XR_MSFT_scene_understanding_preview3
+            // Provides the environment meshes that hide local content behind real surfaces, see UpdateOcclusionMeshes.
+            m_optionalExtensions.SceneUnderstandingSupported =
+                EnableExtensionIfSupported(XR_MSFT_SCENE_UNDERSTANDING_PREVIEW3_EXTENSION_NAME);
+#endif
+#if XR_MSFT_scene_understanding_serialization_preview
+            // Shows the occlusion meshes of a known room right after launch, see UpdateSceneCache.
+            if (m_optionalExtensions.SceneUnderstandingSupported) {
+                m_optionalExtensions.SceneSerializationSupported =
+                    EnableExtensionIfSupported(XR_MSFT_SCENE_UNDERSTANDING_SERIALIZATION_PREVIEW_EXTENSION_NAME);
+            }
+#endif
+#if XR_MSFT_spatial_anchor_persistence_preview
+            // Keeps placed holograms across session restarts and launches, see SpatialAnchorStore.
+            if (m_optionalExtensions.SpatialAnchorSupported) {
+                m_optionalExtensions.SpatialAnchorPersistenceSupported =
+                    EnableExtensionIfSupported(XR_MSFT_SPATIAL_ANCHOR_PERSISTENCE_PREVIEW_EXTENSION_NAME);
+            }
+#endif
 
             return enabledExtensions;
         }
@@ -210,6 +342,25 @@ namespace {
                 suggestedBindings.countSuggestedBindings = (uint32_t)bindings.size();
                 CHECK_XRCMD(xrSuggestInteractionProfileBindings(m_instance.Get(), &suggestedBindings));
             }
+
+            // Prepare the per frame input reads, so that PollActions only syncs and then reads each declared action once per hand.
+            {
+                m_activeActionSet = {m_actionSet.Get(), XR_NULL_PATH};
+
+                const std::pair<XrAction, XrActionStateBoolean HandInput::*> booleanActions[] = {
+                    {m_placeAction.Get(), &HandInput::Place},
+                    {m_exitAction.Get(), &HandInput::Exit},
+                };
+                for (uint32_t side : {LeftSide, RightSide}) {
+                    m_booleanActionInputs[side].clear();
+                    for (const auto& [action, state] : booleanActions) {
+                        BooleanActionInput& booleanAction = m_booleanActionInputs[side].emplace_back();
+                        booleanAction.GetInfo.action = action;
+                        booleanAction.GetInfo.subactionPath = m_subactionPaths[side];
+                        booleanAction.State = state;
+                    }
+                }
+            }
         }
 
         void InitializeSystem() {
@@ -231,21 +382,26 @@ namespace {
                 }
             };
 
+            // Read what the system supports. After a session restart on the same system, or on the next launch, this skips the
+            // enumerations.
+            sample::SystemCapabilityCache::Query query;
+            query.ViewConfigurationType = m_primaryViewConfigType;
+            query.ReprojectionModes = m_optionalExtensions.ReprojectionModeSupported;
+            query.SceneComputeFeatures = m_optionalExtensions.SceneUnderstandingSupported;
+            const sample::SystemCapabilities& capabilities =
+                m_systemCapabilities.GetSystem(m_extensions, m_instance.Get(), m_systemId, query);
+
             // Choose an environment blend mode.
             {
-                // Query the list of supported environment blend modes for the current system.
-                uint32_t count;
-                CHECK_XRCMD(xrEnumerateEnvironmentBlendModes(m_instance.Get(), m_systemId, m_primaryViewConfigType, 0, &count, nullptr));
-                CHECK(count > 0); // A system must support at least one environment blend mode.
-
-                std::vector<XrEnvironmentBlendMode> environmentBlendModes(count);
-                CHECK_XRCMD(xrEnumerateEnvironmentBlendModes(
-                    m_instance.Get(), m_systemId, m_primaryViewConfigType, count, &count, environmentBlendModes.data()));
+                CHECK(capabilities.EnvironmentBlendModes.size() > 0); // A system must support at least one environment blend mode.
 
                 // This sample supports all modes, pick the system's preferred one.
-                m_environmentBlendMode = environmentBlendModes[0];
+                m_environmentBlendMode = capabilities.EnvironmentBlendModes[0];
             }
 
+            // Check which reprojection modes the runtime offers for the projection layer.
+            m_reprojectionPolicy.Initialize(capabilities.ReprojectionModes);
+
             // Choosing a reasonable depth range can help improve hologram visual quality.
             // Use reversed-Z (near > far) for more uniform Z resolution.
             m_nearFar = {20.f, 0.1f};
@@ -274,9 +430,16 @@ namespace {
             CHECK_MSG(featureLevels.size() != 0, "Unsupported minimum feature level!");
 
             ID3D11Device* device = m_graphicsPlugin->InitializeDevice(graphicsRequirements.adapterLuid, featureLevels);
+            m_frameProfiler = std::make_unique<sample::debug::FrameProfiler>(device);
+            m_gpuMemoryGovernor = std::make_unique<sample::GpuMemoryGovernor>(device);
+            if (m_measureInputLatency || m_poseTraceMode == PoseTraceMode::Replay) {
+                m_inputLatencyProbe = std::make_unique<sample::debug::InputLatencyProbe>();
+            }
 
 #ifdef USE_REMOTE_RENDERING
             m_statusDisplay = std::make_unique<StatusDisplay>(device);
+            m_displayedStatus.reset();
+            m_gpuMemoryGovernor->SetUsage(sample::GpuMemoryGovernor::Subsystem::StatusDisplay, m_statusDisplay->GetTextTextureBytes());
 #endif
 
             XrGraphicsBindingD3D11KHR graphicsBinding{XR_TYPE_GRAPHICS_BINDING_D3D11_KHR};
@@ -295,6 +458,20 @@ namespace {
 
             CreateSpaces();
             CreateSwapchains();
+            UpdateVisibilityMasks();
+
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+            if (m_optionalExtensions.HandTrackingMeshSupported && sample::HandMeshTracker::IsSupported(m_instance.Get(), m_systemId)) {
+                m_handMeshTracker.Initialize(m_extensions, m_instance.Get(), m_systemId, m_session.Get());
+            }
+#endif
+
+#if XR_MSFT_spatial_anchor_persistence_preview
+            // Only lists the persisted anchors, they are restored over the following frames as the user comes near them.
+            if (m_optionalExtensions.SpatialAnchorPersistenceSupported && m_anchorStore.Connect(m_extensions, m_session.Get())) {
+                ReserveFrameScratchStorage();
+            }
+#endif
         }
 
         void CreateSpaces() {
@@ -302,7 +479,11 @@ namespace {
 
             // Create a app space to bridge interactions and all holograms.
             {
-                if (m_optionalExtensions.UnboundedRefSpaceSupported) {
+                const std::vector<XrReferenceSpaceType>& referenceSpaceTypes =
+                    m_systemCapabilities.GetSession(m_session.Get()).ReferenceSpaceTypes;
+                if (m_optionalExtensions.UnboundedRefSpaceSupported &&
+                    std::find(referenceSpaceTypes.begin(), referenceSpaceTypes.end(), XR_REFERENCE_SPACE_TYPE_UNBOUNDED_MSFT) !=
+                        referenceSpaceTypes.end()) {
                     // Unbounded reference space provides the best app space for world-scale experiences.
                     m_appSpaceType = XR_REFERENCE_SPACE_TYPE_UNBOUNDED_MSFT;
                 } else {
@@ -339,13 +520,8 @@ namespace {
         std::tuple<DXGI_FORMAT, DXGI_FORMAT> SelectSwapchainPixelFormats() {
             CHECK(m_session.Get() != XR_NULL_HANDLE);
 
-            // Query the runtime's preferred swapchain formats.
-            uint32_t swapchainFormatCount;
-            CHECK_XRCMD(xrEnumerateSwapchainFormats(m_session.Get(), 0, &swapchainFormatCount, nullptr));
-
-            std::vector<int64_t> swapchainFormats(swapchainFormatCount);
-            CHECK_XRCMD(xrEnumerateSwapchainFormats(
-                m_session.Get(), (uint32_t)swapchainFormats.size(), &swapchainFormatCount, swapchainFormats.data()));
+            // The runtime's preferred swapchain formats.
+            const std::vector<int64_t>& swapchainFormats = m_systemCapabilities.GetSession(m_session.Get()).SwapchainFormats;
 
             // Choose the first runtime-preferred format that this app supports.
             auto SelectPixelFormat = [](const std::vector<int64_t>& runtimePreferredFormats,
@@ -373,21 +549,16 @@ namespace {
             m_renderResources = std::make_unique<RenderResources>();
 
             // Read graphics properties for preferred swapchain length and logging.
-            XrSystemProperties systemProperties{XR_TYPE_SYSTEM_PROPERTIES};
-            CHECK_XRCMD(xrGetSystemProperties(m_instance.Get(), m_systemId, &systemProperties));
+            const XrSystemProperties& systemProperties = m_systemCapabilities.Current().SystemProperties;
 
             // Select color and depth swapchain pixel formats.
             const auto [colorSwapchainFormat, depthSwapchainFormat] = SelectSwapchainPixelFormats();
 
-            // Query and cache view configuration views.
-            uint32_t viewCount;
-            CHECK_XRCMD(xrEnumerateViewConfigurationViews(m_instance.Get(), m_systemId, m_primaryViewConfigType, 0, &viewCount, nullptr));
+            // Cache the view configuration views.
+            m_renderResources->ConfigViews = m_systemCapabilities.Current().ViewConfigurationViews;
+            const uint32_t viewCount = (uint32_t)m_renderResources->ConfigViews.size();
             CHECK(viewCount == m_stereoViewCount);
 
-            m_renderResources->ConfigViews.resize(viewCount, {XR_TYPE_VIEW_CONFIGURATION_VIEW});
-            CHECK_XRCMD(xrEnumerateViewConfigurationViews(
-                m_instance.Get(), m_systemId, m_primaryViewConfigType, viewCount, &viewCount, m_renderResources->ConfigViews.data()));
-
             // Using texture array for better performance, so requiring left/right views have identical sizes.
             const XrViewConfigurationView& view = m_renderResources->ConfigViews[0];
             CHECK(m_renderResources->ConfigViews[0].recommendedImageRectWidth ==
@@ -425,8 +596,32 @@ namespace {
                                      0 /*createFlags*/,
                                      XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
 
+            // Create the render target and depth stencil views for every swapchain image up front,
+            // so that the frame loop only needs to look them up by the acquired image index.
+            for (const XrSwapchainImageD3D11KHR& image : m_renderResources->ColorSwapchain.Images) {
+                m_renderResources->ColorSwapchain.RenderTargetViews.push_back(
+                    m_graphicsPlugin->CreateRenderTargetView(image.texture, colorSwapchainFormat));
+            }
+            for (const XrSwapchainImageD3D11KHR& image : m_renderResources->DepthSwapchain.Images) {
+                m_renderResources->DepthSwapchain.DepthStencilViews.push_back(
+                    m_graphicsPlugin->CreateDepthStencilView(image.texture, depthSwapchainFormat));
+            }
+
             // Preallocate view buffers for xrLocateViews later inside frame loop.
             m_renderResources->Views.resize(viewCount, {XR_TYPE_VIEW});
+
+            // Preallocate the per-frame scratch storage so that the steady-state frame loop doesn't allocate.
+            m_renderResources->ViewProjections.resize(viewCount);
+            m_renderResources->ProjectionLayerViews.resize(viewCount);
+            if (m_optionalExtensions.DepthExtensionSupported) {
+                m_renderResources->DepthInfoViews.resize(viewCount);
+            }
+            m_renderResources->Layers.reserve(1);
+            ReserveFrameScratchStorage();
+
+            m_gpuMemoryGovernor->SetUsage(sample::GpuMemoryGovernor::Subsystem::Swapchains,
+                                          GetSwapchainBytes(m_renderResources->ColorSwapchain, swapchainSampleCount) +
+                                              GetSwapchainBytes(m_renderResources->DepthSwapchain, swapchainSampleCount));
         }
 
         struct SwapchainD3D11;
@@ -469,6 +664,22 @@ namespace {
             return swapchain;
         }
 
+        // Estimates the video memory of the swapchain images from their size and format.
+        static uint64_t GetSwapchainBytes(const SwapchainD3D11& swapchain, uint32_t sampleCount) {
+            uint64_t bytesPerPixel = 4; // The 32 bit color and depth formats.
+            switch (swapchain.Format) {
+            case DXGI_FORMAT_D16_UNORM:
+                bytesPerPixel = 2;
+                break;
+            case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+                bytesPerPixel = 8;
+                break;
+            default:
+                break;
+            }
+            return bytesPerPixel * swapchain.Width * swapchain.Height * swapchain.ArraySize * sampleCount * swapchain.Images.size();
+        }
+
         void ProcessEvents(bool* exitRenderLoop, bool* requestRestart) {
             *exitRenderLoop = *requestRestart = false;
 
@@ -519,6 +730,12 @@ namespace {
                     }
                     break;
                 }
+#if XR_KHR_visibility_mask
+                case XR_TYPE_EVENT_DATA_VISIBILITY_MASK_CHANGED_KHR: {
+                    UpdateVisibilityMasks();
+                    break;
+                }
+#endif
                 case XR_TYPE_EVENT_DATA_REFERENCE_SPACE_CHANGE_PENDING:
                 case XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED:
                 default: {
@@ -529,6 +746,35 @@ namespace {
             }
         }
 
+        // Reads the hidden triangle mesh of every view and hands it to the graphics plugin. Without the extension the masks stay
+        // empty and every pixel is shaded.
+        void UpdateVisibilityMasks() {
+#if XR_KHR_visibility_mask
+            if (!m_optionalExtensions.VisibilityMaskSupported || m_session.Get() == XR_NULL_HANDLE) {
+                return;
+            }
+
+            std::vector<sample::VisibilityMask> masks(m_stereoViewCount);
+            for (uint32_t viewIndex = 0; viewIndex < m_stereoViewCount; viewIndex++) {
+                XrVisibilityMaskKHR mask{XR_TYPE_VISIBILITY_MASK_KHR};
+                CHECK_XRCMD(m_extensions.xrGetVisibilityMaskKHR(
+                    m_session.Get(), m_primaryViewConfigType, viewIndex, XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR, &mask));
+
+                masks[viewIndex].Vertices.resize(mask.vertexCountOutput);
+                masks[viewIndex].Indices.resize(mask.indexCountOutput);
+                mask.vertexCapacityInput = mask.vertexCountOutput;
+                mask.vertices = masks[viewIndex].Vertices.data();
+                mask.indexCapacityInput = mask.indexCountOutput;
+                mask.indices = masks[viewIndex].Indices.data();
+                CHECK_XRCMD(m_extensions.xrGetVisibilityMaskKHR(
+                    m_session.Get(), m_primaryViewConfigType, viewIndex, XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR, &mask));
+                masks[viewIndex].Vertices.resize(mask.vertexCountOutput);
+                masks[viewIndex].Indices.resize(mask.indexCountOutput);
+            }
+            m_graphicsPlugin->SetVisibilityMasks(masks);
+#endif
+        }
+
         struct Hologram;
         Hologram CreateHologram(const XrPosef& poseInAppSpace, XrTime placementTime) const {
             Hologram hologram{};
@@ -563,87 +809,160 @@ namespace {
             return hologram;
         }
 
+        void AddHologram(Hologram hologram, const XrPosef& poseInAppSpace, XrTime placementTime) {
+#if XR_MSFT_spatial_anchor_persistence_preview
+            if (hologram.Anchor && m_anchorStore.IsConnected()) {
+                // The store persists the anchor, and releases its space while the user is far away from it.
+                m_anchorStore.Add(std::move(hologram.Anchor), std::move(hologram.Cube.Space), poseInAppSpace, placementTime);
+                return;
+            }
+#endif
+            m_holograms.push_back(std::move(hologram));
+        }
+
         void PollActions() {
-            // Get updated action states.
-            std::vector<XrActiveActionSet> activeActionSets = {{m_actionSet.Get(), XR_NULL_PATH}};
+            // Get updated action states. The active action set never changes, so the sync info points at a member.
             XrActionsSyncInfo syncInfo{XR_TYPE_ACTIONS_SYNC_INFO};
-            syncInfo.countActiveActionSets = (uint32_t)activeActionSets.size();
-            syncInfo.activeActionSets = activeActionSets.data();
+            syncInfo.countActiveActionSets = 1;
+            syncInfo.activeActionSets = &m_activeActionSet;
             CHECK_XRCMD(xrSyncActions(m_session.Get(), &syncInfo));
 
+            ReadHandInputs();
+
             // Check the state of the actions for left and right hands separately.
             for (uint32_t side : {LeftSide, RightSide}) {
-                const XrPath subactionPath = m_subactionPaths[side];
-
-                // Apply a tiny vibration to the corresponding hand to indicate that action is detected.
-                auto ApplyVibration = [this, subactionPath] {
-                    XrHapticActionInfo actionInfo{XR_TYPE_HAPTIC_ACTION_INFO};
-                    actionInfo.action = m_vibrateAction.Get();
-                    actionInfo.subactionPath = subactionPath;
-
-                    XrHapticVibration vibration{XR_TYPE_HAPTIC_VIBRATION};
-                    vibration.amplitude = 0.5f;
-                    vibration.duration = XR_MIN_HAPTIC_DURATION;
-                    vibration.frequency = XR_FREQUENCY_UNSPECIFIED;
-                    CHECK_XRCMD(xrApplyHapticFeedback(m_session.Get(), &actionInfo, (XrHapticBaseHeader*)&vibration));
-                };
-
-                XrActionStateBoolean placeActionValue{XR_TYPE_ACTION_STATE_BOOLEAN};
-                {
-                    XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-                    getInfo.action = m_placeAction.Get();
-                    getInfo.subactionPath = subactionPath;
-                    CHECK_XRCMD(xrGetActionStateBoolean(m_session.Get(), &getInfo, &placeActionValue));
-                }
+                HandInput& input = m_handInputs[side];
 
                 // When select button is pressed, place the cube at the location of the corresponding hand.
+                const XrActionStateBoolean& placeActionValue = input.Place;
                 if (placeActionValue.isActive && placeActionValue.changedSinceLastSync && placeActionValue.currentState) {
                     // Use the pose at the historical time when the action happened to do the placement.
                     const XrTime placementTime = placeActionValue.lastChangeTime;
 
                     // Locate the hand in the scene.
                     XrSpaceLocation handLocation{XR_TYPE_SPACE_LOCATION};
-                    CHECK_XRCMD(xrLocateSpace(m_cubesInHand[side].Space.Get(), m_appSpace.Get(), placementTime, &handLocation));
+                    const XrSpaceLocation* recordedLocation = m_poseTracePlayer ? m_poseTracePlayer->TryGetPlaceLocation(side) : nullptr;
+                    if (recordedLocation != nullptr) {
+                        handLocation = *recordedLocation;
+                    } else {
+                        CHECK_XRCMD(xrLocateSpace(m_cubesInHand[side].Space.Get(), m_appSpace.Get(), placementTime, &handLocation));
+                    }
+                    if (m_poseTraceRecorder) {
+                        m_poseTraceRecorder->RecordPlacement(side, handLocation);
+                    }
 
                     // Ensure we have tracking before placing a cube in the scene, so that it stays reliably at a physical location.
                     if (!xr::math::Pose::IsPoseValid(handLocation)) {
                         DEBUG_PRINT("Cube cannot be placed when positional tracking is lost.");
                     } else {
                         // Place a new cube at the given location and time, and remember output placement space and anchor.
-                        m_holograms.push_back(CreateHologram(handLocation.pose, placementTime));
+#if XR_MSFT_scene_understanding_preview3
+                        const XrPosef placementPose = SnapToSurface(handLocation.pose);
+#else
+                        const XrPosef& placementPose = handLocation.pose;
+#endif
+                        AddHologram(CreateHologram(placementPose, placementTime), placementPose, placementTime);
+                        ReserveFrameScratchStorage();
+#ifdef USE_REMOTE_RENDERING
+                        RayCastRemoteModels(side, handLocation.pose);
+#endif
+
+                        if (m_inputLatencyProbe) {
+#ifdef USE_REMOTE_RENDERING
+                            // The cube is drawn over the remote frame, measure until the remote content caught up as well.
+                            m_inputLatencyProbe->TagInput(placementTime, m_isConnected);
+#else
+                            m_inputLatencyProbe->TagInput(placementTime, false);
+#endif
+                        }
                     }
 
-                    ApplyVibration();
+                    input.VibrationRequested = true;
                 }
 
                 // This sample, when menu button is released, requests to quit the session, and therefore quit the application.
-                {
-                    XrActionStateBoolean exitActionValue{XR_TYPE_ACTION_STATE_BOOLEAN};
-                    XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-                    getInfo.action = m_exitAction.Get();
-                    getInfo.subactionPath = subactionPath;
-                    CHECK_XRCMD(xrGetActionStateBoolean(m_session.Get(), &getInfo, &exitActionValue));
-
-                    if (exitActionValue.isActive && exitActionValue.changedSinceLastSync && !exitActionValue.currentState) {
-                        CHECK_XRCMD(xrRequestExitSession(m_session.Get()));
-                        ApplyVibration();
-                    }
+                const XrActionStateBoolean& exitActionValue = input.Exit;
+                if (exitActionValue.isActive && exitActionValue.changedSinceLastSync && !exitActionValue.currentState) {
+                    CHECK_XRCMD(xrRequestExitSession(m_session.Get()));
+                    input.VibrationRequested = true;
                 }
             }
+
+            ApplyRequestedVibrations();
+        }
+
+        // Reads the state of every boolean action for both hands into m_handInputs, using the get infos prepared in CreateActions.
+        void ReadHandInputs() {
+            for (uint32_t side : {LeftSide, RightSide}) {
+                HandInput& input = m_handInputs[side];
+                for (const BooleanActionInput& booleanAction : m_booleanActionInputs[side]) {
+                    XrActionStateBoolean& state = input.*booleanAction.State;
+                    state = {XR_TYPE_ACTION_STATE_BOOLEAN};
+                    CHECK_XRCMD(xrGetActionStateBoolean(m_session.Get(), &booleanAction.GetInfo, &state));
+                }
+
+                if (m_poseTracePlayer) {
+                    m_poseTracePlayer->ApplyInput(side, input.Place, input.Exit);
+                }
+                if (m_poseTraceRecorder) {
+                    m_poseTraceRecorder->RecordInput(side, input.Place, input.Exit);
+                }
+            }
+        }
+
+        // Applies a tiny vibration to each hand that detected an action this frame, at most once per hand.
+        void ApplyRequestedVibrations() {
+            for (uint32_t side : {LeftSide, RightSide}) {
+                HandInput& input = m_handInputs[side];
+                if (!input.VibrationRequested) {
+                    continue;
+                }
+                input.VibrationRequested = false;
+
+                XrHapticActionInfo actionInfo{XR_TYPE_HAPTIC_ACTION_INFO};
+                actionInfo.action = m_vibrateAction.Get();
+                actionInfo.subactionPath = m_subactionPaths[side];
+
+                XrHapticVibration vibration{XR_TYPE_HAPTIC_VIBRATION};
+                vibration.amplitude = 0.5f;
+                vibration.duration = XR_MIN_HAPTIC_DURATION;
+                vibration.frequency = XR_FREQUENCY_UNSPECIFIED;
+                CHECK_XRCMD(xrApplyHapticFeedback(m_session.Get(), &actionInfo, (XrHapticBaseHeader*)&vibration));
+            }
         }
 
         void RenderFrame() {
             CHECK(m_session.Get() != XR_NULL_HANDLE);
 
+            const sample::debug::ScopedHeapAllocationCounter frameAllocations;
+
             XrFrameWaitInfo frameWaitInfo{XR_TYPE_FRAME_WAIT_INFO};
             XrFrameState frameState{XR_TYPE_FRAME_STATE};
+            m_frameProfiler->BeginStage(FrameStage::WaitFrame);
             CHECK_XRCMD(xrWaitFrame(m_session.Get(), &frameWaitInfo, &frameState));
 
             XrFrameBeginInfo frameBeginInfo{XR_TYPE_FRAME_BEGIN_INFO};
             CHECK_XRCMD(xrBeginFrame(m_session.Get(), &frameBeginInfo));
+            m_frameProfiler->EndStage(FrameStage::WaitFrame);
+
+            if (m_poseTraceRecorder) {
+                m_poseTraceRecorder->RecordFrameState(frameState);
+            }
+
+            // Adapt the render scale to the GPU time of the most recently measured frame.
+            if (m_useDynamicRenderScale) {
+                uint64_t gpuFrameIndex;
+                float gpuMilliseconds;
+                if (m_frameProfiler->TryGetLatestGpuMilliseconds(FrameStage::RenderView, gpuFrameIndex, gpuMilliseconds)) {
+                    const float displayPeriodMilliseconds = static_cast<float>(frameState.predictedDisplayPeriod / 1e6);
+                    m_renderScaleController.Update(
+                        gpuFrameIndex, gpuMilliseconds, displayPeriodMilliseconds, m_frameProfiler->GetFrameIndex());
+                }
+            }
 
             // xrEndFrame can submit multiple layers. This sample submits one.
-            std::vector<XrCompositionLayerBaseHeader*> layers;
+            std::vector<XrCompositionLayerBaseHeader*>& layers = m_renderResources->Layers;
+            layers.clear();
 
             // The projection layer consists of projection layer views.
             XrCompositionLayerProjection layer{XR_TYPE_COMPOSITION_LAYER_PROJECTION};
@@ -679,8 +998,18 @@ namespace {
                     CHECK(viewCountOutput == m_renderResources->DepthSwapchain.ArraySize);
                 }
 
+                // A replayed frame renders the recorded views, and animates the content to the recorded display time.
+                XrTime animationTime = frameState.predictedDisplayTime;
+                if (m_poseTracePlayer) {
+                    animationTime = m_poseTracePlayer->ApplyViews(
+                        frameState.predictedDisplayTime, m_renderResources->ViewState, m_renderResources->Views);
+                }
+                if (m_poseTraceRecorder) {
+                    m_poseTraceRecorder->RecordViews(m_renderResources->ViewState, m_renderResources->Views);
+                }
+
                 // Then, render projection layer into each view.
-                if (RenderLayer(frameState.predictedDisplayTime, layer)) {
+                if (RenderLayer(frameState.predictedDisplayTime, animationTime, layer)) {
                     layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&layer));
                 }
             }
@@ -691,19 +1020,106 @@ namespace {
             frameEndInfo.environmentBlendMode = m_environmentBlendMode;
             frameEndInfo.layerCount = (uint32_t)layers.size();
             frameEndInfo.layers = layers.data();
+            m_frameProfiler->BeginStage(FrameStage::EndFrame);
             CHECK_XRCMD(xrEndFrame(m_session.Get(), &frameEndInfo));
+            m_frameProfiler->EndStage(FrameStage::EndFrame);
+
+            if (m_inputLatencyProbe && !layers.empty()) {
+                m_inputLatencyProbe->OnFrameSubmitted(frameState.predictedDisplayTime);
+            }
+            if (m_poseTracePlayer) {
+                m_poseTracePlayer->OnFrameSubmitted(frameState.predictedDisplayTime, frameState.predictedDisplayPeriod);
+            }
+            if (m_poseTraceRecorder) {
+                m_poseTraceRecorder->EndFrame();
+            }
+
+            CheckSteadyStateFrameAllocations(frameAllocations.Count(), frameAllocations.UncountedCount());
         }
 
-        uint32_t AcquireAndWaitForSwapchainImage(XrSwapchain handle) {
+        // Make sure the visible cube list and the space locator can hold every cube without growing inside the frame loop.
+        void ReserveFrameScratchStorage() {
+            if (m_renderResources != nullptr) {
+                size_t cubeCount = m_cubesInHand.size() + m_holograms.size();
+#if XR_MSFT_spatial_anchor_persistence_preview
+                cubeCount += m_anchorStore.GetAnchors().size(); // Every anchor may become active.
+#endif
+                m_renderResources->VisibleCubes.reserve(cubeCount);
+                size_t spaceCount = cubeCount + 1 /*status display*/;
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+                spaceCount += sample::HandMeshTracker::HandCount;
+#endif
+                m_renderResources->SpaceLocator.Reserve(spaceCount);
+            }
+        }
+
+        // Gathers the spaces of all cubes and the status display and locates them in app space with a single batch.
+        // The order in which cube spaces are added must match the order in which RenderLayer consumes them.
+        void LocateFrameSpaces(XrTime predictedDisplayTime) {
+            xr::SpaceLocator& spaceLocator = m_renderResources->SpaceLocator;
+            spaceLocator.Clear();
+
+            spaceLocator.Add(m_cubesInHand[LeftSide].Space.Get());
+            spaceLocator.Add(m_cubesInHand[RightSide].Space.Get());
+            for (const auto& hologram : m_holograms) {
+                spaceLocator.Add(hologram.Cube.Space.Get());
+            }
+#if XR_MSFT_spatial_anchor_persistence_preview
+            for (const auto& anchor : m_anchorStore.GetAnchors()) {
+                if (anchor.Cube.Space) {
+                    spaceLocator.Add(anchor.Cube.Space.Get());
+                }
+            }
+#endif
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+            m_handMeshTracker.AddSpaces(spaceLocator);
+#endif
+
+#ifdef USE_REMOTE_RENDERING
+            m_renderResources->StatusDisplayLocationIndex = spaceLocator.Add(m_statusDisplaySpace.Get());
+#endif
+
+            spaceLocator.Locate(m_extensions, m_session.Get(), m_appSpace.Get(), predictedDisplayTime);
+        }
+
+        void CheckSteadyStateFrameAllocations([[maybe_unused]] uint64_t allocationCount, [[maybe_unused]] uint64_t uncountedCount) {
+#ifdef _DEBUG
+            // The first frames lazily initialize the spinning cubes, after which the frame loop should not touch the heap.
+            constexpr uint32_t warmUpFrameCount = 10;
+            if (m_renderResources->FrameCount < warmUpFrameCount) {
+                m_renderResources->FrameCount++;
+                return;
+            }
+            assert(allocationCount == 0 && "Steady-state RenderFrame must not allocate from the heap.");
+
+            // Remote rendering and new scenes allocate outside of the counted scope, so they are only reported once in a while.
+            RenderResources::UncountedAllocationReport& report = m_renderResources->UncountedAllocations;
+            report.Allocations += uncountedCount;
+            report.AllocatingFrames += uncountedCount > 0 ? 1 : 0;
+            if (++report.Frames == sample::debug::FrameProfiler::ReportIntervalInFrames) {
+                if (report.Allocations > 0) {
+                    DEBUG_PRINT("RenderFrame made %llu uncounted heap allocations in %u of the last %u frames.",
+                                report.Allocations,
+                                report.AllocatingFrames,
+                                report.Frames);
+                }
+                report = {};
+            }
+#endif
+        }
+
+        uint32_t AcquireSwapchainImage(XrSwapchain handle) {
             uint32_t swapchainImageIndex;
             XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
             CHECK_XRCMD(xrAcquireSwapchainImage(handle, &acquireInfo, &swapchainImageIndex));
+            return swapchainImageIndex;
+        }
 
+        // Blocks until the compositor is done reading the acquired image, which takes long when the GPU is behind.
+        void WaitForSwapchainImage(XrSwapchain handle) {
             XrSwapchainImageWaitInfo waitInfo{XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
             waitInfo.timeout = XR_INFINITE_DURATION;
             CHECK_XRCMD(xrWaitSwapchainImage(handle, &waitInfo));
-
-            return swapchainImageIndex;
         }
 
         void InitializeSpinningCube(XrTime predictedDisplayTime) {
@@ -735,6 +1151,8 @@ namespace {
 
                 m_spinningCubeStartTime = predictedDisplayTime;
             }
+
+            ReserveFrameScratchStorage();
         }
 
         void UpdateSpinningCube(XrTime predictedDisplayTime) {
@@ -763,7 +1181,8 @@ namespace {
             }
         }
 
-        bool RenderLayer(XrTime predictedDisplayTime, XrCompositionLayerProjection& layer) {
+        // The animation time differs from the predicted display time while a pose trace is replayed.
+        bool RenderLayer(XrTime predictedDisplayTime, XrTime animationTime, XrCompositionLayerProjection& layer) {
             const uint32_t viewCount = (uint32_t)m_renderResources->ConfigViews.size();
 
             if (!xr::math::Pose::IsPoseValid(m_renderResources->ViewState)) {
@@ -771,12 +1190,49 @@ namespace {
                 return false; // Skip rendering layers if view location is invalid
             }
 
-            std::vector<const sample::Cube*> visibleCubes;
+            // Swapchain is acquired, rendered to, and released together for all views as texture array
+            const SwapchainD3D11& colorSwapchain = m_renderResources->ColorSwapchain;
+            const SwapchainD3D11& depthSwapchain = m_renderResources->DepthSwapchain;
+
+            // Acquiring doesn't block, the images are only waited for right before rendering into them, so that the CPU work
+            // below overlaps with the compositor still reading the images.
+            const uint32_t colorSwapchainImageIndex = AcquireSwapchainImage(colorSwapchain.Handle.Get());
+            const uint32_t depthSwapchainImageIndex = AcquireSwapchainImage(depthSwapchain.Handle.Get());
+
+            UpdateSpinningCube(animationTime);
+
+#if XR_MSFT_spatial_anchor_persistence_preview
+            // Decide which anchors have a space this frame, before the spaces are gathered for locating.
+            m_anchorStore.Update(m_renderResources->Views[0].pose.position);
+#endif
+
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+            // Only hands with a mesh at this time add their mesh space.
+            m_handMeshTracker.Update(predictedDisplayTime);
+#endif
+
+            // Locate all spaces used by this frame in one pass, the results are reused below.
+            LocateFrameSpaces(predictedDisplayTime);
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+            if (m_handMeshTracker.IsInitialized()) {
+                m_graphicsPlugin->SetHandMeshes(m_handMeshTracker.GetMeshes(m_renderResources->SpaceLocator));
+            }
+#endif
+
+#if XR_MSFT_scene_understanding_preview3
+            UpdateOcclusionMeshes(predictedDisplayTime);
+#endif
+
+            std::vector<const sample::Cube*>& visibleCubes = m_renderResources->VisibleCubes;
+            visibleCubes.clear();
 
-            auto UpdateVisibleCube = [&](sample::Cube& cube) {
+            // Cube locations were added to the space locator in the same order as visited here.
+            const xr::SpaceLocator& spaceLocator = m_renderResources->SpaceLocator;
+            uint32_t cubeLocationIndex = 0;
+            auto UpdateVisibleCube = [&](sample::Cube& cube, const XrSpaceLocation* recordedLocation = nullptr) {
                 if (cube.Space.Get() != XR_NULL_HANDLE) {
-                    XrSpaceLocation cubeSpaceInAppSpace{XR_TYPE_SPACE_LOCATION};
-                    CHECK_XRCMD(xrLocateSpace(cube.Space.Get(), m_appSpace.Get(), predictedDisplayTime, &cubeSpaceInAppSpace));
+                    const XrSpaceLocation& liveLocation = *spaceLocator.TryGetLocation(cubeLocationIndex++);
+                    const XrSpaceLocation& cubeSpaceInAppSpace = recordedLocation != nullptr ? *recordedLocation : liveLocation;
 
                     // Update cube's location with latest space location
                     if (xr::math::Pose::IsPoseValid(cubeSpaceInAppSpace)) {
@@ -786,50 +1242,59 @@ namespace {
                             cube.PoseInAppSpace = cubeSpaceInAppSpace.pose;
                         }
                         visibleCubes.push_back(&cube);
+                        return true;
                     }
                 }
+                return false;
             };
 
-            UpdateSpinningCube(predictedDisplayTime);
-
-            UpdateVisibleCube(m_cubesInHand[LeftSide]);
-            UpdateVisibleCube(m_cubesInHand[RightSide]);
+            [[maybe_unused]] std::array<bool, 2> handTracked;
+            for (uint32_t side : {LeftSide, RightSide}) {
+                if (m_poseTraceRecorder) {
+                    // The hand spaces are never null, so the next location is the hand's.
+                    m_poseTraceRecorder->RecordGrip(side, *spaceLocator.TryGetLocation(cubeLocationIndex));
+                }
+                const XrSpaceLocation* recordedGrip = m_poseTracePlayer ? m_poseTracePlayer->TryGetGripLocation(side) : nullptr;
+                handTracked[side] = UpdateVisibleCube(m_cubesInHand[side], recordedGrip);
+            }
 
             for (auto& hologram : m_holograms) {
                 UpdateVisibleCube(hologram.Cube);
             }
 
-#ifdef USE_REMOTE_RENDERING
-            if (m_statusDisplay != nullptr) {
-                XrSpaceLocation viewSpaceInAppSpace{XR_TYPE_SPACE_LOCATION};
-                CHECK_XRCMD(xrLocateSpace(m_statusDisplaySpace.Get(), m_appSpace.Get(), predictedDisplayTime, &viewSpaceInAppSpace));
-
-                if (xr::math::Pose::IsPoseValid(viewSpaceInAppSpace)) {
-                    m_statusDisplay->PositionDisplay(viewSpaceInAppSpace.pose);
+#if XR_MSFT_spatial_anchor_persistence_preview
+            for (auto& anchor : m_anchorStore.GetAnchors()) {
+                if (UpdateVisibleCube(anchor.Cube)) {
+                    anchor.LastPoseInAppSpace = anchor.Cube.PoseInAppSpace;
                 }
-                m_statusDisplay->Update();
             }
 #endif
 
-            m_renderResources->ProjectionLayerViews.resize(viewCount);
-            if (m_optionalExtensions.DepthExtensionSupported) {
-                m_renderResources->DepthInfoViews.resize(viewCount);
+#ifdef USE_REMOTE_RENDERING
+            {
+                // The ARR calls allocate inside of the runtime, which is outside of this sample's control.
+                const sample::debug::ScopedUncountedHeapAllocations remoteAllocations;
+                UpdateRemoteHover(handTracked);
+
+                if (m_statusDisplay != nullptr) {
+                    const XrSpaceLocation* viewSpaceInAppSpace = spaceLocator.TryGetLocation(m_renderResources->StatusDisplayLocationIndex);
+                    if (viewSpaceInAppSpace != nullptr && xr::math::Pose::IsPoseValid(*viewSpaceInAppSpace)) {
+                        m_statusDisplay->PositionDisplay(viewSpaceInAppSpace->pose);
+                    }
+                    m_statusDisplay->Update();
+                }
             }
+#endif
 
-            // Swapchain is acquired, rendered to, and released together for all views as texture array
-            const SwapchainD3D11& colorSwapchain = m_renderResources->ColorSwapchain;
-            const SwapchainD3D11& depthSwapchain = m_renderResources->DepthSwapchain;
-
-            // Use the full size of the allocated swapchain image (could render smaller some frames to hit framerate)
-            const XrRect2Di imageRect = {{0, 0}, {(int32_t)colorSwapchain.Width, (int32_t)colorSwapchain.Height}};
+            // Render to the part of the allocated swapchain image chosen by the render scale controller, which is smaller than the
+            // full image on frames where the GPU would otherwise miss the display period. The color and depth layer views, the
+            // viewport of the local content and the remote frame blit all use the same rect.
+            const XrRect2Di imageRect = m_renderScaleController.GetImageRect(colorSwapchain.Width, colorSwapchain.Height);
             CHECK(colorSwapchain.Width == depthSwapchain.Width);
             CHECK(colorSwapchain.Height == depthSwapchain.Height);
 
-            const uint32_t colorSwapchainImageIndex = AcquireAndWaitForSwapchainImage(colorSwapchain.Handle.Get());
-            const uint32_t depthSwapchainImageIndex = AcquireAndWaitForSwapchainImage(depthSwapchain.Handle.Get());
-
             // Prepare rendering parameters of each view for swapchain texture arrays
-            std::vector<xr::math::ViewProjection> viewProjections(viewCount);
+            std::vector<xr::math::ViewProjection>& viewProjections = m_renderResources->ViewProjections;
             for (uint32_t i = 0; i < viewCount; i++) {
                 viewProjections[i] = {m_renderResources->Views[i].pose, m_renderResources->Views[i].fov, m_nearFar};
 
@@ -861,6 +1326,16 @@ namespace {
             const DirectX::XMVECTORF32 renderTargetClearColor =
                 (m_environmentBlendMode == XR_ENVIRONMENT_BLEND_MODE_OPAQUE) ? opaqueColor : transparent;
 
+            m_graphicsPlugin->PrepareView(viewProjections);
+
+            {
+                // The time spent here is the GPU back-pressure of this frame.
+                const sample::debug::FrameProfiler::ScopedStage waitStage(*m_frameProfiler, FrameStage::WaitSwapchain);
+                WaitForSwapchainImage(colorSwapchain.Handle.Get());
+                WaitForSwapchainImage(depthSwapchain.Handle.Get());
+            }
+
+            m_frameProfiler->BeginStage(FrameStage::RenderView);
             m_graphicsPlugin->RenderView(
 #ifdef USE_REMOTE_RENDERING
                 this,
@@ -868,11 +1343,10 @@ namespace {
                 imageRect,
                 renderTargetClearColor,
                 viewProjections,
-                colorSwapchain.Format,
-                colorSwapchain.Images[colorSwapchainImageIndex].texture,
-                depthSwapchain.Format,
-                depthSwapchain.Images[depthSwapchainImageIndex].texture,
+                colorSwapchain.RenderTargetViews[colorSwapchainImageIndex].get(),
+                depthSwapchain.DepthStencilViews[depthSwapchainImageIndex].get(),
                 visibleCubes);
+            m_frameProfiler->EndStage(FrameStage::RenderView);
 
             XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
             CHECK_XRCMD(xrReleaseSwapchainImage(colorSwapchain.Handle.Get(), &releaseInfo));
@@ -881,13 +1355,305 @@ namespace {
             layer.space = m_appSpace.Get();
             layer.viewCount = (uint32_t)m_renderResources->ProjectionLayerViews.size();
             layer.views = m_renderResources->ProjectionLayerViews.data();
+
+            // The submitted depth holds the remote depth written by BlitRemoteFrame merged with the local content, so per-pixel
+            // reprojection stabilizes the remote frame over its full depth range instead of a single plane.
+            sample::ReprojectionPolicy::FrameInput reprojectionInput;
+            reprojectionInput.DepthSubmitted = m_optionalExtensions.DepthExtensionSupported && m_useDepthReprojection;
+            reprojectionInput.FocusPositionInAppSpace = GetReprojectionFocus();
+            reprojectionInput.ViewerPositionInAppSpace = m_renderResources->Views[0].pose.position;
+            const std::optional<XrReprojectionModeMSFT> reprojectionMode = m_reprojectionPolicy.Apply(reprojectionInput, layer);
+            m_frameProfiler->SetReprojectionMode(sample::ReprojectionPolicy::ToString(reprojectionMode));
             return true;
         }
 
+        // The content the user most likely looks at, which planar reprojection keeps stable: the remote models once any of them
+        // is shown, otherwise the main cube.
+        std::optional<XrVector3f> GetReprojectionFocus() const {
+#ifdef USE_REMOTE_RENDERING
+            if (m_isConnected && m_modelLoadQueue.GetVisibleCount() > 0) {
+                return ModelPositionInAppSpace;
+            }
+#endif
+            if (m_mainCubeIndex.has_value()) {
+                return m_holograms[m_mainCubeIndex.value()].Cube.PoseInAppSpace.position;
+            }
+            return std::nullopt;
+        }
+
+#if XR_MSFT_scene_understanding_preview3
+        // Computes coarse visual meshes of the environment on a worker thread, and hands the meshes of every new scene to the
+        // graphics plugin for its depth pre-pass. The scene is computed around the app space origin, where the user started.
+        // Scene meshes are world-locked, so they are only located again when a new scene arrives.
+        void UpdateOcclusionMeshes(XrTime predictedDisplayTime) {
+            if (!m_useSceneOcclusion || !m_optionalExtensions.SceneUnderstandingSupported) {
+                return;
+            }
+
+            // The meshes were released by ApplyGpuMemoryLevel, the service starts again when the level goes back up.
+            if (m_gpuMemoryGovernor->GetLevel() == sample::GpuMemoryGovernor::Level::Minimal) {
+                return;
+            }
+
+            // Less of the environment is computed and kept when the video memory is short.
+            const float sceneRadius = m_gpuMemoryGovernor->GetLevel() == sample::GpuMemoryGovernor::Level::Normal
+                                          ? OcclusionSceneRadius
+                                          : OcclusionSceneRadius / 2;
+
+            if (m_sceneService == nullptr) {
+                // The scene bounds need a valid time, so the service is started with the first rendered frame.
+                const sample::debug::ScopedUncountedHeapAllocations serviceAllocations;
+                const std::vector<XrSceneComputeFeatureMSFT>& features = m_systemCapabilities.Current().SceneComputeFeatures;
+                if (std::find(features.begin(), features.end(), XR_SCENE_COMPUTE_FEATURE_VISUAL_MESH_MSFT) == features.end()) {
+                    DEBUG_PRINT("The system doesn't compute visual meshes, local content isn't occluded by the environment.");
+                    m_useSceneOcclusion = false;
+                    return;
+                }
+
+                xr::su::SceneUnderstandingService::Options options;
+                options.features = {XR_SCENE_COMPUTE_FEATURE_VISUAL_MESH_MSFT};
+                // The same scenes provide the surfaces that placed cubes snap to.
+                constexpr XrSceneComputeFeatureMSFT placementFeatures[] = {XR_SCENE_COMPUTE_FEATURE_PLANE_MSFT,
+                                                                           XR_SCENE_COMPUTE_FEATURE_COLLIDER_MESH_MSFT};
+                for (XrSceneComputeFeatureMSFT feature : placementFeatures) {
+                    if (std::find(features.begin(), features.end(), feature) != features.end()) {
+                        options.features.push_back(feature);
+                    }
+                }
+                options.visualMeshLevelOfDetail = XR_MESH_COMPUTE_LOD_COARSE_MSFT; // Depth-only, so detail isn't visible.
+#if SCENE_CACHE_SUPPORTED
+                const bool canSerialize =
+                    std::find(features.begin(), features.end(), XR_SCENE_COMPUTE_FEATURE_SERIALIZE_SCENE_MSFT) != features.end();
+                if (m_optionalExtensions.SceneSerializationSupported && canSerialize && m_anchorStore.IsConnected()) {
+                    options.serializeEveryNthScene = SceneCacheInterval;
+                    options.onSceneSerialized = [this](std::vector<std::vector<uint8_t>> fragments) {
+                        std::lock_guard lock(m_serializedSceneMutex);
+                        m_serializedScene = std::move(fragments); // Replaces an older scene that wasn't written yet.
+                    };
+                }
+#endif
+
+                xr::SceneBounds bounds{m_appSpace.Get(), predictedDisplayTime};
+                bounds.sphereBounds.push_back({xr::math::Pose::Identity().position, sceneRadius});
+                m_sceneService = std::make_unique<xr::su::SceneUnderstandingService>(
+                    m_extensions, m_session.Get(), std::move(options), std::move(bounds));
+                m_occlusionSceneRadius = sceneRadius;
+            } else if (sceneRadius != m_occlusionSceneRadius) {
+                const sample::debug::ScopedUncountedHeapAllocations boundsAllocations;
+                xr::SceneBounds bounds{m_appSpace.Get(), predictedDisplayTime};
+                bounds.sphereBounds.push_back({xr::math::Pose::Identity().position, sceneRadius});
+                m_sceneService->SetBounds(std::move(bounds));
+                m_occlusionSceneRadius = sceneRadius;
+            }
+
+            // Snapshots are immutable, so an unchanged version means that the meshes are already up to date.
+            const std::shared_ptr<const xr::su::SceneSnapshot> snapshot = m_sceneService->GetLatestSnapshot();
+#if SCENE_CACHE_SUPPORTED
+            UpdateSceneCache(snapshot != nullptr);
+#endif
+            if (snapshot == nullptr || snapshot->version == m_occlusionSceneVersion) {
+                return;
+            }
+            m_occlusionSceneVersion = snapshot->version;
+
+            // A new scene arrives every few seconds, and its meshes are uploaded and indexed, which isn't steady-state work.
+            const sample::debug::ScopedUncountedHeapAllocations sceneAllocations;
+
+            m_occlusionMeshIds.clear();
+            for (const auto& [id, mesh] : snapshot->visualMeshes) {
+                m_occlusionMeshIds.push_back(id);
+            }
+            xr::su::LocateObjects(snapshot->scene->Handle(),
+                                  m_extensions,
+                                  m_appSpace.Get(),
+                                  predictedDisplayTime,
+                                  m_occlusionMeshIds,
+                                  m_occlusionMeshLocations);
+
+            m_occlusionMeshes.clear();
+            uint64_t meshBytes = 0;
+            for (size_t k = 0; k < m_occlusionMeshIds.size(); k++) {
+                const XrSceneComponentLocationMSFT& location = m_occlusionMeshLocations[k];
+                if (!xr::math::Pose::IsPoseValid(location.flags)) {
+                    continue;
+                }
+
+                const std::shared_ptr<const xr::su::SceneMeshData>& data = snapshot->visualMeshes.at(m_occlusionMeshIds[k]);
+                m_occlusionMeshes.push_back({data,
+                                             data->vertices.data(),
+                                             (uint32_t)data->vertices.size(),
+                                             data->indices.data(),
+                                             (uint32_t)data->indices.size(),
+                                             location.pose});
+                meshBytes += data->vertices.size() * sizeof(XrVector3f) + data->indices.size() * sizeof(uint32_t);
+            }
+            m_graphicsPlugin->SetOcclusionMeshes(m_occlusionMeshes);
+            m_gpuMemoryGovernor->SetUsage(sample::GpuMemoryGovernor::Subsystem::SceneMeshes, meshBytes);
+
+            UpdatePlacementIndex(*snapshot, predictedDisplayTime);
+        }
+
+        // Refits the placement index to the planes and collider meshes of a new scene. Only the triangle hierarchies of surfaces
+        // whose updateTime changed are rebuilt; the collider mesh buffers were already read by the scene service.
+        void UpdatePlacementIndex(const xr::su::SceneSnapshot& snapshot, XrTime predictedDisplayTime) {
+            m_placementPlaneIds.clear();
+            for (const xr::su::ScenePlane& plane : snapshot.planes) {
+                m_placementPlaneIds.push_back(plane.id);
+            }
+            xr::su::LocateObjects(snapshot.scene->Handle(),
+                                  m_extensions,
+                                  m_appSpace.Get(),
+                                  predictedDisplayTime,
+                                  m_placementPlaneIds,
+                                  m_placementLocations);
+            m_placementIndex.UpdatePlanes(snapshot.planes, m_placementLocations);
+
+            m_placementColliderMeshIds.clear();
+            m_placementColliderMeshes.clear();
+            for (const auto& [id, mesh] : snapshot.colliderMeshes) {
+                m_placementColliderMeshIds.push_back(id);
+                m_placementColliderMeshes.push_back(mesh.get());
+            }
+            xr::su::LocateObjects(snapshot.scene->Handle(),
+                                  m_extensions,
+                                  m_appSpace.Get(),
+                                  predictedDisplayTime,
+                                  m_placementColliderMeshIds,
+                                  m_placementLocations);
+            m_placementIndex.UpdateColliderMeshes(m_placementColliderMeshIds, m_placementColliderMeshes, m_placementLocations);
+        }
+
+        // Moves a cube placed within PlacementSnapDistance of a real surface onto the surface, so that it rests on a table or
+        // sticks to a wall instead of floating next to it.
+        XrPosef SnapToSurface(const XrPosef& poseInAppSpace) const {
+            const std::optional<xr::su::SceneSurfaceHit> hit =
+                m_placementIndex.FindNearestSurface(poseInAppSpace.position, PlacementSnapDistance);
+            if (!hit.has_value()) {
+                return poseInAppSpace;
+            }
+
+            // The normal faces the hand, so the cube ends up on the side of the surface it was placed from.
+            using namespace xr::math;
+            const float halfSize = sample::Cube{}.Scale.y / 2;
+            return {poseInAppSpace.orientation, hit->position + hit->normal * halfSize};
+        }
+#endif
+
+        // Steps the optional consumers of video memory to the level of the governor. The swapchains are kept as they are, since
+        // the render scale controller already renders into a part of them when the GPU is busy.
+        void ApplyGpuMemoryLevel() {
+            const sample::GpuMemoryGovernor::Level level = m_gpuMemoryGovernor->GetLevel();
+#ifdef USE_REMOTE_RENDERING
+            if (m_statusDisplay != nullptr) {
+                m_statusDisplay->SetTextTextureScale(level == sample::GpuMemoryGovernor::Level::Normal ? 1.0f : 0.5f);
+                m_gpuMemoryGovernor->SetUsage(sample::GpuMemoryGovernor::Subsystem::StatusDisplay,
+                                              m_statusDisplay->GetTextTextureBytes());
+            }
+#endif
+#if XR_MSFT_scene_understanding_preview3
+            // The scene radius follows the level in UpdateOcclusionMeshes. At the lowest level the meshes are dropped entirely.
+            if (level == sample::GpuMemoryGovernor::Level::Minimal && m_sceneService != nullptr) {
+                m_sceneService.reset();
+                m_occlusionSceneVersion = 0;
+                m_placementIndex.Clear();
+                m_occlusionMeshes.clear();
+                m_graphicsPlugin->SetOcclusionMeshes(m_occlusionMeshes);
+                m_gpuMemoryGovernor->SetUsage(sample::GpuMemoryGovernor::Subsystem::SceneMeshes, 0);
+            }
+#endif
+        }
+
+#if SCENE_CACHE_SUPPORTED
+        // Until the first scene is available, loads the cached scene of the persisted anchor nearest to the scene center as soon
+        // as such an anchor is located; the fresh scene compute replaces it when it completes. Serialized scenes are written on a
+        // background thread under the same anchor, one at a time; a scene serialized meanwhile waits for the next frame.
+        void UpdateSceneCache(bool hasScene) {
+            const std::string* key = FindSceneCacheKey();
+            if (key == nullptr) {
+                return;
+            }
+
+            if (!hasScene && *key != m_sceneCacheTriedKey) {
+                m_sceneCacheTriedKey = *key;
+                if (auto fragments = m_sceneCache.Open(*key)) {
+                    DEBUG_PRINT("Loading the cached scene of anchor %s.", key->c_str());
+                    m_sceneService->LoadSerializedScene(std::move(fragments));
+                }
+            }
+
+            using namespace std::chrono_literals;
+            if (m_sceneCacheWrite.valid() && m_sceneCacheWrite.wait_for(0s) != std::future_status::ready) {
+                return;
+            }
+
+            std::vector<std::vector<uint8_t>> fragments;
+            {
+                std::lock_guard lock(m_serializedSceneMutex);
+                fragments = std::move(m_serializedScene);
+                m_serializedScene.clear();
+            }
+            if (!fragments.empty()) {
+                m_sceneCacheWrite = std::async(std::launch::async, [this, key = *key, fragments = std::move(fragments)] {
+                    m_sceneCache.Write(key, fragments);
+                });
+            }
+        }
+
+        // Returns the name of the located persisted anchor nearest to the app space origin, which is the center of the scene.
+        const std::string* FindSceneCacheKey() {
+            const std::string* key = nullptr;
+            float nearestDistance = OcclusionSceneRadius;
+            for (const auto& anchor : m_anchorStore.GetAnchors()) {
+                if (!anchor.Persisted || !anchor.LastPoseInAppSpace.has_value()) {
+                    continue;
+                }
+
+                const float distance = xr::math::Length(anchor.LastPoseInAppSpace->position);
+                if (distance < nearestDistance) {
+                    nearestDistance = distance;
+                    key = &anchor.Name;
+                }
+            }
+            return key;
+        }
+#endif
+
         void PrepareSessionRestart() {
+#if XR_MSFT_scene_understanding_preview3
+            // The service computes scenes with the session, and the meshes belong to the device being replaced.
+            m_sceneService.reset();
+            m_occlusionSceneVersion = 0;
+            m_placementIndex.Clear();
+#endif
+#if SCENE_CACHE_SUPPORTED
+            // A scene of the previous device isn't written under an anchor located by the next one.
+            m_serializedScene.clear();
+            m_sceneCacheTriedKey.clear();
+#endif
+#if XR_MSFT_spatial_anchor_persistence_preview
+            // Persists the new anchors in one batch. The anchors are restored from the store by the next session.
+            m_anchorStore.Disconnect();
+#endif
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+            m_handMeshTracker.Reset();
+#endif
+#ifdef USE_REMOTE_RENDERING
+            // The graphics binding was set up for the lost session and device, and ARR has no call that moves it to new ones. So the
+            // connection is re-established as soon as the new session runs and UpdateARR ticks the client again. The rendering
+            // session keeps running, so this takes seconds instead of the minutes a new session would take, but the models are
+            // loaded again.
+            if (m_isConnected || m_currentStatus == AppConnectionStatus::Connecting) {
+                ReconnectToSession();
+            }
+            m_graphicsBinding = nullptr;
+            m_connectionProfileSelector.Reset(nullptr);
+            m_frameStatisticsMonitor.Reset(nullptr, nullptr);
+            m_needsCoordinateSystemUpdate = true;
+#endif
             m_mainCubeIndex = m_spinningCubeIndex = {};
             m_holograms.clear();
-            m_renderResources.reset();
+            m_renderResources.reset(); // Also releases the cached swapchain image views.
+            m_renderScaleController.Reset();
             m_session.Reset();
             m_systemId = XR_NULL_SYSTEM_ID;
         }
@@ -900,40 +1666,66 @@ namespace {
             return xr::StringToPath(m_instance.Get(), string);
         }
 
+        void OpenPoseTrace() {
+            if (m_poseTraceMode == PoseTraceMode::Record) {
+                m_poseTraceRecorder = std::make_unique<sample::debug::PoseTraceRecorder>(m_poseTracePath);
+            } else if (m_poseTraceMode == PoseTraceMode::Replay) {
+                m_poseTracePlayer = std::make_unique<sample::debug::PoseTracePlayer>(m_poseTracePath);
+            }
+        }
+
 #ifdef USE_REMOTE_RENDERING
-        void InitARR() {
-            // 1. One time initialization
-            {
-                RR::RemoteRenderingInitialization clientInit;
-                clientInit.ConnectionType = RR::ConnectionType::General;
-                clientInit.GraphicsApi = RR::GraphicsApiType::OpenXrD3D11;
-                clientInit.ToolId = "<sample name goes here>"; // <put your sample name here>
-                clientInit.UnitsPerMeter = 1.0f;
-                clientInit.Forward = RR::Axis::NegativeZ;
-                clientInit.Right = RR::Axis::X;
-                clientInit.Up = RR::Axis::Y;
-                if (RR::StartupRemoteRendering(clientInit) != RR::Result::Success) {
-                    // something fundamental went wrong with the initialization
-                    throw std::exception("Failed to start remote rendering. Invalid client init data.");
-                }
+        // 1. One time initialization
+        void StartupARR() {
+            RR::RemoteRenderingInitialization clientInit;
+            clientInit.ConnectionType = RR::ConnectionType::General;
+            clientInit.GraphicsApi = RR::GraphicsApiType::OpenXrD3D11;
+            clientInit.ToolId = "<sample name goes here>"; // <put your sample name here>
+            clientInit.UnitsPerMeter = 1.0f;
+            clientInit.Forward = RR::Axis::NegativeZ;
+            clientInit.Right = RR::Axis::X;
+            clientInit.Up = RR::Axis::Y;
+            if (RR::StartupRemoteRendering(clientInit) != RR::Result::Success) {
+                // something fundamental went wrong with the initialization
+                throw std::exception("Failed to start remote rendering. Invalid client init data.");
             }
+        }
 
-            // 2. Create Client
-            {
-                // Users need to fill out the following with their account data and model
-                RR::SessionConfiguration init;
-                init.AccountId = "00000000-0000-0000-0000-000000000000";
-                init.AccountKey = "<account key>";
-                init.RemoteRenderingDomain = "westus2.mixedreality.azure.com"; // <change to the region that the rendering session should be created in>
-                init.AccountDomain = "westus2.mixedreality.azure.com"; // <change to the region the account was created in>
-                m_modelURI = "builtin://Engine";
-                m_sessionOverride = ""; // If there is a valid session ID to re-use, put it here. Otherwise a new one is created
-                m_client = RR::ApiHandle(RR::RemoteRenderingClient(init));
-            }
-
-            // 3. Open/create rendering session
-            {
-                auto SessionHandler = [&](RR::Status status, RR::ApiHandle<RR::CreateRenderingSessionResult> result) {
+        // 2. Create Client
+        void CreateARRClient() {
+            // Users need to fill out the following with their account data and model
+            RR::SessionConfiguration init;
+            init.AccountId = "00000000-0000-0000-0000-000000000000";
+            init.AccountKey = "<account key>";
+            // The session is created in the region with the lowest round trip from this network, see RegionProbe.
+            init.RemoteRenderingDomain = sample::RegionProbe::GetDomain(m_renderingRegion);
+            init.AccountDomain = "westus2.mixedreality.azure.com"; // <change to the region the account was created in>
+            m_modelURIs = {"builtin://Engine"}; // <add all parts of the scene here, they are loaded in parallel>
+            m_coarseModelURIs = {};             // <optionally add decimated conversions of the parts, they are shown first>
+            m_sessionOverride = ""; // If there is a valid session ID to re-use, put it here. Otherwise a new one is created
+            m_client = RR::ApiHandle(RR::RemoteRenderingClient(init));
+
+            // The VM size is chosen from the expected polygon count of the scene, the render mode is stepped down on
+            // reconnects when the link can't keep up.
+            sample::ConnectionProfileSelector::Options profileOptions;
+            profileOptions.ExpectedPolygonCount = 0; // <set to the polygon count of the scene, so that large models get a Premium VM>
+            m_connectionProfileSelector = sample::ConnectionProfileSelector(std::move(profileOptions));
+
+            // The performance HUD shows the remote frame statistics once the model is loaded. The CSV log in the app's local
+            // folder is labeled with the region, so runs against different regions can be compared.
+            sample::FrameStatisticsMonitor::Options statisticsOptions;
+            statisticsOptions.ShowHud = true;
+            statisticsOptions.LogToCsv = true;
+            statisticsOptions.Label = init.RemoteRenderingDomain;
+            m_frameStatisticsMonitor.SetOptions(std::move(statisticsOptions));
+        }
+
+        // 3. Open/create rendering session
+        // Runs on a startup worker, and the ARR callbacks may arrive on other threads as well, so the status and the session are
+        // handed to the main thread, which owns them.
+        void AcquireARRSession() {
+            auto SessionHandler = [this](RR::Status status, RR::ApiHandle<RR::CreateRenderingSessionResult> result) {
+                PostToMainThread([this, status, result] {
                     if (status == RR::Status::OK) {
                         auto ctx = result->GetContext();
                         if (ctx.Result == RR::Result::Success) {
@@ -944,78 +1736,86 @@ namespace {
                     } else {
                         SetNewState(AppConnectionStatus::ConnectionFailed, "failed");
                     }
-                };
+                });
+            };
 
-                // If we had an old (valid) session that we can recycle, we call async function m_client->OpenRenderingSessionAsync
-                if (!m_sessionOverride.empty()) {
-                    m_client->OpenRenderingSessionAsync(m_sessionOverride, SessionHandler);
-                    SetNewState(AppConnectionStatus::CreatingSession, nullptr);
-                } else {
-                    // create a new session
-                    RR::RenderingSessionCreationOptions init;
-                    init.MaxLeaseInMinutes = 10; // session is leased for 10 minutes
-                    init.Size = RR::RenderingSessionVmSize::Standard;
-                    m_client->CreateNewRenderingSessionAsync(init, SessionHandler);
-                    SetNewState(AppConnectionStatus::CreatingSession, nullptr);
-                }
+            PostToMainThread([this] { SetNewState(AppConnectionStatus::CreatingSession, nullptr); });
+
+            // If we had an old (valid) session that we can recycle, we call async function m_client->OpenRenderingSessionAsync
+            if (!m_sessionOverride.empty()) {
+                m_client->OpenRenderingSessionAsync(m_sessionOverride, SessionHandler);
+            } else {
+                // reuse a running session this app created if possible, otherwise create a new one
+                sample::SessionPool::Options poolOptions;
+                poolOptions.LeaseInMinutes = 10; // session is leased for 10 minutes
+                poolOptions.Size = m_connectionProfileSelector.GetVmSize();
+                poolOptions.KeepWarmStandby = false; // set to true to keep a second (billed) session ready for reconnects
+                poolOptions.OwnedSessionIds = sample::SessionPool::LoadOwnedSessionIds(); // sessions created by earlier launches
+                poolOptions.OwnedSessionIdsChanged = &sample::SessionPool::StoreOwnedSessionIds;
+                m_sessionPool = std::make_unique<sample::SessionPool>(m_client, poolOptions);
+                m_sessionPool->AcquireSessionAsync([this](RR::ApiHandle<RR::RenderingSession> session, const char* errorMessage) {
+                    PostToMainThread([this, session, errorMessage = std::string(errorMessage ? errorMessage : "")] {
+                        if (session != nullptr) {
+                            SetNewSession(session);
+                        } else {
+                            SetNewState(AppConnectionStatus::ConnectionFailed, errorMessage.c_str());
+                        }
+                    });
+                });
+            }
+        }
+
+        // Queues work for the next UpdateARR on the main thread. Can be called from any thread.
+        void PostToMainThread(std::function<void()> work) {
+            std::lock_guard lock(m_mainThreadWorkMutex);
+            m_mainThreadWork.push_back(std::move(work));
+        }
+
+        void RunMainThreadWork() {
+            std::vector<std::function<void()>> work;
+            {
+                std::lock_guard lock(m_mainThreadWorkMutex);
+                work.swap(m_mainThreadWork);
+            }
+            for (const std::function<void()>& item : work) {
+                item();
             }
         }
 
         void UpdateARR() {
+            RunMainThreadWork();
+
+            if (m_sessionPool) {
+                // Keep the leases of the pooled sessions alive
+                m_sessionPool->Update(m_timer.GetTotalSeconds());
+            }
+
             if (m_renderingSession != nullptr) {
-                // Tick the client to receive messages
+                if (m_graphicsBinding == nullptr) {
+                    // The session was kept across a session restart, and is reconnected to the new session and device.
+                    m_graphicsBinding = m_renderingSession->GetGraphicsBinding().as<RR::GraphicsBindingOpenXrD3d11>();
+                }
+
+                // Send the raycasts and material changes of this frame, then tick the client to receive messages
+                m_spatialQueries.Flush();
+                m_materialOverrides.Update();
                 m_api->Update();
 
-                if (!m_sessionStarted) {
-                    // Important: To avoid server-side throttling of the requests, we should call GetPropertiesAsync very infrequently:
-                    const double delayBetweenRESTCalls = 10.0;
-
-                    // query session status periodically until we reach 'session started'
-                    if (!m_sessionPropertiesQueryInProgress && m_timer.GetTotalSeconds() - m_timeAtLastRESTCall > delayBetweenRESTCalls) {
-                        m_timeAtLastRESTCall = m_timer.GetTotalSeconds();
-                        m_sessionPropertiesQueryInProgress = true;
-                        m_renderingSession->GetPropertiesAsync(
-                            [this](RR::Status status, RR::ApiHandle<RR::RenderingSessionPropertiesResult> propertiesResult) {
-                                if (status == RR::Status::OK) {
-                                    auto ctx = propertiesResult->GetContext();
-                                    if (ctx.Result == RR::Result::Success) {
-                                        auto res = propertiesResult->GetSessionProperties();
-                                        switch (res.Status) {
-                                        case RR::RenderingSessionStatus::Ready: {
-                                            // The following ConnectAsync is async, but we'll get notifications via
-                                            // OnConnectionStatusChanged
-                                            m_sessionStarted = true;
-                                            SetNewState(AppConnectionStatus::Connecting, nullptr);
-                                            RR::RendererInitOptions init;
-                                            init.IgnoreCertificateValidation = false;
-                                            init.RenderMode = RR::ServiceRenderMode::Default;
-                                            m_renderingSession->ConnectAsync(init, [](RR::Status, RR::ConnectionStatus) {});
-                                        } break;
-                                        case RR::RenderingSessionStatus::Error:
-                                            SetNewState(AppConnectionStatus::ConnectionFailed, "Session error");
-                                            break;
-                                        case RR::RenderingSessionStatus::Stopped:
-                                            SetNewState(AppConnectionStatus::ConnectionFailed, "Session stopped");
-                                            break;
-                                        case RR::RenderingSessionStatus::Expired:
-                                            SetNewState(AppConnectionStatus::ConnectionFailed, "Session expired");
-                                            break;
-                                        }
-                                    } else {
-                                        SetNewState(AppConnectionStatus::ConnectionFailed, ctx.ErrorMessage.c_str());
-                                    }
-                                } else {
-                                    SetNewState(AppConnectionStatus::ConnectionFailed, "Failed to retrieve session status");
-                                }
-                                m_sessionPropertiesQueryInProgress = false; // next try
-                            });
-                    }
-                }
+                // Query the session status until it is ready, then connect right away.
+                m_sessionReadinessWatcher.Update(m_timer.GetTotalSeconds());
 
                 if (m_isConnected && !m_modelLoadTriggered) {
                     m_modelLoadTriggered = true;
                     StartModelLoading();
                 }
+
+                if (m_connectionProfileSelector.Update(m_timer.GetTotalSeconds())) {
+                    // The session stays, only the connection is re-established with the cheaper profile.
+                    ReconnectToSession();
+                }
+
+                // The HUD text is rebuilt by UpdateStatusText when the new summary differs from the shown one.
+                m_frameStatisticsMonitor.Update(m_timer.GetTotalSeconds());
             }
 
             UpdateStatusText();
@@ -1035,23 +1835,36 @@ namespace {
                 // set on the HolographicCamera.
                 auto settings = m_api->GetCameraSettings();
                 float localNear = std::min(m_nearFar.Near, m_nearFar.Far);
-                float localFar = std::max(m_nearFar.Far, m_nearFar.Far);
+                float localFar = std::max(m_nearFar.Near, m_nearFar.Far);
                 settings->SetNearAndFarPlane(localNear, localFar);
                 settings->SetInverseDepth(m_nearFar.Near > m_nearFar.Far);
                 settings->SetEnableDepth(true);
+
+                RR::FrameStatistics statistics;
+                if (m_inputLatencyProbe && m_graphicsBinding->GetLastFrameStatistics(&statistics) == RR::Result::Success) {
+                    m_inputLatencyProbe->OnRemoteRoundTrip(statistics.LatencyPoseToReceive + statistics.LatencyReceiveToPresent);
+                }
             }
         }
 
-        void RenderARR(ID3D11DeviceContext* context) override {
+        void RenderARR(ID3D11DeviceContext1* context, sample::dx::ConstantBufferRing& constantBufferRing) override {
+            // The ARR calls allocate inside of the runtime, which is outside of this sample's control.
+            const sample::debug::ScopedUncountedHeapAllocations remoteAllocations;
+
             // Inject remote rendering: as soon as we are connected, start blitting the remote frame.
             // We do the blit after the Clear and viewport setup, and before our rendering.
             if (m_isConnected) {
+                const sample::debug::FrameProfiler::ScopedStage blitStage(*m_frameProfiler, FrameStage::BlitRemoteFrame);
                 m_graphicsBinding->BlitRemoteFrame();
+
+                // The blit wrote the remote depth over all pixels, including the ones the display never shows.
+                m_graphicsPlugin->RenderVisibilityMask(context, constantBufferRing);
             }
 
             if (m_statusDisplay) {
                 // Draw connection/progress/error status
-                m_statusDisplay->Render(context);
+                const sample::debug::FrameProfiler::ScopedStage statusStage(*m_frameProfiler, FrameStage::StatusDisplay);
+                m_statusDisplay->Render(context, constantBufferRing);
             }
         }
 
@@ -1069,17 +1882,36 @@ namespace {
                 } else {
                     SetNewState(AppConnectionStatus::ConnectionFailed, asString);
                 }
-                m_modelLoadTriggered = m_modelLoadFinished = false;
+                m_modelLoadTriggered = false;
+                m_modelLoadQueue.Reset(nullptr);
+                m_spatialQueries.Reset(nullptr);
+                m_hoveredEntities = {};
+                m_materialOverrides.Reset();
                 m_isConnected = error == RR::Result::Success;
+                m_connectionProfileSelector.Reset(m_isConnected ? m_graphicsBinding : nullptr);
+                m_frameStatisticsMonitor.Reset(m_isConnected ? m_api : nullptr, m_isConnected ? m_graphicsBinding : nullptr);
                 break;
             case RR::ConnectionStatus::Disconnected:
-                if (error == RR::Result::Success) {
+                m_modelLoadTriggered = false;
+                m_modelLoadQueue.Reset(nullptr);
+                m_spatialQueries.Reset(nullptr);
+                m_hoveredEntities = {};
+                m_materialOverrides.Reset();
+                m_isConnected = false;
+                m_connectionProfileSelector.Reset(nullptr);
+                m_frameStatisticsMonitor.Reset(nullptr, nullptr);
+                if (m_inputLatencyProbe) {
+                    m_inputLatencyProbe->Reset();
+                }
+                if (m_reconnectPending) {
+                    // The old connection is gone, so no later event of it can overwrite the state of the new one.
+                    m_reconnectPending = false;
+                    ConnectToSession();
+                } else if (error == RR::Result::Success) {
                     SetNewState(AppConnectionStatus::Disconnected, asString);
                 } else {
                     SetNewState(AppConnectionStatus::ConnectionFailed, asString);
                 }
-                m_modelLoadTriggered = m_modelLoadFinished = false;
-                m_isConnected = false;
                 break;
             default:
                 break;
@@ -1094,38 +1926,127 @@ namespace {
         void SetNewSession(RR::ApiHandle<RR::RenderingSession> newSession) {
             SetNewState(AppConnectionStatus::StartingSession, nullptr);
 
-            m_sessionStartingTime = m_timeAtLastRESTCall = m_timer.GetTotalSeconds();
+            m_sessionStartingTime = m_timer.GetTotalSeconds();
             m_renderingSession = newSession;
             m_api = m_renderingSession->Connection();
             m_graphicsBinding = m_renderingSession->GetGraphicsBinding().as<RR::GraphicsBindingOpenXrD3d11>();
             m_renderingSession->ConnectionStatusChanged([this](auto status, auto error) { OnConnectionStatusChanged(status, error); });
+
+            m_sessionReadinessWatcher.Start(
+                m_renderingSession,
+                m_sessionStartingTime,
+                [this]() { ConnectToSession(); },
+                [this](const char* reason) { SetNewState(AppConnectionStatus::ConnectionFailed, reason); });
+        }
+
+        void ConnectToSession() {
+            // The following ConnectAsync is async, but we'll get notifications via OnConnectionStatusChanged
+            SetNewState(AppConnectionStatus::Connecting, nullptr);
+            RR::RendererInitOptions init;
+            init.IgnoreCertificateValidation = false;
+            m_connectionProfileSelector.ApplyProfile(init);
+            m_renderingSession->ConnectAsync(init, [](RR::Status, RR::ConnectionStatus) {});
+        }
+
+        // Disconnects and connects again once the Disconnected event arrived, so that the events of the old connection
+        // can't be mistaken for the new one. The rendering session keeps running.
+        void ReconnectToSession() {
+            m_reconnectPending = true;
+            SetNewState(AppConnectionStatus::Connecting, nullptr);
+            m_renderingSession->Disconnect();
         }
 
         void StartModelLoading() {
-            m_modelLoadingProgress = 0.f;
-
-            RR::LoadModelFromSasOptions params;
-            params.ModelUri = m_modelURI.c_str();
-            params.Parent = nullptr;
-
-            // start the async model loading
-            m_api->LoadModelFromSasAsync(
-                params,
-                // completed callback
-                [this](RR::Status status, RR::ApiHandle<RR::LoadModelResult> result) {
-                    m_modelLoadResult = RR::StatusToResult(status);
-                    m_modelLoadFinished = true; // successful if m_modelLoadResult==RR::Result::Success
-
-                    if (m_modelLoadResult == RR::Result::Success) {
-                        RR::Double3 pos = {0.0, 0.0, -2.0};
-                        result->GetRoot()->SetPosition(pos);
+            m_spatialQueries.Reset(m_api);
+            m_materialOverrides.Reset();
+            m_modelLoadQueue.Reset(m_api, nullptr, [this](const sample::ModelLoadQueue::ModelLoad& load, bool coarse) {
+                // <parts can be placed or made interactive here, before the rest of the scene has loaded>
+                DEBUG_PRINT("Model %s is shown%s.", load.Request.ModelUri.c_str(), coarse ? " at coarse detail" : "");
+
+                // The full model replaces the bounds and the materials of its coarse version.
+                const RR::ApiHandle<RR::Entity>& root = coarse ? load.CoarseRoot : load.Root;
+                m_spatialQueries.SetEntity(load.Request.ModelUri, root);
+                m_materialOverrides.SetModel(load.Request.ModelUri, root);
+            });
+            for (size_t i = 0; i < m_modelURIs.size(); i++) {
+                sample::ModelLoadQueue::ModelRequest request;
+                request.ModelUri = m_modelURIs[i];
+                if (i < m_coarseModelURIs.size()) {
+                    request.CoarseModelUri = m_coarseModelURIs[i];
+                }
+                request.Position = {ModelPositionInAppSpace.x, ModelPositionInAppSpace.y, ModelPositionInAppSpace.z};
+                m_modelLoadQueue.Enqueue(std::move(request));
+            }
+        }
+
+        // A ray along the pointing direction of the hand. The ARR coordinate system is the app space.
+        static RR::RayCast MakeHandRay(const XrPosef& handPose) {
+            const XrVector3f end = xr::math::Pose::Multiply(xr::math::Pose::Translation({0, 0, -HandRayLength}), handPose).position;
+            RR::RayCast ray;
+            ray.StartPos = {handPose.position.x, handPose.position.y, handPose.position.z};
+            ray.EndPos = {end.x, end.y, end.z};
+            ray.MaxHits = 1;
+            ray.HitCollection = RR::HitCollectionPolicy::ClosestHit;
+            ray.CollisionMask = 0xFFFFFFFF;
+            return ray;
+        }
+
+        // Finds the remote model each tracked hand points at against the cached bounds, without a round trip.
+        void UpdateRemoteHover(const std::array<bool, 2>& handTracked) {
+            for (uint32_t side : {LeftSide, RightSide}) {
+                RR::ApiHandle<RR::Entity> hovered;
+                if (m_isConnected && handTracked[side]) {
+                    const RR::RayCast ray = MakeHandRay(m_cubesInHand[side].PoseInAppSpace);
+                    if (const auto hit = m_spatialQueries.HoverTest(ray.StartPos, ray.EndPos)) {
+                        hovered = hit->Entity;
                     }
-                },
-                // progress update callback
-                [this](float progress) {
-                    // progress callback
-                    m_modelLoadingProgress = progress;
-                });
+                }
+
+                if (hovered != m_hoveredEntities[side]) {
+                    // <hover feedback on the remote model goes here>
+                    m_hoveredEntities[side] = std::move(hovered);
+                }
+            }
+        }
+
+        // Asks the server for the precise hit, but only if the hand points at the bounds of a remote model.
+        void RayCastRemoteModels(uint32_t side, const XrPosef& handPose) {
+            if (!m_isConnected || m_hoveredEntities[side] == nullptr) {
+                return;
+            }
+
+            m_spatialQueries.RayCast(side, MakeHandRay(handPose), [](RR::Result result, const std::vector<RR::RayCastHit>& hits) {
+                if (result == RR::Result::Success && !hits.empty()) {
+                    // <the selected part of the remote model can be manipulated here>
+                    const RR::Double3& position = hits.front().HitPosition;
+                    DEBUG_PRINT("Selected a remote model at (%.2f, %.2f, %.2f).", position.X, position.Y, position.Z);
+                }
+            });
+        }
+
+        // Captures the current connection and loading state in the form shown by the status display.
+        AppStatus GetAppStatus() const {
+            AppStatus status;
+            status.ConnectionStatus = m_currentStatus;
+            status.ModelLoadTriggered = m_modelLoadTriggered;
+            status.ModelLoadFinished = m_modelLoadTriggered && m_modelLoadQueue.IsFinished();
+            if (m_currentStatus == AppConnectionStatus::ConnectionFailed) {
+                status.ErrorMessage = m_statusMsg;
+            }
+            if (m_currentStatus == AppConnectionStatus::StartingSession) {
+                status.SessionStartingSeconds = (int)(m_timer.GetTotalSeconds() - m_sessionStartingTime);
+            }
+            if (m_modelLoadTriggered) {
+                status.ModelLoadResult = status.ModelLoadFinished ? m_modelLoadQueue.GetResult() : RR::Result::Success;
+                status.ModelLoadPercentage = AppStatus::QuantizeModelLoadProgress(m_modelLoadQueue.GetProgress());
+                status.ModelCount = static_cast<int>(m_modelLoadQueue.GetModelLoads().size());
+                status.ModelsLoaded = static_cast<int>(m_modelLoadQueue.GetFinishedCount());
+                status.ModelsVisible = static_cast<int>(m_modelLoadQueue.GetVisibleCount());
+            }
+            if (m_isConnected && m_frameStatisticsMonitor.GetOptions().ShowHud) {
+                status.FrameStatistics = m_frameStatisticsMonitor.GetSummary();
+            }
+            return status;
         }
 
         void UpdateStatusText() {
@@ -1133,70 +2054,124 @@ namespace {
                 return;
             }
 
-            m_statusDisplay->ClearLines();
-            if (m_modelLoadFinished && m_modelLoadResult == RR::Result::Success) {
-                // nothing to show anymore
-                m_statusDisplay->SetTextEnabled(false);
+            // Only produce new text when something visible changed.
+            AppStatus status = GetAppStatus();
+            if (m_displayedStatus.has_value() && m_displayedStatus.value() == status) {
                 return;
             }
 
-            m_statusDisplay->SetTextEnabled(true);
+            wchar_t txtBuffer[1024];
+            std::array<StatusDisplay::Line, 7> lines;
+            size_t lineCount = 0;
+            auto AddLine = [&](std::wstring text, StatusDisplay::TextFormat format, StatusDisplay::TextColor color) {
+                lines[lineCount++] = StatusDisplay::Line{std::move(text), format, color, 1.2f};
+            };
 
-            char txtBuffer[1024];
-            std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t> toWChar;
+            // The performance HUD, shown below the status or on its own once the model is loaded.
+            auto AddFrameStatisticsLines = [&](const sample::FrameStatisticsSummary& statistics) {
+                swprintf_s(txtBuffer,
+                           L"Remote frames/s: %i received, %i reused, %i skipped, %i discarded",
+                           statistics.FramesReceived,
+                           statistics.FramesReused,
+                           statistics.FramesSkipped,
+                           statistics.FramesDiscarded);
+                AddLine(txtBuffer,
+                        StatusDisplay::Small,
+                        statistics.FramesReused > statistics.FramesReceived ? StatusDisplay::Yellow : StatusDisplay::White);
+
+                swprintf_s(txtBuffer,
+                           L"Latency: %i ms pose to receive, %i ms receive to present, %i ms jitter",
+                           statistics.LatencyPoseToReceive,
+                           statistics.LatencyReceiveToPresent,
+                           statistics.FrameJitter);
+                AddLine(txtBuffer, StatusDisplay::Small, StatusDisplay::White);
+
+                if (statistics.HasAssessment) {
+                    swprintf_s(txtBuffer,
+                               L"Server: %.1f ms CPU, %.1f ms GPU, network %i ms",
+                               statistics.ServerTimeCPU * sample::FrameStatisticsSummary::ServerFrameTimeStepInMilliseconds,
+                               statistics.ServerTimeGPU * sample::FrameStatisticsSummary::ServerFrameTimeStepInMilliseconds,
+                               statistics.NetworkLatency);
+                    const StatusDisplay::TextColor color = statistics.Rating == RR::PerformanceRating::Bad    ? StatusDisplay::Red
+                                                           : statistics.Rating == RR::PerformanceRating::Good ? StatusDisplay::Yellow
+                                                                                                              : StatusDisplay::Green;
+                    AddLine(txtBuffer, StatusDisplay::Small, color);
+                }
+            };
 
-            switch (m_currentStatus) {
+            if (status.ModelLoadFinished && status.ModelLoadResult == RR::Result::Success) {
+                if (!status.FrameStatistics.has_value()) {
+                    // nothing to show anymore
+                    m_statusDisplay->ClearLines();
+                    m_statusDisplay->SetTextEnabled(false);
+                    m_displayedStatus = std::move(status);
+                    return;
+                }
+
+                m_statusDisplay->SetTextEnabled(true);
+                AddFrameStatisticsLines(status.FrameStatistics.value());
+                m_statusDisplay->SetLines(winrt::array_view<StatusDisplay::Line>(lines.data(), lines.data() + lineCount));
+                m_displayedStatus = std::move(status);
+                return;
+            }
+
+            m_statusDisplay->SetTextEnabled(true);
+
+            switch (status.ConnectionStatus) {
             case AppConnectionStatus::CreatingSession:
-                sprintf_s(txtBuffer, "Creating session...");
-                m_statusDisplay->AddLine(
-                    StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::White, 1.2f});
+                AddLine(L"Creating session...", StatusDisplay::LargeBold, StatusDisplay::White);
                 break;
-            case AppConnectionStatus::StartingSession: {
-                sprintf_s(txtBuffer, "Starting session...");
-                m_statusDisplay->AddLine(
-                    StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::White, 1.2f});
-                int elapsedSecs = (int)(m_timer.GetTotalSeconds() - m_sessionStartingTime);
-                sprintf_s(txtBuffer, "...this may take a while. Elapsed time: %ds", elapsedSecs);
-                m_statusDisplay->AddLine(
-                    StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::Small, StatusDisplay::White, 1.2f});
+            case AppConnectionStatus::StartingSession:
+                AddLine(L"Starting session...", StatusDisplay::LargeBold, StatusDisplay::White);
+                swprintf_s(txtBuffer, L"...this may take a while. Elapsed time: %ds", status.SessionStartingSeconds);
+                AddLine(txtBuffer, StatusDisplay::Small, StatusDisplay::White);
                 break;
-            }
             case AppConnectionStatus::Connecting:
-                sprintf_s(txtBuffer, "Connecting...");
-                m_statusDisplay->AddLine(
-                    StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::White, 1.2f});
+                AddLine(L"Connecting...", StatusDisplay::LargeBold, StatusDisplay::White);
                 break;
             case AppConnectionStatus::Connected:
-                sprintf_s(txtBuffer, "Connected");
-                m_statusDisplay->AddLine(
-                    StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::Green, 1.2f});
+                AddLine(L"Connected", StatusDisplay::LargeBold, StatusDisplay::Green);
                 break;
-            case AppConnectionStatus::ConnectionFailed:
-                sprintf_s(txtBuffer, "Failed to connect");
-                m_statusDisplay->AddLine(
-                    StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::Red, 1.2f});
-                sprintf_s(txtBuffer, "Error: %s", m_statusMsg.c_str());
-                m_statusDisplay->AddLine(
-                    StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::Red, 1.2f});
+            case AppConnectionStatus::ConnectionFailed: {
+                std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t> toWChar;
+                AddLine(L"Failed to connect", StatusDisplay::LargeBold, StatusDisplay::Red);
+                AddLine(L"Error: " + toWChar.from_bytes(status.ErrorMessage), StatusDisplay::LargeBold, StatusDisplay::Red);
                 break;
+            }
             case AppConnectionStatus::Disconnected:
-                m_statusDisplay->AddLine(StatusDisplay::Line{L"Disconnected", StatusDisplay::LargeBold, StatusDisplay::Yellow, 1.2f});
+                AddLine(L"Disconnected", StatusDisplay::LargeBold, StatusDisplay::Yellow);
                 break;
             }
 
             // add additional lines for model loading progress
-            if (m_modelLoadTriggered) {
-                if (m_modelLoadFinished && m_modelLoadResult != RR::Result::Success) {
-                    sprintf_s(txtBuffer, "Failed to load model: %s", RR::ResultToString(m_modelLoadResult));
-                    m_statusDisplay->AddLine(
-                        StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::Red, 1.2f});
+            if (status.ModelLoadTriggered) {
+                if (status.ModelLoadFinished && status.ModelLoadResult != RR::Result::Success) {
+                    swprintf_s(txtBuffer, L"Failed to load model: %hs", RR::ResultToString(status.ModelLoadResult));
+                    AddLine(txtBuffer, StatusDisplay::LargeBold, StatusDisplay::Red);
+                } else if (status.ModelCount > 1) {
+                    swprintf_s(
+                        txtBuffer, L"Loading models %i/%i (%i%%)", status.ModelsLoaded, status.ModelCount, status.ModelLoadPercentage);
+                    AddLine(txtBuffer, StatusDisplay::LargeBold, StatusDisplay::White);
+                    if (status.ModelsVisible > status.ModelsLoaded) {
+                        swprintf_s(
+                            txtBuffer, L"%i/%i shown at coarse detail", status.ModelsVisible - status.ModelsLoaded, status.ModelCount);
+                        AddLine(txtBuffer, StatusDisplay::Small, StatusDisplay::White);
+                    }
                 } else {
-                    int percentage = (int)(m_modelLoadingProgress * 100.0f);
-                    sprintf_s(txtBuffer, "Loading model (%i%%)", percentage);
-                    m_statusDisplay->AddLine(
-                        StatusDisplay::Line{toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::White, 1.2f});
+                    swprintf_s(txtBuffer,
+                               status.ModelsVisible > status.ModelsLoaded ? L"Refining model (%i%%)" : L"Loading model (%i%%)",
+                               status.ModelLoadPercentage);
+                    AddLine(txtBuffer, StatusDisplay::LargeBold, StatusDisplay::White);
                 }
             }
+
+            if (status.FrameStatistics.has_value()) {
+                AddFrameStatisticsLines(status.FrameStatistics.value());
+            }
+
+            // SetLines keeps the text layouts of lines whose text didn't change.
+            m_statusDisplay->SetLines(winrt::array_view<StatusDisplay::Line>(lines.data(), lines.data() + lineCount));
+            m_displayedStatus = std::move(status);
         }
 #endif
 
@@ -1204,28 +2179,46 @@ namespace {
 #ifdef USE_REMOTE_RENDERING
         // Session related:
         std::string m_sessionOverride;
+        std::string m_renderingRegion;
         RR::ApiHandle<RR::RemoteRenderingClient> m_client;
         RR::ApiHandle<RR::RenderingSession> m_renderingSession;
         RR::ApiHandle<RR::RenderingConnection> m_api;
         RR::ApiHandle<RR::GraphicsBindingOpenXrD3d11> m_graphicsBinding;
+        sample::SessionReadinessWatcher m_sessionReadinessWatcher;
+        std::unique_ptr<sample::SessionPool> m_sessionPool;
 
         // Model loading:
-        std::string m_modelURI;
+        std::vector<std::string> m_modelURIs;
+        std::vector<std::string> m_coarseModelURIs; // Optional low detail versions of m_modelURIs, in the same order.
+        sample::ModelLoadQueue m_modelLoadQueue;
+
+        // Raycasts and hover tests of the hands against the loaded models:
+        sample::SpatialQueryBroker m_spatialQueries;
+        std::array<RR::ApiHandle<RR::Entity>, 2> m_hoveredEntities; // Per hand, according to the cached bounds.
+        constexpr static float HandRayLength = 10.0f; // In meters.
+
+        // Runtime material overrides in the shape of JsonSchemas/MaterialOverridesSchema.json, e.g. to highlight a group of
+        // parts. Set with m_materialOverrides.SetOverrides, applied to all loaded models at once.
+        sample::MaterialOverrideSet m_materialOverrides;
+
+        // Render mode and VM size, downgraded when the remote frames degrade:
+        sample::ConnectionProfileSelector m_connectionProfileSelector;
 
-        // Connection state machine:
+        // Performance HUD and CSV log of the remote frame statistics:
+        sample::FrameStatisticsMonitor m_frameStatisticsMonitor;
+
+        // Connection state machine, only used on the main thread:
         Timer m_timer;
         AppConnectionStatus m_currentStatus = AppConnectionStatus::Disconnected;
         std::string m_statusMsg;
         RR::Result m_connectionResult = RR::Result::Success;
-        RR::Result m_modelLoadResult = RR::Result::Success;
         bool m_isConnected = false;
-        bool m_sessionStarted = false;
+        bool m_reconnectPending = false; // Connect again as soon as the current connection reports Disconnected.
         bool m_modelLoadTriggered = false;
-        bool m_sessionPropertiesQueryInProgress = false;
-        float m_modelLoadingProgress = 0.f;
-        bool m_modelLoadFinished = false;
+        constexpr static XrVector3f ModelPositionInAppSpace{0.0f, 0.0f, -2.0f}; // Where the remote models are placed.
         bool m_needsCoordinateSystemUpdate = true;
-        double m_timeAtLastRESTCall = 0;
+        std::mutex m_mainThreadWorkMutex;
+        std::vector<std::function<void()>> m_mainThreadWork; // Posted by other threads, run by UpdateARR.
 
         // Status text:
         double m_lastTime = -1;
@@ -1233,6 +2226,7 @@ namespace {
 
         std::unique_ptr<StatusDisplay> m_statusDisplay;
         xr::SpaceHandle m_statusDisplaySpace;
+        std::optional<AppStatus> m_displayedStatus;
 #endif
 
         constexpr static XrFormFactor m_formFactor{XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY};
@@ -1242,6 +2236,31 @@ namespace {
         const std::string m_applicationName;
         const std::unique_ptr<sample::IGraphicsPluginD3D11> m_graphicsPlugin;
 
+        // Measures the CPU and GPU time of the frame stages. Recreated with the graphics device.
+        std::unique_ptr<sample::debug::FrameProfiler> m_frameProfiler;
+
+        // Trims the device and steps down optional features when the video memory usage approaches the budget.
+        std::unique_ptr<sample::GpuMemoryGovernor> m_gpuMemoryGovernor;
+
+        // Shrinks the rendered part of the swapchain images when the GPU time of the frames approaches the display period.
+        bool m_useDynamicRenderScale{true};
+
+        // Opt-in measurement of the latency from placing a cube until it is displayed, see InputLatencyProbe.
+        bool m_measureInputLatency{false};
+        std::unique_ptr<sample::debug::InputLatencyProbe> m_inputLatencyProbe;
+
+        // Opt-in recording of the head and hand poses and the input into a trace, or replaying a trace instead of the live
+        // tracking, so that builds can be benchmarked with the same motion, see PoseTrace. Replaying measures the input latency.
+        PoseTraceMode m_poseTraceMode{PoseTraceMode::Off};
+        std::filesystem::path m_poseTracePath = std::filesystem::temp_directory_path() / "BasicXrApp" / "PoseTrace.bin";
+        std::unique_ptr<sample::debug::PoseTraceRecorder> m_poseTraceRecorder;
+        std::unique_ptr<sample::debug::PoseTracePlayer> m_poseTracePlayer;
+
+        // Opt-in microbenchmarks of the XrUtility path conversions at startup, see XrUtilityBenchmarks.
+        bool m_runXrUtilityBenchmarks{false};
+        std::filesystem::path m_benchmarkResultsPath = std::filesystem::temp_directory_path() / "BasicXrApp" / "XrUtilityBenchmarks.txt";
+        sample::RenderScaleController m_renderScaleController;
+
         xr::InstanceHandle m_instance;
         xr::SessionHandle m_session;
         uint64_t m_systemId{XR_NULL_SYSTEM_ID};
@@ -1251,16 +2270,64 @@ namespace {
             bool DepthExtensionSupported{false};
             bool UnboundedRefSpaceSupported{false};
             bool SpatialAnchorSupported{false};
+            bool ReprojectionModeSupported{false};
+            bool SceneUnderstandingSupported{false};
+            bool SpatialAnchorPersistenceSupported{false};
+            bool SceneSerializationSupported{false};
+            bool HandTrackingMeshSupported{false};
+            bool VisibilityMaskSupported{false};
         } m_optionalExtensions;
 
+        // Lets the reprojection policy request per-pixel depth reprojection of the projection layer when the system supports it.
+        // Otherwise it requests a plane through the focus content, or leaves the mode to the runtime.
+        bool m_useDepthReprojection{true};
+        sample::ReprojectionPolicy m_reprojectionPolicy;
+        sample::SystemCapabilityCache m_systemCapabilities{std::filesystem::temp_directory_path() / "BasicXrApp" /
+                                                           "SystemCapabilities.bin"};
+
         xr::SpaceHandle m_appSpace;
         XrReferenceSpaceType m_appSpaceType{};
 
+        // Renders environment meshes depth-only before the local content when the system supports scene understanding, so that
+        // cubes behind walls and furniture are hidden and their pixels are never shaded.
+        bool m_useSceneOcclusion{true};
+#if XR_MSFT_scene_understanding_preview3
+        constexpr static float OcclusionSceneRadius = 10.0f; // In meters around the app space origin.
+#if SCENE_CACHE_SUPPORTED
+        constexpr static uint32_t SceneCacheInterval = 5; // Every how many scene computes are serialized into the cache.
+        sample::SceneCache m_sceneCache{std::filesystem::temp_directory_path() / "BasicXrApp" / "SceneCache"};
+        std::future<void> m_sceneCacheWrite; // Waits for the write when destroyed, so it's declared after the cache.
+        std::string m_sceneCacheTriedKey;
+        std::mutex m_serializedSceneMutex;
+        std::vector<std::vector<uint8_t>> m_serializedScene; // Set by the scene service, written by UpdateSceneCache.
+#endif
+        std::unique_ptr<xr::su::SceneUnderstandingService> m_sceneService; // Destroyed before the session and the app space.
+        uint64_t m_occlusionSceneVersion{0};
+        float m_occlusionSceneRadius{OcclusionSceneRadius}; // Of the bounds given to m_sceneService.
+        std::vector<xr::su::SceneMesh::Id> m_occlusionMeshIds;
+        std::vector<XrSceneComponentLocationMSFT> m_occlusionMeshLocations;
+        std::vector<sample::OcclusionMesh> m_occlusionMeshes;
+
+        // The planes and collider meshes of the latest scene, in app space. Placed cubes snap to them.
+        constexpr static float PlacementSnapDistance = 0.15f; // In meters from the hand.
+        xr::su::SceneSpatialIndex m_placementIndex;
+        std::vector<xr::su::ScenePlane::Id> m_placementPlaneIds;
+        std::vector<xr::su::SceneColliderMesh::Id> m_placementColliderMeshIds;
+        std::vector<const xr::su::SceneMeshData*> m_placementColliderMeshes;
+        std::vector<XrSceneComponentLocationMSFT> m_placementLocations;
+#endif
+
         struct Hologram {
             sample::Cube Cube;
             xr::SpatialAnchorHandle Anchor;
         };
         std::vector<Hologram> m_holograms;
+#if XR_MSFT_spatial_anchor_persistence_preview
+        sample::SpatialAnchorStore m_anchorStore; // The anchored holograms, when the anchor store is available.
+#endif
+#if XR_EXT_hand_tracking && XR_MSFT_hand_tracking_mesh
+        sample::HandMeshTracker m_handMeshTracker; // Drawn as occluders, when the system tracks hand meshes.
+#endif
 
         std::optional<uint32_t> m_mainCubeIndex;
         std::optional<uint32_t> m_spinningCubeIndex;
@@ -1277,6 +2344,20 @@ namespace {
         xr::ActionHandle m_poseAction;
         xr::ActionHandle m_vibrateAction;
 
+        // The input of one hand in the current frame, read for all actions in one pass after xrSyncActions.
+        struct HandInput {
+            XrActionStateBoolean Place{XR_TYPE_ACTION_STATE_BOOLEAN};
+            XrActionStateBoolean Exit{XR_TYPE_ACTION_STATE_BOOLEAN};
+            bool VibrationRequested{false}; // Coalesces the haptic feedback of all actions into one call per frame.
+        };
+        struct BooleanActionInput {
+            XrActionStateGetInfo GetInfo{XR_TYPE_ACTION_STATE_GET_INFO};
+            XrActionStateBoolean HandInput::*State{nullptr};
+        };
+        XrActiveActionSet m_activeActionSet{};
+        std::array<std::vector<BooleanActionInput>, 2> m_booleanActionInputs;
+        std::array<HandInput, 2> m_handInputs{};
+
         XrEnvironmentBlendMode m_environmentBlendMode{};
         xr::math::NearFar m_nearFar{};
 
@@ -1287,6 +2368,10 @@ namespace {
             uint32_t Height{0};
             uint32_t ArraySize{0};
             std::vector<XrSwapchainImageD3D11KHR> Images;
+
+            // Views of each swapchain image, indexed by the image index returned from xrAcquireSwapchainImage.
+            std::vector<winrt::com_ptr<ID3D11RenderTargetView>> RenderTargetViews;
+            std::vector<winrt::com_ptr<ID3D11DepthStencilView>> DepthStencilViews;
         };
 
         struct RenderResources {
@@ -1297,6 +2382,21 @@ namespace {
             SwapchainD3D11 DepthSwapchain;
             std::vector<XrCompositionLayerProjectionView> ProjectionLayerViews;
             std::vector<XrCompositionLayerDepthInfoKHR> DepthInfoViews;
+
+            // Per-frame scratch storage, sized once and reused every frame.
+            std::vector<const sample::Cube*> VisibleCubes;
+            std::vector<xr::math::ViewProjection> ViewProjections;
+            std::vector<XrCompositionLayerBaseHeader*> Layers;
+            xr::SpaceLocator SpaceLocator;
+            uint32_t StatusDisplayLocationIndex{xr::SpaceLocator::InvalidIndex};
+            uint32_t FrameCount{0};
+
+            // The allocations made inside of ScopedUncountedHeapAllocations since the last report.
+            struct UncountedAllocationReport {
+                uint64_t Allocations{0};
+                uint32_t AllocatingFrames{0};
+                uint32_t Frames{0};
+            } UncountedAllocations;
         };
 
         std::unique_ptr<RenderResources> m_renderResources{};
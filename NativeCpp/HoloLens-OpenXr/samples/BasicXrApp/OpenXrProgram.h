@@ -12,6 +12,7 @@
 #include <d3d11_4.h>
 #include <winrt/Windows.Graphics.DirectX.Direct3D11.h>
 namespace RR = Microsoft::Azure::RemoteRendering;
+#include "FrameStatisticsMonitor.h"
 extern "C" void ForceD3D11Device(winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice& device);
 
 // Our application's possible states:
@@ -26,6 +27,41 @@ enum class AppConnectionStatus {
     // error state:
     ConnectionFailed,
 };
+
+// Everything the status display shows. The status text is only rebuilt when one of these fields changes.
+struct AppStatus {
+    // Model loading progress is shown in whole percent, so that small progress updates don't rebuild the text.
+    constexpr static int ModelLoadPercentageStep = 1;
+
+    AppConnectionStatus ConnectionStatus = AppConnectionStatus::Disconnected;
+    std::string ErrorMessage;
+    int SessionStartingSeconds = 0;
+    bool ModelLoadTriggered = false;
+    bool ModelLoadFinished = false;
+    RR::Result ModelLoadResult = RR::Result::Success;
+    int ModelLoadPercentage = 0;
+    int ModelCount = 0;
+    int ModelsLoaded = 0;
+    int ModelsVisible = 0; // Models of which the coarse or the full version is shown.
+    std::optional<sample::FrameStatisticsSummary> FrameStatistics; // Only set while the performance HUD is shown.
+
+    static int QuantizeModelLoadProgress(float progress) {
+        const int percentage = static_cast<int>(progress * 100.0f);
+        return percentage - percentage % ModelLoadPercentageStep;
+    }
+
+    bool operator==(const AppStatus& other) const {
+        return ConnectionStatus == other.ConnectionStatus && ErrorMessage == other.ErrorMessage &&
+               SessionStartingSeconds == other.SessionStartingSeconds && ModelLoadTriggered == other.ModelLoadTriggered &&
+               ModelLoadFinished == other.ModelLoadFinished && ModelLoadResult == other.ModelLoadResult &&
+               ModelLoadPercentage == other.ModelLoadPercentage && ModelCount == other.ModelCount && ModelsLoaded == other.ModelsLoaded &&
+               ModelsVisible == other.ModelsVisible && FrameStatistics == other.FrameStatistics;
+    }
+
+    bool operator!=(const AppStatus& other) const {
+        return !(*this == other);
+    }
+};
 #endif
 
 class Timer {
@@ -45,6 +81,10 @@ private:
 };
 
 namespace sample {
+    namespace dx {
+        class ConstantBufferRing;
+    }
+
     struct Cube {
         xr::SpaceHandle Space{};
         std::optional<XrPosef> PoseInSpace{}; // Relative pose in cube Space. Default to identity.
@@ -53,11 +93,41 @@ namespace sample {
         XrPosef PoseInAppSpace = xr::math::Pose::Identity(); // Cube pose in app space that gets updated every frame
     };
 
+    // A mesh of the real environment, such as a wall or a table. Local content behind it is hidden.
+    struct OcclusionMesh {
+        std::shared_ptr<const void> Owner; // Owns the vertices and indices. Identifies the mesh across SetOcclusionMeshes calls.
+        const XrVector3f* Vertices{nullptr};
+        uint32_t VertexCount{0};
+        const uint32_t* Indices{nullptr};
+        uint32_t IndexCount{0};
+        XrPosef PoseInAppSpace = xr::math::Pose::Identity();
+    };
+
+    // The pixels of one view that the display never shows, as triangles in view space on the z = -1 plane.
+    struct VisibilityMask {
+        std::vector<XrVector2f> Vertices;
+        std::vector<uint32_t> Indices;
+    };
+
+#if XR_MSFT_hand_tracking_mesh
+    // The latest mesh of a tracked hand. Holograms behind it are hidden, so that the hand appears in front of them.
+    struct HandMesh {
+        const XrHandMeshVertexMSFT* Vertices{nullptr};
+        uint32_t VertexCount{0}; // 0 if the hand is not tracked.
+        bool VerticesChanged{false};
+        const uint32_t* Indices{nullptr};
+        uint32_t IndexCount{0};
+        bool IndicesChanged{false};
+        XrPosef PoseInAppSpace = xr::math::Pose::Identity();
+    };
+#endif
+
     struct IOpenXrProgram {
         virtual ~IOpenXrProgram() = default;
         virtual void Run() = 0;
 #ifdef USE_REMOTE_RENDERING
-        virtual void RenderARR(ID3D11DeviceContext* context) = 0;
+        // Constants for the remote rendering content are sub-allocated from the constant buffer ring of the graphics plugin.
+        virtual void RenderARR(ID3D11DeviceContext1* context, sample::dx::ConstantBufferRing& constantBufferRing) = 0;
 #endif
     };
 
@@ -71,7 +141,38 @@ namespace sample {
         virtual const std::vector<DXGI_FORMAT>& SupportedColorFormats() const = 0;
         virtual const std::vector<DXGI_FORMAT>& SupportedDepthFormats() const = 0;
 
-        // Render to swapchain images using stereo image array
+        // Create views of a swapchain image using the original swapchain format (swapchain images are typeless).
+        // Views are created once per swapchain image when the swapchain is created, not in the frame loop.
+        virtual winrt::com_ptr<ID3D11RenderTargetView> CreateRenderTargetView(ID3D11Texture2D* colorTexture,
+                                                                              DXGI_FORMAT colorSwapchainFormat) = 0;
+        virtual winrt::com_ptr<ID3D11DepthStencilView> CreateDepthStencilView(ID3D11Texture2D* depthTexture,
+                                                                              DXGI_FORMAT depthSwapchainFormat) = 0;
+
+        // Replace the environment meshes that are rendered depth-only before the local content, so that the pixels of local
+        // content hidden behind them fail the early depth test and are never shaded. Meshes with the same owner as in the
+        // previous call keep their GPU buffers. Not called in the frame loop unless the environment changed.
+        virtual void SetOcclusionMeshes(const std::vector<OcclusionMesh>& meshes) = 0;
+
+#if XR_MSFT_hand_tracking_mesh
+        // Set the hand meshes of the next RenderView, one entry per hand in the same order every frame. They are drawn after the
+        // remote frame, so they also hide the remote content behind the hands. A hand's GPU buffers are only written when its
+        // mesh changed, or when the hand wasn't drawn in the previous frame.
+        virtual void SetHandMeshes(const std::vector<HandMesh>& hands) = 0;
+#endif
+
+        // Replace the visibility masks, one per view. Views without hidden triangles have an empty mask. Not called in the frame
+        // loop unless the runtime reports a changed mask.
+        virtual void SetVisibilityMasks(const std::vector<VisibilityMask>& masks) = 0;
+
+        // Render pipeline stage that writes the nearest depth over the pixels hidden by the visibility masks, so that everything
+        // drawn afterwards with a depth test skips them. RenderView runs it right after the clear. A stage that overwrites the
+        // depth buffer, like the remote frame blit, must run it again before drawing more content. Restores the depth state.
+        virtual void RenderVisibilityMask(ID3D11DeviceContext1* context, sample::dx::ConstantBufferRing& constantBufferRing) = 0;
+
+        // Compute the per view constants on the CPU, before the swapchain images are waited for.
+        virtual void PrepareView(const std::vector<xr::math::ViewProjection>& viewProjections) = 0;
+
+        // Render to swapchain images using stereo image array, after PrepareView with the same view projections.
         virtual void RenderView(
 #ifdef USE_REMOTE_RENDERING
             IOpenXrProgram* program,
@@ -79,14 +180,18 @@ namespace sample {
             const XrRect2Di& imageRect,
             const float renderTargetClearColor[4],
             const std::vector<xr::math::ViewProjection>& viewProjections,
-            DXGI_FORMAT colorSwapchainFormat,
-            ID3D11Texture2D* colorTexture,
-            DXGI_FORMAT depthSwapchainFormat,
-            ID3D11Texture2D* depthTexture,
+            ID3D11RenderTargetView* renderTargetView,
+            ID3D11DepthStencilView* depthStencilView,
             const std::vector<const sample::Cube*>& cubes) = 0;
     };
 
-    std::unique_ptr<IGraphicsPluginD3D11> CreateCubeGraphics();
+    // How CubeGraphics submits the visible cubes to the GPU.
+    enum class CubeDrawMode {
+        PerCube,   // Update the model constant buffer and issue one draw call per cube.
+        Instanced, // Write all model transforms into one dynamic structured buffer and issue a single instanced draw call.
+    };
+
+    std::unique_ptr<IGraphicsPluginD3D11> CreateCubeGraphics(CubeDrawMode drawMode = CubeDrawMode::Instanced);
     std::unique_ptr<IOpenXrProgram> CreateOpenXrProgram(std::string applicationName, std::unique_ptr<IGraphicsPluginD3D11> graphicsPlugin);
 
 } // namespace sample
@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "PoseTrace.h"
+
+namespace {
+    using sample::debug::PoseTraceFrame;
+
+    PoseTraceFrame::ActionState ToActionState(const XrActionStateBoolean& state) {
+        PoseTraceFrame::ActionState actionState;
+        actionState.IsActive = state.isActive ? 1 : 0;
+        actionState.CurrentState = state.currentState ? 1 : 0;
+        actionState.ChangedSinceLastSync = state.changedSinceLastSync ? 1 : 0;
+        return actionState;
+    }
+
+    PoseTraceFrame::Location ToTraceLocation(const XrSpaceLocation& location) {
+        return {location.locationFlags, location.pose};
+    }
+
+    XrSpaceLocation ToSpaceLocation(const PoseTraceFrame::Location& location) {
+        XrSpaceLocation spaceLocation{XR_TYPE_SPACE_LOCATION};
+        spaceLocation.locationFlags = location.Flags;
+        spaceLocation.pose = location.Pose;
+        return spaceLocation;
+    }
+} // namespace
+
+namespace sample::debug {
+    static_assert(std::is_trivially_copyable_v<PoseTraceFrame>, "Records are written and read as they are in memory.");
+
+    PoseTraceRecorder::PoseTraceRecorder(const std::filesystem::path& path) {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        CHECK_MSG(m_file.is_open(), "Failed to create the pose trace file.");
+        m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+        DEBUG_PRINT("Recording a pose trace to %ls.", path.c_str());
+    }
+
+    PoseTraceRecorder::~PoseTraceRecorder() {
+        WriteBlock();
+        m_file.seekp(0);
+        m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+        if (!m_file) {
+            DEBUG_PRINT("Failed to write the pose trace.");
+            return;
+        }
+        DEBUG_PRINT("Recorded %u frames into the pose trace.", m_header.FrameCount);
+    }
+
+    void PoseTraceRecorder::RecordInput(uint32_t side, const XrActionStateBoolean& place, const XrActionStateBoolean& exit) {
+        PoseTraceFrame::Hand& hand = m_frame.Hands[side];
+        hand.Place = ToActionState(place);
+        hand.Exit = ToActionState(exit);
+
+        // Converted once the frame's predicted display time is known.
+        m_placeChangeTimes[side] = place.lastChangeTime;
+        m_exitChangeTimes[side] = exit.lastChangeTime;
+    }
+
+    void PoseTraceRecorder::RecordPlacement(uint32_t side, const XrSpaceLocation& gripLocation) {
+        m_frame.Hands[side].PlaceLocation = ToTraceLocation(gripLocation);
+    }
+
+    void PoseTraceRecorder::RecordFrameState(const XrFrameState& frameState) {
+        if (m_firstDisplayTime == 0) {
+            m_firstDisplayTime = frameState.predictedDisplayTime;
+        }
+        m_frame.DisplayTime = ToTraceTime(frameState.predictedDisplayTime);
+        m_frame.DisplayPeriod = frameState.predictedDisplayPeriod;
+    }
+
+    void PoseTraceRecorder::RecordViews(const XrViewState& viewState, const std::vector<XrView>& views) {
+        CHECK(views.size() == PoseTraceFrame::ViewCount);
+        m_frame.ViewStateFlags = viewState.viewStateFlags;
+        for (uint32_t i = 0; i < PoseTraceFrame::ViewCount; i++) {
+            m_frame.ViewPoses[i] = views[i].pose;
+            m_frame.ViewFovs[i] = views[i].fov;
+        }
+    }
+
+    void PoseTraceRecorder::RecordGrip(uint32_t side, const XrSpaceLocation& gripLocation) {
+        m_frame.Hands[side].GripLocation = ToTraceLocation(gripLocation);
+    }
+
+    void PoseTraceRecorder::EndFrame() {
+        if (m_firstDisplayTime != 0) {
+            for (uint32_t side = 0; side < m_frame.Hands.size(); side++) {
+                m_frame.Hands[side].Place.LastChangeTime = ToTraceTime(m_placeChangeTimes[side]);
+                m_frame.Hands[side].Exit.LastChangeTime = ToTraceTime(m_exitChangeTimes[side]);
+            }
+            m_block[m_blockFrameCount++] = m_frame;
+            if (m_blockFrameCount == FramesPerBlock) {
+                WriteBlock();
+            }
+        }
+        m_frame = {};
+    }
+
+    void PoseTraceRecorder::WriteBlock() {
+        m_file.write(reinterpret_cast<const char*>(m_block.data()), m_blockFrameCount * sizeof(PoseTraceFrame));
+        m_header.FrameCount += m_blockFrameCount;
+        m_blockFrameCount = 0;
+    }
+
+    PoseTracePlayer::PoseTracePlayer(std::filesystem::path path)
+        : m_path(std::move(path)) {
+        std::ifstream file(m_path, std::ios::binary);
+        CHECK_MSG(file.is_open(), "Failed to open the pose trace file.");
+
+        PoseTraceHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        CHECK_MSG(file && header.Magic == PoseTraceHeader::ExpectedMagic, "The file is not a pose trace.");
+        CHECK_MSG(header.Version == PoseTraceHeader::CurrentVersion, "The pose trace was recorded by another version of the app.");
+
+        m_frames.resize(header.FrameCount);
+        file.read(reinterpret_cast<char*>(m_frames.data()), m_frames.size() * sizeof(PoseTraceFrame));
+        CHECK_MSG(file, "The pose trace is truncated.");
+
+        m_frameMilliseconds.reserve(m_frames.size());
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        m_millisecondsPerTick = 1000.0 / frequency.QuadPart;
+        DEBUG_PRINT("Replaying the %u frames of the pose trace %ls.", header.FrameCount, m_path.c_str());
+    }
+
+    bool PoseTracePlayer::Advance() {
+        if (m_nextFrame == m_frames.size()) {
+            if (m_frame != nullptr) {
+                m_frame = nullptr;
+                Report();
+            }
+            return false;
+        }
+
+        m_frame = &m_frames[m_nextFrame++];
+        for (uint32_t side = 0; side < m_frame->Hands.size(); side++) {
+            m_placeLocations[side] = ToSpaceLocation(m_frame->Hands[side].PlaceLocation);
+            m_gripLocations[side] = ToSpaceLocation(m_frame->Hands[side].GripLocation);
+        }
+        return true;
+    }
+
+    void PoseTracePlayer::ApplyInput(uint32_t side, XrActionStateBoolean& place, XrActionStateBoolean& exit) const {
+        if (m_frame == nullptr) {
+            return;
+        }
+
+        auto apply = [this](const PoseTraceFrame::ActionState& recorded, XrActionStateBoolean& state) {
+            state.isActive = recorded.IsActive && m_firstDisplayTime != 0;
+            state.currentState = recorded.CurrentState;
+            state.changedSinceLastSync = recorded.ChangedSinceLastSync;
+            // Anchors are created at this time, which must not be ahead of the runtime's latest prediction.
+            state.lastChangeTime = std::min(ToRuntimeTime(recorded.LastChangeTime), m_latestDisplayTime);
+        };
+        apply(m_frame->Hands[side].Place, place);
+        apply(m_frame->Hands[side].Exit, exit);
+    }
+
+    XrTime PoseTracePlayer::ApplyViews(XrTime predictedDisplayTime, XrViewState& viewState, std::vector<XrView>& views) {
+        m_latestDisplayTime = predictedDisplayTime;
+        if (m_frame == nullptr) {
+            return predictedDisplayTime;
+        }
+
+        if (m_firstDisplayTime == 0) {
+            m_firstDisplayTime = predictedDisplayTime - m_frame->DisplayTime;
+        }
+
+        CHECK(views.size() == PoseTraceFrame::ViewCount);
+        viewState.viewStateFlags = m_frame->ViewStateFlags;
+        for (uint32_t i = 0; i < PoseTraceFrame::ViewCount; i++) {
+            views[i].pose = m_frame->ViewPoses[i];
+            views[i].fov = m_frame->ViewFovs[i];
+        }
+        return ToRuntimeTime(m_frame->DisplayTime);
+    }
+
+    void PoseTracePlayer::OnFrameSubmitted(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod) {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        if (m_previousSubmitTicks != 0 && m_frameMilliseconds.size() < m_frameMilliseconds.capacity()) {
+            m_frameMilliseconds.push_back(static_cast<float>((now.QuadPart - m_previousSubmitTicks) * m_millisecondsPerTick));
+        }
+        m_previousSubmitTicks = now.QuadPart;
+
+        // The runtime skips the display periods the app missed when it predicts the next display time.
+        if (m_submittedDisplayTime != 0 && predictedDisplayPeriod > 0) {
+            const XrDuration elapsed = predictedDisplayTime - m_submittedDisplayTime;
+            const XrDuration periods = (elapsed + predictedDisplayPeriod / 2) / predictedDisplayPeriod;
+            if (periods > 1) {
+                m_missedDisplayPeriods += static_cast<uint32_t>(periods - 1);
+            }
+        }
+        m_submittedDisplayTime = predictedDisplayTime;
+    }
+
+    void PoseTracePlayer::Report() const {
+        std::vector<float> sorted = m_frameMilliseconds;
+        auto percentile = [&](uint32_t percent) {
+            if (sorted.empty()) {
+                return 0.0f;
+            }
+            const auto nth = sorted.begin() + (sorted.size() - 1) * percent / 100;
+            std::nth_element(sorted.begin(), nth, sorted.end());
+            return *nth;
+        };
+        const float p50 = percentile(50);
+        const float p95 = percentile(95);
+        const float p99 = percentile(99);
+        const float maximum = percentile(100);
+
+        DEBUG_PRINT("Pose trace replay of %zu frames, frame time in ms (p50 / p95 / p99 / max of %zu samples):",
+                    m_frames.size(),
+                    sorted.size());
+        DEBUG_PRINT("  %6.2f / %6.2f / %6.2f / %6.2f, %u display periods missed", p50, p95, p99, maximum, m_missedDisplayPeriods);
+
+        // One value per line, so that the results of two builds can be compared by a script.
+        std::filesystem::path resultsPath = m_path;
+        resultsPath.replace_extension(".results.txt");
+        std::ofstream results(resultsPath, std::ios::trunc);
+        results << "frames " << m_frames.size() << '\n'
+                << "frame_ms_p50 " << p50 << '\n'
+                << "frame_ms_p95 " << p95 << '\n'
+                << "frame_ms_p99 " << p99 << '\n'
+                << "frame_ms_max " << maximum << '\n'
+                << "missed_display_periods " << m_missedDisplayPeriods << '\n';
+        if (!results) {
+            DEBUG_PRINT("Failed to write the pose trace results %ls.", resultsPath.c_str());
+        }
+    }
+} // namespace sample::debug
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+
+namespace sample::debug {
+    // Records the head poses, the hand poses and the input of a session into a binary trace, and replays a trace instead of
+    // the live tracking, so that the same motion can be rendered by different builds and their frame timings compared.
+    //
+    // A trace holds one record per frame loop iteration: the action states read by PollActions, the grip location of a
+    // placement, and the views and hand locations located for the predicted display time. All times are stored relative to
+    // the predicted display time of the first frame. The file is a PoseTraceHeader followed by its FrameCount records.
+    //
+    // Replaying still needs an OpenXR runtime, e.g. holographic remoting or the simulator for the desktop build, since
+    // xrWaitFrame paces the frames and the swapchains belong to the session. Only the poses and input of the runtime are
+    // replaced: the rendered views, the hand cubes, the placements and the content animation follow the trace. With remote
+    // rendering, the remote frames are still rendered for the live head pose, and use the session the app connects to, so
+    // set a session to reuse for comparable runs.
+    enum class PoseTraceMode {
+        Off,
+        Record,
+        Replay,
+    };
+
+#pragma pack(push, 1)
+    struct PoseTraceHeader {
+        constexpr static uint32_t ExpectedMagic = 0x43525450; // "PTRC"
+        constexpr static uint32_t CurrentVersion = 1;
+
+        uint32_t Magic = ExpectedMagic;
+        uint32_t Version = CurrentVersion;
+        uint32_t FrameCount = 0;
+    };
+
+    struct PoseTraceFrame {
+        constexpr static uint32_t ViewCount = 2; // PRIMARY_STEREO
+
+        struct ActionState {
+            uint8_t IsActive = 0;
+            uint8_t CurrentState = 0;
+            uint8_t ChangedSinceLastSync = 0;
+            XrDuration LastChangeTime = 0;
+        };
+
+        struct Location {
+            XrSpaceLocationFlags Flags = 0;
+            XrPosef Pose{};
+        };
+
+        struct Hand {
+            ActionState Place;
+            ActionState Exit;
+            Location PlaceLocation; // The grip at the time Place changed, only located when it was pressed.
+            Location GripLocation;  // The grip at the predicted display time.
+        };
+
+        XrDuration DisplayTime = 0;
+        XrDuration DisplayPeriod = 0;
+        XrViewStateFlags ViewStateFlags = 0; // No valid flags for frames that weren't rendered.
+        std::array<XrPosef, ViewCount> ViewPoses{};
+        std::array<XrFovf, ViewCount> ViewFovs{};
+        std::array<Hand, 2> Hands{};
+    };
+#pragma pack(pop)
+
+    // Writes a trace while the app runs on live tracking. The records are buffered and written in blocks, so recording
+    // doesn't allocate in the frame loop. The trace starts with the first frame that was waited for, and its header is
+    // completed when the recorder is destroyed.
+    class PoseTraceRecorder {
+    public:
+        constexpr static uint32_t FramesPerBlock = 256;
+
+        explicit PoseTraceRecorder(const std::filesystem::path& path);
+        ~PoseTraceRecorder();
+
+        PoseTraceRecorder(const PoseTraceRecorder&) = delete;
+        PoseTraceRecorder& operator=(const PoseTraceRecorder&) = delete;
+
+        // Called after the action states of a hand were read.
+        void RecordInput(uint32_t side, const XrActionStateBoolean& place, const XrActionStateBoolean& exit);
+        void RecordPlacement(uint32_t side, const XrSpaceLocation& gripLocation);
+
+        // Called after xrWaitFrame, and after xrLocateViews and locating the grips of frames that are rendered.
+        void RecordFrameState(const XrFrameState& frameState);
+        void RecordViews(const XrViewState& viewState, const std::vector<XrView>& views);
+        void RecordGrip(uint32_t side, const XrSpaceLocation& gripLocation);
+
+        // Completes the record of the current frame loop iteration.
+        void EndFrame();
+
+    private:
+        XrDuration ToTraceTime(XrTime time) const {
+            return time - m_firstDisplayTime;
+        }
+
+        void WriteBlock();
+
+        std::ofstream m_file;
+        PoseTraceHeader m_header;
+        PoseTraceFrame m_frame;
+        std::array<XrTime, 2> m_placeChangeTimes{};
+        std::array<XrTime, 2> m_exitChangeTimes{};
+        XrTime m_firstDisplayTime = 0;
+        std::array<PoseTraceFrame, FramesPerBlock> m_block;
+        uint32_t m_blockFrameCount = 0;
+    };
+
+    // Reads a trace and hands out its records one frame loop iteration after the other. Recorded times are converted to the
+    // runtime's clock relative to the predicted display time of the first replayed frame, so the content animates the same way
+    // in every run. Frame times and missed display periods are measured while replaying, and summarized once the trace ends,
+    // in the debug output and in a text file next to the trace.
+    class PoseTracePlayer {
+    public:
+        explicit PoseTracePlayer(std::filesystem::path path);
+
+        // Moves on to the record of the next frame loop iteration. Returns false once every record was replayed, after the
+        // summary was reported.
+        bool Advance();
+
+        // Replaces the action states read from the runtime. The input of records before the first rendered frame is dropped,
+        // since their times can't be converted to the runtime's clock yet.
+        void ApplyInput(uint32_t side, XrActionStateBoolean& place, XrActionStateBoolean& exit) const;
+
+        // The recorded grip of a placement, or nullptr if no record is replayed.
+        const XrSpaceLocation* TryGetPlaceLocation(uint32_t side) const {
+            return m_frame != nullptr ? &m_placeLocations[side] : nullptr;
+        }
+
+        // Replaces the views located by the runtime, and returns the recorded display time in the runtime's clock.
+        XrTime ApplyViews(XrTime predictedDisplayTime, XrViewState& viewState, std::vector<XrView>& views);
+
+        // The recorded grip at the display time, or nullptr if no record is replayed.
+        const XrSpaceLocation* TryGetGripLocation(uint32_t side) const {
+            return m_frame != nullptr ? &m_gripLocations[side] : nullptr;
+        }
+
+        // Called after xrEndFrame submitted a replayed frame.
+        void OnFrameSubmitted(XrTime predictedDisplayTime, XrDuration predictedDisplayPeriod);
+
+    private:
+        XrTime ToRuntimeTime(XrDuration traceTime) const {
+            return m_firstDisplayTime + traceTime;
+        }
+
+        void Report() const;
+
+        const std::filesystem::path m_path;
+        std::vector<PoseTraceFrame> m_frames;
+        size_t m_nextFrame = 0;
+        const PoseTraceFrame* m_frame = nullptr;
+        std::array<XrSpaceLocation, 2> m_placeLocations{};
+        std::array<XrSpaceLocation, 2> m_gripLocations{};
+        XrTime m_firstDisplayTime = 0; // The runtime time of the trace's time 0, set by the first rendered frame.
+        XrTime m_latestDisplayTime = 0;
+        XrTime m_submittedDisplayTime = 0;
+
+        std::vector<float> m_frameMilliseconds; // Reserved for every record, so that measuring doesn't allocate.
+        int64_t m_previousSubmitTicks = 0;
+        double m_millisecondsPerTick = 0;
+        uint32_t m_missedDisplayPeriods = 0;
+    };
+} // namespace sample::debug
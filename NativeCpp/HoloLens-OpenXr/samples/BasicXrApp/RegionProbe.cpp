@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#ifdef USE_REMOTE_RENDERING
+#include "OpenXrProgram.h"
+#include "RegionProbe.h"
+
+#include <combaseapi.h>
+#include <fstream>
+#include <future>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <winrt/Windows.Networking.Connectivity.h>
+
+#pragma comment(lib, "Ws2_32.lib")
+
+namespace {
+    // FNV-1a, which unlike std::hash is guaranteed to give the same value in every build and process.
+    uint64_t HashKey(std::string_view key) {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : key) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Identifies the network the device is on by its adapter and profile, e.g. the SSID of a WLAN. Empty when offline.
+    std::string GetNetworkKey() {
+        using winrt::Windows::Networking::Connectivity::NetworkInformation;
+
+        // The probe runs on a startup worker thread, which has no apartment yet.
+        const HRESULT initialized = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        std::string key;
+        try {
+            if (const auto profile = NetworkInformation::GetInternetConnectionProfile()) {
+                key = winrt::to_string(winrt::to_hstring(profile.NetworkAdapter().NetworkAdapterId()) + L"|" + profile.ProfileName());
+            }
+        } catch (const winrt::hresult_error& error) {
+            DEBUG_PRINT("Failed to query the network connection profile (0x%08x).", static_cast<uint32_t>(error.code()));
+        }
+        if (SUCCEEDED(initialized)) {
+            CoUninitialize();
+        }
+        return key;
+    }
+
+    std::optional<std::chrono::microseconds> MeasureConnect(const addrinfo& address, std::chrono::milliseconds timeout) {
+        const SOCKET socketHandle = socket(address.ai_family, address.ai_socktype, address.ai_protocol);
+        if (socketHandle == INVALID_SOCKET) {
+            return std::nullopt;
+        }
+
+        // A non-blocking connect, so that an unreachable region gives up after the timeout instead of the system's.
+        u_long nonBlocking = 1;
+        ioctlsocket(socketHandle, FIONBIO, &nonBlocking);
+
+        const auto start = std::chrono::steady_clock::now();
+        bool connected = connect(socketHandle, address.ai_addr, static_cast<int>(address.ai_addrlen)) == 0;
+        if (!connected && WSAGetLastError() == WSAEWOULDBLOCK) {
+            fd_set writable;
+            fd_set failed;
+            FD_ZERO(&writable);
+            FD_ZERO(&failed);
+            FD_SET(socketHandle, &writable);
+            FD_SET(socketHandle, &failed);
+            const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(timeout).count();
+            const timeval wait{static_cast<long>(micros / 1000000), static_cast<long>(micros % 1000000)};
+            connected = select(0, nullptr, &writable, &failed, &wait) > 0 && FD_ISSET(socketHandle, &writable);
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        closesocket(socketHandle);
+
+        return connected ? std::optional(elapsed) : std::nullopt;
+    }
+
+    // Returns the fastest of the connects to the session endpoint of the region, or nothing if none succeeded.
+    std::optional<std::chrono::microseconds> MeasureRegion(const std::string& region, uint32_t samples, std::chrono::milliseconds timeout) {
+        const std::string host = "remoterendering." + sample::RegionProbe::GetDomain(region);
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(host.c_str(), "443", &hints, &addresses) != 0) {
+            return std::nullopt;
+        }
+        const std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> ownedAddresses(addresses, &freeaddrinfo);
+
+        // The name is resolved once up front, so the samples only contain the handshake.
+        std::optional<std::chrono::microseconds> fastest;
+        for (uint32_t i = 0; i < samples; i++) {
+            const std::optional<std::chrono::microseconds> roundTrip = MeasureConnect(*addresses, timeout);
+            if (roundTrip.has_value() && (!fastest.has_value() || roundTrip.value() < fastest.value())) {
+                fastest = roundTrip;
+            }
+        }
+        return fastest;
+    }
+} // namespace
+
+namespace sample {
+    RegionProbe::RegionProbe()
+        : RegionProbe(Options{}) {
+    }
+
+    RegionProbe::RegionProbe(Options options)
+        : m_options(std::move(options)) {
+    }
+
+    std::string RegionProbe::SelectRegion() {
+        // Without a network there is nothing to measure or cache, the session creation reports the error.
+        const std::string networkKey = GetNetworkKey();
+        if (networkKey.empty()) {
+            return m_options.FallbackRegion;
+        }
+
+        char fileName[32];
+        sprintf_s(fileName, "%016llx.txt", HashKey(networkKey));
+        const std::filesystem::path cachePath = m_options.CacheFolder / fileName;
+
+        std::optional<std::vector<Latency>> latencies = ReadCache(cachePath);
+        const bool cached = latencies.has_value();
+        if (!cached) {
+            latencies = Probe();
+        }
+
+        const Latency* best = nullptr;
+        for (const Latency& latency : latencies.value()) {
+            if (latency.RoundTrip.has_value() && (best == nullptr || latency.RoundTrip.value() < best->RoundTrip.value())) {
+                best = &latency;
+            }
+        }
+        if (best == nullptr) {
+            // Not cached, so that the next launch probes again.
+            DEBUG_PRINT("No ARR region could be reached, using %s.", m_options.FallbackRegion.c_str());
+            return m_options.FallbackRegion;
+        }
+
+        if (!cached) {
+            WriteCache(cachePath, latencies.value());
+        }
+        DEBUG_PRINT("Selected ARR region %s with a round trip of %.1f ms%s.",
+                    best->Region.c_str(),
+                    best->RoundTrip->count() / 1000.0,
+                    cached ? " (cached)" : "");
+        return best->Region;
+    }
+
+    std::string RegionProbe::GetDomain(const std::string& region) {
+        return region + ".mixedreality.azure.com";
+    }
+
+    std::vector<RegionProbe::Latency> RegionProbe::Probe() const {
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            return {};
+        }
+
+        std::vector<std::future<std::optional<std::chrono::microseconds>>> measurements;
+        for (const std::string& region : m_options.Regions) {
+            measurements.push_back(
+                std::async(std::launch::async, MeasureRegion, region, m_options.SamplesPerRegion, m_options.ConnectTimeout));
+        }
+
+        std::vector<Latency> latencies;
+        for (size_t i = 0; i < m_options.Regions.size(); i++) {
+            latencies.push_back({m_options.Regions[i], measurements[i].get()});
+            if (latencies.back().RoundTrip.has_value()) {
+                DEBUG_PRINT("  %-16s %8.1f ms", m_options.Regions[i].c_str(), latencies.back().RoundTrip->count() / 1000.0);
+            } else {
+                DEBUG_PRINT("  %-16s unreachable", m_options.Regions[i].c_str());
+            }
+        }
+
+        WSACleanup();
+        return latencies;
+    }
+
+    std::optional<std::vector<RegionProbe::Latency>> RegionProbe::ReadCache(const std::filesystem::path& path) const {
+        std::error_code error;
+        const auto writeTime = std::filesystem::last_write_time(path, error);
+        if (error || std::filesystem::file_time_type::clock::now() - writeTime > m_options.CacheLifetime) {
+            return std::nullopt;
+        }
+
+        // One line per region with the round trip in microseconds, or -1 if the region couldn't be reached.
+        std::ifstream file(path);
+        std::vector<Latency> latencies;
+        std::string region;
+        long long roundTrip;
+        while (file >> region >> roundTrip) {
+            Latency& latency = latencies.emplace_back();
+            latency.Region = region;
+            if (roundTrip >= 0) {
+                latency.RoundTrip = std::chrono::microseconds(roundTrip);
+            }
+        }
+
+        // Results for another region list are probed again.
+        auto sameRegion = [](const Latency& latency, const std::string& name) { return latency.Region == name; };
+        if (latencies.size() != m_options.Regions.size() ||
+            !std::equal(latencies.begin(), latencies.end(), m_options.Regions.begin(), sameRegion)) {
+            return std::nullopt;
+        }
+        return latencies;
+    }
+
+    void RegionProbe::WriteCache(const std::filesystem::path& path, const std::vector<Latency>& latencies) const {
+        std::error_code error;
+        std::filesystem::create_directories(m_options.CacheFolder, error);
+        std::ofstream file(path, std::ios::trunc);
+        for (const Latency& latency : latencies) {
+            file << latency.Region << ' ' << (latency.RoundTrip.has_value() ? latency.RoundTrip->count() : -1) << '\n';
+        }
+        if (!file) {
+            DEBUG_PRINT("Failed to write the region latency cache %ls.", path.c_str());
+        }
+    }
+} // namespace sample
+#endif
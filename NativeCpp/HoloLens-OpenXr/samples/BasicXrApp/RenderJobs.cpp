@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "RenderJobs.h"
+
+namespace sample::dx {
+    bool RenderJobs::IsWorthwhile(ID3D11Device* device) {
+        D3D11_FEATURE_DATA_THREADING threading{};
+        D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+        return SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading))) &&
+               threading.DriverCommandLists &&
+               // The ConstantBufferRing of a pass maps with D3D11_MAP_WRITE_NO_OVERWRITE on the deferred context.
+               SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) &&
+               options.MapNoOverwriteOnDynamicConstantBuffer;
+    }
+
+    RenderJobs::RenderJobs(ID3D11Device* device, uint32_t workerCount) {
+        m_device.copy_from(device);
+        for (uint32_t i = 0; i < std::max(workerCount, 1u); i++) {
+            m_workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    RenderJobs::~RenderJobs() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopRequested = true;
+        }
+        m_passAdded.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void RenderJobs::Add(RecordFunction record) {
+        std::unique_lock lock(m_mutex);
+        if (m_passCount == m_passes.size()) {
+            // A new slot is only needed the first time a frame has this many passes.
+            lock.unlock();
+            auto pass = std::make_unique<Pass>();
+            CHECK_HRCMD(m_device->CreateDeferredContext1(0, pass->Context.put()));
+            pass->Constants = std::make_unique<ConstantBufferRing>(m_device.get());
+            lock.lock();
+            m_passes.push_back(std::move(pass));
+        }
+
+        m_passes[m_passCount]->Record = std::move(record);
+        m_passCount++;
+        lock.unlock();
+        m_passAdded.notify_one();
+    }
+
+    void RenderJobs::ExecuteInOrder(ID3D11DeviceContext* immediateContext) {
+        std::unique_lock lock(m_mutex);
+        m_passRecorded.wait(lock, [this] { return m_recordedCount == m_passCount; });
+
+        std::exception_ptr firstError;
+        for (size_t i = 0; i < m_passCount; i++) {
+            Pass& pass = *m_passes[i];
+            if (pass.Error) {
+                if (!firstError) {
+                    firstError = pass.Error;
+                }
+                pass.Error = nullptr;
+            } else {
+                // The immediate context state is not restored, the caller binds its state again when it continues drawing.
+                immediateContext->ExecuteCommandList(pass.CommandList.get(), FALSE);
+            }
+            pass.CommandList = nullptr;
+            pass.Record = nullptr;
+        }
+
+        m_passCount = 0;
+        m_nextPass = 0;
+        m_recordedCount = 0;
+        lock.unlock();
+
+        if (firstError) {
+            std::rethrow_exception(firstError);
+        }
+    }
+
+    void RenderJobs::WorkerLoop() {
+        std::unique_lock lock(m_mutex);
+        for (;;) {
+            m_passAdded.wait(lock, [this] { return m_stopRequested || m_nextPass < m_passCount; });
+            if (m_stopRequested) {
+                return;
+            }
+
+            // Passes are heap allocated, so the pointer stays valid while Add grows the slot vector.
+            Pass* pass = m_passes[m_nextPass++].get();
+            lock.unlock();
+            RecordPass(*pass);
+            lock.lock();
+
+            if (++m_recordedCount == m_passCount) {
+                m_passRecorded.notify_one();
+            }
+        }
+    }
+
+    void RenderJobs::RecordPass(Pass& pass) {
+        try {
+            pass.Constants->BeginFrame();
+            pass.Record(pass.Context.get(), *pass.Constants);
+            CHECK_HRCMD(pass.Context->FinishCommandList(FALSE, pass.CommandList.put()));
+        } catch (...) {
+            pass.Error = std::current_exception();
+
+            // Drop whatever was recorded, so the next frame starts with an empty command list.
+            winrt::com_ptr<ID3D11CommandList> discarded;
+            pass.Context->FinishCommandList(FALSE, discarded.put());
+        }
+    }
+} // namespace sample::dx
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <d3d11_1.h>
+#include "ConstantBufferRing.h"
+
+namespace sample::dx {
+    // Records independent render passes on worker threads into D3D11 deferred contexts, and executes the command lists on
+    // the immediate context in the order the passes were added.
+    //
+    // A deferred context starts every command list with the default pipeline state, so a pass must bind everything it uses,
+    // including render targets and viewports. Each pass slot owns its deferred context and its own ConstantBufferRing, so
+    // passes recorded at the same time share no mutable state. Passes must not use Direct2D or anything else that draws
+    // through the immediate context.
+    //
+    // Slots and worker threads are reused every frame. Adding and executing passes does not allocate in the steady state, as
+    // long as the record functions fit into the small buffer of std::function, e.g. by only capturing this.
+    class RenderJobs {
+    public:
+        using RecordFunction = std::function<void(ID3D11DeviceContext1* context, ConstantBufferRing& constantBufferRing)>;
+
+        // Recording on worker threads only pays off if the driver records command lists natively. The device must also support
+        // D3D11_MAP_WRITE_NO_OVERWRITE of constant buffers on deferred contexts.
+        static bool IsWorthwhile(ID3D11Device* device);
+
+        RenderJobs(ID3D11Device* device, uint32_t workerCount);
+        ~RenderJobs();
+
+        RenderJobs(const RenderJobs&) = delete;
+        RenderJobs& operator=(const RenderJobs&) = delete;
+
+        // Starts recording a pass on a worker thread, concurrently with the caller.
+        void Add(RecordFunction record);
+
+        // Waits for the passes added since the last call and executes their command lists in order. If a pass threw, the first
+        // exception is rethrown after the other command lists were executed.
+        void ExecuteInOrder(ID3D11DeviceContext* immediateContext);
+
+    private:
+        struct Pass {
+            winrt::com_ptr<ID3D11DeviceContext1> Context;
+            std::unique_ptr<ConstantBufferRing> Constants;
+            RecordFunction Record;
+            winrt::com_ptr<ID3D11CommandList> CommandList;
+            std::exception_ptr Error;
+        };
+
+        void WorkerLoop();
+        static void RecordPass(Pass& pass);
+
+        winrt::com_ptr<ID3D11Device> m_device;
+        std::vector<std::unique_ptr<Pass>> m_passes; // Slots [0, m_passCount) are used by the current frame.
+        std::vector<std::thread> m_workers;
+
+        // Shared with the workers:
+        std::mutex m_mutex;
+        std::condition_variable m_passAdded;
+        std::condition_variable m_passRecorded;
+        size_t m_passCount = 0;
+        size_t m_nextPass = 0; // The next slot a worker picks up.
+        size_t m_recordedCount = 0;
+        bool m_stopRequested = false;
+    };
+} // namespace sample::dx
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "RenderScaleController.h"
+
+namespace {
+    int32_t ScaleExtent(uint32_t extent, float scale) {
+        // Round down to an even number of pixels.
+        const int32_t scaled = static_cast<int32_t>(extent * scale) & ~1;
+        return std::clamp(scaled, 2, static_cast<int32_t>(extent));
+    }
+} // namespace
+
+namespace sample {
+    void RenderScaleController::Reset() {
+        m_scale = 1.0f;
+        m_framesBelowThreshold = 0;
+        m_firstFrameAtScale = 0;
+        m_lastGpuFrameIndex = 0;
+        m_hasGpuFrame = false;
+    }
+
+    void RenderScaleController::Update(uint64_t gpuFrameIndex,
+                                       float gpuMilliseconds,
+                                       float displayPeriodMilliseconds,
+                                       uint64_t currentFrameIndex) {
+        if (m_hasGpuFrame && gpuFrameIndex <= m_lastGpuFrameIndex) {
+            return;
+        }
+        m_hasGpuFrame = true;
+        m_lastGpuFrameIndex = gpuFrameIndex;
+
+        if (gpuFrameIndex < m_firstFrameAtScale || displayPeriodMilliseconds <= 0) {
+            return; // The frame was rendered at a previous scale.
+        }
+
+        float newScale = m_scale;
+        if (gpuMilliseconds > displayPeriodMilliseconds * m_options.ScaleDownThreshold) {
+            newScale = std::max(m_options.MinScale, m_scale - m_options.ScaleDownStep);
+            m_framesBelowThreshold = 0;
+        } else if (gpuMilliseconds < displayPeriodMilliseconds * m_options.ScaleUpThreshold) {
+            if (++m_framesBelowThreshold >= m_options.ScaleUpFrameCount) {
+                newScale = std::min(1.0f, m_scale + m_options.ScaleUpStep);
+                m_framesBelowThreshold = 0;
+            }
+        } else {
+            m_framesBelowThreshold = 0;
+        }
+
+        if (newScale != m_scale) {
+            DEBUG_PRINT("Render scale changed from %.2f to %.2f, GPU frame time %.2f ms of %.2f ms.",
+                        m_scale,
+                        newScale,
+                        gpuMilliseconds,
+                        displayPeriodMilliseconds);
+            m_scale = newScale;
+            m_firstFrameAtScale = currentFrameIndex;
+        }
+    }
+
+    XrRect2Di RenderScaleController::GetImageRect(uint32_t width, uint32_t height) const {
+        return {{0, 0}, {ScaleExtent(width, m_scale), ScaleExtent(height, m_scale)}};
+    }
+} // namespace sample
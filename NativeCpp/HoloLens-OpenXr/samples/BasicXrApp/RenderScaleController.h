@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace sample {
+    // Chooses how much of the allocated swapchain image a frame renders to, so that the GPU time of a frame stays within the
+    // display period.
+    //
+    // The scale shrinks by ScaleDownStep as soon as a frame's GPU time exceeds ScaleDownThreshold of the display period, and
+    // grows by ScaleUpStep only after the GPU time stayed below ScaleUpThreshold for ScaleUpFrameCount frames. The gap between
+    // the thresholds and the slower growth keep the scale from oscillating. GPU times arrive a few frames late, so samples of
+    // frames rendered before the last scale change are ignored.
+    class RenderScaleController {
+    public:
+        struct Options {
+            float MinScale = 0.6f;           // Of the width and height of the swapchain image.
+            float ScaleDownStep = 0.1f;
+            float ScaleUpStep = 0.05f;
+            float ScaleDownThreshold = 0.9f; // Fractions of the display period.
+            float ScaleUpThreshold = 0.7f;
+            uint32_t ScaleUpFrameCount = 60;
+        };
+
+        RenderScaleController() = default;
+        explicit RenderScaleController(const Options& options)
+            : m_options(options) {
+        }
+
+        // Returns to the full image size, e.g. when the session restarts.
+        void Reset();
+
+        // Takes the GPU time of the frame gpuFrameIndex into account. currentFrameIndex is the frame about to be rendered.
+        // Passing the same gpuFrameIndex again has no effect.
+        void Update(uint64_t gpuFrameIndex, float gpuMilliseconds, float displayPeriodMilliseconds, uint64_t currentFrameIndex);
+
+        float GetScale() const {
+            return m_scale;
+        }
+
+        // The rect at the origin of an image of the given size to render to with the current scale.
+        XrRect2Di GetImageRect(uint32_t width, uint32_t height) const;
+
+    private:
+        Options m_options;
+        float m_scale = 1.0f;
+        uint32_t m_framesBelowThreshold = 0;
+        uint64_t m_firstFrameAtScale = 0;
+        uint64_t m_lastGpuFrameIndex = 0;
+        bool m_hasGpuFrame = false;
+    };
+} // namespace sample
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "ReprojectionPolicy.h"
+
+namespace sample {
+    void ReprojectionPolicy::Initialize(const std::vector<XrReprojectionModeMSFT>& supportedModes) {
+        m_supportedModes = 0;
+        for (const XrReprojectionModeMSFT mode : supportedModes) {
+            if (mode >= 0 && mode < 32) {
+                m_supportedModes |= 1u << mode;
+            }
+        }
+    }
+
+    std::optional<XrReprojectionModeMSFT> ReprojectionPolicy::Apply(const FrameInput& input, XrCompositionLayerProjection& layer) {
+        using namespace xr::math;
+        std::optional<XrReprojectionModeMSFT> mode;
+        std::optional<XrVector3f> planeNormal;
+        if (input.DepthSubmitted && IsSupported(XR_REPROJECTION_MODE_DEPTH_MSFT)) {
+            mode = XR_REPROJECTION_MODE_DEPTH_MSFT;
+        } else if (input.DepthSubmitted && IsSupported(XR_REPROJECTION_MODE_PLANAR_FROM_DEPTH_MSFT)) {
+            mode = XR_REPROJECTION_MODE_PLANAR_FROM_DEPTH_MSFT;
+        } else if (input.FocusPositionInAppSpace.has_value() && IsSupported(XR_REPROJECTION_MODE_PLANAR_MANUAL_MSFT)) {
+            const XrVector3f toViewer = input.ViewerPositionInAppSpace - input.FocusPositionInAppSpace.value();
+            if (Length(toViewer) > 0.01f) {
+                mode = XR_REPROJECTION_MODE_PLANAR_MANUAL_MSFT;
+                planeNormal = Normalize(toViewer);
+            }
+        }
+
+        if (!mode.has_value()) {
+            return std::nullopt;
+        }
+
+        m_reprojectionInfo = {XR_TYPE_COMPOSITION_LAYER_REPROJECTION_INFO_MSFT};
+        m_reprojectionInfo.reprojectionMode = mode.value();
+        m_reprojectionInfo.next = layer.next;
+        layer.next = &m_reprojectionInfo;
+
+        if (planeNormal.has_value()) {
+            // The focus content is static, so the plane has no velocity.
+            m_planeOverride = {XR_TYPE_COMPOSITION_LAYER_REPROJECTION_PLANE_OVERRIDE_MSFT};
+            m_planeOverride.position = input.FocusPositionInAppSpace.value();
+            m_planeOverride.normal = planeNormal.value();
+            m_planeOverride.velocity = {0, 0, 0};
+            m_planeOverride.next = layer.next;
+            layer.next = &m_planeOverride;
+        }
+        return mode;
+    }
+
+    const char* ReprojectionPolicy::ToString(std::optional<XrReprojectionModeMSFT> mode) {
+        if (!mode.has_value()) {
+            return "Default";
+        }
+        switch (mode.value()) {
+        case XR_REPROJECTION_MODE_DEPTH_MSFT:
+            return "Depth";
+        case XR_REPROJECTION_MODE_PLANAR_FROM_DEPTH_MSFT:
+            return "PlanarFromDepth";
+        case XR_REPROJECTION_MODE_PLANAR_MANUAL_MSFT:
+            return "PlanarManual";
+        case XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT:
+            return "OrientationOnly";
+        default:
+            return "Unknown";
+        }
+    }
+
+    bool ReprojectionPolicy::IsSupported(XrReprojectionModeMSFT mode) const {
+        return (m_supportedModes & (1u << mode)) != 0;
+    }
+} // namespace sample
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+
+namespace sample {
+    // Chooses the reprojection mode of the projection layer every frame from the modes the system supports:
+    // - Depth reprojection when the layer carries a depth buffer. The submitted depth holds the remote depth merged with the
+    //   local content, so the remote frame is stabilized over its full depth range. Planar from depth if only that is supported.
+    // - Otherwise a manual plane through the focus point facing the viewer, which keeps the content the user looks at, e.g. a
+    //   static CAD model, stable while the rest may swim slightly.
+    // - Otherwise no hint, so the runtime picks its default.
+    //
+    // The chosen structs are owned by the policy and chained into the layer, so they must stay alive until xrEndFrame.
+    class ReprojectionPolicy {
+    public:
+        struct FrameInput {
+            bool DepthSubmitted{false};
+            std::optional<XrVector3f> FocusPositionInAppSpace;
+            XrVector3f ViewerPositionInAppSpace{};
+        };
+
+        // Takes the reprojection modes the system supports. Without any, e.g. without the extension, no mode is ever requested.
+        void Initialize(const std::vector<XrReprojectionModeMSFT>& supportedModes);
+
+        // Prepends the structs of the chosen mode to the layer's next chain. Returns the chosen mode, or nullopt if the runtime
+        // picks the mode.
+        std::optional<XrReprojectionModeMSFT> Apply(const FrameInput& input, XrCompositionLayerProjection& layer);
+
+        static const char* ToString(std::optional<XrReprojectionModeMSFT> mode);
+
+    private:
+        bool IsSupported(XrReprojectionModeMSFT mode) const;
+
+        uint32_t m_supportedModes{0}; // Bit per XrReprojectionModeMSFT value.
+        XrCompositionLayerReprojectionInfoMSFT m_reprojectionInfo{XR_TYPE_COMPOSITION_LAYER_REPROJECTION_INFO_MSFT};
+        XrCompositionLayerReprojectionPlaneOverrideMSFT m_planeOverride{XR_TYPE_COMPOSITION_LAYER_REPROJECTION_PLANE_OVERRIDE_MSFT};
+    };
+} // namespace sample
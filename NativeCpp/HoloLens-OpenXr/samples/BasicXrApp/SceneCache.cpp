@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "SceneCache.h"
+
+#if XR_MSFT_scene_understanding_serialization_preview
+#include <fstream>
+
+namespace {
+    constexpr uint32_t FileMagic = 0x43535258; // "XRSC"
+    constexpr uint32_t FileVersion = 1;
+
+    // Followed by one uint64_t size per fragment, then the fragment data in the same order.
+    struct FileHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t FragmentCount;
+        uint32_t Reserved;
+    };
+
+    // FNV-1a, which unlike std::hash is guaranteed to give the same value in every build and process.
+    uint64_t HashKey(std::string_view key) {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : key) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+        }
+        return hash;
+    }
+} // namespace
+
+namespace sample {
+    SceneCache::SceneCache(std::filesystem::path folder)
+        : m_folder(std::move(folder)) {
+    }
+
+    std::shared_ptr<const std::vector<XrDeserializeSceneFragmentMSFT>> SceneCache::Open(std::string_view key) const {
+        const std::filesystem::path path = GetPath(key);
+        winrt::file_handle file(CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr));
+        if (!file) {
+            return nullptr;
+        }
+
+        FILE_STANDARD_INFO fileInfo{};
+        if (!GetFileInformationByHandleEx(file.get(), FileStandardInfo, &fileInfo, sizeof(fileInfo)) ||
+            fileInfo.EndOfFile.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader))) {
+            return nullptr;
+        }
+        const uint64_t fileSize = static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart);
+
+        const winrt::handle mapping(CreateFileMappingFromApp(file.get(), nullptr, PAGE_READONLY, 0, nullptr));
+        if (!mapping) {
+            DEBUG_PRINT("Failed to map the scene cache file %ls (%u).", path.c_str(), GetLastError());
+            return nullptr;
+        }
+
+        // The view stays valid after the file and mapping handles are closed, until it is unmapped.
+        const std::shared_ptr<const uint8_t> view(static_cast<const uint8_t*>(MapViewOfFileFromApp(mapping.get(), FILE_MAP_READ, 0, 0)),
+                                                  [](const uint8_t* data) {
+                                                      if (data != nullptr) {
+                                                          UnmapViewOfFile(data);
+                                                      }
+                                                  });
+        if (view == nullptr) {
+            DEBUG_PRINT("Failed to map the scene cache file %ls (%u).", path.c_str(), GetLastError());
+            return nullptr;
+        }
+
+        // The file is written by this app, but may be left over from another version or damaged, so every size is checked.
+        FileHeader header;
+        memcpy(&header, view.get(), sizeof(header));
+        if (header.Magic != FileMagic || header.Version != FileVersion || header.FragmentCount == 0 ||
+            header.FragmentCount > (fileSize - sizeof(FileHeader)) / sizeof(uint64_t)) {
+            DEBUG_PRINT("Ignoring the invalid scene cache file %ls.", path.c_str());
+            return nullptr;
+        }
+
+        // The fragments share ownership of the view, so they keep the file mapped.
+        using MappedFragments = std::pair<std::shared_ptr<const uint8_t>, std::vector<XrDeserializeSceneFragmentMSFT>>;
+        const auto mapped = std::make_shared<MappedFragments>(view, std::vector<XrDeserializeSceneFragmentMSFT>(header.FragmentCount));
+        std::vector<XrDeserializeSceneFragmentMSFT>& fragments = mapped->second;
+        uint64_t offset = sizeof(FileHeader) + header.FragmentCount * sizeof(uint64_t);
+        for (uint32_t k = 0; k < header.FragmentCount; k++) {
+            uint64_t size;
+            memcpy(&size, view.get() + sizeof(FileHeader) + k * sizeof(uint64_t), sizeof(size));
+            if (size == 0 || size > UINT32_MAX || size > fileSize - offset) {
+                DEBUG_PRINT("Ignoring the truncated scene cache file %ls.", path.c_str());
+                return nullptr;
+            }
+
+            fragments[k].size = static_cast<uint32_t>(size);
+            fragments[k].buffer = view.get() + offset;
+            offset += size;
+        }
+
+        return std::shared_ptr<const std::vector<XrDeserializeSceneFragmentMSFT>>(mapped, &fragments);
+    }
+
+    void SceneCache::Write(std::string_view key, const std::vector<std::vector<uint8_t>>& fragments) const {
+        if (fragments.empty()) {
+            return;
+        }
+
+        const std::filesystem::path path = GetPath(key);
+        std::filesystem::path tempPath = path;
+        tempPath += L".tmp";
+
+        std::error_code error;
+        std::filesystem::create_directories(m_folder, error);
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            const FileHeader header{FileMagic, FileVersion, static_cast<uint32_t>(fragments.size()), 0};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const std::vector<uint8_t>& fragment : fragments) {
+                const uint64_t size = fragment.size();
+                file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            }
+            for (const std::vector<uint8_t>& fragment : fragments) {
+                file.write(reinterpret_cast<const char*>(fragment.data()), static_cast<std::streamsize>(fragment.size()));
+            }
+            if (!file) {
+                DEBUG_PRINT("Failed to write the scene cache file %ls.", tempPath.c_str());
+                return;
+            }
+        }
+
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            DEBUG_PRINT("Failed to replace the scene cache file %ls: %s", path.c_str(), error.message().c_str());
+        }
+    }
+
+    std::filesystem::path SceneCache::GetPath(std::string_view key) const {
+        char fileName[32];
+        sprintf_s(fileName, "%016llx.xrscene", HashKey(key));
+        return m_folder / fileName;
+    }
+} // namespace sample
+#endif
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if XR_MSFT_scene_understanding_serialization_preview
+#include <filesystem>
+#include <string_view>
+
+namespace sample {
+    // Keeps serialized scenes in files, one per key, so that a room can be shown right after the next launch while the first
+    // scene compute is still running. The key names what the scene belongs to, e.g. a persisted spatial anchor in the room.
+    //
+    // Open maps the file into memory and returns the fragments in place, so nothing is copied before xrDeserializeSceneMSFT.
+    // Write goes to a temporary file that replaces the cached one, so an interrupted write never leaves a truncated scene.
+    class SceneCache {
+    public:
+        explicit SceneCache(std::filesystem::path folder);
+
+        // Returns the fragments of the cached scene, which keep the file mapped while referenced, or nullptr if no valid scene is
+        // cached for the key.
+        std::shared_ptr<const std::vector<XrDeserializeSceneFragmentMSFT>> Open(std::string_view key) const;
+
+        // Replaces the cached scene of the key. Errors are logged and leave the previous scene in place. Can be called from a
+        // background thread, but not concurrently for the same key.
+        void Write(std::string_view key, const std::vector<std::vector<uint8_t>>& fragments) const;
+
+    private:
+        std::filesystem::path GetPath(std::string_view key) const;
+
+        const std::filesystem::path m_folder;
+    };
+} // namespace sample
+#endif
@@ -0,0 +1,298 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#ifdef USE_REMOTE_RENDERING
+#include "OpenXrProgram.h"
+#include "SessionPool.h"
+
+#include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Windows.Storage.h>
+
+namespace {
+    constexpr wchar_t OwnedSessionIdsSetting[] = L"OwnedRenderingSessionIds";
+    constexpr char OwnedSessionIdSeparator = ';';
+} // namespace
+
+namespace sample {
+    SessionPool::SessionPool(RR::ApiHandle<RR::RemoteRenderingClient> client, Options options)
+        : m_client(std::move(client))
+        , m_options(options) {
+    }
+
+    void SessionPool::AcquireSessionAsync(SessionCallback callback) {
+        if (m_standbySession != nullptr) {
+            // The standby is already tracked, so its lease keeps being renewed.
+            RR::ApiHandle<RR::RenderingSession> session = std::move(m_standbySession);
+            m_standbySession = nullptr;
+            callback(session, nullptr);
+            FillStandby();
+            return;
+        }
+
+        OpenOrCreateSessionAsync(
+            [this, callback = std::move(callback)](RR::ApiHandle<RR::RenderingSession> session, const char* errorMessage) {
+                callback(session, errorMessage);
+                if (session != nullptr) {
+                    FillStandby();
+                }
+            });
+    }
+
+    void SessionPool::Update(double nowInSeconds) {
+        if (nowInSeconds < m_nextRenewCheckTime) {
+            return;
+        }
+        m_nextRenewCheckTime = nowInSeconds + m_options.RenewCheckIntervalInSeconds;
+
+        for (TrackedSession& tracked : m_trackedSessions) {
+            RenewIfNeeded(tracked);
+        }
+    }
+
+    void SessionPool::Clear() {
+        m_trackedSessions.clear();
+        m_standbySession = nullptr;
+        m_standbyRequested = false;
+        m_generation++;
+    }
+
+    const RR::RenderingSessionProperties*
+    SessionPool::SelectReusableSession(const std::vector<RR::RenderingSessionProperties>& sessions) const {
+        const RR::RenderingSessionProperties* best = nullptr;
+        for (const RR::RenderingSessionProperties& properties : sessions) {
+            const bool usable =
+                properties.Status == RR::RenderingSessionStatus::Ready || properties.Status == RR::RenderingSessionStatus::Starting;
+            const int remainingLease = properties.MaxLeaseInMinutes - properties.ElapsedTimeInMinutes;
+            if (!usable || properties.Size != m_options.Size || remainingLease < m_options.MinRemainingLeaseInMinutes) {
+                continue;
+            }
+
+            const bool tracked = std::any_of(m_trackedSessions.begin(), m_trackedSessions.end(), [&](const TrackedSession& t) {
+                return t.Id == properties.Id;
+            });
+            if (tracked) {
+                continue;
+            }
+
+            const bool owned = std::find(m_options.OwnedSessionIds.begin(), m_options.OwnedSessionIds.end(), properties.Id) !=
+                               m_options.OwnedSessionIds.end();
+            if (!owned && !m_options.ReuseAnyAccountSession) {
+                continue;
+            }
+
+            // Prefer Ready over Starting sessions, then the one with the most lease time left.
+            if (best == nullptr) {
+                best = &properties;
+            } else {
+                const bool ready = properties.Status == RR::RenderingSessionStatus::Ready;
+                const bool bestReady = best->Status == RR::RenderingSessionStatus::Ready;
+                if ((ready && !bestReady) ||
+                    (ready == bestReady && remainingLease > best->MaxLeaseInMinutes - best->ElapsedTimeInMinutes)) {
+                    best = &properties;
+                }
+            }
+        }
+        return best;
+    }
+
+    void SessionPool::OpenOrCreateSessionAsync(SessionCallback callback) {
+        m_client->GetCurrentRenderingSessionsAsync(
+            [this, generation = m_generation, callback = std::move(callback)](
+                RR::Status status, RR::ApiHandle<RR::RenderingSessionPropertiesArrayResult> result) {
+                if (generation != m_generation) {
+                    return;
+                }
+
+                std::vector<RR::RenderingSessionProperties> sessions;
+                if (status == RR::Status::OK && result->GetContext().Result == RR::Result::Success) {
+                    sessions = result->GetSessionProperties();
+                    ForgetEndedSessions(sessions);
+                } else {
+                    // Listing is only an optimization, fall back to creating a new session.
+                    DEBUG_PRINT("Failed to list rendering sessions");
+                }
+
+                const RR::RenderingSessionProperties* reusable = SelectReusableSession(sessions);
+                if (reusable == nullptr) {
+                    CreateSessionAsync(std::move(callback));
+                    return;
+                }
+
+                DEBUG_PRINT("Reusing rendering session %s", reusable->Id.c_str());
+                m_client->OpenRenderingSessionAsync(
+                    reusable->Id,
+                    [this, generation, callback](RR::Status status, RR::ApiHandle<RR::CreateRenderingSessionResult> result) {
+                        if (generation == m_generation) {
+                            OnSessionResult(status, result, callback);
+                        }
+                    });
+            });
+    }
+
+    void SessionPool::CreateSessionAsync(SessionCallback callback) {
+        RR::RenderingSessionCreationOptions init;
+        init.MaxLeaseInMinutes = m_options.LeaseInMinutes;
+        init.Size = m_options.Size;
+        m_client->CreateNewRenderingSessionAsync(
+            init,
+            [this, generation = m_generation, callback = std::move(callback)](RR::Status status,
+                                                                               RR::ApiHandle<RR::CreateRenderingSessionResult> result) {
+                if (generation != m_generation) {
+                    return;
+                }
+                if (status == RR::Status::OK && result->GetContext().Result == RR::Result::Success) {
+                    AddOwnedSession(result->GetSession()->GetSessionUuid());
+                }
+                OnSessionResult(status, result, callback);
+            });
+    }
+
+    void SessionPool::OnSessionResult(RR::Status status,
+                                      const RR::ApiHandle<RR::CreateRenderingSessionResult>& result,
+                                      const SessionCallback& callback) {
+        if (status != RR::Status::OK) {
+            callback(nullptr, "failed");
+            return;
+        }
+
+        auto ctx = result->GetContext();
+        if (ctx.Result != RR::Result::Success) {
+            callback(nullptr, ctx.ErrorMessage.c_str());
+            return;
+        }
+
+        RR::ApiHandle<RR::RenderingSession> session = result->GetSession();
+        m_trackedSessions.push_back(TrackedSession{session->GetSessionUuid(), session});
+        callback(session, nullptr);
+    }
+
+    void SessionPool::AddOwnedSession(const std::string& id) {
+        m_options.OwnedSessionIds.push_back(id);
+        if (m_options.OwnedSessionIdsChanged) {
+            m_options.OwnedSessionIdsChanged(m_options.OwnedSessionIds);
+        }
+    }
+
+    void SessionPool::ForgetEndedSessions(const std::vector<RR::RenderingSessionProperties>& sessions) {
+        std::vector<std::string>& owned = m_options.OwnedSessionIds;
+        const size_t ownedCount = owned.size();
+        owned.erase(std::remove_if(owned.begin(),
+                                   owned.end(),
+                                   [&](const std::string& id) {
+                                       return std::none_of(sessions.begin(), sessions.end(), [&](const RR::RenderingSessionProperties& p) {
+                                           return p.Id == id && (p.Status == RR::RenderingSessionStatus::Ready ||
+                                                                 p.Status == RR::RenderingSessionStatus::Starting);
+                                       });
+                                   }),
+                    owned.end());
+        if (owned.size() != ownedCount && m_options.OwnedSessionIdsChanged) {
+            m_options.OwnedSessionIdsChanged(owned);
+        }
+    }
+
+    std::vector<std::string> SessionPool::LoadOwnedSessionIds() {
+        std::vector<std::string> ids;
+        const winrt::Windows::Foundation::IInspectable value =
+            winrt::Windows::Storage::ApplicationData::Current().LocalSettings().Values().TryLookup(OwnedSessionIdsSetting);
+        const std::string joined = winrt::to_string(winrt::unbox_value_or<winrt::hstring>(value, L""));
+        size_t begin = 0;
+        while (begin < joined.size()) {
+            size_t end = joined.find(OwnedSessionIdSeparator, begin);
+            if (end == std::string::npos) {
+                end = joined.size();
+            }
+            if (end > begin) {
+                ids.push_back(joined.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+        return ids;
+    }
+
+    void SessionPool::StoreOwnedSessionIds(const std::vector<std::string>& ownedSessionIds) {
+        std::string joined;
+        for (const std::string& id : ownedSessionIds) {
+            if (!joined.empty()) {
+                joined += OwnedSessionIdSeparator;
+            }
+            joined += id;
+        }
+        winrt::Windows::Storage::ApplicationData::Current().LocalSettings().Values().Insert(OwnedSessionIdsSetting,
+                                                                                            winrt::box_value(winrt::to_hstring(joined)));
+    }
+
+    void SessionPool::FillStandby() {
+        if (!m_options.KeepWarmStandby || m_standbySession != nullptr || m_standbyRequested) {
+            return;
+        }
+
+        m_standbyRequested = true;
+        OpenOrCreateSessionAsync([this](RR::ApiHandle<RR::RenderingSession> session, const char* errorMessage) {
+            m_standbyRequested = false;
+            if (session != nullptr) {
+                m_standbySession = session;
+            } else {
+                DEBUG_PRINT("Failed to start standby session: %s", errorMessage);
+            }
+        });
+    }
+
+    SessionPool::TrackedSession* SessionPool::FindTracked(const std::string& id) {
+        auto it = std::find_if(m_trackedSessions.begin(), m_trackedSessions.end(), [&](const TrackedSession& t) { return t.Id == id; });
+        return it != m_trackedSessions.end() ? &*it : nullptr;
+    }
+
+    void SessionPool::Untrack(const std::string& id) {
+        m_trackedSessions.erase(
+            std::remove_if(m_trackedSessions.begin(), m_trackedSessions.end(), [&](const TrackedSession& t) { return t.Id == id; }),
+            m_trackedSessions.end());
+
+        if (m_standbySession != nullptr && m_standbySession->GetSessionUuid() == id) {
+            m_standbySession = nullptr;
+            FillStandby();
+        }
+    }
+
+    void SessionPool::RenewIfNeeded(TrackedSession& tracked) {
+        if (tracked.RenewInProgress) {
+            return;
+        }
+        tracked.RenewInProgress = true;
+
+        tracked.Session->GetPropertiesAsync(
+            [this, generation = m_generation, id = tracked.Id](RR::Status status,
+                                                                RR::ApiHandle<RR::RenderingSessionPropertiesResult> propertiesResult) {
+                TrackedSession* tracked = generation == m_generation ? FindTracked(id) : nullptr;
+                if (tracked == nullptr) {
+                    return;
+                }
+                tracked->RenewInProgress = false;
+
+                if (status != RR::Status::OK || propertiesResult->GetContext().Result != RR::Result::Success) {
+                    return; // Try again on the next check.
+                }
+
+                const RR::RenderingSessionProperties properties = propertiesResult->GetSessionProperties();
+                if (properties.Status == RR::RenderingSessionStatus::Error || properties.Status == RR::RenderingSessionStatus::Stopped ||
+                    properties.Status == RR::RenderingSessionStatus::Expired) {
+                    Untrack(id);
+                    return;
+                }
+
+                if (properties.MaxLeaseInMinutes - properties.ElapsedTimeInMinutes >= m_options.RenewThresholdInMinutes) {
+                    return;
+                }
+
+                RR::RenderingSessionUpdateOptions update;
+                update.MaxLeaseInMinutes = properties.MaxLeaseInMinutes + m_options.RenewIncrementInMinutes;
+                tracked->Session->RenewAsync(update, [id](RR::Status status, RR::ApiHandle<RR::SessionContextResult> result) {
+                    if (status != RR::Status::OK || result->GetContext().Result != RR::Result::Success) {
+                        DEBUG_PRINT("Failed to renew the lease of rendering session %s", id.c_str());
+                    }
+                });
+            });
+    }
+} // namespace sample
+#endif
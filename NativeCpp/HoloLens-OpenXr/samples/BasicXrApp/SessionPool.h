@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#ifdef USE_REMOTE_RENDERING
+#include <functional>
+
+namespace sample {
+    // Hands out rendering sessions, preferring ones that are already running over starting a new VM.
+    //
+    // Acquiring a session first takes the warm standby, if there is one. Otherwise it lists the account's sessions and
+    // opens the best Ready (or else Starting) session of the requested size that has enough lease time left, the same
+    // information RenderingSession.ps1 GetSessions reports. Only sessions this client created are reused, since connecting
+    // to a session takes it over from whoever is rendering in it. A new session is only created when nothing can be reused.
+    // Update renews the leases of the sessions handed out by the pool before they expire.
+    class SessionPool {
+    public:
+        struct Options {
+            RR::RenderingSessionVmSize Size = RR::RenderingSessionVmSize::Standard;
+            int LeaseInMinutes = 10;            // Lease of newly created sessions.
+            int MinRemainingLeaseInMinutes = 3; // Sessions with less lease time left are not reused.
+            int RenewThresholdInMinutes = 3;    // Leases are extended once less than this is left...
+            int RenewIncrementInMinutes = 10;   // ...by this many minutes.
+            double RenewCheckIntervalInSeconds = 60.0;
+            bool KeepWarmStandby = false;       // Keeps a second session running for fast reconnects. Standby VMs are billed too.
+
+            // Ids of the sessions this client created, for example stored by an earlier run of the app. These may be reused,
+            // sessions the pool creates are added and sessions that ended are removed.
+            std::vector<std::string> OwnedSessionIds;
+
+            // Called whenever OwnedSessionIds changes, for example with StoreOwnedSessionIds.
+            std::function<void(const std::vector<std::string>& ownedSessionIds)> OwnedSessionIdsChanged;
+
+            // Also reuses sessions that other clients of the account created, and may be rendering in right now.
+            bool ReuseAnyAccountSession = false;
+        };
+
+        // On failure session is null and errorMessage describes the error.
+        using SessionCallback = std::function<void(RR::ApiHandle<RR::RenderingSession> session, const char* errorMessage)>;
+
+        SessionPool(RR::ApiHandle<RR::RemoteRenderingClient> client, Options options);
+
+        // Acquires a session asynchronously. The session may still be starting when the callback is invoked.
+        void AcquireSessionAsync(SessionCallback callback);
+
+        // Renews leases when due. Call once per frame.
+        void Update(double nowInSeconds);
+
+        // Stops tracking all sessions. The sessions themselves keep running until their lease ends, so they can be reused later.
+        void Clear();
+
+        // Ids of the sessions this client created. Store them to reuse the sessions after the app restarts.
+        const std::vector<std::string>& GetOwnedSessionIds() const {
+            return m_options.OwnedSessionIds;
+        }
+
+        // Loads and stores the owned session ids in the app's local settings, so that the next launch reuses the sessions.
+        static std::vector<std::string> LoadOwnedSessionIds();
+        static void StoreOwnedSessionIds(const std::vector<std::string>& ownedSessionIds);
+
+    private:
+        struct TrackedSession {
+            std::string Id;
+            RR::ApiHandle<RR::RenderingSession> Session;
+            bool RenewInProgress = false;
+        };
+
+        // Picks the untracked session to reuse out of the account's sessions, or returns nullptr if none fits.
+        const RR::RenderingSessionProperties* SelectReusableSession(const std::vector<RR::RenderingSessionProperties>& sessions) const;
+        void OpenOrCreateSessionAsync(SessionCallback callback);
+        void CreateSessionAsync(SessionCallback callback);
+        void OnSessionResult(RR::Status status,
+                             const RR::ApiHandle<RR::CreateRenderingSessionResult>& result,
+                             const SessionCallback& callback);
+        void AddOwnedSession(const std::string& id);
+        // Removes the owned sessions that are no longer listed as Ready or Starting.
+        void ForgetEndedSessions(const std::vector<RR::RenderingSessionProperties>& sessions);
+        void FillStandby();
+        TrackedSession* FindTracked(const std::string& id);
+        void Untrack(const std::string& id);
+        void RenewIfNeeded(TrackedSession& tracked);
+
+        RR::ApiHandle<RR::RemoteRenderingClient> m_client;
+        Options m_options;
+        std::vector<TrackedSession> m_trackedSessions;
+        RR::ApiHandle<RR::RenderingSession> m_standbySession;
+        bool m_standbyRequested = false;
+        double m_nextRenewCheckTime = 0;
+        uint64_t m_generation = 0;
+    };
+} // namespace sample
+#endif
@@ -0,0 +1,229 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "SpatialAnchorStore.h"
+
+#if XR_MSFT_spatial_anchor_persistence_preview
+#include <string_view>
+#include <unordered_set>
+
+namespace sample {
+    SpatialAnchorStore::SpatialAnchorStore(Options options)
+        : m_options(std::move(options)) {
+    }
+
+    bool SpatialAnchorStore::Connect(const xr::ExtensionDispatchTable& extensions, XrSession session) {
+        CHECK(!m_connection);
+        m_extensions = &extensions;
+        m_session = session;
+
+        const XrResult result = extensions.xrCreateSpatialAnchorStoreConnectionMSFT(
+            session, m_connection.Put(extensions.xrDestroySpatialAnchorStoreConnectionMSFT));
+        if (XR_FAILED(result)) {
+            DEBUG_PRINT("The spatial anchor store is not available (%d), placed holograms are not persisted.", result);
+            return false;
+        }
+
+        uint32_t count = 0;
+        CHECK_XRCMD(extensions.xrEnumeratePersistedSpatialAnchorNamesMSFT(m_connection.Get(), 0, &count, nullptr));
+        std::vector<XrSpatialAnchorPersistenceNameMSFT> names(count);
+        CHECK_XRCMD(extensions.xrEnumeratePersistedSpatialAnchorNamesMSFT(m_connection.Get(), count, &count, names.data()));
+        names.resize(count);
+
+        // Anchors known from a previous session keep their last known pose, so the nearby ones are activated first.
+        // Reserve first, so that the names the set refers to don't move.
+        const size_t knownCount = m_anchors.size();
+        m_anchors.reserve(knownCount + names.size());
+        std::unordered_set<std::string_view> knownNames;
+        for (Anchor& anchor : m_anchors) {
+            anchor.Unlocatable = false;
+            knownNames.insert(anchor.Name);
+        }
+
+        for (const XrSpatialAnchorPersistenceNameMSFT& name : names) {
+            if (knownNames.count(name.name) == 0) {
+                Anchor& anchor = m_anchors.emplace_back();
+                anchor.Name = name.name;
+                anchor.Persisted = true;
+            }
+        }
+        m_candidates.reserve(m_anchors.size());
+
+        DEBUG_PRINT("Found %u persisted anchors, %zu of them new to this run.", count, m_anchors.size() - knownCount);
+        return true;
+    }
+
+    void SpatialAnchorStore::Disconnect() {
+        if (!m_connection) {
+            return;
+        }
+
+        const uint32_t persistedCount = PersistPending();
+        if (persistedCount > 0) {
+            DEBUG_PRINT("Persisted %u anchors.", persistedCount);
+        }
+
+        // Anchors that couldn't be persisted can't be restored without their handle.
+        m_anchors.erase(std::remove_if(m_anchors.begin(), m_anchors.end(), [](const Anchor& anchor) { return !anchor.Persisted; }),
+                        m_anchors.end());
+        for (Anchor& anchor : m_anchors) {
+            anchor.Cube.Space.Reset();
+            anchor.Handle.Reset();
+            anchor.UnlocatedFrames = 0;
+        }
+
+        m_activeCount = 0;
+        m_nextDiscovery = 0;
+        m_connection.Reset();
+        m_session = XR_NULL_HANDLE;
+    }
+
+    void SpatialAnchorStore::Add(xr::SpatialAnchorHandle anchor,
+                                 xr::SpaceHandle space,
+                                 const XrPosef& poseInAppSpace,
+                                 XrTime placementTime) {
+        CHECK(m_connection);
+
+        // Names only need to be unique within the store, which also holds the anchors of previous launches.
+        std::string name;
+        do {
+            name = "BasicXrApp.Hologram." + std::to_string(placementTime) + "." + std::to_string(m_nameCounter++);
+        } while (std::any_of(m_anchors.begin(), m_anchors.end(), [&](const Anchor& other) { return other.Name == name; }));
+        CHECK(name.size() < XR_MAX_SPATIAL_ANCHOR_NAME_SIZE_MSFT);
+
+        Anchor& added = m_anchors.emplace_back();
+        added.Name = std::move(name);
+        added.Handle = std::move(anchor);
+        added.Cube.Space = std::move(space);
+        added.Cube.PoseInAppSpace = poseInAppSpace;
+        added.LastPoseInAppSpace = poseInAppSpace;
+        m_activeCount++;
+        m_candidates.reserve(m_anchors.size());
+    }
+
+    uint32_t SpatialAnchorStore::PersistPending() {
+        if (!m_connection) {
+            return 0;
+        }
+
+        // The extension persists one anchor per call, so all new anchors are persisted together rather than on placement.
+        uint32_t persistedCount = 0;
+        for (Anchor& anchor : m_anchors) {
+            if (anchor.Persisted || !anchor.Handle) {
+                continue;
+            }
+
+            XrSpatialAnchorPersistenceInfoMSFT persistenceInfo{XR_TYPE_SPATIAL_ANCHOR_PERSISTENCE_INFO_MSFT};
+            strcpy_s(persistenceInfo.spatialAnchorPersistenceName.name, anchor.Name.c_str());
+            persistenceInfo.spatialAnchor = anchor.Handle.Get();
+
+            const XrResult result = m_extensions->xrPersistSpatialAnchorMSFT(m_connection.Get(), &persistenceInfo);
+            if (XR_FAILED(result)) {
+                DEBUG_PRINT("Anchor %s cannot be persisted (%d).", anchor.Name.c_str(), result);
+                continue;
+            }
+
+            anchor.Persisted = true;
+            persistedCount++;
+            if (!anchor.Cube.Space) {
+                // Released while waiting to be persisted, the store can restore it from now on.
+                anchor.Handle.Reset();
+            }
+        }
+        return persistedCount;
+    }
+
+    void SpatialAnchorStore::Update(const XrVector3f& userPositionInAppSpace) {
+        if (!m_connection) {
+            return;
+        }
+
+        const float activationDistanceSquared = m_options.ActivationDistance * m_options.ActivationDistance;
+        const float releaseDistanceSquared = m_options.ReleaseDistance * m_options.ReleaseDistance;
+
+        // Release the anchors the user moved away from, and the ones that could not be located since their activation.
+        m_candidates.clear();
+        for (Anchor& anchor : m_anchors) {
+            if (anchor.Cube.Space) {
+                if (anchor.LastPoseInAppSpace.has_value()) {
+                    if (DistanceSquared(anchor.LastPoseInAppSpace->position, userPositionInAppSpace) > releaseDistanceSquared) {
+                        Release(anchor);
+                    }
+                } else if (++anchor.UnlocatedFrames > m_options.DiscoveryFrames) {
+                    anchor.Unlocatable = true;
+                    Release(anchor);
+                }
+            } else if (!anchor.Unlocatable && anchor.LastPoseInAppSpace.has_value() &&
+                       DistanceSquared(anchor.LastPoseInAppSpace->position, userPositionInAppSpace) <= activationDistanceSquared) {
+                m_candidates.push_back(&anchor);
+            }
+        }
+
+        // Activate the nearest anchors first, within the per-frame budget.
+        uint32_t budget = m_options.MaxActivationsPerFrame;
+        const size_t activationCount = std::min<size_t>(budget, m_candidates.size());
+        std::partial_sort(m_candidates.begin(),
+                          m_candidates.begin() + activationCount,
+                          m_candidates.end(),
+                          [&](const Anchor* a, const Anchor* b) {
+                              return DistanceSquared(a->LastPoseInAppSpace->position, userPositionInAppSpace) <
+                                     DistanceSquared(b->LastPoseInAppSpace->position, userPositionInAppSpace);
+                          });
+        for (size_t k = 0; k < activationCount; k++, budget--) {
+            Activate(*m_candidates[k]);
+        }
+
+        // Spend the rest of the budget on finding out where the anchors without a known pose are.
+        while (budget > 0 && m_nextDiscovery < m_anchors.size()) {
+            Anchor& anchor = m_anchors[m_nextDiscovery++];
+            if (!anchor.Cube.Space && !anchor.Unlocatable && !anchor.LastPoseInAppSpace.has_value()) {
+                Activate(anchor);
+                budget--;
+            }
+        }
+    }
+
+    bool SpatialAnchorStore::Activate(Anchor& anchor) {
+        if (!anchor.Handle) {
+            XrSpatialAnchorFromPersistedAnchorCreateInfoMSFT createInfo{XR_TYPE_SPATIAL_ANCHOR_FROM_PERSISTED_ANCHOR_CREATE_INFO_MSFT};
+            createInfo.spatialAnchorStore = m_connection.Get();
+            strcpy_s(createInfo.spatialAnchorPersistenceName.name, anchor.Name.c_str());
+
+            const XrResult result = m_extensions->xrCreateSpatialAnchorFromPersistedNameMSFT(
+                m_session, &createInfo, anchor.Handle.Put(m_extensions->xrDestroySpatialAnchorMSFT));
+            if (XR_FAILED(result)) {
+                DEBUG_PRINT("Anchor %s cannot be restored (%d).", anchor.Name.c_str(), result);
+                anchor.Unlocatable = true;
+                return false;
+            }
+        }
+
+        XrSpatialAnchorSpaceCreateInfoMSFT createSpaceInfo{XR_TYPE_SPATIAL_ANCHOR_SPACE_CREATE_INFO_MSFT};
+        createSpaceInfo.anchor = anchor.Handle.Get();
+        createSpaceInfo.poseInAnchorSpace = xr::math::Pose::Identity();
+        CHECK_XRCMD(m_extensions->xrCreateSpatialAnchorSpaceMSFT(m_session, &createSpaceInfo, anchor.Cube.Space.Put()));
+
+        anchor.UnlocatedFrames = 0;
+        m_activeCount++;
+        return true;
+    }
+
+    void SpatialAnchorStore::Release(Anchor& anchor) {
+        anchor.Cube.Space.Reset();
+        if (anchor.Persisted) {
+            // Anchors that are not persisted yet have no other way back, so they keep their anchor handle.
+            anchor.Handle.Reset();
+        }
+        m_activeCount--;
+    }
+
+    float SpatialAnchorStore::DistanceSquared(const XrVector3f& a, const XrVector3f& b) {
+        const float x = a.x - b.x;
+        const float y = a.y - b.y;
+        const float z = a.z - b.z;
+        return x * x + y * y + z * z;
+    }
+} // namespace sample
+#endif
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if XR_MSFT_spatial_anchor_persistence_preview
+#include <optional>
+#include <string>
+#include <vector>
+#include "OpenXrProgram.h"
+
+namespace xr {
+    class SpatialAnchorStoreConnectionHandle : public UniqueExtHandle<XrSpatialAnchorStoreConnectionMSFT> {};
+} // namespace xr
+
+namespace sample {
+    // Keeps the placed holograms of the sample in the persisted spatial anchor store, and only holds anchor spaces for the anchors
+    // near the user.
+    //
+    // Connect lists the persisted anchor names with a single call and creates no anchor. Update then activates anchors, i.e.
+    // creates the anchor from its persisted name and an anchor space for it, at most MaxActivationsPerFrame per frame:
+    // - Anchors whose last known pose is within ActivationDistance of the user, nearest first.
+    // - Anchors that were never located, e.g. persisted by a previous launch, so that their location becomes known. If such an
+    //   anchor isn't located within DiscoveryFrames, it is released and not tried again until the next Connect.
+    // Active anchors farther than ReleaseDistance are released again; the name and the last known pose stay for a later
+    // activation. New anchors are persisted in one batch by PersistPending, which Disconnect calls before a session restart.
+    //
+    // Anchor entries are never removed while connected, so pointers to Anchor::Cube stay valid until the next Add or Connect.
+    class SpatialAnchorStore {
+    public:
+        struct Options {
+            float ActivationDistance = 10.0f; // In meters.
+            float ReleaseDistance = 15.0f;    // Larger than ActivationDistance, so anchors at the border don't flip every frame.
+            uint32_t MaxActivationsPerFrame = 4;
+            uint32_t DiscoveryFrames = 90;
+        };
+
+        struct Anchor {
+            std::string Name;
+            sample::Cube Cube; // Cube.Space is only valid while the anchor is active.
+            std::optional<XrPosef> LastPoseInAppSpace;
+            xr::SpatialAnchorHandle Handle;
+            bool Persisted{false};
+            bool Unlocatable{false};
+            uint32_t UnlocatedFrames{0}; // Frames the anchor was active while LastPoseInAppSpace was unknown.
+        };
+
+        SpatialAnchorStore() = default;
+        explicit SpatialAnchorStore(Options options);
+
+        // Connects to the anchor store of a new session and lists the persisted anchors. Anchors already known from a previous
+        // session keep their last known pose. Returns false if the store is not available.
+        bool Connect(const xr::ExtensionDispatchTable& extensions, XrSession session);
+
+        // Persists the new anchors and releases all handles of the session.
+        void Disconnect();
+
+        bool IsConnected() const noexcept {
+            return m_connection;
+        }
+
+        // Takes over the anchor and the anchor space of a newly placed hologram. The anchor is persisted by the next PersistPending.
+        void Add(xr::SpatialAnchorHandle anchor, xr::SpaceHandle space, const XrPosef& poseInAppSpace, XrTime placementTime);
+
+        // Persists all anchors that are not persisted yet. Returns the number of persisted anchors.
+        uint32_t PersistPending();
+
+        // Activates and releases anchors given the user position. Call once per frame before the active anchor spaces are located.
+        void Update(const XrVector3f& userPositionInAppSpace);
+
+        // The anchors in a stable order. Only anchors with a valid Cube.Space need to be located and rendered.
+        std::vector<Anchor>& GetAnchors() noexcept {
+            return m_anchors;
+        }
+
+        size_t GetActiveCount() const noexcept {
+            return m_activeCount;
+        }
+
+    private:
+        bool Activate(Anchor& anchor);
+        void Release(Anchor& anchor);
+        static float DistanceSquared(const XrVector3f& a, const XrVector3f& b);
+
+        Options m_options;
+        const xr::ExtensionDispatchTable* m_extensions{nullptr};
+        XrSession m_session{XR_NULL_HANDLE};
+        xr::SpatialAnchorStoreConnectionHandle m_connection;
+        std::vector<Anchor> m_anchors;
+        size_t m_activeCount{0};
+        size_t m_nextDiscovery{0}; // Anchors before this index were tried once without a known pose.
+        std::vector<Anchor*> m_candidates; // Reused by Update, only grows with the number of anchors.
+        uint32_t m_nameCounter{0};
+    };
+} // namespace sample
+#endif
@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#ifdef USE_REMOTE_RENDERING
+#include "OpenXrProgram.h"
+#include "SpatialQueryBroker.h"
+
+namespace {
+    // Rays closer than this in meters at both ends hit the same surfaces for the purpose of coalescing.
+    constexpr double SameRayTolerance = 0.001;
+
+    bool IsNear(const RR::Double3& a, const RR::Double3& b) {
+        return std::abs(a.X - b.X) <= SameRayTolerance && std::abs(a.Y - b.Y) <= SameRayTolerance &&
+               std::abs(a.Z - b.Z) <= SameRayTolerance;
+    }
+
+    bool IsSameQuery(const RR::RayCast& a, const RR::RayCast& b) {
+        return IsNear(a.StartPos, b.StartPos) && IsNear(a.EndPos, b.EndPos) && a.MaxHits == b.MaxHits &&
+               a.HitCollection == b.HitCollection && a.CollisionMask == b.CollisionMask;
+    }
+
+    // Returns the distance from start at which the segment from start to end enters the box, if it does.
+    std::optional<double> IntersectSegment(const RR::Double3& start, const RR::Double3& end, const RR::Bounds& bounds) {
+        const double origin[3] = {start.X, start.Y, start.Z};
+        const double direction[3] = {end.X - start.X, end.Y - start.Y, end.Z - start.Z};
+        const double min[3] = {bounds.Min.X, bounds.Min.Y, bounds.Min.Z};
+        const double max[3] = {bounds.Max.X, bounds.Max.Y, bounds.Max.Z};
+
+        // Slab test, with the segment parameterized from 0 at start to 1 at end.
+        double enter = 0.0;
+        double exit = 1.0;
+        for (int i = 0; i < 3; i++) {
+            if (direction[i] == 0.0) {
+                if (origin[i] < min[i] || origin[i] > max[i]) {
+                    return std::nullopt;
+                }
+                continue;
+            }
+
+            double t0 = (min[i] - origin[i]) / direction[i];
+            double t1 = (max[i] - origin[i]) / direction[i];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            enter = std::max(enter, t0);
+            exit = std::min(exit, t1);
+            if (enter > exit) {
+                return std::nullopt;
+            }
+        }
+
+        const double length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+        return enter * length;
+    }
+} // namespace
+
+namespace sample {
+    void SpatialQueryBroker::Reset(RR::ApiHandle<RR::RenderingConnection> connection) {
+        m_connection = std::move(connection);
+        m_entities.clear();
+        m_queued.clear();
+        m_sourcesInFlight.clear();
+        m_generation++;
+    }
+
+    void SpatialQueryBroker::SetEntity(const std::string& key, RR::ApiHandle<RR::Entity> entity) {
+        RemoveEntity(key);
+        if (entity == nullptr) {
+            return;
+        }
+
+        m_entities.push_back({key, entity, std::nullopt});
+
+        // The models are placed once they have loaded and don't move afterwards, so the bounds are queried only once.
+        entity->QueryWorldBoundsAsync([this, key, entity, generation = m_generation](RR::Status status, RR::Bounds bounds) {
+            if (generation != m_generation || status != RR::Status::OK) {
+                return;
+            }
+
+            for (EntityBounds& cached : m_entities) {
+                if (cached.Key == key && cached.Entity == entity) {
+                    cached.Bounds = bounds;
+                }
+            }
+        });
+    }
+
+    void SpatialQueryBroker::RemoveEntity(const std::string& key) {
+        auto matches = [&](const EntityBounds& cached) { return cached.Key == key; };
+        m_entities.erase(std::remove_if(m_entities.begin(), m_entities.end(), matches), m_entities.end());
+    }
+
+    std::optional<SpatialQueryBroker::CoarseHit> SpatialQueryBroker::HoverTest(const RR::Double3& start, const RR::Double3& end) const {
+        std::optional<CoarseHit> nearest;
+        for (const EntityBounds& cached : m_entities) {
+            if (!cached.Bounds.has_value()) {
+                continue;
+            }
+
+            const std::optional<double> distance = IntersectSegment(start, end, cached.Bounds.value());
+            if (distance.has_value() && (!nearest.has_value() || distance.value() < nearest->Distance)) {
+                nearest = CoarseHit{cached.Entity, distance.value()};
+            }
+        }
+        return nearest;
+    }
+
+    void SpatialQueryBroker::RayCast(uint32_t source, const RR::RayCast& rayCast, HitsCallback onHits) {
+        for (QueuedRayCast& queued : m_queued) {
+            if (queued.Sources.front() == source) {
+                queued.Cast = rayCast;
+                queued.Callbacks.push_back(std::move(onHits));
+                return;
+            }
+        }
+
+        QueuedRayCast& queued = m_queued.emplace_back();
+        queued.Cast = rayCast;
+        queued.Sources.push_back(source);
+        queued.Callbacks.push_back(std::move(onHits));
+    }
+
+    void SpatialQueryBroker::Flush() {
+        if (m_connection == nullptr || m_queued.empty()) {
+            return;
+        }
+
+        // Merge the sendable raycasts into as few queries as possible, the others stay queued.
+        std::vector<QueuedRayCast> sending;
+        std::vector<QueuedRayCast> waiting;
+        for (QueuedRayCast& queued : m_queued) {
+            if (IsInFlight(queued.Sources.front())) {
+                waiting.push_back(std::move(queued));
+                continue;
+            }
+
+            auto same = std::find_if(
+                sending.begin(), sending.end(), [&](const QueuedRayCast& query) { return IsSameQuery(query.Cast, queued.Cast); });
+            if (same == sending.end()) {
+                sending.push_back(std::move(queued));
+                continue;
+            }
+            same->Sources.push_back(queued.Sources.front());
+            std::move(queued.Callbacks.begin(), queued.Callbacks.end(), std::back_inserter(same->Callbacks));
+        }
+        m_queued = std::move(waiting);
+
+        for (QueuedRayCast& query : sending) {
+            m_sourcesInFlight.insert(m_sourcesInFlight.end(), query.Sources.begin(), query.Sources.end());
+
+            auto sent = std::make_shared<QueuedRayCast>(std::move(query));
+            m_connection->RayCastQueryAsync(
+                sent->Cast, [this, sent, generation = m_generation](RR::Status status, RR::ApiHandle<RR::RayCastQueryResult> result) {
+                    if (generation == m_generation) {
+                        OnRayCastCompleted(*sent, status, std::move(result));
+                    }
+                });
+        }
+    }
+
+    bool SpatialQueryBroker::IsInFlight(uint32_t source) const {
+        return std::find(m_sourcesInFlight.begin(), m_sourcesInFlight.end(), source) != m_sourcesInFlight.end();
+    }
+
+    void SpatialQueryBroker::OnRayCastCompleted(const QueuedRayCast& sent,
+                                                RR::Status status,
+                                                RR::ApiHandle<RR::RayCastQueryResult> result) {
+        for (uint32_t source : sent.Sources) {
+            m_sourcesInFlight.erase(std::find(m_sourcesInFlight.begin(), m_sourcesInFlight.end(), source));
+        }
+
+        std::vector<RR::RayCastHit> hits;
+        const RR::Result queryResult = RR::StatusToResult(status);
+        if (queryResult == RR::Result::Success) {
+            result->GetHits(hits);
+        }
+
+        // Callbacks may queue the next raycast of their source, which is sent with the next Flush.
+        for (const HitsCallback& onHits : sent.Callbacks) {
+            if (onHits) {
+                onHits(queryResult, hits);
+            }
+        }
+    }
+} // namespace sample
+#endif
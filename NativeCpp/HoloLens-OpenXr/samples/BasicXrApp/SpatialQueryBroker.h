@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#ifdef USE_REMOTE_RENDERING
+#include <functional>
+#include <optional>
+
+namespace sample {
+    // Sends the spatial queries of the input handling to the server with as few round trips as possible.
+    //
+    // Raycasts are queued during the frame and sent by Flush. A source, e.g. a hand, has at most one raycast on the server: a
+    // newer raycast of the same source replaces its queued one, and one queued while the previous is in flight waits for its
+    // result, so a moving pointer never builds up a backlog of stale queries. All callbacks of the replaced raycasts receive
+    // the hits of the one that was sent. Identical raycasts of different sources share one query.
+    //
+    // The world bounds of the loaded models are queried once and cached, so that hover tests are answered locally against the
+    // bounds without a round trip. Only precise hits, e.g. on select, go to the server.
+    class SpatialQueryBroker {
+    public:
+        // Invoked with the hits of a raycast, ordered by distance, or with an empty list if the query failed.
+        using HitsCallback = std::function<void(RR::Result result, const std::vector<RR::RayCastHit>& hits)>;
+
+        struct CoarseHit {
+            RR::ApiHandle<RR::Entity> Entity;
+            double Distance; // From the start of the ray to where it enters the bounds.
+        };
+
+        // Drops the cached bounds and the queued raycasts, and ignores the results of queries in flight.
+        void Reset(RR::ApiHandle<RR::RenderingConnection> connection);
+
+        // Caches the world bounds of the entity under the given key, replacing the entity previously set under it, e.g. when
+        // the full version of a model replaces the coarse one. The entity is only hover tested once its bounds arrived.
+        void SetEntity(const std::string& key, RR::ApiHandle<RR::Entity> entity);
+        void RemoveEntity(const std::string& key);
+
+        // Returns the nearest entity whose cached bounds the ray from start to end intersects. Answered locally.
+        std::optional<CoarseHit> HoverTest(const RR::Double3& start, const RR::Double3& end) const;
+
+        // Queues a precise raycast of the source, sent with the next Flush.
+        void RayCast(uint32_t source, const RR::RayCast& rayCast, HitsCallback onHits);
+
+        // Sends the queued raycasts. Call once per frame after the input has been handled.
+        void Flush();
+
+    private:
+        struct EntityBounds {
+            std::string Key;
+            RR::ApiHandle<RR::Entity> Entity;
+            std::optional<RR::Bounds> Bounds;
+        };
+
+        struct QueuedRayCast {
+            RR::RayCast Cast;
+            std::vector<uint32_t> Sources;
+            std::vector<HitsCallback> Callbacks;
+        };
+
+        bool IsInFlight(uint32_t source) const;
+        void OnRayCastCompleted(const QueuedRayCast& sent, RR::Status status, RR::ApiHandle<RR::RayCastQueryResult> result);
+
+        RR::ApiHandle<RR::RenderingConnection> m_connection;
+        std::vector<EntityBounds> m_entities;
+        std::vector<QueuedRayCast> m_queued; // At most one per source.
+        std::vector<uint32_t> m_sourcesInFlight;
+        uint64_t m_generation = 0;
+    };
+} // namespace sample
+#endif
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "StartupGraph.h"
+
+namespace sample {
+    StartupGraph::TaskId StartupGraph::Add(const char* name, Thread thread, std::vector<TaskId> dependencies, std::function<void()> work) {
+        const TaskId id = static_cast<TaskId>(m_tasks.size());
+        for (TaskId dependency : dependencies) {
+            CHECK_MSG(dependency < id, "Startup tasks can only depend on tasks added before them.");
+        }
+        m_tasks.push_back(Task{name, thread, std::move(dependencies), std::move(work)});
+        return id;
+    }
+
+    void StartupGraph::Run() {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> workers;
+        for (TaskId id = 0; id < m_tasks.size(); id++) {
+            if (m_tasks[id].RunOn == Thread::Worker) {
+                workers.emplace_back([this, id] { RunTask(id); });
+            }
+        }
+
+        for (TaskId id = 0; id < m_tasks.size(); id++) {
+            if (m_tasks[id].RunOn == Thread::Main) {
+                RunTask(id);
+            }
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        LogTimeline(start);
+
+        if (m_firstException) {
+            std::rethrow_exception(m_firstException);
+        }
+    }
+
+    void StartupGraph::RunTask(TaskId id) {
+        Task& task = m_tasks[id];
+        {
+            std::unique_lock lock(m_mutex);
+            bool dependencyFailed = false;
+            m_taskFinished.wait(lock, [&] {
+                for (TaskId dependency : task.Dependencies) {
+                    const TaskState state = m_tasks[dependency].State;
+                    if (state == TaskState::Failed) {
+                        dependencyFailed = true;
+                    } else if (state != TaskState::Finished) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+
+            if (dependencyFailed) {
+                task.State = TaskState::Failed;
+                m_taskFinished.notify_all();
+                return;
+            }
+            task.State = TaskState::Running;
+            task.Begin = std::chrono::steady_clock::now();
+        }
+
+        std::exception_ptr exception;
+        try {
+            task.Work();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            task.End = std::chrono::steady_clock::now();
+            task.State = exception ? TaskState::Failed : TaskState::Finished;
+            if (exception && !m_firstException) {
+                m_firstException = exception;
+            }
+        }
+        m_taskFinished.notify_all();
+    }
+
+    void StartupGraph::LogTimeline(std::chrono::steady_clock::time_point start) const {
+        using Milliseconds = std::chrono::duration<float, std::milli>;
+
+        std::vector<const Task*> tasks;
+        for (const Task& task : m_tasks) {
+            tasks.push_back(&task);
+        }
+        std::stable_sort(tasks.begin(), tasks.end(), [](const Task* a, const Task* b) { return a->Begin < b->Begin; });
+
+        auto end = start;
+        DEBUG_PRINT("Startup timeline in ms:");
+        for (const Task* task : tasks) {
+            if (task->Begin == std::chrono::steady_clock::time_point{}) {
+                DEBUG_PRINT("  %-28s %-6s skipped", task->Name, task->RunOn == Thread::Main ? "main" : "worker");
+                continue;
+            }
+            end = std::max(end, task->End);
+            DEBUG_PRINT("  %-28s %-6s start %8.1f  duration %8.1f%s",
+                        task->Name,
+                        task->RunOn == Thread::Main ? "main" : "worker",
+                        Milliseconds(task->Begin - start).count(),
+                        Milliseconds(task->End - task->Begin).count(),
+                        task->State == TaskState::Failed ? "  failed" : "");
+        }
+        DEBUG_PRINT("  Total %.1f", Milliseconds(end - start).count());
+    }
+} // namespace sample
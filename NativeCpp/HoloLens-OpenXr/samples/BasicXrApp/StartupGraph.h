@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace sample {
+    // Runs the one-time startup work of the app as a graph of tasks, so that independent work such as the remote rendering
+    // startup and the OpenXR and D3D setup overlaps instead of adding up.
+    //
+    // Main tasks run on the thread calling Run, in the order they were added, each once its dependencies have finished.
+    // Worker tasks run on a thread of their own as soon as their dependencies have finished. A task can only depend on tasks
+    // added before it, so the graph can't have cycles. When a task throws, the tasks depending on it are skipped and Run
+    // rethrows the exception after all other tasks have finished.
+    //
+    // Run prints the start and duration of every task relative to the start of Run to the debug output.
+    class StartupGraph {
+    public:
+        using TaskId = uint32_t;
+
+        enum class Thread {
+            Main,
+            Worker,
+        };
+
+        TaskId Add(const char* name, Thread thread, std::vector<TaskId> dependencies, std::function<void()> work);
+
+        void Run();
+
+    private:
+        enum class TaskState {
+            Pending,
+            Running,
+            Finished,
+            Failed, // The task threw, or a dependency failed and the task was skipped.
+        };
+
+        struct Task {
+            const char* Name;
+            Thread RunOn;
+            std::vector<TaskId> Dependencies;
+            std::function<void()> Work;
+            TaskState State = TaskState::Pending;
+            std::chrono::steady_clock::time_point Begin;
+            std::chrono::steady_clock::time_point End;
+        };
+
+        void RunTask(TaskId id);
+        void LogTimeline(std::chrono::steady_clock::time_point start) const;
+
+        std::vector<Task> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_taskFinished;
+        std::exception_ptr m_firstException;
+    };
+} // namespace sample
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "SystemCapabilities.h"
+
+#include <fstream>
+#include <XrUtility/XrEnumerate.h>
+#if XR_MSFT_scene_understanding_preview3
+#include <XrUtility/XrSceneUnderstanding.h>
+#endif
+
+namespace {
+    constexpr uint32_t FileMagic = 0x50435258; // "XRCP"
+    constexpr uint32_t FileVersion = 1;
+
+    // Values are written as they are in memory. Chained next pointers are not valid in the file and are cleared on load.
+    template <typename T>
+    void WriteValue(std::ostream& file, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void WriteArray(std::ostream& file, const std::vector<T>& values) {
+        WriteValue(file, static_cast<uint32_t>(values.size()));
+        file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    template <typename T>
+    bool ReadValue(std::istream& file, T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template <typename T>
+    bool ReadArray(std::istream& file, std::vector<T>& values) {
+        constexpr uint32_t MaxCount = 1024; // Far more than any enumeration returns, so a damaged file can't allocate much.
+        uint32_t count;
+        if (!ReadValue(file, count) || count > MaxCount) {
+            return false;
+        }
+        values.resize(count);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T))));
+    }
+
+    std::vector<XrReprojectionModeMSFT> EnumerateReprojectionModes(const xr::ExtensionDispatchTable& extensions,
+                                                                  XrInstance instance,
+                                                                  XrSystemId systemId,
+                                                                  XrViewConfigurationType viewConfigurationType) {
+        uint32_t count;
+        CHECK_XRCMD(extensions.xrEnumerateReprojectionModesMSFT(instance, systemId, viewConfigurationType, 0, &count, nullptr));
+        std::vector<XrReprojectionModeMSFT> modes(count);
+        CHECK_XRCMD(extensions.xrEnumerateReprojectionModesMSFT(instance, systemId, viewConfigurationType, count, &count, modes.data()));
+        modes.resize(count);
+        return modes;
+    }
+} // namespace
+
+namespace sample {
+    SystemCapabilityCache::SystemCapabilityCache(std::filesystem::path file)
+        : m_file(std::move(file)) {
+    }
+
+    const SystemCapabilities& SystemCapabilityCache::GetSystem(const xr::ExtensionDispatchTable& extensions,
+                                                               XrInstance instance,
+                                                               XrSystemId systemId,
+                                                               const Query& query) {
+        XrSystemProperties systemProperties{XR_TYPE_SYSTEM_PROPERTIES};
+        CHECK_XRCMD(xrGetSystemProperties(instance, systemId, &systemProperties));
+
+        const std::string key = GetKey(instance, systemProperties, query);
+        if (m_capabilities.has_value() && key == m_key) {
+            m_capabilities->SystemProperties = systemProperties;
+            return m_capabilities.value();
+        }
+
+        if (Load(key)) {
+            DEBUG_PRINT("Using the capabilities of %s from the last launch.", systemProperties.systemName);
+            m_capabilities->SystemProperties = systemProperties;
+            return m_capabilities.value();
+        }
+
+        SystemCapabilities& capabilities = m_capabilities.emplace();
+        m_key = key;
+        capabilities.SystemProperties = systemProperties;
+        capabilities.EnvironmentBlendModes = xr::EnumerateEnvironmentBlendModes(instance, systemId, query.ViewConfigurationType);
+        capabilities.ViewConfigurationViews = xr::EnumerateViewConfigurationViews(instance, systemId, query.ViewConfigurationType);
+        if (query.ReprojectionModes) {
+            capabilities.ReprojectionModes = EnumerateReprojectionModes(extensions, instance, systemId, query.ViewConfigurationType);
+        }
+#if XR_MSFT_scene_understanding_preview3
+        if (query.SceneComputeFeatures) {
+            capabilities.SceneComputeFeatures = xr::EnumerateSceneComputeFeatures(extensions, instance, systemId);
+        }
+#endif
+        return capabilities;
+    }
+
+    const SystemCapabilities& SystemCapabilityCache::GetSession(XrSession session) {
+        CHECK(m_capabilities.has_value());
+
+        // A system supports at least one swapchain format, so an empty list means the session queries are still missing.
+        SystemCapabilities& capabilities = m_capabilities.value();
+        if (capabilities.SwapchainFormats.empty()) {
+            capabilities.SwapchainFormats = xr::EnumerateSwapchainFormats(session);
+            capabilities.ReferenceSpaceTypes = xr::EnumerateReferenceSpaceTypes(session);
+            Save();
+        }
+        return capabilities;
+    }
+
+    std::string SystemCapabilityCache::GetKey(XrInstance instance, const XrSystemProperties& systemProperties, const Query& query) {
+        // A runtime update may change what the system supports, so the runtime version is part of the key.
+        XrInstanceProperties instanceProperties{XR_TYPE_INSTANCE_PROPERTIES};
+        CHECK_XRCMD(xrGetInstanceProperties(instance, &instanceProperties));
+
+        char key[XR_MAX_RUNTIME_NAME_SIZE + XR_MAX_SYSTEM_NAME_SIZE + 64];
+        sprintf_s(key,
+                  "%s|%llu|%s|%u|%d|%d|%d",
+                  instanceProperties.runtimeName,
+                  static_cast<unsigned long long>(instanceProperties.runtimeVersion),
+                  systemProperties.systemName,
+                  systemProperties.vendorId,
+                  static_cast<int>(query.ViewConfigurationType),
+                  query.ReprojectionModes ? 1 : 0,
+                  query.SceneComputeFeatures ? 1 : 0);
+        return key;
+    }
+
+    bool SystemCapabilityCache::Load(const std::string& key) {
+        std::ifstream file(m_file, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        // The file is written by this app, but may be left over from another version or damaged, so every read is checked.
+        uint32_t magic, version;
+        std::string fileKey;
+        SystemCapabilities capabilities;
+        bool valid = ReadValue(file, magic) && magic == FileMagic && ReadValue(file, version) && version == FileVersion;
+        if (valid) {
+            std::vector<char> keyChars;
+            valid = ReadArray(file, keyChars);
+            fileKey.assign(keyChars.begin(), keyChars.end());
+        }
+        if (!valid || fileKey != key) {
+            return false;
+        }
+
+        valid = ReadArray(file, capabilities.EnvironmentBlendModes) && ReadArray(file, capabilities.ViewConfigurationViews) &&
+                ReadArray(file, capabilities.ReprojectionModes) &&
+#if XR_MSFT_scene_understanding_preview3
+                ReadArray(file, capabilities.SceneComputeFeatures) &&
+#endif
+                ReadArray(file, capabilities.SwapchainFormats) && ReadArray(file, capabilities.ReferenceSpaceTypes);
+        if (!valid || capabilities.EnvironmentBlendModes.empty() || capabilities.ViewConfigurationViews.empty() ||
+            capabilities.SwapchainFormats.empty()) {
+            DEBUG_PRINT("Ignoring the invalid capability cache file %ls.", m_file.c_str());
+            return false;
+        }
+
+        for (XrViewConfigurationView& view : capabilities.ViewConfigurationViews) {
+            view.next = nullptr;
+        }
+        m_capabilities = std::move(capabilities);
+        m_key = key;
+        return true;
+    }
+
+    void SystemCapabilityCache::Save() const {
+        std::filesystem::path tempPath = m_file;
+        tempPath += L".tmp";
+
+        std::error_code error;
+        std::filesystem::create_directories(m_file.parent_path(), error);
+        {
+            const SystemCapabilities& capabilities = m_capabilities.value();
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            WriteValue(file, FileMagic);
+            WriteValue(file, FileVersion);
+            WriteArray(file, std::vector<char>(m_key.begin(), m_key.end()));
+            WriteArray(file, capabilities.EnvironmentBlendModes);
+            WriteArray(file, capabilities.ViewConfigurationViews);
+            WriteArray(file, capabilities.ReprojectionModes);
+#if XR_MSFT_scene_understanding_preview3
+            WriteArray(file, capabilities.SceneComputeFeatures);
+#endif
+            WriteArray(file, capabilities.SwapchainFormats);
+            WriteArray(file, capabilities.ReferenceSpaceTypes);
+            if (!file) {
+                DEBUG_PRINT("Failed to write the capability cache file %ls.", tempPath.c_str());
+                return;
+            }
+        }
+
+        std::filesystem::rename(tempPath, m_file, error);
+        if (error) {
+            DEBUG_PRINT("Failed to replace the capability cache file %ls: %s", m_file.c_str(), error.message().c_str());
+        }
+    }
+} // namespace sample
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+
+namespace sample {
+    // What the sample reads from an OpenXR system through the two-call enumerations.
+    struct SystemCapabilities {
+        XrSystemProperties SystemProperties{XR_TYPE_SYSTEM_PROPERTIES};
+        std::vector<XrEnvironmentBlendMode> EnvironmentBlendModes;
+        std::vector<XrViewConfigurationView> ViewConfigurationViews;
+        std::vector<XrReprojectionModeMSFT> ReprojectionModes;
+#if XR_MSFT_scene_understanding_preview3
+        std::vector<XrSceneComputeFeatureMSFT> SceneComputeFeatures;
+#endif
+
+        // The runtime only reports these for a session, so they are queried with the first session of the system.
+        std::vector<int64_t> SwapchainFormats;
+        std::vector<XrReferenceSpaceType> ReferenceSpaceTypes;
+    };
+
+    // Keeps the capabilities of the current system, so that a session restart on the same system skips the enumerations, and
+    // writes them to a file keyed by the runtime and the system, so that the next launch skips them as well.
+    //
+    // Systems are told apart by xrGetSystemProperties, a single call that also notices a different device behind the same
+    // system id, e.g. when holographic remoting connects to another device.
+    class SystemCapabilityCache {
+    public:
+        struct Query {
+            XrViewConfigurationType ViewConfigurationType{XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO};
+            bool ReprojectionModes{false};    // Requires XR_MSFT_composition_layer_reprojection.
+            bool SceneComputeFeatures{false}; // Requires XR_MSFT_scene_understanding.
+        };
+
+        explicit SystemCapabilityCache(std::filesystem::path file);
+
+        // Returns the capabilities of the system, enumerated only if neither this run nor the file knows the system.
+        const SystemCapabilities& GetSystem(const xr::ExtensionDispatchTable& extensions,
+                                            XrInstance instance,
+                                            XrSystemId systemId,
+                                            const Query& query);
+
+        // Returns the capabilities including the session queries of the current system, enumerated with its first session.
+        const SystemCapabilities& GetSession(XrSession session);
+
+        // The capabilities of the system given to the last GetSystem.
+        const SystemCapabilities& Current() const {
+            CHECK(m_capabilities.has_value());
+            return m_capabilities.value();
+        }
+
+    private:
+        static std::string GetKey(XrInstance instance, const XrSystemProperties& systemProperties, const Query& query);
+        bool Load(const std::string& key);
+        void Save() const;
+
+        const std::filesystem::path m_file;
+        std::string m_key; // Of m_capabilities.
+        std::optional<SystemCapabilities> m_capabilities;
+    };
+} // namespace sample
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "XrUtilityBenchmarks.h"
+
+namespace {
+    using sample::debug::BenchmarkResult;
+    using sample::debug::Consume;
+    using sample::debug::Measure;
+
+    void AddPathBenchmarks(XrInstance instance, std::vector<BenchmarkResult>& results) {
+        // The paths BasicXrApp converts when it sets up its actions and bindings.
+        constexpr const char* paths[] = {
+            "/user/hand/left",
+            "/user/hand/right",
+            "/user/hand/left/input/select/click",
+            "/user/hand/right/input/select/click",
+            "/user/hand/left/input/grip/pose",
+            "/user/hand/right/input/grip/pose",
+            "/user/hand/left/output/haptic",
+            "/user/hand/right/output/haptic",
+            "/user/hand/left/input/menu/click",
+            "/user/hand/right/input/menu/click",
+            "/interaction_profiles/khr/simple_controller",
+            "/interaction_profiles/microsoft/motion_controller",
+        };
+        constexpr uint32_t pathCount = static_cast<uint32_t>(std::size(paths));
+
+        std::array<XrPath, pathCount> xrPaths{};
+        results.push_back(Measure("StringToPath", pathCount, [&] {
+            for (uint32_t i = 0; i < pathCount; i++) {
+                xrPaths[i] = xr::StringToPath(instance, paths[i]);
+            }
+            Consume(xrPaths.back());
+        }));
+
+        results.push_back(Measure("PathToString", pathCount, [&] {
+            for (uint32_t i = 0; i < pathCount; i++) {
+                Consume(xr::PathToString(instance, xrPaths[i]).front());
+            }
+        }));
+    }
+} // namespace
+
+namespace sample::debug {
+    std::vector<BenchmarkResult> RunXrUtilityBenchmarks(XrInstance instance, const std::filesystem::path& resultsPath) {
+        std::vector<BenchmarkResult> results;
+        AddPathBenchmarks(instance, results);
+
+#ifdef _DEBUG
+        DEBUG_PRINT("XrUtility path benchmarks of a debug build, compare the times of release builds:");
+#else
+        DEBUG_PRINT("XrUtility path benchmarks, allocations are only counted in debug builds:");
+#endif
+        for (const BenchmarkResult& result : results) {
+            DEBUG_PRINT("  %-32s %10.1f ns/op %8.3f allocations/op",
+                        result.Name.c_str(),
+                        result.NanosecondsPerOperation,
+                        result.AllocationsPerOperation);
+        }
+
+        if (!WriteBenchmarkResults(results, resultsPath)) {
+            DEBUG_PRINT("Failed to write the benchmark results %ls.", resultsPath.c_str());
+        }
+        return results;
+    }
+} // namespace sample::debug
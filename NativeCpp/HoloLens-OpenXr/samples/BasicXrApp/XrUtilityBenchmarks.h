@@ -0,0 +1,16 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Benchmark.h"
+
+namespace sample::debug {
+    // Microbenchmarks of the path conversions of XrString.h, which go through the loader and runtime of the given instance
+    // and so can only run inside of the app. The helpers that don't need a runtime, i.e. the math, struct chain and scene
+    // understanding helpers, are measured by the XrUtilityBench console target.
+    //
+    // Runs on the calling thread. The results are printed to the debug output and written to resultsPath, see
+    // WriteBenchmarkResults.
+    std::vector<BenchmarkResult> RunXrUtilityBenchmarks(XrInstance instance, const std::filesystem::path& resultsPath);
+} // namespace sample::debug
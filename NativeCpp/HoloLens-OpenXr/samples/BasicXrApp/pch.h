@@ -34,5 +34,6 @@
 #include <XrUtility/XrMath.h>
 #include <XrUtility/XrString.h>
 #include <XrUtility/XrExtensions.h>
+#include <XrUtility/XrSpaceLocator.h>
 
 #include <winrt/base.h> // winrt::com_ptr
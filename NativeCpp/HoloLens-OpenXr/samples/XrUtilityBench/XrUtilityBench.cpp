@@ -0,0 +1,329 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <XrUtility/XrStruct.h>
+
+#if XR_MSFT_scene_understanding_preview3
+#include <XrUtility/XrSceneUnderstanding.hpp>
+#include <XrUtility/XrSceneUnderstandingSpatialIndex.hpp>
+#endif
+
+// Microbenchmarks of the XrUtility helpers on the per-frame paths of BasicXrApp: the pose and projection math of XrMath.h,
+// the struct chains of XrStruct.h, the scene component queries of XrSceneUnderstanding.hpp and the placement queries of
+// XrSceneUnderstandingSpatialIndex.hpp. The scene queries read a synthetic scene from stub dispatch table functions, so
+// neither a runtime nor a headset is needed. The path conversions of XrString.h go through the runtime, so BasicXrApp
+// measures those, see XrUtilityBenchmarks.
+//
+// Usage: XrUtilityBench [results path], by default XrUtilityBench.txt in the working directory. The release build counts
+// heap allocations as well, see COUNT_HEAP_ALLOCATIONS in the project.
+namespace {
+    using sample::debug::BenchmarkResult;
+    using sample::debug::Consume;
+    using sample::debug::Measure;
+
+    constexpr uint32_t c_poseCount = 1000;
+
+    // Deterministic poses spread over a few meters and all orientations.
+    std::vector<XrPosef> MakePoses(uint32_t count, uint32_t seed) {
+        std::vector<XrPosef> poses(count);
+        for (uint32_t i = 0; i < count; i++) {
+            const float t = static_cast<float>(i + seed);
+            poses[i].orientation = xr::math::Quaternion::RotationRollPitchYaw({t * 0.1f, t * 0.2f, t * 0.3f});
+            poses[i].position = {std::sin(t) * 2, std::cos(t * 0.5f), std::sin(t * 0.25f) * 3};
+        }
+        return poses;
+    }
+
+    void AddMathBenchmarks(std::vector<BenchmarkResult>& results) {
+        using namespace xr::math;
+        const std::vector<XrPosef> poses = MakePoses(c_poseCount, 0);
+        const std::vector<XrPosef> otherPoses = MakePoses(c_poseCount, 7);
+        const XrPosef parent = poses[c_poseCount / 2];
+        std::vector<XrPosef> outPoses(c_poseCount);
+
+        results.push_back(Measure("Pose::Multiply", c_poseCount, [&] {
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                outPoses[i] = Pose::Multiply(poses[i], parent);
+            }
+            Consume(outPoses.back());
+        }));
+
+        results.push_back(Measure("Pose::Invert", c_poseCount, [&] {
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                outPoses[i] = Pose::Invert(poses[i]);
+            }
+            Consume(outPoses.back());
+        }));
+
+        results.push_back(Measure("Pose::Slerp", c_poseCount, [&] {
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                outPoses[i] = Pose::Slerp(poses[i], otherPoses[i], 0.5f);
+            }
+            Consume(outPoses.back());
+        }));
+
+        const std::vector<XrVector3f> scales(c_poseCount, XrVector3f{0.1f, 0.2f, 0.3f});
+        std::vector<DirectX::XMFLOAT4X4> matrices(c_poseCount);
+        results.push_back(Measure("StoreXrPoseMatrices", c_poseCount, [&] {
+            StoreXrPoseMatrices(matrices.data(), poses.data(), c_poseCount, scales.data(), true);
+            Consume(matrices.back());
+        }));
+
+        // Fields of view of a HoloLens 2 like display, varied a little per view.
+        std::vector<XrFovf> fovs(c_poseCount);
+        for (uint32_t i = 0; i < c_poseCount; i++) {
+            const float jitter = 0.01f * (i % 10);
+            fovs[i] = {-0.72f - jitter, 0.66f + jitter, 0.59f + jitter, -0.61f - jitter};
+        }
+        const NearFar nearFar{0.1f, 20.0f};
+        results.push_back(Measure("ComposeProjectionMatrix", c_poseCount, [&] {
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                DirectX::XMStoreFloat4x4(&matrices[i], ComposeProjectionMatrix(fovs[i], nearFar));
+            }
+            Consume(matrices.back());
+        }));
+
+        std::vector<XrFovf> outFovs(c_poseCount);
+        results.push_back(Measure("DecomposeProjectionMatrix", c_poseCount, [&] {
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                outFovs[i] = DecomposeProjectionMatrix(matrices[i]);
+            }
+            Consume(outFovs.back());
+        }));
+    }
+
+    void AddStructBenchmarks(std::vector<BenchmarkResult>& results) {
+        // The chain that every mesh buffer read sets up.
+        using MeshBuffersChain = xr::StructChain<XrSceneMeshBuffersMSFT, XrSceneMeshVertexBufferMSFT, XrSceneMeshIndicesUint32MSFT>;
+        std::vector<MeshBuffersChain> chains(c_poseCount);
+        results.push_back(Measure("StructChain (3 structs)", c_poseCount, [&] {
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                chains[i] = MeshBuffersChain();
+                chains[i].Get<XrSceneMeshVertexBufferMSFT>().vertexCapacityInput = i;
+                chains[i].Get<XrSceneMeshIndicesUint32MSFT>().indexCapacityInput = i;
+            }
+            Consume(chains.back());
+        }));
+
+        std::vector<XrSceneComponentStatesMSFT> states(c_poseCount, {XR_TYPE_SCENE_COMPONENT_STATES_MSFT});
+        std::vector<XrSceneMeshStatesMSFT> meshStates(c_poseCount, {XR_TYPE_SCENE_MESH_STATES_MSFT});
+        results.push_back(Measure("InsertExtensionStruct", c_poseCount, [&] {
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                states[i].next = nullptr;
+                xr::InsertExtensionStruct(states[i], meshStates[i]);
+            }
+            Consume(states.back());
+        }));
+    }
+
+#if XR_MSFT_scene_understanding_preview3
+    constexpr uint32_t c_sceneMeshCount = 500;
+    constexpr uint32_t c_verticesPerMesh = 256;
+    constexpr uint32_t c_indicesPerMesh = 1152;
+
+    template <typename T>
+    T* FindChainedStruct(void* next, XrStructureType type) {
+        for (auto* header = static_cast<XrBaseOutStructure*>(next); header != nullptr; header = header->next) {
+            if (header->type == type) {
+                return reinterpret_cast<T*>(header);
+            }
+        }
+        return nullptr;
+    }
+
+    // A scene of c_sceneMeshCount visual meshes and no other components.
+    XrResult XRAPI_CALL GetSyntheticSceneComponents(XrSceneMSFT,
+                                                    const XrSceneComponentsGetInfoMSFT* getInfo,
+                                                    XrSceneComponentStatesMSFT* componentStates) {
+        const uint32_t count = getInfo->componentType == XR_SCENE_COMPONENT_TYPE_VISUAL_MESH_MSFT ? c_sceneMeshCount : 0;
+        componentStates->componentCountOutput = count;
+        if (componentStates->componentCapacityInput == 0) {
+            return XR_SUCCESS;
+        }
+        if (componentStates->componentCapacityInput < count) {
+            return XR_ERROR_SIZE_INSUFFICIENT;
+        }
+
+        auto* meshStates = FindChainedStruct<XrSceneMeshStatesMSFT>(componentStates->next, XR_TYPE_SCENE_MESH_STATES_MSFT);
+        for (uint32_t k = 0; k < count; k++) {
+            XrSceneComponentStateMSFT& component = componentStates->components[k];
+            component.componentType = getInfo->componentType;
+            component.componentId = {};
+            const uint32_t id = k + 1;
+            std::memcpy(component.componentId.bytes, &id, sizeof(id));
+            component.parentObjectId = {};
+            component.updateTime = 1;
+            if (meshStates != nullptr) {
+                meshStates->sceneMeshes[k] = {id, XR_FALSE};
+            }
+        }
+        return XR_SUCCESS;
+    }
+
+    // The vertex and index all meshes have at i, none of them zero, so that a buffer that wasn't copied is noticed.
+    XrVector3f SyntheticVertex(uint32_t i) {
+        return {static_cast<float>(i + 1), 2, 3};
+    }
+
+    uint32_t SyntheticIndex(uint32_t i) {
+        return i % (c_verticesPerMesh - 1) + 1;
+    }
+
+    // Every mesh has the same size, the buffers are filled like the runtime copies them, and a capacity of 0 is a size query.
+    XrResult XRAPI_CALL GetSyntheticSceneMeshBuffers(XrSceneMSFT, const XrSceneMeshBuffersGetInfoMSFT*, XrSceneMeshBuffersMSFT* buffers) {
+        XrResult result = XR_SUCCESS;
+        if (auto* vertices = FindChainedStruct<XrSceneMeshVertexBufferMSFT>(buffers->next, XR_TYPE_SCENE_MESH_VERTEX_BUFFER_MSFT)) {
+            vertices->vertexCountOutput = c_verticesPerMesh;
+            if (vertices->vertexCapacityInput >= c_verticesPerMesh) {
+                for (uint32_t i = 0; i < c_verticesPerMesh; i++) {
+                    vertices->vertices[i] = SyntheticVertex(i);
+                }
+            } else if (vertices->vertexCapacityInput != 0) {
+                result = XR_ERROR_SIZE_INSUFFICIENT;
+            }
+        }
+        if (auto* indices = FindChainedStruct<XrSceneMeshIndicesUint32MSFT>(buffers->next, XR_TYPE_SCENE_MESH_INDICES_UINT32_MSFT)) {
+            indices->indexCountOutput = c_indicesPerMesh;
+            if (indices->indexCapacityInput >= c_indicesPerMesh) {
+                for (uint32_t i = 0; i < c_indicesPerMesh; i++) {
+                    indices->indices[i] = SyntheticIndex(i);
+                }
+            } else if (indices->indexCapacityInput != 0) {
+                result = XR_ERROR_SIZE_INSUFFICIENT;
+            }
+        }
+        return result;
+    }
+
+    // Checks that a mesh was read with its contents, and not only with its size.
+    void CheckSyntheticMesh(const XrVector3f* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) {
+        CHECK(vertexCount == c_verticesPerMesh && indexCount == c_indicesPerMesh);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            CHECK(vertices[i].x == SyntheticVertex(i).x);
+        }
+        for (uint32_t i = 0; i < indexCount; i++) {
+            CHECK(indices[i] == SyntheticIndex(i));
+        }
+    }
+
+    void AddSceneBenchmarks(std::vector<BenchmarkResult>& results) {
+        xr::ExtensionDispatchTable extensions;
+        extensions.xrGetSceneComponentsMSFT = GetSyntheticSceneComponents;
+        extensions.xrGetSceneMeshBuffersMSFT = GetSyntheticSceneMeshBuffers;
+        const XrSceneMSFT scene = XR_NULL_HANDLE; // Ignored by the stubs.
+
+        results.push_back(Measure("su::GetSceneVisualMeshes", c_sceneMeshCount, [&] {
+            Consume(xr::su::GetSceneVisualMeshes(scene, extensions).back());
+        }));
+
+        const std::vector<XrSceneComponentTypeMSFT> componentTypes{XR_SCENE_COMPONENT_TYPE_VISUAL_MESH_MSFT};
+        results.push_back(Measure("su::GetSceneComponentSnapshot", c_sceneMeshCount, [&] {
+            const xr::su::SceneComponentSnapshot snapshot = xr::su::GetSceneComponentSnapshot(scene, extensions, componentTypes, false);
+            Consume(snapshot.visualMeshes.meshBufferIds.back());
+        }));
+
+        const std::vector<xr::su::SceneMesh> meshes = xr::su::GetSceneVisualMeshes(scene, extensions);
+        std::vector<XrVector3f> vertices;
+        std::vector<uint32_t> indices;
+        xr::ReadMeshBuffers(scene, extensions, meshes.front().meshBufferId, vertices, indices);
+        CheckSyntheticMesh(vertices.data(), static_cast<uint32_t>(vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+
+        xr::su::SceneMeshSlab slab;
+        xr::su::ReadMeshBuffers(scene, extensions, meshes, slab);
+        for (size_t k = 0; k < meshes.size(); k++) {
+            const xr::su::SceneMeshSlab::Range& range = slab.meshes[k];
+            CheckSyntheticMesh(slab.MeshVertices(k), range.vertexCount, slab.MeshIndices(k), range.indexCount);
+        }
+        results.push_back(Measure("su::ReadMeshBuffers", c_sceneMeshCount, [&] {
+            xr::su::ReadMeshBuffers(scene, extensions, meshes, slab);
+            Consume(slab.indices.back());
+        }));
+    }
+
+    // A room of c_sceneMeshCount planes of 1 by 0.5 meters, spread and oriented like the poses of the math benchmarks.
+    void AddSpatialIndexBenchmarks(std::vector<BenchmarkResult>& results) {
+        const std::vector<XrPosef> planePoses = MakePoses(c_sceneMeshCount, 3);
+        std::vector<xr::su::ScenePlane> planes(c_sceneMeshCount);
+        std::vector<XrSceneComponentLocationMSFT> locations(c_sceneMeshCount);
+        for (uint32_t k = 0; k < c_sceneMeshCount; k++) {
+            const uint32_t id = k + 1;
+            std::memcpy(planes[k].id.bytes, &id, sizeof(id));
+            planes[k].updateTime = 1;
+            planes[k].size = {1.0f, 0.5f};
+            locations[k].flags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+            locations[k].pose = planePoses[k];
+        }
+
+        // Unchanged planes are only relocated, which is the common case of a new scene compute.
+        xr::su::SceneSpatialIndex index;
+        results.push_back(Measure("su::SceneSpatialIndex::UpdatePlanes", c_sceneMeshCount, [&] {
+            index.UpdatePlanes(planes, locations);
+            Consume(index.Size());
+        }));
+        CHECK(index.Size() == c_sceneMeshCount);
+
+        // Rays and points where a hand would place a cube, with the forward direction of each pose.
+        const std::vector<XrPosef> queryPoses = MakePoses(c_poseCount, 11);
+        std::vector<XrVector3f> directions(c_poseCount);
+        for (uint32_t i = 0; i < c_poseCount; i++) {
+            const DirectX::XMVECTOR forward = DirectX::XMVectorSet(0, 0, -1, 0);
+            const DirectX::XMVECTOR orientation = xr::math::LoadXrQuaternion(queryPoses[i].orientation);
+            xr::math::StoreXrVector3(&directions[i], DirectX::XMVector3Rotate(forward, orientation));
+        }
+
+        uint32_t hitCount = 0;
+        results.push_back(Measure("su::SceneSpatialIndex::Raycast", c_poseCount, [&] {
+            hitCount = 0;
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                hitCount += index.Raycast(queryPoses[i].position, directions[i], 10.0f).has_value() ? 1 : 0;
+            }
+            Consume(hitCount);
+        }));
+
+        results.push_back(Measure("su::SceneSpatialIndex::FindNearestSurface", c_poseCount, [&] {
+            hitCount = 0;
+            for (uint32_t i = 0; i < c_poseCount; i++) {
+                hitCount += index.FindNearestSurface(queryPoses[i].position, 0.15f).has_value() ? 1 : 0;
+            }
+            Consume(hitCount);
+        }));
+    }
+#endif
+} // namespace
+
+int wmain(int argc, wchar_t* argv[]) {
+    const std::filesystem::path resultsPath = argc > 1 ? argv[1] : L"XrUtilityBench.txt";
+
+    try {
+        std::vector<BenchmarkResult> results;
+        AddMathBenchmarks(results);
+        AddStructBenchmarks(results);
+#if XR_MSFT_scene_understanding_preview3
+        AddSceneBenchmarks(results);
+        AddSpatialIndexBenchmarks(results);
+#endif
+
+#ifdef _DEBUG
+        std::printf("XrUtility benchmarks of a debug build, compare the times of release builds:\n");
+#endif
+        for (const BenchmarkResult& result : results) {
+            std::printf("  %-40s %10.1f ns/op %8.3f allocations/op\n",
+                        result.Name.c_str(),
+                        result.NanosecondsPerOperation,
+                        result.AllocationsPerOperation);
+        }
+
+        if (!sample::debug::WriteBenchmarkResults(results, resultsPath)) {
+            std::fprintf(stderr, "Failed to write the benchmark results %ls.\n", resultsPath.c_str());
+            return 1;
+        }
+        return 0;
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "%s\n", ex.what());
+        return 1;
+    }
+}
@@ -119,6 +119,12 @@
 #define FOR_EACH_SPATIAL_ANCHOR_PERSISTENCE_FUNCTION(_)
 #endif
 
+#if XR_KHR_locate_spaces
+#define FOR_EACH_LOCATE_SPACES_FUNCTION(_) _(xrLocateSpacesKHR)
+#else
+#define FOR_EACH_LOCATE_SPACES_FUNCTION(_)
+#endif
+
 #define FOR_EACH_COMPOSITION_LAYER_REPROJECTION_FUNCTION(_) _(xrEnumerateReprojectionModesMSFT)
 
 #define FOR_EACH_EXTENSION_FUNCTION(_)                     \
@@ -135,7 +141,8 @@
     FOR_EACH_SCENE_UNDERSTANDING_SERIALIZATION_FUNCTION(_) \
     FOR_EACH_SPATIAL_ANCHOR_EXPORT_FUNCTION(_)             \
     FOR_EACH_SPATIAL_ANCHOR_PERSISTENCE_FUNCTION(_)        \
-    FOR_EACH_COMPOSITION_LAYER_REPROJECTION_FUNCTION(_)
+    FOR_EACH_COMPOSITION_LAYER_REPROJECTION_FUNCTION(_)    \
+    FOR_EACH_LOCATE_SPACES_FUNCTION(_)
 
 
 #define GET_INSTANCE_PROC_ADDRESS(name) \
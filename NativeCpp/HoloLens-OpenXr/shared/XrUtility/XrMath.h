@@ -74,7 +74,19 @@ namespace xr::math {
     bool XM_CALLCONV StoreXrPose(XrPosef* out, DirectX::FXMMATRIX matrix);
     void XM_CALLCONV StoreXrExtent(XrExtent2Df* extend, DirectX::FXMVECTOR inVec);
 
+    // Batch convert XR poses to DX matrices, the same as storing XMMatrixScaling(scales[i]) * LoadXrPose(poses[i]) for each pose.
+    // Scales can be nullptr for unit scale, and transpose stores the transposed matrices used by shader constants.
+    void StoreXrPoseMatrices(DirectX::XMFLOAT4X4* outMatrices,
+                             const XrPosef* poses,
+                             size_t count,
+                             const XrVector3f* scales = nullptr,
+                             bool transpose = false);
+
     // Projection matrix math
+    constexpr bool IsValidFov(const XrFovf& fov);
+    constexpr bool operator==(const XrFovf& a, const XrFovf& b);
+    constexpr bool operator==(const NearFar& a, const NearFar& b);
+    constexpr bool IsReversedZ(const NearFar& nearFar);
     DirectX::XMMATRIX ComposeProjectionMatrix(const XrFovf& fov, const NearFar& nearFar);
     NearFar GetProjectionNearFar(const DirectX::XMFLOAT4X4& projectionMatrix);
     XrFovf DecomposeProjectionMatrix(const DirectX::XMFLOAT4X4& projectionMatrix);
@@ -304,6 +316,73 @@ namespace xr::math {
         return true;
     }
 
+    inline void StoreXrPoseMatrices(
+        DirectX::XMFLOAT4X4* outMatrices, const XrPosef* poses, size_t count, const XrVector3f* scales, bool transpose) {
+        using namespace DirectX;
+        const XMVECTOR one = XMVectorSplatOne();
+        const XMVECTOR zero = XMVectorZero();
+
+        // Four poses per iteration: the quaternions, positions and scales are transposed so that each vector holds one
+        // component of four poses, the 16 matrix elements are computed for all four poses at once, then transposed back.
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const XrPosef* p = poses + i;
+            const XMMATRIX q = XMMatrixTranspose(XMMATRIX(LoadXrQuaternion(p[0].orientation),
+                                                          LoadXrQuaternion(p[1].orientation),
+                                                          LoadXrQuaternion(p[2].orientation),
+                                                          LoadXrQuaternion(p[3].orientation)));
+            const XMMATRIX t = XMMatrixTranspose(XMMATRIX(LoadXrVector3(p[0].position),
+                                                          LoadXrVector3(p[1].position),
+                                                          LoadXrVector3(p[2].position),
+                                                          LoadXrVector3(p[3].position)));
+            const XMMATRIX s = scales != nullptr ? XMMatrixTranspose(XMMATRIX(LoadXrVector3(scales[i]),
+                                                                            LoadXrVector3(scales[i + 1]),
+                                                                            LoadXrVector3(scales[i + 2]),
+                                                                            LoadXrVector3(scales[i + 3])))
+                                                 : XMMATRIX(one, one, one, one);
+
+            const XMVECTOR x = q.r[0], y = q.r[1], z = q.r[2], w = q.r[3];
+            const XMVECTOR x2 = XMVectorAdd(x, x), y2 = XMVectorAdd(y, y), z2 = XMVectorAdd(z, z);
+            const XMVECTOR xx = XMVectorMultiply(x, x2), yy = XMVectorMultiply(y, y2), zz = XMVectorMultiply(z, z2);
+            const XMVECTOR xy = XMVectorMultiply(x, y2), xz = XMVectorMultiply(x, z2), yz = XMVectorMultiply(y, z2);
+            const XMVECTOR wx = XMVectorMultiply(w, x2), wy = XMVectorMultiply(w, y2), wz = XMVectorMultiply(w, z2);
+
+            // Same layout as XMMatrixRotationQuaternion, with each rotation row scaled and the translation in the last row.
+            const XMVECTOR m[4][4] = {
+                {XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(yy, zz)), s.r[0]),
+                 XMVectorMultiply(XMVectorAdd(xy, wz), s.r[0]),
+                 XMVectorMultiply(XMVectorSubtract(xz, wy), s.r[0]),
+                 zero},
+                {XMVectorMultiply(XMVectorSubtract(xy, wz), s.r[1]),
+                 XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(xx, zz)), s.r[1]),
+                 XMVectorMultiply(XMVectorAdd(yz, wx), s.r[1]),
+                 zero},
+                {XMVectorMultiply(XMVectorAdd(xz, wy), s.r[2]),
+                 XMVectorMultiply(XMVectorSubtract(yz, wx), s.r[2]),
+                 XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(xx, yy)), s.r[2]),
+                 zero},
+                {t.r[0], t.r[1], t.r[2], one},
+            };
+
+            XMMATRIX rows[4];
+            for (int r = 0; r < 4; r++) {
+                rows[r] = transpose ? XMMatrixTranspose(XMMATRIX(m[0][r], m[1][r], m[2][r], m[3][r]))
+                                    : XMMatrixTranspose(XMMATRIX(m[r][0], m[r][1], m[r][2], m[r][3]));
+            }
+            for (int k = 0; k < 4; k++) {
+                XMStoreFloat4x4(&outMatrices[i + k], XMMATRIX(rows[0].r[k], rows[1].r[k], rows[2].r[k], rows[3].r[k]));
+            }
+        }
+
+        for (; i < count; i++) {
+            XMMATRIX matrix = LoadXrPose(poses[i]);
+            if (scales != nullptr) {
+                matrix = XMMatrixScaling(scales[i].x, scales[i].y, scales[i].z) * matrix;
+            }
+            XMStoreFloat4x4(&outMatrices[i], transpose ? XMMatrixTranspose(matrix) : matrix);
+        }
+    }
+
     namespace Pose {
         constexpr XrPosef Identity() {
             return {{0, 0, 0, 1}, {0, 0, 0}};
@@ -459,7 +538,7 @@ namespace xr::math {
         return a / std::sqrt(Dot(a, a));
     }
 
-    inline bool IsValidFov(const XrFovf& fov) {
+    constexpr bool IsValidFov(const XrFovf& fov) {
         if (fov.angleRight >= DirectX::XM_PIDIV2 || fov.angleLeft <= -DirectX::XM_PIDIV2) {
             return false;
         }
@@ -547,15 +626,53 @@ namespace xr::math {
         }
     }
 
-    inline bool IsInfiniteNearPlaneProjectionMatrix(const DirectX::XMFLOAT4X4& p) {
+    constexpr bool operator==(const XrFovf& a, const XrFovf& b) {
+        return a.angleLeft == b.angleLeft && a.angleRight == b.angleRight && a.angleUp == b.angleUp && a.angleDown == b.angleDown;
+    }
+
+    constexpr bool operator==(const NearFar& a, const NearFar& b) {
+        return a.Near == b.Near && a.Far == b.Far;
+    }
+
+    // Reversed-Z puts the near plane at depth 1 and the far plane at depth 0, which is requested with Near > Far.
+    constexpr bool IsReversedZ(const NearFar& nearFar) {
+        return nearFar.Near > nearFar.Far;
+    }
+
+    // Keeps the projection matrix of one view and only composes it again when its fov or near/far planes change,
+    // which for most devices is never after the first frame.
+    class ProjectionMatrixCache {
+    public:
+        DirectX::XMMATRIX XM_CALLCONV Get(const XrFovf& fov, const NearFar& nearFar) {
+            if (!m_valid || !(fov == m_fov) || !(nearFar == m_nearFar)) {
+                DirectX::XMStoreFloat4x4(&m_matrix, ComposeProjectionMatrix(fov, nearFar));
+                m_fov = fov;
+                m_nearFar = nearFar;
+                m_valid = true;
+            }
+            return DirectX::XMLoadFloat4x4(&m_matrix);
+        }
+
+        void Reset() noexcept {
+            m_valid = false;
+        }
+
+    private:
+        XrFovf m_fov{};
+        NearFar m_nearFar{};
+        DirectX::XMFLOAT4X4 m_matrix{};
+        bool m_valid{false};
+    };
+
+    constexpr bool IsInfiniteNearPlaneProjectionMatrix(const DirectX::XMFLOAT4X4& p) {
         return (p._33 == 0);
     }
 
-    inline bool IsInfiniteFarPlaneProjectionMatrix(const DirectX::XMFLOAT4X4& p) {
+    constexpr bool IsInfiniteFarPlaneProjectionMatrix(const DirectX::XMFLOAT4X4& p) {
         return (p._33 == -1);
     }
 
-    inline void ValidateProjectionMatrix(const DirectX::XMFLOAT4X4& p) {
+    constexpr void ValidateProjectionMatrix(const DirectX::XMFLOAT4X4& p) {
         // Reference equations on top of ComposeProjectionMatrix() above.
         if (p._12 != 0 || p._13 != 0 || p._14 != 0 ||
             // p._21 is not 0 on old MR devices, but small enough to be ignored. For future MR devices, it should be 0 (no shear)
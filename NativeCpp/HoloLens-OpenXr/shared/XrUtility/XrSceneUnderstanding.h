@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include "XrStruct.h"
 #include "XrHandle.h"
 #include "XrMath.h"
@@ -76,57 +77,140 @@ namespace xr {
         CHECK_XRCMD(extensions.xrComputeNewSceneMSFT(sceneObserver, &computeInfo));
     }
 
-    // Reads mesh vertices and 32-bit indices.
+    // The element counts of a scene mesh buffer.
+    struct MeshBufferCounts {
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+    };
+
+    namespace detail {
+        template <typename TIndex>
+        struct SceneMeshIndices;
+
+        template <>
+        struct SceneMeshIndices<uint32_t> {
+            using Struct = XrSceneMeshIndicesUint32MSFT;
+        };
+
+        template <>
+        struct SceneMeshIndices<uint16_t> {
+            using Struct = XrSceneMeshIndicesUint16MSFT;
+        };
+
+        template <typename TIndex>
+        inline bool TryReadMeshBuffers(XrSceneMSFT scene,
+                                       const xr::ExtensionDispatchTable& extensions,
+                                       uint64_t meshBufferId,
+                                       XrVector3f* vertexBuffer,
+                                       uint32_t vertexCapacity,
+                                       TIndex* indexBuffer,
+                                       uint32_t indexCapacity,
+                                       MeshBufferCounts& counts) {
+            XrSceneMeshBuffersGetInfoMSFT meshGetInfo{XR_TYPE_SCENE_MESH_BUFFERS_GET_INFO_MSFT};
+            meshGetInfo.meshBufferId = meshBufferId;
+
+            using IndicesStruct = typename SceneMeshIndices<TIndex>::Struct;
+            xr::StructChain<XrSceneMeshBuffersMSFT, XrSceneMeshVertexBufferMSFT, IndicesStruct> meshBuffers;
+            XrSceneMeshVertexBufferMSFT& vertices = meshBuffers.template Get<XrSceneMeshVertexBufferMSFT>();
+            IndicesStruct& indices = meshBuffers.template Get<IndicesStruct>();
+            vertices.vertexCapacityInput = vertexCapacity;
+            vertices.vertices = vertexBuffer;
+            indices.indexCapacityInput = indexCapacity;
+            indices.indices = indexBuffer;
+
+            const XrResult result = extensions.xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, meshBuffers.Get());
+            if (result != XR_ERROR_SIZE_INSUFFICIENT) {
+                CHECK_XRRESULT(result, "xrGetSceneMeshBuffersMSFT");
+            }
+            counts.vertexCount = vertices.vertexCountOutput;
+            counts.indexCount = indices.indexCountOutput;
+
+            // A capacity of 0 is a size query, which succeeds without copying anything, so the counts decide whether the
+            // buffers were filled.
+            return result != XR_ERROR_SIZE_INSUFFICIENT && counts.vertexCount <= vertexCapacity && counts.indexCount <= indexCapacity;
+        }
+
+        template <typename TIndex>
+        inline void ReadMeshBuffers(XrSceneMSFT scene,
+                                    const xr::ExtensionDispatchTable& extensions,
+                                    uint64_t meshBufferId,
+                                    std::vector<XrVector3f>& vertexBuffer,
+                                    std::vector<TIndex>& indexBuffer) {
+            // Read into the capacity the vectors already have, so that re-reading a mesh that didn't grow takes a single call
+            // and no allocation. Otherwise grow geometrically, so a mesh that keeps growing is reallocated only a few times.
+            vertexBuffer.resize(vertexBuffer.capacity());
+            indexBuffer.resize(indexBuffer.capacity());
+            MeshBufferCounts counts;
+            if (!TryReadMeshBuffers(scene,
+                                    extensions,
+                                    meshBufferId,
+                                    vertexBuffer.data(),
+                                    static_cast<uint32_t>(vertexBuffer.size()),
+                                    indexBuffer.data(),
+                                    static_cast<uint32_t>(indexBuffer.size()),
+                                    counts)) {
+                vertexBuffer.reserve(std::max<size_t>(counts.vertexCount, vertexBuffer.capacity() * 2));
+                indexBuffer.reserve(std::max<size_t>(counts.indexCount, indexBuffer.capacity() * 2));
+                vertexBuffer.resize(vertexBuffer.capacity());
+                indexBuffer.resize(indexBuffer.capacity());
+                CHECK(TryReadMeshBuffers(scene,
+                                         extensions,
+                                         meshBufferId,
+                                         vertexBuffer.data(),
+                                         static_cast<uint32_t>(vertexBuffer.size()),
+                                         indexBuffer.data(),
+                                         static_cast<uint32_t>(indexBuffer.size()),
+                                         counts));
+            }
+            vertexBuffer.resize(counts.vertexCount);
+            indexBuffer.resize(counts.indexCount);
+        }
+    } // namespace detail
+
+    // Reads mesh vertices and 32-bit indices into caller-provided memory with a single xrGetSceneMeshBuffersMSFT call, e.g.
+    // straight into the mapped memory of D3D11_USAGE_DYNAMIC vertex and index buffers. Returns false if a capacity is too
+    // small, including a capacity of 0 for a mesh that isn't empty, in which case the contents of the memory are undefined.
+    // In both cases counts tells the capacities needed.
+    inline bool TryReadMeshBuffers(XrSceneMSFT scene,
+                                   const xr::ExtensionDispatchTable& extensions,
+                                   uint64_t meshBufferId,
+                                   XrVector3f* vertexBuffer,
+                                   uint32_t vertexCapacity,
+                                   uint32_t* indexBuffer,
+                                   uint32_t indexCapacity,
+                                   MeshBufferCounts& counts) {
+        return detail::TryReadMeshBuffers(
+            scene, extensions, meshBufferId, vertexBuffer, vertexCapacity, indexBuffer, indexCapacity, counts);
+    }
+
+    // Reads mesh vertices and 16-bit indices into caller-provided memory, see above.
+    inline bool TryReadMeshBuffers(XrSceneMSFT scene,
+                                   const xr::ExtensionDispatchTable& extensions,
+                                   uint64_t meshBufferId,
+                                   XrVector3f* vertexBuffer,
+                                   uint32_t vertexCapacity,
+                                   uint16_t* indexBuffer,
+                                   uint32_t indexCapacity,
+                                   MeshBufferCounts& counts) {
+        return detail::TryReadMeshBuffers(
+            scene, extensions, meshBufferId, vertexBuffer, vertexCapacity, indexBuffer, indexCapacity, counts);
+    }
+
+    // Reads mesh vertices and 32-bit indices. The vectors keep their capacity, so they can be reused for the next read.
     inline void ReadMeshBuffers(XrSceneMSFT scene,
                                 const xr::ExtensionDispatchTable& extensions,
                                 uint64_t meshBufferId,
                                 std::vector<XrVector3f>& vertexBuffer,
                                 std::vector<uint32_t>& indexBuffer) {
-        XrSceneMeshBuffersGetInfoMSFT meshGetInfo{XR_TYPE_SCENE_MESH_BUFFERS_GET_INFO_MSFT};
-        meshGetInfo.meshBufferId = meshBufferId;
-
-        XrSceneMeshBuffersMSFT meshBuffers{XR_TYPE_SCENE_MESH_BUFFERS_MSFT};
-        XrSceneMeshVertexBufferMSFT vertices{XR_TYPE_SCENE_MESH_VERTEX_BUFFER_MSFT};
-        XrSceneMeshIndicesUint32MSFT indices{XR_TYPE_SCENE_MESH_INDICES_UINT32_MSFT};
-        xr::InsertExtensionStruct(meshBuffers, vertices);
-        xr::InsertExtensionStruct(meshBuffers, indices);
-        CHECK_XRCMD(extensions.xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers));
-
-        vertexBuffer.resize(vertices.vertexCountOutput);
-        indexBuffer.resize(indices.indexCountOutput);
-        vertices.vertexCapacityInput = vertices.vertexCountOutput;
-        indices.indexCapacityInput = indices.indexCountOutput;
-        vertices.vertices = vertexBuffer.data();
-        indices.indices = indexBuffer.data();
-        CHECK_XRCMD(extensions.xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers));
-        vertexBuffer.resize(vertices.vertexCountOutput);
-        indexBuffer.resize(indices.indexCountOutput);
+        detail::ReadMeshBuffers(scene, extensions, meshBufferId, vertexBuffer, indexBuffer);
     }
 
-    // Reads mesh vertices and 16-bit indices.
+    // Reads mesh vertices and 16-bit indices. The vectors keep their capacity, so they can be reused for the next read.
     inline void ReadMeshBuffers(XrSceneMSFT scene,
                                 const xr::ExtensionDispatchTable& extensions,
                                 uint64_t meshBufferId,
                                 std::vector<XrVector3f>& vertexBuffer,
                                 std::vector<uint16_t>& indexBuffer) {
-        XrSceneMeshBuffersGetInfoMSFT meshGetInfo{XR_TYPE_SCENE_MESH_BUFFERS_GET_INFO_MSFT};
-        meshGetInfo.meshBufferId = meshBufferId;
-
-        XrSceneMeshBuffersMSFT meshBuffers{XR_TYPE_SCENE_MESH_BUFFERS_MSFT};
-        XrSceneMeshVertexBufferMSFT vertices{XR_TYPE_SCENE_MESH_VERTEX_BUFFER_MSFT};
-        XrSceneMeshIndicesUint16MSFT indices{XR_TYPE_SCENE_MESH_INDICES_UINT16_MSFT};
-        xr::InsertExtensionStruct(meshBuffers, vertices);
-        xr::InsertExtensionStruct(meshBuffers, indices);
-        CHECK_XRCMD(extensions.xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers));
-
-        vertexBuffer.resize(vertices.vertexCountOutput);
-        indexBuffer.resize(indices.indexCountOutput);
-        vertices.vertexCapacityInput = vertices.vertexCountOutput;
-        indices.indexCapacityInput = indices.indexCountOutput;
-        vertices.vertices = vertexBuffer.data();
-        indices.indices = indexBuffer.data();
-        CHECK_XRCMD(extensions.xrGetSceneMeshBuffersMSFT(scene, &meshGetInfo, &meshBuffers));
-        vertexBuffer.resize(vertices.vertexCountOutput);
-        indexBuffer.resize(indices.indexCountOutput);
+        detail::ReadMeshBuffers(scene, extensions, meshBufferId, vertexBuffer, indexBuffer);
     }
 } // namespace xr
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <future>
 #include <optional>
 #include <XrUtility/XrExtensions.h>
 #include <XrUtility/XrUuid.h>
@@ -65,25 +68,26 @@ namespace xr::su {
             xr::InsertExtensionStruct(getInfo, typesFilter);
         }
 
-        XrSceneComponentStatesMSFT sceneComponents{XR_TYPE_SCENE_COMPONENT_STATES_MSFT};
-        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents));
-        const uint32_t count = sceneComponents.componentCountOutput;
+        XrSceneComponentStatesMSFT countQuery{XR_TYPE_SCENE_COMPONENT_STATES_MSFT};
+        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &countQuery));
+        const uint32_t count = countQuery.componentCountOutput;
 
+        xr::StructChain<XrSceneComponentStatesMSFT, XrSceneObjectStatesMSFT> sceneComponents;
         std::vector<XrSceneComponentStateMSFT> components(count);
-        sceneComponents.componentCapacityInput = count;
-        sceneComponents.components = components.data();
+        sceneComponents->componentCapacityInput = count;
+        sceneComponents->components = components.data();
 
         std::vector<XrSceneObjectStateMSFT> objects(count);
-        XrSceneObjectStatesMSFT sceneObjects{XR_TYPE_SCENE_OBJECT_STATES_MSFT};
+        XrSceneObjectStatesMSFT& sceneObjects = sceneComponents.Get<XrSceneObjectStatesMSFT>();
         sceneObjects.sceneObjectCount = count;
         sceneObjects.sceneObjects = objects.data();
-        xr::InsertExtensionStruct(sceneComponents, sceneObjects);
 
-        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents));
+        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, sceneComponents.Get()));
 
         std::vector<SceneObject> result(count);
         for (uint32_t k = 0; k < count; k++) {
             result[k].id = components[k].componentId;
+            result[k].parentObjectId = components[k].parentObjectId;
             result[k].updateTime = components[k].updateTime;
             result[k].type = objects[k].objectType;
         }
@@ -123,21 +127,21 @@ namespace xr::su {
             xr::InsertExtensionStruct(getInfo, alignmentFilter);
         }
 
-        XrSceneComponentStatesMSFT sceneComponents{XR_TYPE_SCENE_COMPONENT_STATES_MSFT};
-        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents));
-        const uint32_t count = sceneComponents.componentCountOutput;
+        XrSceneComponentStatesMSFT countQuery{XR_TYPE_SCENE_COMPONENT_STATES_MSFT};
+        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &countQuery));
+        const uint32_t count = countQuery.componentCountOutput;
 
+        xr::StructChain<XrSceneComponentStatesMSFT, XrScenePlaneStatesMSFT> sceneComponents;
         std::vector<XrSceneComponentStateMSFT> components(count);
-        sceneComponents.componentCapacityInput = count;
-        sceneComponents.components = components.data();
+        sceneComponents->componentCapacityInput = count;
+        sceneComponents->components = components.data();
 
         std::vector<XrScenePlaneStateMSFT> planes(count);
-        XrScenePlaneStatesMSFT scenePlanes{XR_TYPE_SCENE_PLANE_STATES_MSFT};
+        XrScenePlaneStatesMSFT& scenePlanes = sceneComponents.Get<XrScenePlaneStatesMSFT>();
         scenePlanes.scenePlaneCount = count;
         scenePlanes.scenePlanes = planes.data();
-        xr::InsertExtensionStruct(sceneComponents, scenePlanes);
 
-        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents));
+        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, sceneComponents.Get()));
 
         std::vector<ScenePlane> result(count);
         for (uint32_t k = 0; k < count; k++) {
@@ -175,21 +179,21 @@ namespace xr::su {
             xr::InsertExtensionStruct(getInfo, typesFilter);
         }
 
-        XrSceneComponentStatesMSFT sceneComponents{XR_TYPE_SCENE_COMPONENT_STATES_MSFT};
-        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents));
-        const uint32_t count = sceneComponents.componentCountOutput;
+        XrSceneComponentStatesMSFT countQuery{XR_TYPE_SCENE_COMPONENT_STATES_MSFT};
+        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &countQuery));
+        const uint32_t count = countQuery.componentCountOutput;
 
+        xr::StructChain<XrSceneComponentStatesMSFT, XrSceneMeshStatesMSFT> sceneComponents;
         std::vector<XrSceneComponentStateMSFT> components(count);
-        sceneComponents.componentCapacityInput = count;
-        sceneComponents.components = components.data();
+        sceneComponents->componentCapacityInput = count;
+        sceneComponents->components = components.data();
 
         std::vector<XrSceneMeshStateMSFT> meshes(count);
-        XrSceneMeshStatesMSFT sceneMeshes{XR_TYPE_SCENE_MESH_STATES_MSFT};
+        XrSceneMeshStatesMSFT& sceneMeshes = sceneComponents.Get<XrSceneMeshStatesMSFT>();
         sceneMeshes.sceneMeshCount = count;
         sceneMeshes.sceneMeshes = meshes.data();
-        xr::InsertExtensionStruct(sceneComponents, sceneMeshes);
 
-        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents));
+        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, sceneComponents.Get()));
 
         std::vector<SceneMesh> result(count);
         for (uint32_t k = 0; k < count; k++) {
@@ -222,21 +226,21 @@ namespace xr::su {
             xr::InsertExtensionStruct(getInfo, typesFilter);
         }
 
-        XrSceneComponentStatesMSFT sceneComponents{XR_TYPE_SCENE_COMPONENT_STATES_MSFT};
-        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents));
-        const uint32_t count = sceneComponents.componentCountOutput;
+        XrSceneComponentStatesMSFT countQuery{XR_TYPE_SCENE_COMPONENT_STATES_MSFT};
+        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &countQuery));
+        const uint32_t count = countQuery.componentCountOutput;
 
+        xr::StructChain<XrSceneComponentStatesMSFT, XrSceneMeshStatesMSFT> sceneComponents;
         std::vector<XrSceneComponentStateMSFT> components(count);
-        sceneComponents.componentCapacityInput = count;
-        sceneComponents.components = components.data();
+        sceneComponents->componentCapacityInput = count;
+        sceneComponents->components = components.data();
 
         std::vector<XrSceneMeshStateMSFT> meshes(count);
-        XrSceneMeshStatesMSFT sceneMeshes{XR_TYPE_SCENE_MESH_STATES_MSFT};
+        XrSceneMeshStatesMSFT& sceneMeshes = sceneComponents.Get<XrSceneMeshStatesMSFT>();
         sceneMeshes.sceneMeshCount = count;
         sceneMeshes.sceneMeshes = meshes.data();
-        xr::InsertExtensionStruct(sceneComponents, sceneMeshes);
 
-        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, &sceneComponents));
+        CHECK_XRCMD(extensions.xrGetSceneComponentsMSFT(scene, &getInfo, sceneComponents.Get()));
 
         std::vector<SceneColliderMesh> result(count);
         for (uint32_t k = 0; k < count; k++) {
@@ -249,6 +253,73 @@ namespace xr::su {
         return result;
     }
 
+    // The vertices and 32-bit indices of several scene meshes in one contiguous allocation each.
+    // Indices are relative to the first vertex of their mesh.
+    struct SceneMeshSlab {
+        struct Range {
+            uint32_t firstVertex;
+            uint32_t vertexCount;
+            uint32_t firstIndex;
+            uint32_t indexCount;
+        };
+
+        std::vector<XrVector3f> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<Range> meshes; // In the order of the meshes passed to ReadMeshBuffers.
+
+        inline const XrVector3f* MeshVertices(size_t mesh) const {
+            return vertices.data() + meshes[mesh].firstVertex;
+        }
+
+        inline const uint32_t* MeshIndices(size_t mesh) const {
+            return indices.data() + meshes[mesh].firstIndex;
+        }
+    };
+
+    // Reads the mesh buffers of several meshes into a slab. The sizes of all meshes are queried first, then the slab is
+    // grown once to fit all of them, and each mesh is read straight into its range. The slab keeps its capacity, so
+    // reading a scene that didn't grow into the same slab again doesn't allocate.
+    // TMesh is SceneMesh, SceneColliderMesh or ScenePlane. Meshes without a mesh buffer get an empty range.
+    template <typename TMesh>
+    void ReadMeshBuffers(XrSceneMSFT scene,
+                         const xr::ExtensionDispatchTable& extensions,
+                         const std::vector<TMesh>& meshes,
+                         SceneMeshSlab& slab) {
+        slab.meshes.resize(meshes.size());
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        for (size_t k = 0; k < meshes.size(); k++) {
+            MeshBufferCounts counts;
+            if (meshes[k].meshBufferId != 0) {
+                // A size query, which only returns false because nothing was copied.
+                uint32_t* const noIndices = nullptr;
+                TryReadMeshBuffers(scene, extensions, meshes[k].meshBufferId, nullptr, 0, noIndices, 0, counts);
+            }
+            slab.meshes[k] = {vertexCount, counts.vertexCount, indexCount, counts.indexCount};
+            vertexCount += counts.vertexCount;
+            indexCount += counts.indexCount;
+        }
+
+        slab.vertices.resize(vertexCount);
+        slab.indices.resize(indexCount);
+        for (size_t k = 0; k < meshes.size(); k++) {
+            const SceneMeshSlab::Range& range = slab.meshes[k];
+            if (range.vertexCount == 0 && range.indexCount == 0) {
+                continue;
+            }
+            MeshBufferCounts counts;
+            CHECK(TryReadMeshBuffers(scene,
+                                     extensions,
+                                     meshes[k].meshBufferId,
+                                     slab.vertices.data() + range.firstVertex,
+                                     range.vertexCount,
+                                     slab.indices.data() + range.firstIndex,
+                                     range.indexCount,
+                                     counts));
+            CHECK(counts.vertexCount == range.vertexCount && counts.indexCount == range.indexCount);
+        }
+    }
+
     // Locate components given space and time.
     template <typename TUuid>
     void LocateObjects(XrSceneMSFT scene,
@@ -272,6 +343,142 @@ namespace xr::su {
         CHECK_XRCMD(extensions.xrLocateSceneComponentsMSFT(scene, &locateInfo, &componentLocations));
     }
 
+    // The components of one type of a scene in structure-of-arrays layout: element k of every column belongs to the same
+    // component, so filters and spatial queries can scan only the columns they need.
+    template <typename TId>
+    struct SceneComponentColumns {
+        std::vector<TId> ids;
+        std::vector<SceneObject::Id> parentObjectIds;
+        std::vector<XrTime> updateTimes;
+
+        inline size_t size() const noexcept {
+            return ids.size();
+        }
+    };
+
+    struct SceneObjectColumns : SceneComponentColumns<SceneObject::Id> {
+        std::vector<SceneObject::Type> types;
+    };
+
+    struct ScenePlaneColumns : SceneComponentColumns<ScenePlane::Id> {
+        std::vector<ScenePlane::Alignment> alignments;
+        std::vector<ScenePlane::Extent> sizes;
+        std::vector<uint64_t> meshBufferIds;
+        std::vector<uint8_t> supportsIndicesUint16; // Not std::vector<bool>, so the column can be scanned as bytes.
+    };
+
+    template <typename TId>
+    struct SceneMeshColumns : SceneComponentColumns<TId> {
+        std::vector<uint64_t> meshBufferIds;
+        std::vector<uint8_t> supportsIndicesUint16;
+    };
+
+    // The components of a scene, as returned by Scene::Snapshot. Component types that were not requested stay empty.
+    struct SceneComponentSnapshot {
+        SceneObjectColumns objects;
+        ScenePlaneColumns planes;
+        SceneMeshColumns<SceneMesh::Id> visualMeshes;
+        SceneMeshColumns<SceneColliderMesh::Id> colliderMeshes;
+    };
+
+    namespace detail {
+        template <typename TId, typename TComponent>
+        inline void FillComponentColumns(const std::vector<TComponent>& components, SceneComponentColumns<TId>& columns) {
+            columns.ids.resize(components.size());
+            columns.parentObjectIds.resize(components.size());
+            columns.updateTimes.resize(components.size());
+            for (size_t k = 0; k < components.size(); k++) {
+                columns.ids[k] = components[k].id;
+                columns.parentObjectIds[k] = components[k].parentObjectId;
+                columns.updateTimes[k] = components[k].updateTime;
+            }
+        }
+
+        inline void FillColumns(const std::vector<SceneObject>& objects, SceneObjectColumns& columns) {
+            FillComponentColumns(objects, columns);
+            columns.types.resize(objects.size());
+            for (size_t k = 0; k < objects.size(); k++) {
+                columns.types[k] = objects[k].type;
+            }
+        }
+
+        inline void FillColumns(const std::vector<ScenePlane>& planes, ScenePlaneColumns& columns) {
+            FillComponentColumns(planes, columns);
+            columns.alignments.resize(planes.size());
+            columns.sizes.resize(planes.size());
+            columns.meshBufferIds.resize(planes.size());
+            columns.supportsIndicesUint16.resize(planes.size());
+            for (size_t k = 0; k < planes.size(); k++) {
+                columns.alignments[k] = planes[k].alignment;
+                columns.sizes[k] = planes[k].size;
+                columns.meshBufferIds[k] = planes[k].meshBufferId;
+                columns.supportsIndicesUint16[k] = planes[k].supportsIndicesUint16 ? 1 : 0;
+            }
+        }
+
+        // TMesh is SceneMesh or SceneColliderMesh.
+        template <typename TMesh>
+        inline void FillColumns(const std::vector<TMesh>& meshes, SceneMeshColumns<typename TMesh::Id>& columns) {
+            FillComponentColumns(meshes, columns);
+            columns.meshBufferIds.resize(meshes.size());
+            columns.supportsIndicesUint16.resize(meshes.size());
+            for (size_t k = 0; k < meshes.size(); k++) {
+                columns.meshBufferIds[k] = meshes[k].meshBufferId;
+                columns.supportsIndicesUint16[k] = meshes[k].supportsIndicesUint16 ? 1 : 0;
+            }
+        }
+    } // namespace detail
+
+    // Queries all components of the requested types of a scene with the getters above, and transposes them into columns.
+    // With runInParallel, each component type is queried on its own task of the standard library's thread pool and the
+    // calling thread waits for all of them; errors of any query are rethrown on the calling thread.
+    inline SceneComponentSnapshot GetSceneComponentSnapshot(XrSceneMSFT scene,
+                                                            const xr::ExtensionDispatchTable& extensions,
+                                                            const std::vector<XrSceneComponentTypeMSFT>& componentTypes,
+                                                            bool runInParallel = true) {
+        // Each component type is queried once, since two parallel queries of the same type would write the same columns.
+        std::vector<XrSceneComponentTypeMSFT> uniqueComponentTypes = componentTypes;
+        std::sort(uniqueComponentTypes.begin(), uniqueComponentTypes.end());
+        uniqueComponentTypes.erase(std::unique(uniqueComponentTypes.begin(), uniqueComponentTypes.end()), uniqueComponentTypes.end());
+
+        SceneComponentSnapshot snapshot;
+        std::vector<std::future<void>> queries;
+        for (const XrSceneComponentTypeMSFT componentType : uniqueComponentTypes) {
+            std::function<void()> query;
+            switch (componentType) {
+            case XR_SCENE_COMPONENT_TYPE_OBJECT_MSFT:
+                query = [&] { detail::FillColumns(GetSceneObjects(scene, extensions), snapshot.objects); };
+                break;
+            case XR_SCENE_COMPONENT_TYPE_PLANE_MSFT:
+                query = [&] { detail::FillColumns(GetScenePlanes(scene, extensions), snapshot.planes); };
+                break;
+            case XR_SCENE_COMPONENT_TYPE_VISUAL_MESH_MSFT:
+                query = [&] { detail::FillColumns(GetSceneVisualMeshes(scene, extensions), snapshot.visualMeshes); };
+                break;
+            case XR_SCENE_COMPONENT_TYPE_COLLIDER_MESH_MSFT:
+                query = [&] { detail::FillColumns(GetSceneColliderMeshes(scene, extensions), snapshot.colliderMeshes); };
+                break;
+            default:
+                throw std::invalid_argument("Unsupported scene component type");
+            }
+
+            if (runInParallel) {
+                queries.push_back(std::async(std::launch::async, std::move(query)));
+            } else {
+                query();
+            }
+        }
+
+        // Wait for all queries before rethrowing, since they write to the snapshot.
+        for (std::future<void>& query : queries) {
+            query.wait();
+        }
+        for (std::future<void>& query : queries) {
+            query.get();
+        }
+        return snapshot;
+    }
+
     // C++ wrapper for XrSceneMSFT
     struct Scene {
         Scene(const xr::ExtensionDispatchTable& extensions, XrSceneObserverMSFT sceneObserver)
@@ -313,6 +520,31 @@ namespace xr::su {
             return GetSceneColliderMeshes(m_scene.Get(), m_extensions, parentObjectId, filterObjectType);
         }
 
+        // Reads the mesh buffers of a component of this scene into the given vectors, reusing their storage.
+        inline void ReadMeshBuffers(uint64_t meshBufferId,
+                                    std::vector<XrVector3f>& vertexBuffer,
+                                    std::vector<uint32_t>& indexBuffer) const {
+            xr::ReadMeshBuffers(m_scene.Get(), m_extensions, meshBufferId, vertexBuffer, indexBuffer);
+        }
+
+        inline void ReadMeshBuffers(uint64_t meshBufferId,
+                                    std::vector<XrVector3f>& vertexBuffer,
+                                    std::vector<uint16_t>& indexBuffer) const {
+            xr::ReadMeshBuffers(m_scene.Get(), m_extensions, meshBufferId, vertexBuffer, indexBuffer);
+        }
+
+        // Queries all components of the requested types in structure-of-arrays layout, one task per component type.
+        inline SceneComponentSnapshot Snapshot(const std::vector<XrSceneComponentTypeMSFT>& componentTypes,
+                                               bool runInParallel = true) const {
+            return GetSceneComponentSnapshot(m_scene.Get(), m_extensions, componentTypes, runInParallel);
+        }
+
+        // Reads the mesh buffers of several meshes of this scene into one slab.
+        template <typename TMesh>
+        inline void ReadMeshBuffers(const std::vector<TMesh>& meshes, SceneMeshSlab& slab) const {
+            xr::su::ReadMeshBuffers(m_scene.Get(), m_extensions, meshes, slab);
+        }
+
         inline XrSceneMSFT Handle() const noexcept {
             return m_scene.Get();
         }
@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+#include "XrSceneUnderstanding.hpp"
+
+namespace xr::su {
+    // Keeps the mesh buffers of the scene components of one type across scenes computed by the same scene observer.
+    //
+    // Components keep their id from one scene to the next, and their updateTime only changes when the component changed.
+    // Update therefore only reads the mesh buffers of components that are new or have a newer updateTime than the cached
+    // copy, and drops the components that are no longer in the scene. The vertex and index vectors of updated entries are
+    // reused, so their storage stays allocated. Which entries changed is reported by Update, so that only their GPU buffers
+    // need to be uploaded again.
+    //
+    // TComponent is SceneMesh, SceneColliderMesh or ScenePlane. Planes without a mesh buffer are cached without vertices.
+    template <typename TComponent>
+    class SceneMeshCache {
+    public:
+        using Id = typename TComponent::Id;
+
+        struct Entry {
+            TComponent component; // As found in the latest scene.
+            std::vector<XrVector3f> vertices;
+            std::vector<uint32_t> indices;
+        };
+
+        struct Changes {
+            std::vector<Id> added;
+            std::vector<Id> updated;
+            std::vector<Id> removed;
+
+            bool empty() const noexcept {
+                return added.empty() && updated.empty() && removed.empty();
+            }
+
+            void clear() noexcept {
+                added.clear();
+                updated.clear();
+                removed.clear();
+            }
+        };
+
+        // Updates the cache to the components of a new scene. The components are the result of GetVisualMeshes,
+        // GetColliderMeshes or GetPlanes of the same scene.
+        void Update(const Scene& scene, const std::vector<TComponent>& components, Changes* changes = nullptr) {
+            if (changes != nullptr) {
+                changes->clear();
+            }
+            m_generation++;
+
+            for (const TComponent& component : components) {
+                auto [it, inserted] = m_entries.try_emplace(component.id);
+                Entry& entry = it->second.entry;
+                it->second.generation = m_generation;
+
+                const bool changed = inserted || component.updateTime > entry.component.updateTime;
+                entry.component = component; // The mesh buffer id is only valid within the scene it came from.
+                if (!changed) {
+                    continue;
+                }
+
+                if (component.meshBufferId != 0) {
+                    scene.ReadMeshBuffers(component.meshBufferId, entry.vertices, entry.indices);
+                } else {
+                    entry.vertices.clear();
+                    entry.indices.clear();
+                }
+
+                if (changes != nullptr) {
+                    (inserted ? changes->added : changes->updated).push_back(component.id);
+                }
+            }
+
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                if (it->second.generation != m_generation) {
+                    if (changes != nullptr) {
+                        changes->removed.push_back(it->first);
+                    }
+                    it = m_entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // Returns the cached entry of a component, or nullptr if it is not in the latest scene.
+        const Entry* Find(const Id& id) const {
+            const auto it = m_entries.find(id);
+            return it != m_entries.end() ? &it->second.entry : nullptr;
+        }
+
+        size_t Size() const noexcept {
+            return m_entries.size();
+        }
+
+        template <typename TFunc>
+        void ForEach(TFunc&& func) const {
+            for (const auto& [id, tracked] : m_entries) {
+                func(id, tracked.entry);
+            }
+        }
+
+        void Clear() noexcept {
+            m_entries.clear();
+        }
+
+    private:
+        struct TrackedEntry {
+            Entry entry;
+            uint64_t generation = 0; // The Update call that last saw the component.
+        };
+
+        std::unordered_map<Id, TrackedEntry> m_entries;
+        uint64_t m_generation = 0;
+    };
+
+    using SceneVisualMeshCache = SceneMeshCache<SceneMesh>;
+    using SceneColliderMeshCache = SceneMeshCache<SceneColliderMesh>;
+    using ScenePlaneMeshCache = SceneMeshCache<ScenePlane>;
+} // namespace xr::su
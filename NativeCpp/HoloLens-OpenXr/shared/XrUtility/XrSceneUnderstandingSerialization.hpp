@@ -47,4 +47,26 @@ namespace xr::su {
         return buffer;
     }
 
+    // Reads all serialized fragments of a scene that was computed with XR_SCENE_COMPUTE_FEATURE_SERIALIZE_SCENE_MSFT.
+    inline std::vector<std::vector<uint8_t>> ReadSerializedScene(XrSceneMSFT scene, const xr::ExtensionDispatchTable& extensions) {
+        const std::vector<SceneFragment> fragments = GetSerializedSceneFragments(scene, extensions);
+        std::vector<std::vector<uint8_t>> result;
+        result.reserve(fragments.size());
+        for (const SceneFragment& fragment : fragments) {
+            result.push_back(ReadSceneFragmentData(scene, extensions, fragment.id));
+        }
+        return result;
+    }
+
+    // Begins deserializing a scene asynchronously. Like after ComputeNewScene, the scene observer reports the completion through
+    // its compute state, and CreateScene then returns the deserialized scene. Keep the fragment buffers valid until then.
+    inline void DeserializeScene(XrSceneObserverMSFT sceneObserver,
+                                 const xr::ExtensionDispatchTable& extensions,
+                                 const std::vector<XrDeserializeSceneFragmentMSFT>& fragments) {
+        XrSceneDeserializeInfoMSFT deserializeInfo{XR_TYPE_SCENE_DESERIALIZE_INFO_MSFT};
+        deserializeInfo.fragmentCount = static_cast<uint32_t>(fragments.size());
+        deserializeInfo.fragments = fragments.data();
+        CHECK_XRCMD(extensions.xrDeserializeSceneMSFT(sceneObserver, &deserializeInfo));
+    }
+
 } // namespace xr::su
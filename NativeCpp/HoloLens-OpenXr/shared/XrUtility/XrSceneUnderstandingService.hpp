@@ -0,0 +1,277 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "XrSceneUnderstandingCache.hpp"
+#if XR_MSFT_scene_understanding_serialization_preview
+#include "XrSceneUnderstandingSerialization.hpp"
+#endif
+
+namespace xr::su {
+    // Vertices and indices of a scene mesh, shared by all snapshots in which the mesh is unchanged.
+    struct SceneMeshData {
+        XrTime updateTime;
+        SceneObject::Id parentObjectId;
+        std::vector<XrVector3f> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    // An immutable result of one scene compute. The scene is kept alive for LocateObjects as long as the snapshot is used.
+    struct SceneSnapshot {
+        uint64_t version = 0; // Increments with every published snapshot.
+        std::shared_ptr<const Scene> scene;
+        std::vector<SceneObject> objects;
+        std::vector<ScenePlane> planes;
+        std::unordered_map<SceneMesh::Id, std::shared_ptr<const SceneMeshData>> visualMeshes;
+        std::unordered_map<SceneColliderMesh::Id, std::shared_ptr<const SceneMeshData>> colliderMeshes;
+    };
+
+    // Computes scenes on a worker thread and publishes them as snapshots to the rendering thread.
+    //
+    // The worker starts a new scene compute every computeInterval, polls the observer until the compute completes, then
+    // reads the scene objects, planes and meshes of the requested features. Meshes go through a SceneMeshCache, so only
+    // the buffers of components that changed since the previous scene are read and copied into new SceneMeshData; all
+    // other meshes are shared with the previous snapshot. The finished snapshot replaces the published one with an atomic
+    // swap, so GetLatestSnapshot never waits for the worker and a snapshot never changes while the renderer holds it.
+    //
+    // With serialization enabled, every serializeEveryNthScene-th compute also requests the serialized scene and passes its
+    // fragments to onSceneSerialized, so that the application can cache the scene. A cached scene given to LoadSerializedScene
+    // is deserialized before the next compute and published like a computed scene, unless a computed scene came first.
+    //
+    // An OpenXR error on the worker stops it; HasFailed then returns true. The extension dispatch table and the session
+    // must outlive the service.
+    class SceneUnderstandingService {
+    public:
+        struct Options {
+            std::vector<XrSceneComputeFeatureMSFT> features;
+            std::chrono::milliseconds computeInterval{2000}; // From the start of one compute to the start of the next.
+            std::chrono::milliseconds pollInterval{50};      // Between compute state queries.
+            bool disableInferredSceneObjects = false;
+            std::optional<XrMeshComputeLodMSFT> visualMeshLevelOfDetail;
+#if XR_MSFT_scene_understanding_serialization_preview
+            uint32_t serializeEveryNthScene = 0; // 0 disables serialization.
+            std::function<void(std::vector<std::vector<uint8_t>> fragments)> onSceneSerialized; // Called on the worker thread.
+#endif
+        };
+
+        SceneUnderstandingService(const xr::ExtensionDispatchTable& extensions, XrSession session, Options options, SceneBounds bounds)
+            : m_extensions(extensions)
+            , m_observer(extensions, session)
+            , m_options(std::move(options))
+            , m_bounds(std::move(bounds)) {
+#if XR_MSFT_scene_understanding_serialization_preview
+            m_serializingFeatures = m_options.features;
+            m_serializingFeatures.push_back(XR_SCENE_COMPUTE_FEATURE_SERIALIZE_SCENE_MSFT);
+#endif
+            m_worker = std::thread([this] { Run(); });
+        }
+
+        ~SceneUnderstandingService() {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopRequested = true;
+            }
+            m_wakeUp.notify_all();
+            m_worker.join();
+        }
+
+        SceneUnderstandingService(const SceneUnderstandingService&) = delete;
+        SceneUnderstandingService& operator=(const SceneUnderstandingService&) = delete;
+
+        // Sets the bounds of the next scene compute, e.g. to follow the user. Can be called from any thread.
+        void SetBounds(SceneBounds bounds) {
+            std::lock_guard lock(m_mutex);
+            m_bounds = std::move(bounds);
+        }
+
+        // Returns the latest published snapshot, or nullptr if no scene has been computed yet. Can be called from any thread.
+        std::shared_ptr<const SceneSnapshot> GetLatestSnapshot() const {
+            return std::atomic_load(&m_snapshot);
+        }
+
+#if XR_MSFT_scene_understanding_serialization_preview
+        // Deserializes a previously serialized scene before the next compute. The fragments, e.g. a view of a memory-mapped file,
+        // are kept alive until the deserialization completed. Ignored once a computed scene was published. Can be called from any
+        // thread.
+        void LoadSerializedScene(std::shared_ptr<const std::vector<XrDeserializeSceneFragmentMSFT>> fragments) {
+            std::lock_guard lock(m_mutex);
+            m_serializedScene = std::move(fragments);
+        }
+#endif
+
+        bool HasFailed() const noexcept {
+            return m_failed;
+        }
+
+    private:
+        void Run() {
+            try {
+                auto nextComputeTime = std::chrono::steady_clock::now();
+                while (WaitUntil(nextComputeTime)) {
+                    nextComputeTime = std::chrono::steady_clock::now() + m_options.computeInterval;
+
+                    SceneBounds bounds;
+                    {
+                        std::lock_guard lock(m_mutex);
+                        bounds = m_bounds;
+                    }
+#if XR_MSFT_scene_understanding_serialization_preview
+                    if (!DeserializePendingScene()) {
+                        return;
+                    }
+                    const bool serialize = m_options.serializeEveryNthScene > 0 && m_options.onSceneSerialized &&
+                                           m_computedSceneCount % m_options.serializeEveryNthScene == 0;
+                    const std::vector<XrSceneComputeFeatureMSFT>& features = serialize ? m_serializingFeatures : m_options.features;
+#else
+                    const std::vector<XrSceneComputeFeatureMSFT>& features = m_options.features;
+#endif
+                    m_observer.ComputeNewScene(features, bounds, m_options.disableInferredSceneObjects, m_options.visualMeshLevelOfDetail);
+                    if (!WaitForSceneCompute()) {
+                        return;
+                    }
+
+                    if (m_observer.GetSceneComputeState() == XR_SCENE_COMPUTE_STATE_COMPLETED_WITH_ERROR_MSFT) {
+                        DEBUG_PRINT("Scene compute completed with an error, keeping the previous scene.");
+                        continue;
+                    }
+
+                    const std::shared_ptr<const SceneSnapshot> snapshot(ReadSnapshot());
+                    std::atomic_store(&m_snapshot, snapshot);
+                    m_computedSceneCount++;
+#if XR_MSFT_scene_understanding_serialization_preview
+                    if (serialize) {
+                        m_options.onSceneSerialized(ReadSerializedScene(snapshot->scene->Handle(), m_extensions));
+                    }
+#endif
+                }
+            } catch (const std::exception& ex) {
+                DEBUG_PRINT("Scene understanding stopped: %s", ex.what());
+                m_failed = true;
+            }
+        }
+
+        // Polls the scene observer until its compute or deserialization completed. Returns false if the service is shutting down.
+        bool WaitForSceneCompute() {
+            while (!m_observer.IsSceneComputeCompleted()) {
+                if (!WaitUntil(std::chrono::steady_clock::now() + m_options.pollInterval)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+#if XR_MSFT_scene_understanding_serialization_preview
+        // Publishes the scene given to LoadSerializedScene, if any. Returns false if the service is shutting down.
+        bool DeserializePendingScene() {
+            std::shared_ptr<const std::vector<XrDeserializeSceneFragmentMSFT>> fragments;
+            {
+                std::lock_guard lock(m_mutex);
+                fragments = std::move(m_serializedScene);
+                m_serializedScene = nullptr;
+            }
+            if (fragments == nullptr || fragments->empty() || m_computedSceneCount > 0) {
+                return true;
+            }
+
+            DeserializeScene(m_observer.Handle(), m_extensions, *fragments);
+            if (!WaitForSceneCompute()) {
+                return false;
+            }
+
+            if (m_observer.GetSceneComputeState() == XR_SCENE_COMPUTE_STATE_COMPLETED_WITH_ERROR_MSFT) {
+                DEBUG_PRINT("The serialized scene cannot be deserialized, waiting for the computed scene.");
+            } else {
+                std::atomic_store(&m_snapshot, std::shared_ptr<const SceneSnapshot>(ReadSnapshot()));
+            }
+            return true;
+        }
+#endif
+
+        // Waits until the given time. Returns false if the service is shutting down.
+        bool WaitUntil(std::chrono::steady_clock::time_point time) {
+            std::unique_lock lock(m_mutex);
+            return !m_wakeUp.wait_until(lock, time, [this] { return m_stopRequested; });
+        }
+
+        bool HasFeature(XrSceneComputeFeatureMSFT feature) const {
+            return std::find(m_options.features.begin(), m_options.features.end(), feature) != m_options.features.end();
+        }
+
+        std::unique_ptr<SceneSnapshot> ReadSnapshot() {
+            auto snapshot = std::make_unique<SceneSnapshot>();
+            snapshot->version = ++m_version;
+
+            std::shared_ptr<const Scene> scene = m_observer.CreateScene();
+            snapshot->scene = scene;
+            snapshot->objects = scene->GetObjects();
+            if (HasFeature(XR_SCENE_COMPUTE_FEATURE_PLANE_MSFT)) {
+                snapshot->planes = scene->GetPlanes();
+            }
+            if (HasFeature(XR_SCENE_COMPUTE_FEATURE_VISUAL_MESH_MSFT)) {
+                UpdateMeshes(*scene, scene->GetVisualMeshes(), m_visualMeshCache, m_visualMeshes);
+                snapshot->visualMeshes = m_visualMeshes;
+            }
+            if (HasFeature(XR_SCENE_COMPUTE_FEATURE_COLLIDER_MESH_MSFT)) {
+                UpdateMeshes(*scene, scene->GetColliderMeshes(), m_colliderMeshCache, m_colliderMeshes);
+                snapshot->colliderMeshes = m_colliderMeshes;
+            }
+            return snapshot;
+        }
+
+        // Brings the published meshes up to date with the cache, creating new mesh data only for changed components.
+        template <typename TComponent>
+        static void UpdateMeshes(const Scene& scene,
+                                 const std::vector<TComponent>& components,
+                                 SceneMeshCache<TComponent>& cache,
+                                 std::unordered_map<typename TComponent::Id, std::shared_ptr<const SceneMeshData>>& meshes) {
+            typename SceneMeshCache<TComponent>::Changes changes;
+            cache.Update(scene, components, &changes);
+
+            for (const auto& id : changes.removed) {
+                meshes.erase(id);
+            }
+            for (const auto* changed : {&changes.added, &changes.updated}) {
+                for (const auto& id : *changed) {
+                    const auto* entry = cache.Find(id);
+                    meshes[id] = std::make_shared<const SceneMeshData>(
+                        SceneMeshData{entry->component.updateTime, entry->component.parentObjectId, entry->vertices, entry->indices});
+                }
+            }
+        }
+
+        const xr::ExtensionDispatchTable& m_extensions;
+        SceneObserver m_observer;
+        const Options m_options;
+        std::thread m_worker;
+
+        // Shared with other threads:
+        std::mutex m_mutex;
+        std::condition_variable m_wakeUp;
+        bool m_stopRequested = false;
+        SceneBounds m_bounds;
+        std::shared_ptr<const SceneSnapshot> m_snapshot; // Only accessed through std::atomic_load and std::atomic_store.
+        std::atomic<bool> m_failed{false};
+#if XR_MSFT_scene_understanding_serialization_preview
+        std::shared_ptr<const std::vector<XrDeserializeSceneFragmentMSFT>> m_serializedScene;
+        std::vector<XrSceneComputeFeatureMSFT> m_serializingFeatures;
+#endif
+
+        // Owned by the worker:
+        uint64_t m_version = 0;
+        uint64_t m_computedSceneCount = 0;
+        SceneVisualMeshCache m_visualMeshCache;
+        SceneColliderMeshCache m_colliderMeshCache;
+        std::unordered_map<SceneMesh::Id, std::shared_ptr<const SceneMeshData>> m_visualMeshes;
+        std::unordered_map<SceneColliderMesh::Id, std::shared_ptr<const SceneMeshData>> m_colliderMeshes;
+    };
+} // namespace xr::su
@@ -0,0 +1,486 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cfloat>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <DirectXCollision.h>
+#include "XrSceneUnderstanding.hpp"
+
+namespace xr::su {
+    namespace detail {
+        using namespace xr::math;
+
+        inline XrVector3f Cross(const XrVector3f& a, const XrVector3f& b) {
+            return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+        }
+
+        inline float Component(const XrVector3f& v, int axis) {
+            return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+        }
+
+        inline XrVector3f RotateVector(const XrQuaternionf& orientation, const XrVector3f& v) {
+            XrVector3f result;
+            StoreXrVector3(&result, DirectX::XMVector3Rotate(LoadXrVector3(v), LoadXrQuaternion(orientation)));
+            return result;
+        }
+
+        inline XrVector3f InverseRotateVector(const XrQuaternionf& orientation, const XrVector3f& v) {
+            XrVector3f result;
+            StoreXrVector3(&result, DirectX::XMVector3InverseRotate(LoadXrVector3(v), LoadXrQuaternion(orientation)));
+            return result;
+        }
+
+        struct Aabb {
+            XrVector3f min{FLT_MAX, FLT_MAX, FLT_MAX};
+            XrVector3f max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+            void Grow(const XrVector3f& p) {
+                min = {std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z)};
+                max = {std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z)};
+            }
+
+            void Grow(const Aabb& other) {
+                Grow(other.min);
+                Grow(other.max);
+            }
+
+            XrVector3f Center() const {
+                return (min + max) * 0.5f;
+            }
+
+            // Slab test of a ray given by its origin and the reciprocal of its direction.
+            bool IntersectsRay(const XrVector3f& origin, const XrVector3f& inverseDirection, float maxDistance) const {
+                float entry = 0;
+                float exit = maxDistance;
+                for (int axis = 0; axis < 3; axis++) {
+                    const float t0 = (Component(min, axis) - Component(origin, axis)) * Component(inverseDirection, axis);
+                    const float t1 = (Component(max, axis) - Component(origin, axis)) * Component(inverseDirection, axis);
+                    entry = std::max(entry, std::min(t0, t1));
+                    exit = std::min(exit, std::max(t0, t1));
+                }
+                return entry <= exit;
+            }
+
+            float DistanceSquared(const XrVector3f& p) const {
+                const XrVector3f clamped{std::clamp(p.x, min.x, max.x), std::clamp(p.y, min.y, max.y), std::clamp(p.z, min.z, max.z)};
+                const XrVector3f d = p - clamped;
+                return Dot(d, d);
+            }
+
+            Aabb Transformed(const XrPosef& pose) const {
+                Aabb result;
+                for (int corner = 0; corner < 8; corner++) {
+                    const XrVector3f p{(corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z};
+                    result.Grow(RotateVector(pose.orientation, p) + pose.position);
+                }
+                return result;
+            }
+
+            DirectX::BoundingBox ToBoundingBox() const {
+                const XrVector3f center = Center();
+                const XrVector3f extents = (max - min) * 0.5f;
+                return DirectX::BoundingBox({center.x, center.y, center.z}, {extents.x, extents.y, extents.z});
+            }
+        };
+
+        // A bounding volume hierarchy over primitives given by their bounds, split at the median of the longest axis.
+        class Bvh {
+        public:
+            static constexpr uint32_t MaxLeafSize = 4;
+
+            void Build(const std::vector<Aabb>& primitiveBounds) {
+                m_nodes.clear();
+                m_primitives.resize(primitiveBounds.size());
+                std::iota(m_primitives.begin(), m_primitives.end(), 0);
+                if (primitiveBounds.empty()) {
+                    return;
+                }
+                m_nodes.reserve(2 * primitiveBounds.size());
+                m_nodes.emplace_back();
+                BuildNode(0, 0, static_cast<uint32_t>(primitiveBounds.size()), primitiveBounds);
+            }
+
+            const Aabb& Bounds() const {
+                static const Aabb empty;
+                return m_nodes.empty() ? empty : m_nodes[0].bounds;
+            }
+
+            // Calls visitPrimitive(index) for every primitive in the nodes for which enterNode(bounds) returns true.
+            template <typename TEnterNode, typename TVisitPrimitive>
+            void Traverse(TEnterNode&& enterNode, TVisitPrimitive&& visitPrimitive) const {
+                if (m_nodes.empty()) {
+                    return;
+                }
+                uint32_t stack[64];
+                uint32_t stackSize = 0;
+                stack[stackSize++] = 0;
+                while (stackSize > 0) {
+                    const Node& node = m_nodes[stack[--stackSize]];
+                    if (!enterNode(node.bounds)) {
+                        continue;
+                    }
+                    if (node.count > 0) {
+                        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                            visitPrimitive(m_primitives[i]);
+                        }
+                    } else {
+                        stack[stackSize++] = node.first;
+                        stack[stackSize++] = node.first + 1;
+                    }
+                }
+            }
+
+        private:
+            struct Node {
+                Aabb bounds;
+                uint32_t first = 0; // First primitive of a leaf, or the left child of an inner node. The right child follows it.
+                uint32_t count = 0; // 0 for inner nodes.
+            };
+
+            void BuildNode(uint32_t nodeIndex, uint32_t first, uint32_t count, const std::vector<Aabb>& primitiveBounds) {
+                Aabb bounds;
+                Aabb centroidBounds;
+                for (uint32_t i = first; i < first + count; i++) {
+                    bounds.Grow(primitiveBounds[m_primitives[i]]);
+                    centroidBounds.Grow(primitiveBounds[m_primitives[i]].Center());
+                }
+                m_nodes[nodeIndex].bounds = bounds;
+
+                if (count <= MaxLeafSize) {
+                    m_nodes[nodeIndex].first = first;
+                    m_nodes[nodeIndex].count = count;
+                    return;
+                }
+
+                const XrVector3f extent = centroidBounds.max - centroidBounds.min;
+                const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+                const uint32_t middle = first + count / 2;
+                std::nth_element(m_primitives.begin() + first,
+                                 m_primitives.begin() + middle,
+                                 m_primitives.begin() + first + count,
+                                 [&](uint32_t a, uint32_t b) {
+                                     return Component(primitiveBounds[a].Center(), axis) < Component(primitiveBounds[b].Center(), axis);
+                                 });
+
+                const uint32_t left = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+                m_nodes.emplace_back();
+                m_nodes[nodeIndex].first = left;
+                m_nodes[nodeIndex].count = 0;
+                BuildNode(left, first, middle - first, primitiveBounds);
+                BuildNode(left + 1, middle, first + count - middle, primitiveBounds);
+            }
+
+            std::vector<Node> m_nodes;
+            std::vector<uint32_t> m_primitives;
+        };
+
+        // Moeller-Trumbore ray-triangle intersection, returns the distance along the ray or a negative value for a miss.
+        inline float IntersectRayTriangle(
+            const XrVector3f& origin, const XrVector3f& direction, const XrVector3f& a, const XrVector3f& b, const XrVector3f& c) {
+            const XrVector3f ab = b - a;
+            const XrVector3f ac = c - a;
+            const XrVector3f p = Cross(direction, ac);
+            const float determinant = Dot(ab, p);
+            if (std::abs(determinant) < 1e-9f) {
+                return -1;
+            }
+            const float inverseDeterminant = 1 / determinant;
+            const XrVector3f s = origin - a;
+            const float u = Dot(s, p) * inverseDeterminant;
+            if (u < 0 || u > 1) {
+                return -1;
+            }
+            const XrVector3f q = Cross(s, ab);
+            const float v = Dot(direction, q) * inverseDeterminant;
+            if (v < 0 || u + v > 1) {
+                return -1;
+            }
+            return Dot(ac, q) * inverseDeterminant;
+        }
+
+        // The closest point of a triangle to p, from Ericson, Real-Time Collision Detection, 5.1.5.
+        inline XrVector3f ClosestPointOnTriangle(const XrVector3f& p, const XrVector3f& a, const XrVector3f& b, const XrVector3f& c) {
+            const XrVector3f ab = b - a;
+            const XrVector3f ac = c - a;
+            const XrVector3f ap = p - a;
+            const float d1 = Dot(ab, ap);
+            const float d2 = Dot(ac, ap);
+            if (d1 <= 0 && d2 <= 0) {
+                return a;
+            }
+            const XrVector3f bp = p - b;
+            const float d3 = Dot(ab, bp);
+            const float d4 = Dot(ac, bp);
+            if (d3 >= 0 && d4 <= d3) {
+                return b;
+            }
+            const float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+                return a + ab * (d1 / (d1 - d3));
+            }
+            const XrVector3f cp = p - c;
+            const float d5 = Dot(ab, cp);
+            const float d6 = Dot(ac, cp);
+            if (d6 >= 0 && d5 <= d6) {
+                return c;
+            }
+            const float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+                return a + ac * (d2 / (d2 - d6));
+            }
+            const float va = d3 * d6 - d5 * d4;
+            if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+                return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+            }
+            const float denominator = 1 / (va + vb + vc);
+            return a + ab * (vb * denominator) + ac * (vc * denominator);
+        }
+    } // namespace detail
+
+    enum class SceneSurfaceKind { Plane, ColliderMesh };
+
+    // A point on a surface of the spatial index, in the space the components were located in.
+    struct SceneSurfaceHit {
+        SceneSurfaceKind kind;
+        XrUuidMSFT id;       // The ScenePlane::Id or SceneColliderMesh::Id.
+        float distance;      // Along the ray, or from the query point.
+        XrVector3f position;
+        XrVector3f normal;   // Of the triangle hit, facing the ray origin or the query point.
+    };
+
+    // A two-level bounding volume hierarchy over the planes and collider meshes of a scene, for placing holograms
+    // against real surfaces.
+    //
+    // Every surface keeps a triangle hierarchy in its own space, which is only rebuilt when the surface's updateTime
+    // changes; new locations just move its world bounds. The top level over the world bounds of all surfaces is rebuilt
+    // on every update, which is cheap for the few hundred surfaces of a room. Planes are quads in the XY plane of their
+    // pose, centered on it. Components whose location isn't valid are left out until they are located again.
+    class SceneSpatialIndex {
+    public:
+        // Updates the planes, with locations from LocateObjects for the same ids in the same order.
+        void UpdatePlanes(const std::vector<ScenePlane>& planes, const std::vector<XrSceneComponentLocationMSFT>& locations) {
+            CHECK(planes.size() == locations.size());
+            UpdateSurfaces(
+                SceneSurfaceKind::Plane,
+                locations,
+                [&](size_t k) { return std::make_pair(static_cast<XrUuidMSFT>(planes[k].id), planes[k].updateTime); },
+                [&](size_t k, Surface& surface) {
+                    const float x = planes[k].size.width * 0.5f;
+                    const float y = planes[k].size.height * 0.5f;
+                    surface.vertices = {{-x, -y, 0}, {x, -y, 0}, {x, y, 0}, {-x, y, 0}};
+                    surface.indices = {0, 1, 2, 0, 2, 3};
+                });
+        }
+
+        // Updates the collider meshes, reading the mesh buffers of the changed ones from the scene.
+        void UpdateColliderMeshes(const Scene& scene,
+                                  const std::vector<SceneColliderMesh>& meshes,
+                                  const std::vector<XrSceneComponentLocationMSFT>& locations) {
+            CHECK(meshes.size() == locations.size());
+            UpdateSurfaces(
+                SceneSurfaceKind::ColliderMesh,
+                locations,
+                [&](size_t k) { return std::make_pair(static_cast<XrUuidMSFT>(meshes[k].id), meshes[k].updateTime); },
+                [&](size_t k, Surface& surface) { scene.ReadMeshBuffers(meshes[k].meshBufferId, surface.vertices, surface.indices); });
+        }
+
+        // Updates the collider meshes from buffers that were already read, e.g. the SceneMeshData of a SceneUnderstandingService
+        // snapshot: meshes[k] has the updateTime, vertices and indices of ids[k]. Only the buffers of changed meshes are copied.
+        template <typename TMeshData>
+        void UpdateColliderMeshes(const std::vector<SceneColliderMesh::Id>& ids,
+                                  const std::vector<const TMeshData*>& meshes,
+                                  const std::vector<XrSceneComponentLocationMSFT>& locations) {
+            CHECK(ids.size() == meshes.size() && ids.size() == locations.size());
+            UpdateSurfaces(
+                SceneSurfaceKind::ColliderMesh,
+                locations,
+                [&](size_t k) { return std::make_pair(static_cast<XrUuidMSFT>(ids[k]), meshes[k]->updateTime); },
+                [&](size_t k, Surface& surface) {
+                    surface.vertices = meshes[k]->vertices;
+                    surface.indices = meshes[k]->indices;
+                });
+        }
+
+        // Removes all surfaces, e.g. when the scene they came from is discarded.
+        void Clear() {
+            m_surfaces.clear();
+            m_surfaceList.clear();
+            m_topLevel.Build({});
+        }
+
+        // Finds the closest surface hit by a ray within maxDistance. direction must be normalized.
+        std::optional<SceneSurfaceHit> Raycast(const XrVector3f& origin, const XrVector3f& direction, float maxDistance) const {
+            std::optional<SceneSurfaceHit> hit;
+            float closest = maxDistance;
+            const XrVector3f inverseDirection = Reciprocal(direction);
+            m_topLevel.Traverse([&](const detail::Aabb& bounds) { return bounds.IntersectsRay(origin, inverseDirection, closest); },
+                                [&](uint32_t index) { RaycastSurface(*m_surfaceList[index], origin, direction, closest, hit); });
+            return hit;
+        }
+
+        // Finds the closest point on any surface within maxDistance of a point.
+        std::optional<SceneSurfaceHit> FindNearestSurface(const XrVector3f& point, float maxDistance) const {
+            std::optional<SceneSurfaceHit> hit;
+            float closestSquared = maxDistance * maxDistance;
+            m_topLevel.Traverse([&](const detail::Aabb& bounds) { return bounds.DistanceSquared(point) < closestSquared; },
+                                [&](uint32_t index) { FindNearestOnSurface(*m_surfaceList[index], point, closestSquared, hit); });
+            return hit;
+        }
+
+        // Appends the ids of the surfaces whose world bounds overlap the frustum.
+        void FindSurfacesInFrustum(const DirectX::BoundingFrustum& frustum, std::vector<XrUuidMSFT>& ids) const {
+            m_topLevel.Traverse([&](const detail::Aabb& bounds) { return frustum.Intersects(bounds.ToBoundingBox()); },
+                                [&](uint32_t index) {
+                                    if (frustum.Intersects(m_surfaceList[index]->worldBounds.ToBoundingBox())) {
+                                        ids.push_back(m_surfaceList[index]->id);
+                                    }
+                                });
+        }
+
+        size_t Size() const noexcept {
+            return m_surfaceList.size();
+        }
+
+    private:
+        struct Surface {
+            SceneSurfaceKind kind;
+            XrUuidMSFT id;
+            XrTime updateTime = 0;
+            XrPosef pose;
+            std::vector<XrVector3f> vertices; // In the space of the pose.
+            std::vector<uint32_t> indices;
+            detail::Bvh triangles;
+            detail::Aabb worldBounds;
+            uint64_t generation = 0;
+
+            std::tuple<XrVector3f, XrVector3f, XrVector3f> Triangle(uint32_t triangle) const {
+                return {vertices[indices[triangle * 3]], vertices[indices[triangle * 3 + 1]], vertices[indices[triangle * 3 + 2]]};
+            }
+
+            void BuildTriangles() {
+                std::vector<detail::Aabb> bounds(indices.size() / 3);
+                for (uint32_t k = 0; k < bounds.size(); k++) {
+                    const auto [a, b, c] = Triangle(k);
+                    bounds[k].Grow(a);
+                    bounds[k].Grow(b);
+                    bounds[k].Grow(c);
+                }
+                triangles.Build(bounds);
+            }
+        };
+
+        static XrVector3f Reciprocal(const XrVector3f& v) {
+            return {1 / v.x, 1 / v.y, 1 / v.z};
+        }
+
+        // Turns a local triangle normal into a world normal facing against the given local direction.
+        static SceneSurfaceHit MakeHit(
+            const Surface& surface, float distance, const XrVector3f& position, XrVector3f localNormal, const XrVector3f& localDirection) {
+            using namespace xr::math;
+            if (Dot(localNormal, localDirection) > 0) {
+                localNormal = localNormal * -1.0f;
+            }
+            return {surface.kind, surface.id, distance, position, detail::RotateVector(surface.pose.orientation, Normalize(localNormal))};
+        }
+
+        void RaycastSurface(const Surface& surface,
+                            const XrVector3f& origin,
+                            const XrVector3f& direction,
+                            float& closest,
+                            std::optional<SceneSurfaceHit>& hit) const {
+            using namespace xr::math;
+            const XrVector3f localOrigin = detail::InverseRotateVector(surface.pose.orientation, origin - surface.pose.position);
+            const XrVector3f localDirection = detail::InverseRotateVector(surface.pose.orientation, direction);
+            const XrVector3f localInverseDirection = Reciprocal(localDirection);
+            surface.triangles.Traverse(
+                [&](const detail::Aabb& bounds) { return bounds.IntersectsRay(localOrigin, localInverseDirection, closest); },
+                [&](uint32_t triangle) {
+                    const auto [a, b, c] = surface.Triangle(triangle);
+                    const float t = detail::IntersectRayTriangle(localOrigin, localDirection, a, b, c);
+                    if (t >= 0 && t < closest) {
+                        closest = t;
+                        hit = MakeHit(surface, t, origin + direction * t, detail::Cross(b - a, c - a), localDirection);
+                    }
+                });
+        }
+
+        void FindNearestOnSurface(const Surface& surface,
+                                  const XrVector3f& point,
+                                  float& closestSquared,
+                                  std::optional<SceneSurfaceHit>& hit) const {
+            using namespace xr::math;
+            const XrVector3f localPoint = detail::InverseRotateVector(surface.pose.orientation, point - surface.pose.position);
+            surface.triangles.Traverse([&](const detail::Aabb& bounds) { return bounds.DistanceSquared(localPoint) < closestSquared; },
+                                       [&](uint32_t triangle) {
+                                           const auto [a, b, c] = surface.Triangle(triangle);
+                                           const XrVector3f localClosest = detail::ClosestPointOnTriangle(localPoint, a, b, c);
+                                           const XrVector3f toSurface = localClosest - localPoint;
+                                           const float distanceSquared = Dot(toSurface, toSurface);
+                                           if (distanceSquared < closestSquared) {
+                                               closestSquared = distanceSquared;
+                                               const XrVector3f position =
+                                                   detail::RotateVector(surface.pose.orientation, localClosest) + surface.pose.position;
+                                               const XrVector3f normal = detail::Cross(b - a, c - a);
+                                               hit = MakeHit(surface, std::sqrt(distanceSquared), position, normal, toSurface);
+                                           }
+                                       });
+        }
+
+        // getComponent(k) returns the id and updateTime of component k, readGeometry(k, surface) reads its vertices and indices.
+        template <typename TGetComponent, typename TReadGeometry>
+        void UpdateSurfaces(SceneSurfaceKind kind,
+                            const std::vector<XrSceneComponentLocationMSFT>& locations,
+                            TGetComponent&& getComponent,
+                            TReadGeometry&& readGeometry) {
+            m_generation++;
+
+            constexpr XrSpaceLocationFlags validFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+            for (size_t k = 0; k < locations.size(); k++) {
+                if ((locations[k].flags & validFlags) != validFlags) {
+                    continue;
+                }
+
+                const auto [id, updateTime] = getComponent(k);
+                auto [it, inserted] = m_surfaces.try_emplace(id);
+                Surface& surface = it->second;
+                if (inserted || updateTime > surface.updateTime) {
+                    surface.kind = kind;
+                    surface.id = id;
+                    surface.updateTime = updateTime;
+                    readGeometry(k, surface);
+                    surface.BuildTriangles();
+                }
+                surface.pose = locations[k].pose;
+                surface.worldBounds = surface.triangles.Bounds().Transformed(surface.pose);
+                surface.generation = m_generation;
+            }
+
+            for (auto it = m_surfaces.begin(); it != m_surfaces.end();) {
+                if (it->second.kind == kind && it->second.generation != m_generation) {
+                    it = m_surfaces.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            m_surfaceList.clear();
+            std::vector<detail::Aabb> bounds;
+            bounds.reserve(m_surfaces.size());
+            for (const auto& [id, surface] : m_surfaces) {
+                m_surfaceList.push_back(&surface);
+                bounds.push_back(surface.worldBounds);
+            }
+            m_topLevel.Build(bounds);
+        }
+
+        std::unordered_map<XrUuidMSFT, Surface> m_surfaces;
+        std::vector<const Surface*> m_surfaceList; // Primitives of the top level.
+        detail::Bvh m_topLevel;
+        uint64_t m_generation = 0;
+    };
+} // namespace xr::su
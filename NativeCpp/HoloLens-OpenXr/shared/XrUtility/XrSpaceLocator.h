@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "XrError.h"
+#include "XrExtensions.h"
+#include "XrMath.h"
+
+namespace xr {
+    // Locates a set of spaces relative to a base space at a given time in a single pass.
+    // Spaces are gathered with Add, resolved together with Locate, and the results stay valid until the next Clear.
+    // When the runtime offers XR_KHR_locate_spaces all spaces are located with one xrLocateSpacesKHR call,
+    // otherwise this falls back to one xrLocateSpace call per space.
+    class SpaceLocator {
+    public:
+        constexpr static uint32_t InvalidIndex = static_cast<uint32_t>(-1);
+
+        void Reserve(size_t capacity) {
+            m_spaces.reserve(capacity);
+            m_locations.reserve(capacity);
+#if XR_KHR_locate_spaces
+            m_locationData.reserve(capacity);
+#endif
+        }
+
+        void Clear() {
+            m_spaces.clear();
+            m_locations.clear();
+        }
+
+        // Returns the index of the location of the space after Locate, or InvalidIndex for a null space.
+        uint32_t Add(XrSpace space) {
+            if (space == XR_NULL_HANDLE) {
+                return InvalidIndex;
+            }
+            m_spaces.push_back(space);
+            return static_cast<uint32_t>(m_spaces.size() - 1);
+        }
+
+        void Locate(const xr::ExtensionDispatchTable& extensions, XrSession session, XrSpace baseSpace, XrTime time) {
+            m_locations.resize(m_spaces.size(), {XR_TYPE_SPACE_LOCATION});
+            if (m_spaces.empty()) {
+                return;
+            }
+
+#if XR_KHR_locate_spaces
+            if (extensions.xrLocateSpacesKHR != nullptr) {
+                m_locationData.resize(m_spaces.size());
+
+                XrSpacesLocateInfoKHR locateInfo{XR_TYPE_SPACES_LOCATE_INFO_KHR};
+                locateInfo.baseSpace = baseSpace;
+                locateInfo.time = time;
+                locateInfo.spaceCount = static_cast<uint32_t>(m_spaces.size());
+                locateInfo.spaces = m_spaces.data();
+
+                XrSpaceLocationsKHR locations{XR_TYPE_SPACE_LOCATIONS_KHR};
+                locations.locationCount = static_cast<uint32_t>(m_locationData.size());
+                locations.locations = m_locationData.data();
+                CHECK_XRCMD(extensions.xrLocateSpacesKHR(session, &locateInfo, &locations));
+
+                for (size_t i = 0; i < m_locationData.size(); i++) {
+                    m_locations[i].locationFlags = m_locationData[i].locationFlags;
+                    m_locations[i].pose = m_locationData[i].pose;
+                }
+                return;
+            }
+#else
+            (void)extensions;
+            (void)session;
+#endif
+
+            for (size_t i = 0; i < m_spaces.size(); i++) {
+                CHECK_XRCMD(xrLocateSpace(m_spaces[i], baseSpace, time, &m_locations[i]));
+            }
+        }
+
+        size_t Size() const {
+            return m_spaces.size();
+        }
+
+        // Returns the located space, or nullptr if index is InvalidIndex.
+        const XrSpaceLocation* TryGetLocation(uint32_t index) const {
+            return index == InvalidIndex ? nullptr : &m_locations[index];
+        }
+
+    private:
+        std::vector<XrSpace> m_spaces;
+        std::vector<XrSpaceLocation> m_locations;
+#if XR_KHR_locate_spaces
+        std::vector<XrSpaceLocationDataKHR> m_locationData;
+#endif
+    };
+} // namespace xr
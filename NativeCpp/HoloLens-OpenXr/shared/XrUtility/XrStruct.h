@@ -4,6 +4,10 @@
 #pragma once
 
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <openxr/openxr_reflection.h>
 
 namespace xr {
     struct NameVersion {
@@ -45,6 +49,91 @@ namespace xr {
         xrStruct.next = &xrExtension;
     }
 
+    // The XrStructureType value of an OpenXR struct, e.g. StructureType<XrSceneMeshBuffersMSFT>::value.
+    template <typename XrStruct>
+    struct StructureType;
+
+#define DEFINE_STRUCTURE_TYPE(XrStruct, XR_TYPE) \
+    template <>                                  \
+    struct StructureType<XrStruct> : std::integral_constant<XrStructureType, XR_TYPE> {};
+
+    XR_LIST_STRUCTURE_TYPES(DEFINE_STRUCTURE_TYPE)
+#undef DEFINE_STRUCTURE_TYPE
+
+    // A struct followed by the extension structs in its next chain, in the order given, laid out in one object.
+    // The types and next pointers are set on construction, so a chain kept across calls only needs its inputs refreshed.
+    // Get<T> reads a struct of the chain by type, and doesn't compile for a struct that is not part of the chain.
+    template <typename XrStruct, typename... XrExtensions>
+    class StructChain {
+    public:
+        StructChain() noexcept {
+            Link();
+        }
+
+        StructChain(const StructChain& other) noexcept
+            : m_structs(other.m_structs) {
+            Link();
+        }
+
+        StructChain& operator=(const StructChain& other) noexcept {
+            m_structs = other.m_structs;
+            Link();
+            return *this;
+        }
+
+        // The head of the chain, to pass to the OpenXR function.
+        XrStruct* Get() noexcept {
+            return &std::get<0>(m_structs);
+        }
+
+        const XrStruct* Get() const noexcept {
+            return &std::get<0>(m_structs);
+        }
+
+        XrStruct* operator->() noexcept {
+            return Get();
+        }
+
+        const XrStruct* operator->() const noexcept {
+            return Get();
+        }
+
+        template <typename T>
+        T& Get() noexcept {
+            return std::get<T>(m_structs); // Also fails for a struct that appears twice, which can't be told apart by type.
+        }
+
+        template <typename T>
+        const T& Get() const noexcept {
+            return std::get<T>(m_structs);
+        }
+
+    private:
+        static constexpr size_t Count = 1 + sizeof...(XrExtensions);
+
+        void Link() noexcept {
+            Link(std::make_index_sequence<Count>());
+        }
+
+        template <size_t... Index>
+        void Link(std::index_sequence<Index...>) noexcept {
+            ((std::get<Index>(m_structs).type = StructureType<std::tuple_element_t<Index, Structs>>::value), ...);
+            ((std::get<Index>(m_structs).next = Next<Index + 1>()), ...);
+        }
+
+        template <size_t Index>
+        void* Next() noexcept {
+            if constexpr (Index < Count) {
+                return &std::get<Index>(m_structs);
+            } else {
+                return nullptr;
+            }
+        }
+
+        using Structs = std::tuple<XrStruct, XrExtensions...>;
+        Structs m_structs{};
+    };
+
     // Cast event data buffer to strongly typed event data if eventData->type matches.
     template <typename XrEventData>
     const XrEventData* event_cast(const XrEventDataBuffer* eventData) = delete;
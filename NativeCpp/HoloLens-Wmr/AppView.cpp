@@ -93,15 +93,22 @@ void AppView::Run()
         {
             CoreWindow::GetForCurrentThread().Dispatcher().ProcessEvents(CoreProcessEventsOption::ProcessAllIfPresent);
 
+            m_deviceResources->GetFrameProfiler().BeginFrame();
+
             HolographicFrame currentFrame = m_main->Update(previousFrame);
 
             if (m_main->Render(currentFrame))
             {
                 // The holographic frame has an API that presents the swap chain for each
                 // holographic camera.
+                // Present may recreate the device and with it the profiler, so look it up again afterwards.
+                m_deviceResources->GetFrameProfiler().BeginStage(DX::FrameStage::Present);
                 m_deviceResources->Present(currentFrame);
+                m_deviceResources->GetFrameProfiler().EndStage(DX::FrameStage::Present);
             }
 
+            m_deviceResources->GetFrameProfiler().EndFrame();
+
             previousFrame = currentFrame;
         }
         else
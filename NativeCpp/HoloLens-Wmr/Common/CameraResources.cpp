@@ -111,19 +111,6 @@ void DX::CameraResources::CreateResourcesForBackBuffer(
                 &m_d3dDepthStencilView
             ));
     }
-
-    // Create the constant buffer, if needed.
-    if (m_viewProjectionConstantBuffer == nullptr)
-    {
-        // Create a constant buffer to store view and projection matrices for the camera.
-        CD3D11_BUFFER_DESC constantBufferDesc(sizeof(ViewProjectionConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
-        winrt::check_hresult(
-            device->CreateBuffer(
-                &constantBufferDesc,
-                nullptr,
-                &m_viewProjectionConstantBuffer
-            ));
-    }
 }
 
 // Releases resources associated with a back buffer.
@@ -136,7 +123,6 @@ void DX::CameraResources::ReleaseResourcesForBackBuffer(DX::DeviceResources* pDe
     m_d3dDepthStencil.Reset();
     m_d3dRenderTargetView.Reset();
     m_d3dDepthStencilView.Reset();
-    m_viewProjectionConstantBuffer.Reset();
 
     // Ensure system references to the back buffer are released by clearing the render
     // target from the graphics pipeline state, and then flushing the Direct3D context.
@@ -145,7 +131,7 @@ void DX::CameraResources::ReleaseResourcesForBackBuffer(DX::DeviceResources* pDe
     context->Flush();
 }
 
-// Updates the view/projection constant buffer for a holographic camera.
+// Updates the view/projection constants for a holographic camera.
 void DX::CameraResources::UpdateViewProjectionBuffer(
     std::shared_ptr<DX::DeviceResources> deviceResources,
     HolographicCameraPose const& cameraPose,
@@ -174,7 +160,6 @@ void DX::CameraResources::UpdateViewProjectionBuffer(
     // This usually means that positional tracking is not active for the current frame, in
     // which case it is possible to use a SpatialLocatorAttachedFrameOfReference to render
     // content that is not world-locked instead.
-    DX::ViewProjectionConstantBuffer viewProjectionConstantBufferData;
     bool viewTransformAcquired = viewTransformContainer != nullptr;
     if (viewTransformAcquired)
     {
@@ -185,52 +170,32 @@ void DX::CameraResources::UpdateViewProjectionBuffer(
         // constantly moving relative to the world. The view matrices need to be updated
         // every frame.
         XMStoreFloat4x4(
-            &viewProjectionConstantBufferData.viewProjection[0],
+            &m_viewProjectionConstantBufferData.viewProjection[0],
             XMMatrixTranspose(XMLoadFloat4x4(&viewCoordinateSystemTransform.Left) * XMLoadFloat4x4(&cameraProjectionTransform.Left))
         );
         XMStoreFloat4x4(
-            &viewProjectionConstantBufferData.viewProjection[1],
+            &m_viewProjectionConstantBufferData.viewProjection[1],
             XMMatrixTranspose(XMLoadFloat4x4(&viewCoordinateSystemTransform.Right) * XMLoadFloat4x4(&cameraProjectionTransform.Right))
         );
     }
 
-    // Use the D3D device context to update Direct3D device-based resources.
-    ID3D11DeviceContext* context = deviceResources->GetD3DDeviceContext();
-
-    // Loading is asynchronous. Resources must be created before they can be updated.
-    if (context == nullptr || m_viewProjectionConstantBuffer == nullptr || !viewTransformAcquired)
-    {
-        m_framePending = false;
-    }
-    else
-    {
-        // Update the view and projection matrices.
-        context->UpdateSubresource(
-            m_viewProjectionConstantBuffer.Get(),
-            0,
-            nullptr,
-            &viewProjectionConstantBufferData,
-            0,
-            0
-        );
-
-        m_framePending = true;
-    }
+    // The matrices are uploaded when the camera is attached to the pipeline.
+    m_framePending = viewTransformAcquired;
 }
 
-// Gets the view-projection constant buffer for the HolographicCamera and attaches it
-// to the shader pipeline.
+// Copies the view-projection constants for the HolographicCamera into the constant buffer
+// ring and attaches them to the shader pipeline.
 bool DX::CameraResources::AttachViewProjectionBuffer(
     std::shared_ptr<DX::DeviceResources>& deviceResources
 )
 {
     // This method uses Direct3D device-based resources.
-    ID3D11DeviceContext* context = deviceResources->GetD3DDeviceContext();
+    ID3D11DeviceContext3* context = deviceResources->GetD3DDeviceContext();
 
     // Loading is asynchronous. Resources must be created before they can be updated.
     // Cameras can also be added asynchronously, in which case they must be initialized
     // before they can be used.
-    if (context == nullptr || m_viewProjectionConstantBuffer == nullptr || m_framePending == false)
+    if (context == nullptr || m_d3dRenderTargetView == nullptr || m_framePending == false)
     {
         return false;
     }
@@ -238,12 +203,10 @@ bool DX::CameraResources::AttachViewProjectionBuffer(
     // Set the viewport for this camera.
     context->RSSetViewports(1, &m_d3dViewport);
 
-    // Send the constant buffer to the vertex shader.
-    context->VSSetConstantBuffers(
-        1,
-        1,
-        m_viewProjectionConstantBuffer.GetAddressOf()
-    );
+    // Send the constants to the vertex shader. The allocation stays valid for the rest of the frame.
+    const ConstantBufferRing::Allocation viewProjection =
+        deviceResources->GetConstantBufferRing().Allocate(context, m_viewProjectionConstantBufferData);
+    ConstantBufferRing::VSSetConstantBuffer(context, 1, viewProjection);
 
     // The template includes a pass-through geometry shader that is used by
     // default on systems that don't support the D3D11_FEATURE_D3D11_OPTIONS3::
@@ -252,10 +215,12 @@ bool DX::CameraResources::AttachViewProjectionBuffer(
     // If your app will also use the geometry shader for other tasks and those
     // tasks require the view/projection matrix, uncomment the following line 
     // of code to send the constant buffer to the geometry shader as well.
-    /*context->GSSetConstantBuffers(
+    /*context->GSSetConstantBuffers1(
     1,
     1,
-    m_viewProjectionConstantBuffer.GetAddressOf()
+    &viewProjection.Buffer,
+    &viewProjection.FirstConstant,
+    &viewProjection.NumConstants
     );*/
 
     m_framePending = false;
@@ -58,8 +58,9 @@ namespace DX
         Microsoft::WRL::ComPtr<ID3D11Texture2D>                     m_d3dBackBuffer;
         Microsoft::WRL::ComPtr<ID3D11Texture2D>                     m_d3dDepthStencil;
 
-        // Device resource to store view and projection matrices.
-        Microsoft::WRL::ComPtr<ID3D11Buffer>                        m_viewProjectionConstantBuffer;
+        // View and projection matrices of the pending frame. They are copied into the device's constant
+        // buffer ring when the camera is attached to the pipeline.
+        ViewProjectionConstantBuffer                                m_viewProjectionConstantBufferData = {};
 
         // Direct3D rendering properties.
         DXGI_FORMAT                                                 m_dxgiFormat;
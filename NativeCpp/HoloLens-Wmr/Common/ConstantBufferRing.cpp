@@ -0,0 +1,77 @@
+#include "pch.h"
+
+#include "ConstantBufferRing.h"
+
+namespace
+{
+    constexpr UINT AlignUp(UINT value, UINT alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+DX::ConstantBufferRing::ConstantBufferRing(ID3D11Device* device, UINT bufferSizeInBytes) :
+    m_device(device),
+    m_bufferSizeInBytes(AlignUp(bufferSizeInBytes, AlignmentInBytes))
+{
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+    winrt::check_hresult(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)));
+    if (!options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer)
+    {
+        winrt::throw_hresult(DXGI_ERROR_UNSUPPORTED);
+    }
+
+    CreateBuffer();
+}
+
+void DX::ConstantBufferRing::BeginFrame()
+{
+    m_currentBuffer = 0;
+    m_offsetInBytes = 0;
+    m_discardCurrentBuffer = true;
+}
+
+DX::ConstantBufferRing::Allocation DX::ConstantBufferRing::Allocate(ID3D11DeviceContext1* context, void const* data, UINT sizeInBytes)
+{
+    const UINT alignedSize = AlignUp(sizeInBytes, AlignmentInBytes);
+    if (alignedSize > m_bufferSizeInBytes)
+    {
+        winrt::throw_hresult(E_INVALIDARG);
+    }
+
+    if (m_offsetInBytes + alignedSize > m_bufferSizeInBytes)
+    {
+        // Continue in the next buffer, the current one may still be bound.
+        m_currentBuffer++;
+        if (m_currentBuffer == m_buffers.size())
+        {
+            CreateBuffer();
+        }
+        m_offsetInBytes = 0;
+        m_discardCurrentBuffer = true;
+    }
+
+    ID3D11Buffer* buffer = m_buffers[m_currentBuffer].Get();
+    const D3D11_MAP mapType = m_discardCurrentBuffer ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+    m_discardCurrentBuffer = false;
+
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    winrt::check_hresult(context->Map(buffer, 0, mapType, 0, &mapped));
+    memcpy(static_cast<uint8_t*>(mapped.pData) + m_offsetInBytes, data, sizeInBytes);
+    context->Unmap(buffer, 0);
+
+    Allocation allocation;
+    allocation.Buffer = buffer;
+    allocation.FirstConstant = m_offsetInBytes / 16;
+    allocation.NumConstants = alignedSize / 16;
+    m_offsetInBytes += alignedSize;
+    return allocation;
+}
+
+void DX::ConstantBufferRing::CreateBuffer()
+{
+    const CD3D11_BUFFER_DESC desc(m_bufferSizeInBytes, D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+    Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+    winrt::check_hresult(m_device->CreateBuffer(&desc, nullptr, &buffer));
+    m_buffers.push_back(std::move(buffer));
+}
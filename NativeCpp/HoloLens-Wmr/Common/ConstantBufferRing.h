@@ -0,0 +1,57 @@
+#pragma once
+
+namespace DX
+{
+    // Sub-allocates per-draw shader constants from dynamic constant buffers without waiting for the GPU. Allocations stay
+    // valid until the next BeginFrame.
+    class ConstantBufferRing
+    {
+    public:
+        struct Allocation
+        {
+            ID3D11Buffer*       Buffer = nullptr;
+            UINT                FirstConstant = 0;  // In units of 16-byte shader constants.
+            UINT                NumConstants = 0;
+        };
+
+        // Requires D3D11.1 constant buffer offsetting.
+        ConstantBufferRing(ID3D11Device* device, UINT bufferSizeInBytes = DefaultBufferSizeInBytes);
+
+        // Starts a new frame. Allocations of the previous frame must not be bound for new draws after this.
+        void BeginFrame();
+
+        // Copies the data into the ring. The allocation stays valid until the next BeginFrame.
+        Allocation Allocate(ID3D11DeviceContext1* context, void const* data, UINT sizeInBytes);
+
+        template<typename T>
+        Allocation Allocate(ID3D11DeviceContext1* context, T const& data)
+        {
+            return Allocate(context, &data, sizeof(T));
+        }
+
+        static void VSSetConstantBuffer(ID3D11DeviceContext1* context, UINT slot, Allocation const& allocation)
+        {
+            context->VSSetConstantBuffers1(slot, 1, &allocation.Buffer, &allocation.FirstConstant, &allocation.NumConstants);
+        }
+
+        static void PSSetConstantBuffer(ID3D11DeviceContext1* context, UINT slot, Allocation const& allocation)
+        {
+            context->PSSetConstantBuffers1(slot, 1, &allocation.Buffer, &allocation.FirstConstant, &allocation.NumConstants);
+        }
+
+    private:
+        static constexpr UINT DefaultBufferSizeInBytes = 64 * 1024;
+
+        // Offsets and sizes passed to *SetConstantBuffers1 must be multiples of 16 constants.
+        static constexpr UINT AlignmentInBytes = 16 * 16;
+
+        void CreateBuffer();
+
+        Microsoft::WRL::ComPtr<ID3D11Device>                    m_device;
+        std::vector<Microsoft::WRL::ComPtr<ID3D11Buffer>>       m_buffers;
+        UINT                                                    m_bufferSizeInBytes;
+        size_t                                                  m_currentBuffer = 0;
+        UINT                                                    m_offsetInBytes = 0;
+        bool                                                    m_discardCurrentBuffer = true;
+    };
+}
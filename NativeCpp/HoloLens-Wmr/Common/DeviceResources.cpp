@@ -3,6 +3,8 @@
 #include "DeviceResources.h"
 #include "DirectXHelper.h"
 
+#include <thread>
+
 using namespace D2D1;
 using namespace Microsoft::WRL;
 using namespace winrt::Windows::Graphics::DirectX::Direct3D11;
@@ -13,6 +15,7 @@ using namespace winrt::Windows::Graphics::Holographic;
 DX::DeviceResources::DeviceResources()
 {
     CreateDeviceIndependentResources();
+    PublishCameraResourceTable(std::make_unique<CameraResourceTable>());
 }
 
 // Configures resources that don't depend on the Direct3D device.
@@ -190,6 +193,10 @@ void DX::DeviceResources::CreateDeviceResources()
     winrt::check_hresult(device.As(&m_d3dDevice));
     winrt::check_hresult(context.As(&m_d3dContext));
 
+    // Create the ring that per-frame shader constants are allocated from.
+    m_constantBufferRing = std::make_unique<ConstantBufferRing>(m_d3dDevice.Get());
+    m_frameProfiler = std::make_unique<FrameProfiler>(m_d3dDevice.Get());
+
     // Acquire the DXGI interface for the Direct3D device.
     ComPtr<IDXGIDevice3> dxgiDevice;
     winrt::check_hresult(m_d3dDevice.As(&dxgiDevice));
@@ -214,51 +221,170 @@ void DX::DeviceResources::CreateDeviceResources()
     {
         m_supportsVprt = true;
     }
+
+#ifdef RUN_STEREO_RENDERING_BENCHMARK
+    // Measure the stereo rendering paths before any content is created, then let the content use the fastest one.
+    const StereoRenderingBenchmark::Results results = StereoRenderingBenchmark::Run(m_d3dDevice.Get(), m_d3dContext.Get(), m_supportsVprt);
+    StereoRenderingBenchmark::Report(results);
+    m_stereoRenderingPath = StereoRenderingBenchmark::SelectFastestContentPath(results, m_supportsVprt);
+#else
+    m_stereoRenderingPath = GetDefaultStereoRenderingPath(m_supportsVprt);
+#endif
 }
 
 // Validates the back buffer for each HolographicCamera and recreates
 // resources for back buffers that have changed.
-// Locks the set of holographic camera resources until the function exits.
+// Also frees the cameras that were removed since the last frame, since the render thread no longer uses them.
 void DX::DeviceResources::EnsureCameraResources(
     HolographicFrame frame,
     HolographicFramePrediction prediction)
 {
-    UseHolographicCameraResources<void>([this, frame, prediction](std::map<UINT32, std::unique_ptr<CameraResources>>& cameraResourceMap)
+    ReleaseRetiredCameraResources();
+
+    UseHolographicCameraResources<void>([this, frame, prediction](CameraResourceTable const& cameraResources)
     {
         for (HolographicCameraPose const& cameraPose : prediction.CameraPoses())
         {
             HolographicCameraRenderingParameters renderingParameters = frame.GetRenderingParameters(cameraPose);
-            CameraResources* pCameraResources = cameraResourceMap[cameraPose.HolographicCamera().Id()].get();
+            CameraResources* pCameraResources = cameraResources.Find(cameraPose.HolographicCamera().Id());
 
-            pCameraResources->CreateResourcesForBackBuffer(this, renderingParameters);
+            if (pCameraResources != nullptr)
+            {
+                pCameraResources->CreateResourcesForBackBuffer(this, renderingParameters);
+            }
         }
     });
 }
 
 // Prepares to allocate resources and adds resource views for a camera.
-// Locks the set of holographic camera resources until the function exits.
+// Publishes a copy of the camera table that includes the new camera.
 void DX::DeviceResources::AddHolographicCamera(HolographicCamera camera)
 {
-    UseHolographicCameraResources<void>([this, camera](std::map<UINT32, std::unique_ptr<CameraResources>>& cameraResourceMap)
+    std::lock_guard<std::mutex> guard(m_cameraResourcesLock);
+
+    auto table = std::make_unique<CameraResourceTable>(*m_cameraResources);
+    auto& entries = table->m_entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), camera.Id(),
+        [](CameraResourceTable::Entry const& entry, UINT32 id) { return entry.first < id; });
+    if (it != entries.end() && it->first == camera.Id())
     {
-        cameraResourceMap[camera.Id()] = std::make_unique<CameraResources>(camera);
-    });
+        std::shared_ptr<CameraResources> replacedCameraResources = std::move(it->second);
+        it->second = std::make_shared<CameraResources>(camera);
+        PublishCameraResourceTable(std::move(table));
+
+        ReleaseBackBufferResources(*replacedCameraResources);
+        m_retiredCameraResources.push_back(std::move(replacedCameraResources));
+        return;
+    }
+
+    entries.emplace(it, camera.Id(), std::make_shared<CameraResources>(camera));
+    PublishCameraResourceTable(std::move(table));
 }
 
-// Deallocates resources for a camera and removes the camera from the set.
-// Locks the set of holographic camera resources until the function exits.
+// Removes the camera from the set and deallocates the resources of its back buffer before returning, as required by the
+// CameraRemoved event. Publishes a copy of the camera table that no longer includes the camera; the CameraResources
+// object itself is freed on the render thread at the start of the next frame.
 void DX::DeviceResources::RemoveHolographicCamera(HolographicCamera camera)
 {
-    UseHolographicCameraResources<void>([this, camera](std::map<UINT32, std::unique_ptr<CameraResources>>& cameraResourceMap)
+    std::lock_guard<std::mutex> guard(m_cameraResourcesLock);
+
+    auto table = std::make_unique<CameraResourceTable>(*m_cameraResources);
+    auto& entries = table->m_entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), camera.Id(),
+        [](CameraResourceTable::Entry const& entry, UINT32 id) { return entry.first < id; });
+    if (it == entries.end() || it->first != camera.Id())
+    {
+        return;
+    }
+
+    std::shared_ptr<CameraResources> removedCameraResources = std::move(it->second);
+    entries.erase(it);
+    PublishCameraResourceTable(std::move(table));
+
+    ReleaseBackBufferResources(*removedCameraResources);
+    m_retiredCameraResources.push_back(std::move(removedCameraResources));
+}
+
+// Releases the back buffer of a camera that is no longer in the current table. Must be called with m_cameraResourcesLock
+// held, so that only one release is pending at a time. Waits until the render thread is not inside
+// UseHolographicCameraResources: the frame that still sees the camera has then finished with it, and a frame that starts
+// before the release is done waits in BeginCameraResourceRead, so it does not render while the render targets are unbound.
+void DX::DeviceResources::ReleaseBackBufferResources(CameraResources& cameraResources)
+{
+    m_backBufferReleasePending.store(true);
+    while (m_renderThreadReading.load())
+    {
+        std::this_thread::yield();
+    }
+
+    UseD3DDeviceContext([this, &cameraResources](auto)
+    {
+        cameraResources.ReleaseResourcesForBackBuffer(this);
+    });
+
+    m_backBufferReleasePending.store(false);
+}
+
+// Marks the render thread as using the current table and returns it. The flags are sequentially consistent, so either
+// the render thread sees a pending back buffer release and steps back, or the releasing thread sees it reading and waits.
+DX::CameraResourceTable const& DX::DeviceResources::BeginCameraResourceRead()
+{
+    for (;;)
     {
-        CameraResources* pCameraResources = cameraResourceMap[camera.Id()].get();
+        m_renderThreadReading.store(true);
+        if (!m_backBufferReleasePending.load())
+        {
+            break;
+        }
 
-        if (pCameraResources != nullptr)
+        m_renderThreadReading.store(false);
+        while (m_backBufferReleasePending.load())
         {
-            pCameraResources->ReleaseResourcesForBackBuffer(this);
-            cameraResourceMap.erase(camera.Id());
+            std::this_thread::yield();
         }
-    });
+    }
+
+    return *m_currentCameraResources.load(std::memory_order_acquire);
+}
+
+void DX::DeviceResources::EndCameraResourceRead()
+{
+    m_renderThreadReading.store(false);
+}
+
+// Makes the table the current one. Must be called with m_cameraResourcesLock held, except from the constructor.
+void DX::DeviceResources::PublishCameraResourceTable(std::unique_ptr<CameraResourceTable> table)
+{
+    m_currentCameraResources.store(table.get(), std::memory_order_release);
+    if (m_cameraResources != nullptr)
+    {
+        // The render thread may still be reading the old table.
+        m_retiredCameraTables.push_back(std::move(m_cameraResources));
+    }
+    m_cameraResources = std::move(table);
+    m_hasRetiredCameraResources.store(true, std::memory_order_release);
+}
+
+// Frees replaced camera tables and removed cameras, whose back buffers were already released. Must be called on the
+// render thread outside of UseHolographicCameraResources, when no old table can be in use anymore.
+void DX::DeviceResources::ReleaseRetiredCameraResources()
+{
+    if (!m_hasRetiredCameraResources.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::vector<std::unique_ptr<CameraResourceTable>> retiredTables;
+    std::vector<std::shared_ptr<CameraResources>> retiredCameras;
+    {
+        std::lock_guard<std::mutex> guard(m_cameraResourcesLock);
+        retiredTables.swap(m_retiredCameraTables);
+        retiredCameras.swap(m_retiredCameraResources);
+        m_hasRetiredCameraResources.store(false, std::memory_order_relaxed);
+    }
+
+    retiredTables.clear();
+    retiredCameras.clear();
 }
 
 // Recreate all device resources and set them back to the current state.
@@ -270,9 +396,11 @@ void DX::DeviceResources::HandleDeviceLost()
         m_deviceNotify->OnDeviceLost();
     }
 
-    UseHolographicCameraResources<void>([this](std::map<UINT32, std::unique_ptr<CameraResources>>& cameraResourceMap)
+    ReleaseRetiredCameraResources();
+
+    UseHolographicCameraResources<void>([this](CameraResourceTable const& cameraResources)
     {
-        for (auto& pair : cameraResourceMap)
+        for (auto& pair : cameraResources)
         {
             CameraResources* pCameraResources = pair.second.get();
             pCameraResources->ReleaseResourcesForBackBuffer(this);
@@ -314,7 +442,7 @@ void DX::DeviceResources::Trim()
 // Locks the set of holographic camera resources until the function exits.
 void DX::DeviceResources::Present(HolographicFrame const& frame)
 {
-    HolographicFramePresentResult presentResult = frame.PresentUsingCurrentPrediction(HolographicFramePresentWaitBehavior::DoNotWaitForFrameToFinish);
+    HolographicFramePresentResult presentResult = frame.PresentUsingCurrentPrediction(m_presentWaitBehavior);
 
     // The PresentUsingCurrentPrediction API will detect when the graphics device
     // changes or becomes invalid. When this happens, it is considered a Direct3D
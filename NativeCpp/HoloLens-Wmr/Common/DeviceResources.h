@@ -2,6 +2,9 @@
 #pragma once
 
 #include "CameraResources.h"
+#include "ConstantBufferRing.h"
+#include "FrameProfiler.h"
+#include "StereoRendering.h"
 
 namespace DX
 {
@@ -12,6 +15,30 @@ namespace DX
         virtual void OnDeviceRestored() = 0;
     };
 
+    // An immutable snapshot of the resources of all attached holographic cameras, sorted by camera id.
+    // DeviceResources publishes a new table whenever a camera is added or removed, so the render thread reads it without a lock.
+    class CameraResourceTable
+    {
+    public:
+        using Entry = std::pair<UINT32, std::shared_ptr<CameraResources>>;
+
+        // Returns the resources of the camera, or nullptr if the camera is not in the table.
+        CameraResources* Find(UINT32 cameraId) const
+        {
+            auto it = std::lower_bound(m_entries.begin(), m_entries.end(), cameraId,
+                [](Entry const& entry, UINT32 id) { return entry.first < id; });
+            return (it != m_entries.end() && it->first == cameraId) ? it->second.get() : nullptr;
+        }
+
+        std::vector<Entry>::const_iterator begin()              const { return m_entries.begin();       }
+        std::vector<Entry>::const_iterator end()                const { return m_entries.end();         }
+        size_t                  size()                          const { return m_entries.size();        }
+
+    private:
+        friend class DeviceResources;
+        std::vector<Entry>                                      m_entries;
+    };
+
     // Creates and manages a Direct3D device and immediate context, Direct2D device and context (for debug), and the holographic swap chain.
     class DeviceResources
     {
@@ -24,6 +51,9 @@ namespace DX
         void Trim();
         void Present(winrt::Windows::Graphics::Holographic::HolographicFrame const& frame);
 
+        // Apps that don't wait for the next frame themselves can let Present block until the GPU has finished the frame.
+        void SetPresentWaitBehavior(winrt::Windows::Graphics::Holographic::HolographicFramePresentWaitBehavior waitBehavior) { m_presentWaitBehavior = waitBehavior; }
+
         // Public methods related to holographic devices.
         void SetHolographicSpace(winrt::Windows::Graphics::Holographic::HolographicSpace space);
         void EnsureCameraResources(
@@ -45,6 +75,9 @@ namespace DX
         ID3D11DeviceContext3*   GetD3DDeviceContext()           const { return m_d3dContext.Get();      }
         D3D_FEATURE_LEVEL       GetDeviceFeatureLevel()         const { return m_d3dFeatureLevel;       }
         bool                    GetDeviceSupportsVprt()         const { return m_supportsVprt;          }
+        StereoRenderingPath     GetStereoRenderingPath()        const { return m_stereoRenderingPath;   }
+        ConstantBufferRing&     GetConstantBufferRing()         const { return *m_constantBufferRing;   }
+        FrameProfiler&          GetFrameProfiler()              const { return *m_frameProfiler;        }
 
         // DXGI acessors.
         IDXGIAdapter3*          GetDXGIAdapter()                const { return m_dxgiAdapter.Get();     }
@@ -63,12 +96,25 @@ namespace DX
         void InitializeUsingHolographicSpace();
         void CreateDeviceResources();
 
+        // Private methods related to the camera resource table.
+        void PublishCameraResourceTable(std::unique_ptr<CameraResourceTable> table);
+        void ReleaseBackBufferResources(CameraResources& cameraResources);
+        void ReleaseRetiredCameraResources();
+        CameraResourceTable const& BeginCameraResourceRead();
+        void EndCameraResourceRead();
+
         // Direct3D objects.
         Microsoft::WRL::ComPtr<ID3D11Device4>                   m_d3dDevice;
         Microsoft::WRL::ComPtr<ID3D11DeviceContext3>            m_d3dContext;
         Microsoft::WRL::ComPtr<IDXGIAdapter3>                   m_dxgiAdapter;
         mutable std::recursive_mutex                            m_d3dContextMutex;
 
+        // Per-frame shader constants are sub-allocated from this ring. Only used on the render thread.
+        std::unique_ptr<ConstantBufferRing>                     m_constantBufferRing;
+
+        // Measures the CPU and GPU time of the frame stages. Recreated with the device, so don't hold on to it across Present.
+        std::unique_ptr<FrameProfiler>                          m_frameProfiler;
+
         // Direct3D interop objects.
         winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice m_d3dInteropDevice;
 
@@ -90,23 +136,48 @@ namespace DX
         // for setting the render target array index from the vertex shader stage.
         bool                                                    m_supportsVprt = false;
 
-        // Back buffer resources, etc. for attached holographic cameras.
-        std::map<UINT32, std::unique_ptr<CameraResources>>      m_cameraResources;
+        // How local content renders both views, selected per device.
+        StereoRenderingPath                                     m_stereoRenderingPath = StereoRenderingPath::InstancedGeometryShader;
+
+        // How Present waits for the frame to finish.
+        winrt::Windows::Graphics::Holographic::HolographicFramePresentWaitBehavior m_presentWaitBehavior =
+            winrt::Windows::Graphics::Holographic::HolographicFramePresentWaitBehavior::DoNotWaitForFrameToFinish;
+
+        // Back buffer resources, etc. for attached holographic cameras. The current table is read on the render thread
+        // without taking a lock. Adding and removing cameras copies the table under m_cameraResourcesLock and publishes the copy.
+        // The back buffers of removed cameras are released right away: the writer raises m_backBufferReleasePending and
+        // waits until m_renderThreadReading shows that no frame is using a table, and a frame that starts meanwhile waits
+        // for the release to finish. Replaced tables and removed cameras are retired and freed by the render thread at the
+        // start of the next frame, when no frame can reference them anymore.
+        std::unique_ptr<CameraResourceTable>                    m_cameraResources;
+        std::atomic<CameraResourceTable const*>                 m_currentCameraResources = nullptr;
+        std::vector<std::unique_ptr<CameraResourceTable>>       m_retiredCameraTables;
+        std::vector<std::shared_ptr<CameraResources>>           m_retiredCameraResources;
+        std::atomic<bool>                                       m_hasRetiredCameraResources = false;
+        std::atomic<bool>                                       m_renderThreadReading = false;
+        std::atomic<bool>                                       m_backBufferReleasePending = false;
         std::mutex                                              m_cameraResourcesLock;
     };
 }
 
-// Device-based resources for holographic cameras are stored in a std::map. Access this list by providing a
-// callback to this function, and the std::map will be guarded from add and remove
-// events until the callback returns. The callback is processed immediately and must
-// not contain any nested calls to UseHolographicCameraResources.
-// The callback takes a parameter of type std::map<UINT32, std::unique_ptr<DX::CameraResources>>&
-// through which the list of cameras will be accessed.
+// Device-based resources for holographic cameras are stored in a CameraResourceTable. Access this list by providing a
+// callback to this function. The table passed to the callback does not change while the callback runs, even if cameras
+// are added or removed concurrently, and no lock is taken. A camera that is removed while the callback runs keeps its
+// back buffer until the callback returns; only a frame that starts during such a removal waits for it to finish.
+// This function must only be called from the render thread.
+// The callback takes a parameter of type DX::CameraResourceTable const& through which the list of cameras will be accessed.
 template<typename RetType, typename LCallback>
 RetType DX::DeviceResources::UseHolographicCameraResources(LCallback const& callback)
 {
-    std::lock_guard<std::mutex> guard(m_cameraResourcesLock);
-    return callback(m_cameraResources);
+    struct ReadScope
+    {
+        DeviceResources& deviceResources;
+        ~ReadScope() { deviceResources.EndCameraResourceRead(); }
+    };
+
+    CameraResourceTable const& cameraResources = BeginCameraResourceRead();
+    ReadScope readScope{ *this };
+    return callback(cameraResources);
 }
 
 template <typename F>
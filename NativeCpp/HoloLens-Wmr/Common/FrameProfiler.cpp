@@ -0,0 +1,272 @@
+#include "pch.h"
+
+#include "FrameProfiler.h"
+
+#include <TraceLoggingProvider.h>
+
+// Provider GUID is the ETW name hash of "Microsoft.Azure.RemoteRendering.Samples", shared with the HoloLens-OpenXr sample.
+TRACELOGGING_DEFINE_PROVIDER(
+    g_sampleTraceProvider,
+    "Microsoft.Azure.RemoteRendering.Samples",
+    (0x011839b0, 0x6b94, 0x543b, 0x89, 0x7f, 0x59, 0xaf, 0xe9, 0x43, 0xe1, 0x28));
+
+namespace
+{
+    struct FrameStageInfo
+    {
+        const char* Name;
+        bool MeasureGpu;
+    };
+
+    constexpr FrameStageInfo c_frameStages[] =
+    {
+        { "Update", false },
+        { "WaitForFrame", false },
+        { "Render", true },
+        { "BlitRemoteFrame", true },
+        { "StatusDisplay", true },
+        { "Present", false },
+    };
+    static_assert(std::size(c_frameStages) == static_cast<size_t>(DX::FrameStage::Count), "Every frame stage needs an entry.");
+
+    constexpr uint32_t c_noGpuStage = ~0u;
+
+    // The provider stays registered for the lifetime of the process, profilers are recreated with the device.
+    void EnsureTraceProviderRegistered()
+    {
+        struct Registration
+        {
+            Registration()
+            {
+                TraceLoggingRegister(g_sampleTraceProvider);
+            }
+            ~Registration()
+            {
+                TraceLoggingUnregister(g_sampleTraceProvider);
+            }
+        };
+        static Registration registration;
+    }
+
+    int64_t QueryTicks()
+    {
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+        return ticks.QuadPart;
+    }
+}
+
+DX::RollingPercentiles::Summary DX::RollingPercentiles::Compute() const
+{
+    Summary summary;
+    summary.Count = m_count;
+    if (m_count == 0)
+    {
+        return summary;
+    }
+
+    std::array<float, Capacity> sorted;
+    std::copy_n(m_samples.begin(), m_count, sorted.begin());
+    const auto begin = sorted.begin();
+    const auto end = sorted.begin() + m_count;
+    const auto percentile = [&](uint32_t percent)
+        {
+            const auto nth = begin + (m_count - 1) * percent / 100;
+            std::nth_element(begin, nth, end);
+            return *nth;
+        };
+    summary.P50 = percentile(50);
+    summary.P95 = percentile(95);
+    summary.P99 = percentile(99);
+    return summary;
+}
+
+DX::FrameProfiler::FrameProfiler(ID3D11Device* device)
+{
+    EnsureTraceProviderRegistered();
+
+    device->GetImmediateContext(&m_context);
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    m_millisecondsPerTick = 1000.0 / frequency.QuadPart;
+
+    const CD3D11_QUERY_DESC disjointDesc(D3D11_QUERY_TIMESTAMP_DISJOINT);
+    const CD3D11_QUERY_DESC timestampDesc(D3D11_QUERY_TIMESTAMP);
+    for (GpuFrame& frame : m_gpuFrames)
+    {
+        winrt::check_hresult(device->CreateQuery(&disjointDesc, &frame.Disjoint));
+        for (GpuStage& stage : frame.Stages)
+        {
+            winrt::check_hresult(device->CreateQuery(&timestampDesc, &stage.Begin));
+            winrt::check_hresult(device->CreateQuery(&timestampDesc, &stage.End));
+        }
+    }
+    m_openGpuStage.fill(c_noGpuStage);
+}
+
+void DX::FrameProfiler::BeginFrame()
+{
+    m_stageTicks.fill(0);
+    m_stageStartTicks.fill(0);
+    m_openGpuStage.fill(c_noGpuStage);
+
+    // Collect what the GPU has finished since the last frame, then reuse the oldest slot.
+    for (GpuFrame& frame : m_gpuFrames)
+    {
+        if (frame.Pending)
+        {
+            TryResolve(frame);
+        }
+    }
+
+    m_currentGpuFrame = &m_gpuFrames[m_frameIndex % FramesInFlight];
+    if (m_currentGpuFrame->Pending)
+    {
+        m_currentGpuFrame->Pending = false;
+        m_droppedGpuFrames++;
+    }
+    m_currentGpuFrame->FrameIndex = m_frameIndex;
+    m_currentGpuFrame->StageCount = 0;
+    m_context->Begin(m_currentGpuFrame->Disjoint.Get());
+}
+
+void DX::FrameProfiler::EndFrame()
+{
+    if (m_currentGpuFrame == nullptr)
+    {
+        return;
+    }
+
+    m_context->End(m_currentGpuFrame->Disjoint.Get());
+    m_currentGpuFrame->Pending = true;
+    m_currentGpuFrame = nullptr;
+
+    for (uint32_t i = 0; i < StageCount; i++)
+    {
+        if (m_stageTicks[i] == 0)
+        {
+            continue; // The stage didn't run in this frame.
+        }
+        const float milliseconds = static_cast<float>(m_stageTicks[i] * m_millisecondsPerTick);
+        m_cpuMilliseconds[i].Add(milliseconds);
+        TraceLoggingWrite(
+            g_sampleTraceProvider,
+            "FrameStageCpu",
+            TraceLoggingUInt64(m_frameIndex, "Frame"),
+            TraceLoggingString(c_frameStages[i].Name, "Stage"),
+            TraceLoggingFloat32(milliseconds, "Milliseconds"));
+    }
+
+    m_frameIndex++;
+    if (m_frameIndex % ReportIntervalInFrames == 0)
+    {
+        Report();
+    }
+}
+
+void DX::FrameProfiler::BeginStage(FrameStage stage)
+{
+    const uint32_t index = static_cast<uint32_t>(stage);
+    m_stageStartTicks[index] = QueryTicks();
+
+    if (m_currentGpuFrame != nullptr && c_frameStages[index].MeasureGpu && m_currentGpuFrame->StageCount < MaxGpuStagesPerFrame)
+    {
+        GpuStage& gpuStage = m_currentGpuFrame->Stages[m_currentGpuFrame->StageCount];
+        gpuStage.Stage = stage;
+        m_context->End(gpuStage.Begin.Get());
+        m_openGpuStage[index] = m_currentGpuFrame->StageCount++;
+    }
+}
+
+void DX::FrameProfiler::EndStage(FrameStage stage)
+{
+    const uint32_t index = static_cast<uint32_t>(stage);
+    if (m_stageStartTicks[index] == 0)
+    {
+        return; // The stage began before the current frame.
+    }
+    m_stageTicks[index] += QueryTicks() - m_stageStartTicks[index];
+    m_stageStartTicks[index] = 0;
+
+    if (m_currentGpuFrame != nullptr && m_openGpuStage[index] != c_noGpuStage)
+    {
+        m_context->End(m_currentGpuFrame->Stages[m_openGpuStage[index]].End.Get());
+        m_openGpuStage[index] = c_noGpuStage;
+    }
+}
+
+bool DX::FrameProfiler::TryResolve(GpuFrame& frame)
+{
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+    if (m_context->GetData(frame.Disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+    {
+        return false;
+    }
+
+    std::array<uint64_t, StageCount> stageTicks = {};
+    std::array<bool, StageCount> stageMeasured = {};
+    for (uint32_t i = 0; i < frame.StageCount; i++)
+    {
+        uint64_t begin, end;
+        if (m_context->GetData(frame.Stages[i].Begin.Get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            m_context->GetData(frame.Stages[i].End.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            return false;
+        }
+        stageTicks[static_cast<uint32_t>(frame.Stages[i].Stage)] += end - begin;
+        stageMeasured[static_cast<uint32_t>(frame.Stages[i].Stage)] = true;
+    }
+
+    frame.Pending = false;
+    if (disjoint.Disjoint)
+    {
+        // The GPU clock changed frequency during the frame, the timestamps can't be compared.
+        m_droppedGpuFrames++;
+        return true;
+    }
+
+    for (uint32_t i = 0; i < StageCount; i++)
+    {
+        if (stageMeasured[i])
+        {
+            const float milliseconds = static_cast<float>(stageTicks[i] * 1000.0 / disjoint.Frequency);
+            m_gpuMilliseconds[i].Add(milliseconds);
+            TraceLoggingWrite(
+                g_sampleTraceProvider,
+                "FrameStageGpu",
+                TraceLoggingUInt64(frame.FrameIndex, "Frame"),
+                TraceLoggingString(c_frameStages[i].Name, "Stage"),
+                TraceLoggingFloat32(milliseconds, "Milliseconds"));
+        }
+    }
+    return true;
+}
+
+void DX::FrameProfiler::Report()
+{
+    char buffer[256];
+    sprintf_s(buffer, "Frame timings in ms (p50 / p95 / p99 of the last %u samples), %llu GPU frames dropped:\n",
+        RollingPercentiles::Capacity, m_droppedGpuFrames);
+    OutputDebugStringA(buffer);
+
+    for (uint32_t i = 0; i < StageCount; i++)
+    {
+        const RollingPercentiles::Summary cpu = m_cpuMilliseconds[i].Compute();
+        if (cpu.Count == 0)
+        {
+            continue;
+        }
+        if (c_frameStages[i].MeasureGpu)
+        {
+            const RollingPercentiles::Summary gpu = m_gpuMilliseconds[i].Compute();
+            sprintf_s(buffer, "  %-16s CPU %6.2f / %6.2f / %6.2f  GPU %6.2f / %6.2f / %6.2f\n",
+                c_frameStages[i].Name, cpu.P50, cpu.P95, cpu.P99, gpu.P50, gpu.P95, gpu.P99);
+        }
+        else
+        {
+            sprintf_s(buffer, "  %-16s CPU %6.2f / %6.2f / %6.2f\n", c_frameStages[i].Name, cpu.P50, cpu.P95, cpu.P99);
+        }
+        OutputDebugStringA(buffer);
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+namespace DX
+{
+    // The stages of a frame measured by the FrameProfiler. Stages may nest, e.g. Render includes BlitRemoteFrame and StatusDisplay.
+    enum class FrameStage : uint32_t
+    {
+        Update,             // HolographicAppMain::Update without the frame wait.
+        WaitForFrame,       // Waiting for the next frame, as configured by the frame pacing mode.
+        Render,             // HolographicAppMain::Render.
+        BlitRemoteFrame,    // Blitting the remote frame into the back buffer.
+        StatusDisplay,      // Drawing the status display.
+        Present,            // DeviceResources::Present.
+        Count
+    };
+
+    // Keeps the most recent samples of a measurement and computes percentiles over them.
+    class RollingPercentiles
+    {
+    public:
+        static constexpr uint32_t Capacity = 512;
+
+        struct Summary
+        {
+            uint32_t            Count = 0;
+            float               P50 = 0;
+            float               P95 = 0;
+            float               P99 = 0;
+        };
+
+        void Add(float value)
+        {
+            m_samples[m_next] = value;
+            m_next = (m_next + 1) % Capacity;
+            m_count = std::min(m_count + 1, Capacity);
+        }
+
+        Summary Compute() const;
+
+    private:
+        std::array<float, Capacity>                             m_samples = {};
+        uint32_t                                                m_next = 0;
+        uint32_t                                                m_count = 0;
+    };
+
+    // Measures the CPU time of each frame stage with QueryPerformanceCounter and the GPU time of the rendering stages with
+    // D3D11 timestamp queries. GPU results are read back a few frames later without stalling; frames whose queries are not
+    // ready when their slot is reused are dropped.
+    // Every stage sample is written as an ETW event of the "Microsoft.Azure.RemoteRendering.Samples" TraceLogging provider,
+    // which Tools/ETLProfiles/AzureRemoteRenderingNetworkProfiling.wprp records next to the ARR network events. Percentiles
+    // over a rolling window are printed to the debug output periodically.
+    class FrameProfiler
+    {
+    public:
+        static constexpr uint32_t ReportIntervalInFrames = 300;
+
+        FrameProfiler(ID3D11Device* device);
+        FrameProfiler(FrameProfiler const&) = delete;
+        FrameProfiler& operator=(FrameProfiler const&) = delete;
+
+        void BeginFrame();
+        void EndFrame();
+
+        void BeginStage(FrameStage stage);
+        void EndStage(FrameStage stage);
+
+        class ScopedStage
+        {
+        public:
+            ScopedStage(FrameProfiler& profiler, FrameStage stage) :
+                m_profiler(profiler),
+                m_stage(stage)
+            {
+                m_profiler.BeginStage(m_stage);
+            }
+
+            ~ScopedStage()
+            {
+                m_profiler.EndStage(m_stage);
+            }
+
+        private:
+            FrameProfiler&      m_profiler;
+            const FrameStage    m_stage;
+        };
+
+    private:
+        static constexpr uint32_t FramesInFlight = 4;
+        static constexpr uint32_t MaxGpuStagesPerFrame = 16;
+        static constexpr uint32_t StageCount = static_cast<uint32_t>(FrameStage::Count);
+
+        struct GpuStage
+        {
+            FrameStage                                  Stage = FrameStage::Update;
+            Microsoft::WRL::ComPtr<ID3D11Query>         Begin;
+            Microsoft::WRL::ComPtr<ID3D11Query>         End;
+        };
+
+        struct GpuFrame
+        {
+            Microsoft::WRL::ComPtr<ID3D11Query>         Disjoint;
+            std::array<GpuStage, MaxGpuStagesPerFrame>  Stages;
+            uint32_t                                    StageCount = 0;
+            uint64_t                                    FrameIndex = 0;
+            bool                                        Pending = false;
+        };
+
+        bool TryResolve(GpuFrame& frame);
+        void Report();
+
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext>             m_context;
+        std::array<GpuFrame, FramesInFlight>                    m_gpuFrames;
+        GpuFrame*                                               m_currentGpuFrame = nullptr;
+
+        double                                                  m_millisecondsPerTick = 0;
+        uint64_t                                                m_frameIndex = 0;
+        std::array<int64_t, StageCount>                         m_stageStartTicks = {};
+        std::array<int64_t, StageCount>                         m_stageTicks = {};
+        std::array<uint32_t, StageCount>                        m_openGpuStage = {};
+
+        std::array<RollingPercentiles, StageCount>              m_cpuMilliseconds;
+        std::array<RollingPercentiles, StageCount>              m_gpuMilliseconds;
+        uint64_t                                                m_droppedGpuFrames = 0;
+    };
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace DX
+{
+    // Runs the app logic on a thread of its own at a fixed rate, so that it doesn't depend on the frame rate.
+    //
+    // In fixed timestep mode, StepTimer::Tick runs the updates a slow frame missed back to back in the next frame, which makes
+    // that frame slow as well. Here every step publishes a snapshot of the state with the time it simulates, and the render
+    // thread samples the state at the predicted display time of its frame, interpolating between the two snapshots around it.
+    // A slow frame just samples a later time. Steps are computed Lead ahead of the time they simulate, so the snapshots cover
+    // the display time of the frame being prepared. If the simulation thread itself falls behind by more than MaxCatchUpSteps,
+    // e.g. while the app was suspended, the missed steps are dropped instead of run back to back.
+    //
+    // The step function runs on the simulation thread and only sees the state and the latest input set by the render thread,
+    // so the two threads share nothing else.
+    template <typename TState, typename TInput>
+    class SimulationThread
+    {
+    public:
+        using Clock = winrt::clock; // The clock of HolographicFramePrediction timestamps.
+
+        using StepFunction = std::function<void(TState& state, const TInput& input, float stepSeconds)>;
+        using InterpolateFunction = std::function<TState(const TState& from, const TState& to, float amount)>;
+
+        struct Options
+        {
+            Clock::duration Step = std::chrono::microseconds(16667);  // 60 steps per second.
+            Clock::duration Lead = std::chrono::milliseconds(50);     // Covers the span between a frame's update and its display.
+            uint32_t MaxCatchUpSteps = 2;
+        };
+
+        SimulationThread(TState initialState, StepFunction step, InterpolateFunction interpolate)
+            : SimulationThread(std::move(initialState), std::move(step), std::move(interpolate), Options{})
+        {
+        }
+
+        SimulationThread(TState initialState, StepFunction step, InterpolateFunction interpolate, Options options)
+            : m_state(std::move(initialState))
+            , m_step(std::move(step))
+            , m_interpolate(std::move(interpolate))
+            , m_options(options)
+        {
+            PushSnapshot(Clock::now(), m_state);
+        }
+
+        ~SimulationThread()
+        {
+            Stop();
+        }
+
+        void Start()
+        {
+            if (m_thread.joinable())
+            {
+                return;
+            }
+
+            m_stopRequested = false;
+            m_thread = std::thread([this]() { Run(); });
+        }
+
+        void Stop()
+        {
+            {
+                std::scoped_lock lock(m_mutex);
+                m_stopRequested = true;
+            }
+            m_wakeUp.notify_all();
+            if (m_thread.joinable())
+            {
+                m_thread.join();
+            }
+        }
+
+        // Sets the input the next steps are computed with.
+        void SetInput(TInput input)
+        {
+            std::scoped_lock lock(m_mutex);
+            m_input = std::move(input);
+        }
+
+        // Returns the state at the given time, held at the oldest or latest snapshot outside of the published ones.
+        TState Sample(Clock::time_point time) const
+        {
+            std::scoped_lock lock(m_mutex);
+            const Snapshot* previous = &GetSnapshot(0);
+            if (time <= previous->Time)
+            {
+                return previous->State;
+            }
+
+            for (size_t i = 1; i < m_snapshotCount; i++)
+            {
+                const Snapshot& next = GetSnapshot(i);
+                if (time <= next.Time)
+                {
+                    const float amount = std::chrono::duration<float>(time - previous->Time) / (next.Time - previous->Time);
+                    return m_interpolate(previous->State, next.State, amount);
+                }
+                previous = &next;
+            }
+            return previous->State;
+        }
+
+    private:
+        struct Snapshot
+        {
+            Clock::time_point Time;
+            TState State;
+        };
+
+        // Enough to cover Lead at the default step, plus the snapshot before the sampled time.
+        static constexpr size_t SnapshotCapacity = 6;
+
+        void Run()
+        {
+            // The step function may use WinRT objects, e.g. the latest pointer pose.
+            winrt::init_apartment(winrt::apartment_type::multi_threaded);
+
+            const float stepSeconds = std::chrono::duration<float>(m_options.Step).count();
+            Clock::time_point stepTime = Clock::now() + m_options.Lead; // The time the next step simulates.
+
+            std::unique_lock lock(m_mutex);
+            while (!m_stopRequested)
+            {
+                const Clock::time_point wakeTime = stepTime - m_options.Lead;
+                if (m_wakeUp.wait_for(lock, wakeTime - Clock::now(), [this]() { return m_stopRequested; }))
+                {
+                    break;
+                }
+
+                const Clock::time_point now = Clock::now();
+                if (now - wakeTime > m_options.Step * m_options.MaxCatchUpSteps)
+                {
+                    stepTime = now + m_options.Lead;
+                }
+
+                const TInput input = m_input;
+                lock.unlock();
+                m_step(m_state, input, stepSeconds);
+                lock.lock();
+
+                PushSnapshot(stepTime, m_state);
+                stepTime += m_options.Step;
+            }
+            lock.unlock();
+
+            winrt::uninit_apartment();
+        }
+
+        // The caller holds m_mutex, or the simulation thread isn't running.
+        void PushSnapshot(Clock::time_point time, const TState& state)
+        {
+            m_snapshots[m_nextSnapshot] = { time, state };
+            m_nextSnapshot = (m_nextSnapshot + 1) % SnapshotCapacity;
+            m_snapshotCount = std::min(m_snapshotCount + 1, SnapshotCapacity);
+        }
+
+        // Index 0 is the oldest snapshot.
+        const Snapshot& GetSnapshot(size_t index) const
+        {
+            return m_snapshots[(m_nextSnapshot + SnapshotCapacity - m_snapshotCount + index) % SnapshotCapacity];
+        }
+
+        TState                                      m_state; // Only used by the simulation thread while it runs.
+        const StepFunction                          m_step;
+        const InterpolateFunction                   m_interpolate;
+        const Options                               m_options;
+
+        mutable std::mutex                          m_mutex;
+        std::condition_variable                     m_wakeUp;
+        bool                                        m_stopRequested = false;
+        TInput                                      m_input = {};
+        std::array<Snapshot, SnapshotCapacity>      m_snapshots = {};
+        size_t                                      m_nextSnapshot = 0;
+        size_t                                      m_snapshotCount = 0;
+        std::thread                                 m_thread;
+    };
+}
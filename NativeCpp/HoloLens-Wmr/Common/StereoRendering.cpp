@@ -0,0 +1,362 @@
+#include "pch.h"
+
+#include "StereoRendering.h"
+
+#include <thread>
+
+#include <shaders\GeometryShader_txt.h>
+#include <shaders\PixelShader_txt.h>
+#include <shaders\VPRTVertexShader_txt.h>
+#include <shaders\VertexShader_txt.h>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    constexpr const char* c_stereoRenderingPathNames[] =
+    {
+        "VPRT",
+        "Instanced + GS",
+        "Multi-pass",
+    };
+    static_assert(std::size(c_stereoRenderingPathNames) == static_cast<size_t>(DX::StereoRenderingPath::Count), "Every path needs a name.");
+
+    constexpr size_t c_pathCount = static_cast<size_t>(DX::StereoRenderingPath::Count);
+    constexpr UINT c_viewCount = 2;
+
+    // Same layout as the status display quad, see VertexShaderShared_txt.hlsl.
+    struct BenchmarkVertex
+    {
+        DirectX::XMFLOAT3 pos;
+        DirectX::XMFLOAT2 uv;
+    };
+
+    struct BenchmarkResources
+    {
+        ComPtr<ID3D11RenderTargetView>                              arrayRenderTargetView;
+        std::array<ComPtr<ID3D11RenderTargetView>, c_viewCount>     sliceRenderTargetViews;
+        ComPtr<ID3D11VertexShader>                                  vprtVertexShader;
+        ComPtr<ID3D11InputLayout>                                   vprtInputLayout;
+        ComPtr<ID3D11VertexShader>                                  vertexShader;
+        ComPtr<ID3D11InputLayout>                                   inputLayout;
+        ComPtr<ID3D11GeometryShader>                                geometryShader;
+        ComPtr<ID3D11PixelShader>                                   pixelShader;
+        ComPtr<ID3D11Buffer>                                        vertexBuffer;
+        ComPtr<ID3D11Buffer>                                        indexBuffer;
+        ComPtr<ID3D11Buffer>                                        modelConstantBuffer;
+        ComPtr<ID3D11Buffer>                                        viewProjectionConstantBuffer;
+        ComPtr<ID3D11ShaderResourceView>                            textureView;
+        ComPtr<ID3D11SamplerState>                                  samplerState;
+        ComPtr<ID3D11RasterizerState>                               rasterizerState;
+        UINT                                                        indexCount = 0;
+    };
+
+    BenchmarkResources CreateBenchmarkResources(ID3D11Device* device, bool supportsVprt, DX::StereoRenderingBenchmark::Options const& options)
+    {
+        BenchmarkResources resources;
+
+        // Offscreen render target array with one slice per view.
+        const DXGI_FORMAT format = DXGI_FORMAT_B8G8R8A8_UNORM;
+        const CD3D11_TEXTURE2D_DESC targetDesc(format, options.Width, options.Height, c_viewCount, 1, D3D11_BIND_RENDER_TARGET);
+        ComPtr<ID3D11Texture2D> target;
+        winrt::check_hresult(device->CreateTexture2D(&targetDesc, nullptr, &target));
+
+        const CD3D11_RENDER_TARGET_VIEW_DESC arrayViewDesc(D3D11_RTV_DIMENSION_TEXTURE2DARRAY, format, 0, 0, c_viewCount);
+        winrt::check_hresult(device->CreateRenderTargetView(target.Get(), &arrayViewDesc, &resources.arrayRenderTargetView));
+        for (UINT view = 0; view < c_viewCount; view++)
+        {
+            const CD3D11_RENDER_TARGET_VIEW_DESC sliceViewDesc(D3D11_RTV_DIMENSION_TEXTURE2DARRAY, format, 0, view, 1);
+            winrt::check_hresult(device->CreateRenderTargetView(target.Get(), &sliceViewDesc, &resources.sliceRenderTargetViews[view]));
+        }
+
+        // Shaders.
+        static const D3D11_INPUT_ELEMENT_DESC vertexDesc[] = {
+            {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+            {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        };
+        if (supportsVprt)
+        {
+            winrt::check_hresult(device->CreateVertexShader(VPRTVertexShader_txt, sizeof(VPRTVertexShader_txt), nullptr, &resources.vprtVertexShader));
+            winrt::check_hresult(device->CreateInputLayout(
+                vertexDesc, ARRAYSIZE(vertexDesc), VPRTVertexShader_txt, sizeof(VPRTVertexShader_txt), &resources.vprtInputLayout));
+        }
+        winrt::check_hresult(device->CreateVertexShader(VertexShader_txt, sizeof(VertexShader_txt), nullptr, &resources.vertexShader));
+        winrt::check_hresult(device->CreateInputLayout(
+            vertexDesc, ARRAYSIZE(vertexDesc), VertexShader_txt, sizeof(VertexShader_txt), &resources.inputLayout));
+        winrt::check_hresult(device->CreateGeometryShader(GeometryShader_txt, sizeof(GeometryShader_txt), nullptr, &resources.geometryShader));
+        winrt::check_hresult(device->CreatePixelShader(PixelShader_txt, sizeof(PixelShader_txt), nullptr, &resources.pixelShader));
+
+        // A full-screen grid in clip space, so that every path shades the same pixels. 16-bit indices limit its size.
+        const UINT gridSize = std::clamp(options.GridSize, 1u, 255u);
+        std::vector<BenchmarkVertex> vertices;
+        vertices.reserve((gridSize + 1) * (gridSize + 1));
+        for (UINT y = 0; y <= gridSize; y++)
+        {
+            for (UINT x = 0; x <= gridSize; x++)
+            {
+                const float u = static_cast<float>(x) / gridSize;
+                const float v = static_cast<float>(y) / gridSize;
+                vertices.push_back({ DirectX::XMFLOAT3(u * 2.f - 1.f, 1.f - v * 2.f, 0.5f), DirectX::XMFLOAT2(u, v) });
+            }
+        }
+
+        std::vector<uint16_t> indices;
+        indices.reserve(gridSize * gridSize * 6);
+        for (UINT y = 0; y < gridSize; y++)
+        {
+            for (UINT x = 0; x < gridSize; x++)
+            {
+                const uint16_t topLeft = static_cast<uint16_t>(y * (gridSize + 1) + x);
+                const uint16_t bottomLeft = static_cast<uint16_t>(topLeft + gridSize + 1);
+                indices.insert(indices.end(), { topLeft, uint16_t(topLeft + 1), uint16_t(bottomLeft + 1) });
+                indices.insert(indices.end(), { topLeft, uint16_t(bottomLeft + 1), bottomLeft });
+            }
+        }
+        resources.indexCount = static_cast<UINT>(indices.size());
+
+        const D3D11_SUBRESOURCE_DATA vertexData = { vertices.data(), 0, 0 };
+        const CD3D11_BUFFER_DESC vertexBufferDesc(static_cast<UINT>(vertices.size() * sizeof(BenchmarkVertex)), D3D11_BIND_VERTEX_BUFFER);
+        winrt::check_hresult(device->CreateBuffer(&vertexBufferDesc, &vertexData, &resources.vertexBuffer));
+
+        const D3D11_SUBRESOURCE_DATA indexData = { indices.data(), 0, 0 };
+        const CD3D11_BUFFER_DESC indexBufferDesc(static_cast<UINT>(indices.size() * sizeof(uint16_t)), D3D11_BIND_INDEX_BUFFER);
+        winrt::check_hresult(device->CreateBuffer(&indexBufferDesc, &indexData, &resources.indexBuffer));
+
+        // Identity model and view projection transforms keep the grid in clip space.
+        DirectX::XMFLOAT4X4 transforms[c_viewCount];
+        for (DirectX::XMFLOAT4X4& transform : transforms)
+        {
+            DirectX::XMStoreFloat4x4(&transform, DirectX::XMMatrixIdentity());
+        }
+        const D3D11_SUBRESOURCE_DATA modelData = { transforms, 0, 0 };
+        const CD3D11_BUFFER_DESC modelBufferDesc(sizeof(DirectX::XMFLOAT4X4), D3D11_BIND_CONSTANT_BUFFER);
+        winrt::check_hresult(device->CreateBuffer(&modelBufferDesc, &modelData, &resources.modelConstantBuffer));
+
+        const D3D11_SUBRESOURCE_DATA viewProjectionData = { transforms, 0, 0 };
+        const CD3D11_BUFFER_DESC viewProjectionBufferDesc(sizeof(transforms), D3D11_BIND_CONSTANT_BUFFER);
+        winrt::check_hresult(device->CreateBuffer(&viewProjectionBufferDesc, &viewProjectionData, &resources.viewProjectionConstantBuffer));
+
+        // A white texel for the pixel shader to sample.
+        const uint32_t white = 0xffffffff;
+        const D3D11_SUBRESOURCE_DATA textureData = { &white, sizeof(white), 0 };
+        const CD3D11_TEXTURE2D_DESC textureDesc(DXGI_FORMAT_B8G8R8A8_UNORM, 1, 1, 1, 1, D3D11_BIND_SHADER_RESOURCE, D3D11_USAGE_IMMUTABLE);
+        ComPtr<ID3D11Texture2D> texture;
+        winrt::check_hresult(device->CreateTexture2D(&textureDesc, &textureData, &texture));
+        winrt::check_hresult(device->CreateShaderResourceView(texture.Get(), nullptr, &resources.textureView));
+
+        const CD3D11_SAMPLER_DESC samplerDesc(D3D11_DEFAULT);
+        winrt::check_hresult(device->CreateSamplerState(&samplerDesc, &resources.samplerState));
+
+        CD3D11_RASTERIZER_DESC rasterizerDesc(D3D11_DEFAULT);
+        rasterizerDesc.CullMode = D3D11_CULL_NONE;
+        winrt::check_hresult(device->CreateRasterizerState(&rasterizerDesc, &resources.rasterizerState));
+
+        return resources;
+    }
+
+    void BindBenchmarkResources(ID3D11DeviceContext* context, BenchmarkResources const& resources, DX::StereoRenderingBenchmark::Options const& options)
+    {
+        const UINT stride = sizeof(BenchmarkVertex);
+        const UINT offset = 0;
+        context->IASetVertexBuffers(0, 1, resources.vertexBuffer.GetAddressOf(), &stride, &offset);
+        context->IASetIndexBuffer(resources.indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        ID3D11Buffer* const constantBuffers[] = { resources.modelConstantBuffer.Get(), resources.viewProjectionConstantBuffer.Get() };
+        context->VSSetConstantBuffers(0, ARRAYSIZE(constantBuffers), constantBuffers);
+
+        context->PSSetShader(resources.pixelShader.Get(), nullptr, 0);
+        context->PSSetShaderResources(0, 1, resources.textureView.GetAddressOf());
+        context->PSSetSamplers(0, 1, resources.samplerState.GetAddressOf());
+
+        context->RSSetState(resources.rasterizerState.Get());
+        const CD3D11_VIEWPORT viewport(0.f, 0.f, static_cast<float>(options.Width), static_cast<float>(options.Height));
+        context->RSSetViewports(1, &viewport);
+    }
+
+    void DrawBenchmarkPath(
+        ID3D11DeviceContext* context,
+        BenchmarkResources const& resources,
+        DX::StereoRenderingPath path,
+        DX::StereoRenderingBenchmark::Options const& options)
+    {
+        const bool useVprtShader = path == DX::StereoRenderingPath::Vprt ||
+            (path == DX::StereoRenderingPath::MultiPass && resources.vprtVertexShader != nullptr);
+        context->IASetInputLayout(useVprtShader ? resources.vprtInputLayout.Get() : resources.inputLayout.Get());
+        context->VSSetShader(useVprtShader ? resources.vprtVertexShader.Get() : resources.vertexShader.Get(), nullptr, 0);
+        context->GSSetShader(useVprtShader ? nullptr : resources.geometryShader.Get(), nullptr, 0);
+
+        if (path == DX::StereoRenderingPath::MultiPass)
+        {
+            // A single instance renders to array index 0, which is the bound slice.
+            for (UINT view = 0; view < c_viewCount; view++)
+            {
+                context->OMSetRenderTargets(1, resources.sliceRenderTargetViews[view].GetAddressOf(), nullptr);
+                for (UINT draw = 0; draw < options.DrawsPerIteration; draw++)
+                {
+                    context->DrawIndexedInstanced(resources.indexCount, 1, 0, 0, 0);
+                }
+            }
+        }
+        else
+        {
+            context->OMSetRenderTargets(1, resources.arrayRenderTargetView.GetAddressOf(), nullptr);
+            for (UINT draw = 0; draw < options.DrawsPerIteration; draw++)
+            {
+                context->DrawIndexedInstanced(resources.indexCount, c_viewCount, 0, 0, 0);
+            }
+        }
+    }
+
+    template<typename T>
+    T WaitForQueryData(ID3D11DeviceContext* context, ID3D11Query* query)
+    {
+        T data = {};
+        HRESULT hr;
+        while ((hr = context->GetData(query, &data, sizeof(data), 0)) == S_FALSE)
+        {
+            std::this_thread::yield();
+        }
+        winrt::check_hresult(hr);
+        return data;
+    }
+}
+
+const char* DX::GetStereoRenderingPathName(StereoRenderingPath path)
+{
+    return c_stereoRenderingPathNames[static_cast<size_t>(path)];
+}
+
+bool DX::IsStereoRenderingPathSupportedByContent(StereoRenderingPath path, bool supportsVprt)
+{
+    switch (path)
+    {
+    case StereoRenderingPath::Vprt:
+        return supportsVprt;
+    case StereoRenderingPath::InstancedGeometryShader:
+        return true;
+    default:
+        return false;
+    }
+}
+
+DX::StereoRenderingPath DX::GetDefaultStereoRenderingPath(bool supportsVprt)
+{
+    return supportsVprt ? StereoRenderingPath::Vprt : StereoRenderingPath::InstancedGeometryShader;
+}
+
+DX::StereoRenderingBenchmark::Results DX::StereoRenderingBenchmark::Run(
+    ID3D11Device* device,
+    ID3D11DeviceContext* context,
+    bool supportsVprt,
+    Options const& options)
+{
+    Results results;
+    std::array<std::vector<float>, c_pathCount> samples;
+    for (size_t i = 0; i < c_pathCount; i++)
+    {
+        results[i].Path = static_cast<StereoRenderingPath>(i);
+        samples[i].reserve(options.Iterations);
+    }
+
+    const BenchmarkResources resources = CreateBenchmarkResources(device, supportsVprt, options);
+    BindBenchmarkResources(context, resources, options);
+
+    const CD3D11_QUERY_DESC disjointDesc(D3D11_QUERY_TIMESTAMP_DISJOINT);
+    const CD3D11_QUERY_DESC timestampDesc(D3D11_QUERY_TIMESTAMP);
+
+    // The first iteration warms up shaders and driver state and is not counted.
+    for (UINT iteration = 0; iteration <= options.Iterations; iteration++)
+    {
+        ComPtr<ID3D11Query> disjoint;
+        std::array<ComPtr<ID3D11Query>, c_pathCount> begin;
+        std::array<ComPtr<ID3D11Query>, c_pathCount> end;
+        winrt::check_hresult(device->CreateQuery(&disjointDesc, &disjoint));
+
+        context->Begin(disjoint.Get());
+        for (size_t i = 0; i < c_pathCount; i++)
+        {
+            const StereoRenderingPath path = static_cast<StereoRenderingPath>(i);
+            if (path == StereoRenderingPath::Vprt && !supportsVprt)
+            {
+                continue;
+            }
+
+            winrt::check_hresult(device->CreateQuery(&timestampDesc, &begin[i]));
+            winrt::check_hresult(device->CreateQuery(&timestampDesc, &end[i]));
+            context->End(begin[i].Get());
+            DrawBenchmarkPath(context, resources, path, options);
+            context->End(end[i].Get());
+        }
+        context->End(disjoint.Get());
+
+        const auto disjointData = WaitForQueryData<D3D11_QUERY_DATA_TIMESTAMP_DISJOINT>(context, disjoint.Get());
+        if (iteration == 0 || disjointData.Disjoint)
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i < c_pathCount; i++)
+        {
+            if (begin[i] == nullptr)
+            {
+                continue;
+            }
+            const UINT64 beginTicks = WaitForQueryData<UINT64>(context, begin[i].Get());
+            const UINT64 endTicks = WaitForQueryData<UINT64>(context, end[i].Get());
+            samples[i].push_back(static_cast<float>((endTicks - beginTicks) * 1000.0 / disjointData.Frequency));
+        }
+    }
+
+    for (size_t i = 0; i < c_pathCount; i++)
+    {
+        std::vector<float>& pathSamples = samples[i];
+        if (pathSamples.empty())
+        {
+            continue;
+        }
+        const auto median = pathSamples.begin() + pathSamples.size() / 2;
+        std::nth_element(pathSamples.begin(), median, pathSamples.end());
+        results[i].Measured = true;
+        results[i].GpuMilliseconds = *median;
+    }
+
+    // Leave nothing of the benchmark bound for the content.
+    context->ClearState();
+    return results;
+}
+
+void DX::StereoRenderingBenchmark::Report(Results const& results, Options const& options)
+{
+    char buffer[256];
+    sprintf_s(buffer, "Stereo rendering benchmark, %u draws of %u triangles per view at %ux%u, median of %u iterations:\n",
+        options.DrawsPerIteration, 2 * options.GridSize * options.GridSize, options.Width, options.Height, options.Iterations);
+    OutputDebugStringA(buffer);
+
+    for (Result const& result : results)
+    {
+        if (result.Measured)
+        {
+            sprintf_s(buffer, "  %-16s %8.3f ms\n", GetStereoRenderingPathName(result.Path), result.GpuMilliseconds);
+        }
+        else
+        {
+            sprintf_s(buffer, "  %-16s not supported\n", GetStereoRenderingPathName(result.Path));
+        }
+        OutputDebugStringA(buffer);
+    }
+}
+
+DX::StereoRenderingPath DX::StereoRenderingBenchmark::SelectFastestContentPath(Results const& results, bool supportsVprt)
+{
+    Result const* fastest = nullptr;
+    for (Result const& result : results)
+    {
+        if (result.Measured && IsStereoRenderingPathSupportedByContent(result.Path, supportsVprt) &&
+            (fastest == nullptr || result.GpuMilliseconds < fastest->GpuMilliseconds))
+        {
+            fastest = &result;
+        }
+    }
+    return fastest != nullptr ? fastest->Path : GetDefaultStereoRenderingPath(supportsVprt);
+}
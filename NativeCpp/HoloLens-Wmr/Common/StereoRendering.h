@@ -0,0 +1,67 @@
+#pragma once
+
+//
+// Uncomment this preprocessor definition to measure the GPU cost of every stereo
+// rendering path when the Direct3D device is created. The results are written to
+// the debug output, and the local content then uses the fastest path it supports.
+//
+//#define RUN_STEREO_RENDERING_BENCHMARK
+
+namespace DX
+{
+    // The ways to render both views of a holographic camera.
+    enum class StereoRenderingPath
+    {
+        Vprt,                       // One instanced draw, the vertex shader sets the render target array index.
+        InstancedGeometryShader,    // One instanced draw, a pass-through geometry shader sets the render target array index.
+        MultiPass,                  // One draw per view into a render target view of a single array slice.
+
+        Count
+    };
+
+    const char* GetStereoRenderingPathName(StereoRenderingPath path);
+
+    // Whether the local content can render with the path on a device. VPRT needs the optional
+    // D3D11_FEATURE_D3D11_OPTIONS3::VPAndRTArrayIndexFromAnyShaderFeedingRasterizer feature. Multi-pass rendering works on
+    // every device, but the camera resources only have views of the whole back buffer array, so content doesn't use it.
+    bool IsStereoRenderingPathSupportedByContent(StereoRenderingPath path, bool supportsVprt);
+
+    // The path local content uses when no benchmark results are available: VPRT if the device supports it.
+    StereoRenderingPath GetDefaultStereoRenderingPath(bool supportsVprt);
+
+    // Measures the GPU time of each stereo rendering path on the current device.
+    //
+    // Every path draws the same tessellated full-screen grid into an offscreen render target array with the status display
+    // shaders, so the paths only differ in how the views are produced. Multi-pass uses the VPRT vertex shader if the device
+    // supports it, and the geometry shader otherwise, as the shaders have no variant without a render target array index.
+    // The benchmark waits for the GPU and clears the context state, so it is meant to run once, before content is created.
+    class StereoRenderingBenchmark
+    {
+    public:
+        struct Options
+        {
+            UINT Width = 1440;              // Per view, roughly the HoloLens 2 back buffer size.
+            UINT Height = 936;
+            UINT GridSize = 64;             // Quads per side of the grid, 2 * GridSize^2 triangles per draw.
+            UINT DrawsPerIteration = 16;
+            UINT Iterations = 9;            // The median iteration is reported.
+        };
+
+        struct Result
+        {
+            StereoRenderingPath Path = StereoRenderingPath::Vprt;
+            bool Measured = false;
+            float GpuMilliseconds = 0;      // Per iteration.
+        };
+
+        using Results = std::array<Result, static_cast<size_t>(StereoRenderingPath::Count)>;
+
+        static Results Run(ID3D11Device* device, ID3D11DeviceContext* context, bool supportsVprt, Options const& options = Options());
+
+        // Writes the results to the debug output.
+        static void Report(Results const& results, Options const& options = Options());
+
+        // Returns the fastest measured path the content supports, or the default path if none was measured.
+        static StereoRenderingPath SelectFastestContentPath(Results const& results, bool supportsVprt);
+    };
+}
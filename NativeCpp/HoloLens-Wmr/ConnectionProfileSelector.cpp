@@ -0,0 +1,80 @@
+#include "pch.h"
+
+#ifdef USE_REMOTE_RENDERING
+#include "HolographicAppMain.h"
+#include "ConnectionProfileSelector.h"
+
+namespace HolographicApp
+{
+    ConnectionProfileSelector::ConnectionProfileSelector(Options options)
+        : m_options(std::move(options))
+    {
+        if (m_options.Profiles.empty())
+        {
+            m_options.Profiles.push_back({ "Default", RR::ServiceRenderMode::Default });
+        }
+    }
+
+    RR::RenderingSessionVmSize ConnectionProfileSelector::GetVmSize() const
+    {
+        return m_options.ExpectedPolygonCount > StandardVmMaxPolygonCount ? RR::RenderingSessionVmSize::Premium : RR::RenderingSessionVmSize::Standard;
+    }
+
+    void ConnectionProfileSelector::ApplyProfile(RR::RendererInitOptions& init) const
+    {
+        init.RenderMode = GetProfile().RenderMode;
+    }
+
+    void ConnectionProfileSelector::Reset(RR::ApiHandle<RR::GraphicsBindingWmrD3d11> graphicsBinding)
+    {
+        m_graphicsBinding = std::move(graphicsBinding);
+        m_nextSampleTime = 0;
+        m_samplesSinceConnect = 0;
+        m_degradedSamples = 0;
+    }
+
+    bool ConnectionProfileSelector::Update(double nowInSeconds)
+    {
+        if (m_graphicsBinding == nullptr || nowInSeconds < m_nextSampleTime)
+        {
+            return false;
+        }
+        m_nextSampleTime = nowInSeconds + m_options.SampleIntervalInSeconds;
+
+        RR::FrameStatistics statistics;
+        if (m_graphicsBinding->GetLastFrameStatistics(&statistics) != RR::Result::Success)
+        {
+            // No remote frame has been received yet.
+            return false;
+        }
+
+        if (++m_samplesSinceConnect <= m_options.GraceSamples)
+        {
+            return false;
+        }
+
+        m_degradedSamples = IsDegraded(statistics) ? m_degradedSamples + 1 : 0;
+        if (m_degradedSamples < m_options.DegradedSamplesBeforeDowngrade || m_profileIndex + 1 >= m_options.Profiles.size())
+        {
+            return false;
+        }
+
+        char buffer[256];
+        sprintf_s(buffer, "ConnectionProfileSelector: Remote frames degraded (%u received, %u skipped, %u discarded), switching from %s to %s.\n",
+            statistics.VideoFramesReceived, statistics.VideoFramesSkipped, statistics.VideoFramesDiscarded,
+            m_options.Profiles[m_profileIndex].Name, m_options.Profiles[m_profileIndex + 1].Name);
+        OutputDebugStringA(buffer);
+
+        m_profileIndex++;
+        m_degradedSamples = 0;
+        return true;
+    }
+
+    bool ConnectionProfileSelector::IsDegraded(const RR::FrameStatistics& statistics) const
+    {
+        return statistics.VideoFramesReceived < m_options.MinFramesReceivedPerSample ||
+            statistics.VideoFramesSkipped + statistics.VideoFramesDiscarded > m_options.MaxDroppedFramesPerSample ||
+            statistics.LatencyPoseToReceive > m_options.MaxLatencyPoseToReceiveInSeconds;
+    }
+}
+#endif
@@ -42,8 +42,12 @@ void SpinningCubeRenderer::Update(DX::StepTimer const& timer)
     // Convert degrees to radians, then convert seconds to rotation angle.
     const float    radiansPerSecond = XMConvertToRadians(m_degreesPerSecond);
     const double   totalRotation = timer.GetTotalSeconds() * radiansPerSecond;
-    const float    radians = static_cast<float>(fmod(totalRotation, XM_2PI));
-    const XMMATRIX modelRotation = XMMatrixRotationY(-radians);
+    Update(static_cast<float>(fmod(totalRotation, XM_2PI)));
+}
+
+void SpinningCubeRenderer::Update(float rotationRadians)
+{
+    const XMMATRIX modelRotation = XMMatrixRotationY(-rotationRadians);
 
     // Position the cube.
     const XMMATRIX modelTranslation = XMMatrixTranslationFromVector(XMLoadFloat3(&m_position));
@@ -56,27 +60,8 @@ void SpinningCubeRenderer::Update(DX::StepTimer const& timer)
     // The view and projection matrices are provided by the system; they are associated
     // with holographic cameras, and updated on a per-camera basis.
     // Here, we provide the model transform for the sample hologram. The model transform
-    // matrix is transposed to prepare it for the shader.
+    // matrix is transposed to prepare it for the shader. It is uploaded when the hologram is rendered.
     XMStoreFloat4x4(&m_modelConstantBufferData.model, XMMatrixTranspose(modelTransform));
-
-    // Loading is asynchronous. Resources must be created before they can be updated.
-    if (!m_loadingComplete)
-    {
-        return;
-    }
-
-    // Use the D3D device context to update Direct3D device-based resources.
-    const auto context = m_deviceResources->GetD3DDeviceContext();
-
-    // Update the model transform buffer for the hologram.
-    context->UpdateSubresource(
-        m_modelConstantBuffer.Get(),
-        0,
-        nullptr,
-        &m_modelConstantBufferData,
-        0,
-        0
-    );
 }
 
 // Renders one frame using the vertex and pixel shaders.
@@ -118,12 +103,10 @@ void SpinningCubeRenderer::Render()
         nullptr,
         0
     );
-    // Apply the model constant buffer to the vertex shader.
-    context->VSSetConstantBuffers(
-        0,
-        1,
-        m_modelConstantBuffer.GetAddressOf()
-    );
+    // Apply the model constants to the vertex shader.
+    const DX::ConstantBufferRing::Allocation modelConstants =
+        m_deviceResources->GetConstantBufferRing().Allocate(context, m_modelConstantBufferData);
+    DX::ConstantBufferRing::VSSetConstantBuffer(context, 0, modelConstants);
 
     if (!m_usingVprtShaders)
     {
@@ -159,7 +142,7 @@ void SpinningCubeRenderer::Render()
 #pragma optimize( "", off )
 std::future<void> SpinningCubeRenderer::CreateDeviceDependentResources()
 {
-    m_usingVprtShaders = m_deviceResources->GetDeviceSupportsVprt();
+    m_usingVprtShaders = m_deviceResources->GetStereoRenderingPath() == DX::StereoRenderingPath::Vprt;
 
     // On devices that do support the D3D11_FEATURE_D3D11_OPTIONS3::
     // VPAndRTArrayIndexFromAnyShaderFeedingRasterizer optional feature
@@ -205,14 +188,6 @@ std::future<void> SpinningCubeRenderer::CreateDeviceDependentResources()
             &m_pixelShader
         ));
 
-    const CD3D11_BUFFER_DESC constantBufferDesc(sizeof(ModelConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
-    winrt::check_hresult(
-        m_deviceResources->GetD3DDevice()->CreateBuffer(
-            &constantBufferDesc,
-            nullptr,
-            &m_modelConstantBuffer
-        ));
-
 
     if (!m_usingVprtShaders)
     {
@@ -311,7 +286,6 @@ void SpinningCubeRenderer::ReleaseDeviceDependentResources()
     m_inputLayout.Reset();
     m_pixelShader.Reset();
     m_geometryShader.Reset();
-    m_modelConstantBuffer.Reset();
     m_vertexBuffer.Reset();
     m_indexBuffer.Reset();
 }
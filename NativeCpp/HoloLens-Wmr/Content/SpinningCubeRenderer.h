@@ -14,6 +14,10 @@ namespace HolographicApp
         std::future<void> CreateDeviceDependentResources();
         void ReleaseDeviceDependentResources();
         void Update(DX::StepTimer const& timer);
+
+        // Sets the model transform with the given rotation, e.g. sampled from the simulation thread.
+        void Update(float rotationRadians);
+        float GetRadiansPerSecond() const                                           { return DirectX::XMConvertToRadians(m_degreesPerSecond); }
         void Render();
 
         // Repositions the sample hologram.
@@ -34,7 +38,6 @@ namespace HolographicApp
         Microsoft::WRL::ComPtr<ID3D11VertexShader>      m_vertexShader;
         Microsoft::WRL::ComPtr<ID3D11GeometryShader>    m_geometryShader;
         Microsoft::WRL::ComPtr<ID3D11PixelShader>       m_pixelShader;
-        Microsoft::WRL::ComPtr<ID3D11Buffer>            m_modelConstantBuffer;
 
         // System resources for cube geometry.
         ModelConstantBuffer                             m_modelConstantBufferData;
@@ -109,11 +109,9 @@ void StatusDisplay::Render()
         // Attach the vertex shader.
         context->VSSetShader(m_vertexShader.get(), nullptr, 0);
 
-        context->UpdateSubresource(m_modelConstantBuffer.get(), 0, nullptr, &m_modelConstantBufferDataImage, 0, 0);
-
-        // Apply the model constant buffer to the vertex shader.
-        pBufferToSet = m_modelConstantBuffer.get();
-        context->VSSetConstantBuffers(0, 1, &pBufferToSet);
+        // Apply the model constants of the image to the vertex shader.
+        DX::ConstantBufferRing& constantBufferRing = m_deviceResources->GetConstantBufferRing();
+        DX::ConstantBufferRing::VSSetConstantBuffer(context, 0, constantBufferRing.Allocate(context, m_modelConstantBufferDataImage));
 
         // On devices that do not support the D3D11_FEATURE_D3D11_OPTIONS3::
         // VPAndRTArrayIndexFromAnyShaderFeedingRasterizer optional feature,
@@ -151,7 +149,7 @@ void StatusDisplay::Render()
         ID3D11SamplerState* pSamplerToSet = m_textSamplerState.get();
         context->PSSetSamplers(0, 1, &pSamplerToSet);
 
-        context->UpdateSubresource(m_modelConstantBuffer.get(), 0, nullptr, &m_modelConstantBufferDataText, 0, 0);
+        DX::ConstantBufferRing::VSSetConstantBuffer(context, 0, constantBufferRing.Allocate(context, m_modelConstantBufferDataText));
 
         // Draw the text.
         context->DrawIndexedInstanced(
@@ -171,37 +169,18 @@ void StatusDisplay::Render()
     });
 }
 
-void StatusDisplay::CreateDeviceDependentResources()
+task<void> StatusDisplay::CreateDeviceDependentResources()
 {
     CD3D11_SAMPLER_DESC desc(D3D11_DEFAULT);
 
-    CD3D11_TEXTURE2D_DESC textureDesc(
-        DXGI_FORMAT_B8G8R8A8_UNORM, TEXTURE_WIDTH, TEXTURE_HEIGHT, 1, 1, D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET);
-
-    m_textTexture = nullptr;
-    m_deviceResources->GetD3DDevice()->CreateTexture2D(&textureDesc, nullptr, m_textTexture.put());
-
-    m_textShaderResourceView = nullptr;
-    m_deviceResources->GetD3DDevice()->CreateShaderResourceView(m_textTexture.get(), nullptr, m_textShaderResourceView.put());
-
-    m_textRenderTarget = nullptr;
-    m_deviceResources->GetD3DDevice()->CreateRenderTargetView(m_textTexture.get(), nullptr, m_textRenderTarget.put());
-
-    D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
-        D2D1_RENDER_TARGET_TYPE_DEFAULT, D2D1::PixelFormat(DXGI_FORMAT_UNKNOWN, D2D1_ALPHA_MODE_PREMULTIPLIED), 96, 96);
-
-    winrt::com_ptr<IDXGISurface> dxgiSurface;
-    m_textTexture.as(dxgiSurface);
-
-
-    m_d2dTextRenderTarget = nullptr;
-    winrt::check_hresult(
-        m_deviceResources->GetD2DFactory()->CreateDxgiSurfaceRenderTarget(dxgiSurface.get(), &props, m_d2dTextRenderTarget.put()));
-
+    // The fonts don't depend on the device and are needed by SetLines right away, so only they are created synchronously.
     CreateFonts();
-    CreateBrushes();
 
-    m_usingVprtShaders = m_deviceResources->GetDeviceSupportsVprt();
+    // create the text texture and its Direct2D render target. The D2D factory is multithreaded, so this runs in parallel
+    // with the shader creation.
+    task<void> createTextTargetTask([this]() { CreateTextTexture(); });
+
+    m_usingVprtShaders = m_deviceResources->GetStereoRenderingPath() == DX::StereoRenderingPath::Vprt;
 
     // If the optional VPRT feature is supported by the graphics device, we
     // can avoid using geometry shaders to set the render target array index.
@@ -222,13 +201,10 @@ void StatusDisplay::CreateDeviceDependentResources()
             vertexDesc, ARRAYSIZE(vertexDesc), vertexShaderData, vertexShaderDataSize, m_inputLayout.put()));
     });
 
-    // create the pixel shader and constant buffer.
+    // create the pixel shader.
     task<void> createPSTask([this]() {
         winrt::check_hresult(
             m_deviceResources->GetD3DDevice()->CreatePixelShader(PixelShader_txt, sizeof(PixelShader_txt), nullptr, m_pixelShader.put()));
-
-        const CD3D11_BUFFER_DESC constantBufferDesc(sizeof(ModelConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
-        winrt::check_hresult(m_deviceResources->GetD3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, m_modelConstantBuffer.put()));
     });
 
     task<void> createGSTask;
@@ -357,8 +333,66 @@ void StatusDisplay::CreateDeviceDependentResources()
 
     winrt::check_hresult(m_deviceResources->GetD3DDevice()->CreateBlendState(&blendStateDesc, m_textAlphaBlendState.put()));
 
-    // Once the quad is loaded, the object is ready to be rendered.
-    auto loadCompleteCallback = createQuadTask.then([this]() { m_loadingComplete = true; });
+    // Once the quad and the text target are loaded, the object is ready to be rendered.
+    return (createQuadTask && createTextTargetTask).then([this]() { m_loadingComplete = true; });
+}
+
+void StatusDisplay::SetTextTextureScale(float scale)
+{
+    if (scale == m_textTextureScale)
+    {
+        return;
+    }
+
+    // While the resources are still being created, the creation task picks up the new scale.
+    m_textTextureScale = scale;
+    if (m_loadingComplete)
+    {
+        CreateTextTexture();
+    }
+}
+
+uint64_t StatusDisplay::GetTextTextureBytes() const
+{
+    if (m_textTexture == nullptr)
+    {
+        return 0;
+    }
+
+    D3D11_TEXTURE2D_DESC textureDesc;
+    m_textTexture->GetDesc(&textureDesc);
+    return uint64_t{ textureDesc.Width } * textureDesc.Height * 4; // DXGI_FORMAT_B8G8R8A8_UNORM
+}
+
+void StatusDisplay::CreateTextTexture()
+{
+    // The text is laid out in DIPs on a TEXTURE_WIDTH x TEXTURE_HEIGHT page. A scaled texture keeps the page and only changes
+    // the DPI, so the text looks the same apart from its sharpness.
+    const UINT width = static_cast<UINT>(TEXTURE_WIDTH * m_textTextureScale);
+    const UINT height = static_cast<UINT>(TEXTURE_HEIGHT * m_textTextureScale);
+    CD3D11_TEXTURE2D_DESC textureDesc(
+        DXGI_FORMAT_B8G8R8A8_UNORM, width, height, 1, 1, D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET);
+
+    // Release the previous texture first, so that both don't hold memory at the same time.
+    m_d2dTextRenderTarget = nullptr;
+    m_textRenderTarget = nullptr;
+    m_textShaderResourceView = nullptr;
+    m_textTexture = nullptr;
+    winrt::check_hresult(m_deviceResources->GetD3DDevice()->CreateTexture2D(&textureDesc, nullptr, m_textTexture.put()));
+    winrt::check_hresult(
+        m_deviceResources->GetD3DDevice()->CreateShaderResourceView(m_textTexture.get(), nullptr, m_textShaderResourceView.put()));
+    winrt::check_hresult(m_deviceResources->GetD3DDevice()->CreateRenderTargetView(m_textTexture.get(), nullptr, m_textRenderTarget.put()));
+
+    const float dpi = 96 * m_textTextureScale;
+    D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
+        D2D1_RENDER_TARGET_TYPE_DEFAULT, D2D1::PixelFormat(DXGI_FORMAT_UNKNOWN, D2D1_ALPHA_MODE_PREMULTIPLIED), dpi, dpi);
+
+    winrt::com_ptr<IDXGISurface> dxgiSurface;
+    m_textTexture.as(dxgiSurface);
+    winrt::check_hresult(
+        m_deviceResources->GetD2DFactory()->CreateDxgiSurfaceRenderTarget(dxgiSurface.get(), &props, m_d2dTextRenderTarget.put()));
+
+    CreateBrushes();
 }
 
 void StatusDisplay::ReleaseDeviceDependentResources()
@@ -371,8 +405,6 @@ void StatusDisplay::ReleaseDeviceDependentResources()
     m_pixelShader = nullptr;
     m_geometryShader = nullptr;
 
-    m_modelConstantBuffer = nullptr;
-
     m_vertexBufferImage = nullptr;
     m_vertexBufferText = nullptr;
     m_indexBuffer = nullptr;
@@ -380,6 +412,10 @@ void StatusDisplay::ReleaseDeviceDependentResources()
     m_imageView = nullptr;
     m_imageSamplerState = nullptr;
 
+    m_textTexture = nullptr;
+    m_textShaderResourceView = nullptr;
+    m_textRenderTarget = nullptr;
+    m_d2dTextRenderTarget = nullptr;
     m_textSamplerState = nullptr;
     m_textAlphaBlendState = nullptr;
 
@@ -538,26 +574,44 @@ void StatusDisplay::PositionDisplay(float deltaTimeInSeconds, const SpatialPoint
 {
     if (pointerPose != nullptr)
     {
-        // Get the gaze direction relative to the given coordinate system.
-        const float3 headPosition = pointerPose.Head().Position();
-        const float3 headDirection = pointerPose.Head().ForwardDirection();
+        SetPositions(FollowGaze({m_positionImage, m_positionText}, deltaTimeInSeconds, pointerPose));
+    }
+}
+
+StatusDisplay::DisplayPositions StatusDisplay::FollowGaze(
+    const DisplayPositions& positions,
+    float deltaTimeInSeconds,
+    const SpatialPointerPose& pointerPose)
+{
+    if (pointerPose == nullptr)
+    {
+        return positions;
+    }
 
-        const float3 offsetImage = float3(0.0f, -0.02f, 0.0f);
-        const float3 gazeAtTwoMetersImage = headPosition + (2.05f * (headDirection + offsetImage));
+    // Get the gaze direction relative to the given coordinate system.
+    const float3 headPosition = pointerPose.Head().Position();
+    const float3 headDirection = pointerPose.Head().ForwardDirection();
 
-        const float3 offsetText = float3(0.0f, -0.035f, 0.0f);
-        const float3 gazeAtTwoMetersText = headPosition + (2.0f * (headDirection + offsetText));
+    const float3 offsetImage = float3(0.0f, -0.02f, 0.0f);
+    const float3 gazeAtTwoMetersImage = headPosition + (2.05f * (headDirection + offsetImage));
 
-        // Lerp the position, to keep the hologram comfortably stable.
-        auto imagePosition = lerp(m_positionImage, gazeAtTwoMetersImage, deltaTimeInSeconds * c_lerpRate);
-        auto textPosition = lerp(m_positionText, gazeAtTwoMetersText, deltaTimeInSeconds * c_lerpRate);
+    const float3 offsetText = float3(0.0f, -0.035f, 0.0f);
+    const float3 gazeAtTwoMetersText = headPosition + (2.0f * (headDirection + offsetText));
 
-        m_lastPositionImage = m_positionImage;
-        m_positionImage = imagePosition;
+    // Lerp the position, to keep the hologram comfortably stable.
+    DisplayPositions result;
+    result.image = lerp(positions.image, gazeAtTwoMetersImage, deltaTimeInSeconds * c_lerpRate);
+    result.text = lerp(positions.text, gazeAtTwoMetersText, deltaTimeInSeconds * c_lerpRate);
+    return result;
+}
 
-        m_lastPositionText = m_positionText;
-        m_positionText = textPosition;
-    }
+void StatusDisplay::SetPositions(const DisplayPositions& positions)
+{
+    m_lastPositionImage = m_positionImage;
+    m_positionImage = positions.image;
+
+    m_lastPositionText = m_positionText;
+    m_positionText = positions.text;
 }
 
 void StatusDisplay::UpdateConstantBuffer(
@@ -14,6 +14,7 @@
 #include "..\Common\DeviceResources.h"
 #include "ShaderStructures.h"
 
+#include <ppltasks.h>
 #include <string>
 
 #include <winrt\Windows.Networking.Connectivity.h>
@@ -54,6 +55,13 @@ public:
         bool alignBottom = false;
     };
 
+    // Where the image and the text of the display are placed.
+    struct DisplayPositions
+    {
+        winrt::Windows::Foundation::Numerics::float3 image = {0.f, 0.f, -2.f};
+        winrt::Windows::Foundation::Numerics::float3 text = {0.f, -0.1f, -0.1f};
+    };
+
 public:
     StatusDisplay(const std::shared_ptr<DX::DeviceResources>& deviceResources);
 
@@ -61,7 +69,8 @@ public:
 
     void Render();
 
-    void CreateDeviceDependentResources();
+    // Completes when the display can render again. Shaders and textures are created on background tasks.
+    Concurrency::task<void> CreateDeviceDependentResources();
     void ReleaseDeviceDependentResources();
 
     /*
@@ -105,6 +114,22 @@ public:
     // Repositions the status display
     void PositionDisplay(float deltaTimeInSeconds, const winrt::Windows::UI::Input::Spatial::SpatialPointerPose& pointerPose);
 
+    // Moves the display from the given positions towards the gaze of the pointer pose, the way PositionDisplay does. Doesn't
+    // touch the display, so that the positions can be simulated on another thread and applied with SetPositions.
+    static DisplayPositions FollowGaze(
+        const DisplayPositions& positions,
+        float deltaTimeInSeconds,
+        const winrt::Windows::UI::Input::Spatial::SpatialPointerPose& pointerPose);
+
+    void SetPositions(const DisplayPositions& positions);
+
+    // Rasterizes the text into a texture of the given fraction of the full size, e.g. to save video memory. The text keeps
+    // its size and layout but is less sharp.
+    void SetTextTextureScale(float scale);
+
+    // Video memory held by the text texture.
+    uint64_t GetTextTextureBytes() const;
+
     // Get the center position of the status display
     winrt::Windows::Foundation::Numerics::float3 GetPosition()
     {
@@ -126,6 +151,7 @@ private:
 
     void CreateFonts();
     void CreateBrushes();
+    void CreateTextTexture();
     void UpdateLineInternal(RuntimeLine& runtimLine, const Line& line);
     void UpdateConstantBuffer(
         float deltaTimeInSeconds,
@@ -147,6 +173,7 @@ private:
     winrt::com_ptr<ID3D11ShaderResourceView> m_textShaderResourceView;
     winrt::com_ptr<ID3D11RenderTargetView> m_textRenderTarget;
     winrt::com_ptr<ID2D1RenderTarget> m_d2dTextRenderTarget;
+    float m_textTextureScale = 1.0f;
 
     // Direct3D resources for quad geometry.
     winrt::com_ptr<ID3D11InputLayout> m_inputLayout;
@@ -156,7 +183,6 @@ private:
     winrt::com_ptr<ID3D11VertexShader> m_vertexShader;
     winrt::com_ptr<ID3D11GeometryShader> m_geometryShader;
     winrt::com_ptr<ID3D11PixelShader> m_pixelShader;
-    winrt::com_ptr<ID3D11Buffer> m_modelConstantBuffer;
 
     // Direct3D resources for a texture.
     winrt::com_ptr<ID3D11ShaderResourceView> m_imageView;
@@ -184,7 +210,7 @@ private:
     bool m_usingVprtShaders = false;
 
     // This is the rate at which the hologram position is interpolated ("lerped") to the current location.
-    const float c_lerpRate = 4.0f;
+    static constexpr float c_lerpRate = 4.0f;
 
     bool m_imageEnabled = true;
     bool m_textEnabled = true;
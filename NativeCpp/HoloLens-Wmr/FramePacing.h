@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace HolographicApp
+{
+    // How the app synchronizes with the display before it starts pose-dependent work for the next frame.
+    enum class FramePacingMode
+    {
+        // Wait until the GPU has finished the previous frame. Used on OS versions without WaitForNextFrameReady.
+        WaitForFrameToFinish,
+
+        // Let the platform pick the wakeup time that gives the lowest latency at the current frame rate.
+        WaitForNextFrameReady,
+
+        // Wake up a fixed head start ahead of the platform's wakeup time, for apps with more CPU work per frame.
+        WaitForNextFrameReadyWithHeadStart,
+    };
+
+    // Measures where each frame's work happens relative to the time its photons are predicted to be displayed, and
+    // reports averages with OutputDebugStringA. All offsets are in milliseconds before the prediction's target time:
+    // * wakeup:  when the frame wait returned, which is the budget for the whole frame.
+    // * latch:   when the camera poses used for rendering were predicted, which is the motion-to-photon latency of
+    //            locally rendered content.
+    // * submit:  when rendering finished and the frame was handed to Present.
+    class FramePacingStats
+    {
+    public:
+        using Clock = winrt::clock;
+
+        static constexpr uint32_t FramesPerReport = 300;
+
+        explicit FramePacingStats(FramePacingMode mode = FramePacingMode::WaitForNextFrameReady)
+            : m_mode(mode)
+        {
+        }
+
+        void SetMode(FramePacingMode mode)
+        {
+            if (m_mode != mode)
+            {
+                m_mode = mode;
+                Reset();
+            }
+        }
+
+        // Called right before and after the frame wait.
+        void OnWaitStarted()
+        {
+            m_waitStart = Clock::now();
+        }
+
+        void OnWaitFinished()
+        {
+            m_wakeup = Clock::now();
+            m_waitMs += ToMilliseconds(m_wakeup - m_waitStart);
+        }
+
+        // Called right after the camera poses the frame is rendered with were predicted.
+        void OnPoseLatched(winrt::Windows::Graphics::Holographic::HolographicFramePrediction const& prediction)
+        {
+            m_latch = Clock::now();
+            m_target = prediction.Timestamp().TargetTime();
+        }
+
+        // Called when rendering of the frame has finished.
+        void OnFrameSubmitted()
+        {
+            const Clock::time_point submit = Clock::now();
+            m_wakeupMs += ToMilliseconds(m_target - m_wakeup);
+            m_latchMs += ToMilliseconds(m_target - m_latch);
+            m_submitMs += ToMilliseconds(m_target - submit);
+
+            if (++m_frameCount == FramesPerReport)
+            {
+                char buffer[256];
+                sprintf_s(buffer, "Frame pacing (%s): wait %.2f ms, wakeup %.2f ms, latch %.2f ms, submit %.2f ms before target\n",
+                    GetModeName(m_mode), m_waitMs / m_frameCount, m_wakeupMs / m_frameCount, m_latchMs / m_frameCount, m_submitMs / m_frameCount);
+                OutputDebugStringA(buffer);
+                Reset();
+            }
+        }
+
+        static const char* GetModeName(FramePacingMode mode)
+        {
+            switch (mode)
+            {
+            case FramePacingMode::WaitForFrameToFinish:
+                return "WaitForFrameToFinish";
+            case FramePacingMode::WaitForNextFrameReady:
+                return "WaitForNextFrameReady";
+            case FramePacingMode::WaitForNextFrameReadyWithHeadStart:
+                return "WaitForNextFrameReadyWithHeadStart";
+            }
+            return "Unknown";
+        }
+
+    private:
+        static double ToMilliseconds(Clock::duration duration)
+        {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+
+        void Reset()
+        {
+            m_frameCount = 0;
+            m_waitMs = m_wakeupMs = m_latchMs = m_submitMs = 0.0;
+        }
+
+        FramePacingMode m_mode;
+        Clock::time_point m_waitStart;
+        Clock::time_point m_wakeup;
+        Clock::time_point m_latch;
+        Clock::time_point m_target;
+
+        uint32_t m_frameCount = 0;
+        double m_waitMs = 0.0;
+        double m_wakeupMs = 0.0;
+        double m_latchMs = 0.0;
+        double m_submitMs = 0.0;
+    };
+}
@@ -0,0 +1,223 @@
+#include "pch.h"
+
+#ifdef USE_REMOTE_RENDERING
+#include "HolographicAppMain.h"
+#include "FrameStatisticsMonitor.h"
+
+#include <cstdio>
+
+namespace HolographicApp
+{
+    namespace
+    {
+        constexpr float MillisecondsPerSecond = 1000.0f;
+
+        const char* CsvHeader =
+            "Time,Label,LatencyPoseToReceiveMs,LatencyReceiveToPresentMs,LatencyPresentToDisplayMs,TimeSinceLastPresentMs,"
+            "VideoFrameMinDeltaMs,VideoFrameMaxDeltaMs,VideoFramesReceived,VideoFramesReused,VideoFramesSkipped,VideoFramesDiscarded,"
+            "ServerTimeCPUMs,ServerTimeGPUMs,ServerUtilizationCPU,ServerUtilizationGPU,ServerMemoryCPU,ServerMemoryGPU,"
+            "NetworkLatencyMs,PolygonsRendered\n";
+
+        RR::PerformanceRating WorseRating(RR::PerformanceRating a, RR::PerformanceRating b)
+        {
+            for (RR::PerformanceRating rating : { RR::PerformanceRating::Bad, RR::PerformanceRating::Good, RR::PerformanceRating::Great })
+            {
+                if (a == rating || b == rating)
+                {
+                    return rating;
+                }
+            }
+            return RR::PerformanceRating::Unknown;
+        }
+    }
+
+    void FrameStatisticsMonitor::SetOptions(Options options)
+    {
+        m_options = std::move(options);
+        if (!m_options.LogToCsv)
+        {
+            m_csvFile.close();
+        }
+    }
+
+    void FrameStatisticsMonitor::Reset(RR::ApiHandle<RR::RenderingConnection> connection, RR::ApiHandle<RR::GraphicsBindingWmrD3d11> graphicsBinding)
+    {
+        m_connection = std::move(connection);
+        m_graphicsBinding = std::move(graphicsBinding);
+        m_summary.reset();
+        m_assessment.reset();
+        m_assessmentInProgress = false;
+        m_nextSampleTime = 0;
+        m_nextAssessmentTime = 0;
+
+        // Results of queries on the previous connection are ignored.
+        m_generation++;
+    }
+
+    bool FrameStatisticsMonitor::Update(double nowInSeconds)
+    {
+        if (m_connection == nullptr || m_graphicsBinding == nullptr || nowInSeconds < m_nextSampleTime)
+        {
+            return false;
+        }
+        m_nextSampleTime = nowInSeconds + m_options.SampleIntervalInSeconds;
+
+        if (!m_assessmentInProgress && nowInSeconds >= m_nextAssessmentTime)
+        {
+            m_nextAssessmentTime = nowInSeconds + m_options.AssessmentIntervalInSeconds;
+            QueryAssessment();
+        }
+
+        RR::FrameStatistics statistics;
+        if (m_graphicsBinding->GetLastFrameStatistics(&statistics) != RR::Result::Success)
+        {
+            // No remote frame has been received yet.
+            return false;
+        }
+
+        if (m_options.LogToCsv)
+        {
+            WriteCsvRow(nowInSeconds, statistics);
+        }
+
+        const float latencyStep = FrameStatisticsSummary::LatencyStepInMilliseconds;
+        const float serverFrameTimeStep = FrameStatisticsSummary::ServerFrameTimeStepInMilliseconds;
+
+        FrameStatisticsSummary summary;
+        summary.LatencyPoseToReceive = FrameStatisticsSummary::Quantize(statistics.LatencyPoseToReceive * MillisecondsPerSecond, latencyStep);
+        summary.LatencyReceiveToPresent = FrameStatisticsSummary::Quantize(statistics.LatencyReceiveToPresent * MillisecondsPerSecond, latencyStep);
+        summary.LatencyPresentToDisplay = FrameStatisticsSummary::Quantize(statistics.LatencyPresentToDisplay * MillisecondsPerSecond, latencyStep);
+        summary.FrameJitter = FrameStatisticsSummary::Quantize(
+            (statistics.VideoFrameMaxDelta - statistics.VideoFrameMinDelta) * MillisecondsPerSecond, latencyStep);
+        summary.FramesReceived = static_cast<int>(statistics.VideoFramesReceived);
+        summary.FramesReused = static_cast<int>(statistics.VideoFramesReused);
+        summary.FramesSkipped = static_cast<int>(statistics.VideoFramesSkipped);
+        summary.FramesDiscarded = static_cast<int>(statistics.VideoFramesDiscarded);
+        if (m_assessment.has_value())
+        {
+            const RR::PerformanceAssessment& assessment = m_assessment.value();
+            summary.HasAssessment = true;
+            summary.ServerTimeCPU = FrameStatisticsSummary::Quantize(assessment.TimeCPU.Aggregate, serverFrameTimeStep);
+            summary.ServerTimeGPU = FrameStatisticsSummary::Quantize(assessment.TimeGPU.Aggregate, serverFrameTimeStep);
+            summary.NetworkLatency = FrameStatisticsSummary::Quantize(assessment.NetworkLatency.Aggregate, latencyStep);
+            summary.Rating = WorseRating(WorseRating(assessment.TimeCPU.Rating, assessment.TimeGPU.Rating), assessment.NetworkLatency.Rating);
+        }
+
+        const bool changed = !m_summary.has_value() || m_summary.value() != summary;
+        m_summary = summary;
+        return changed && m_options.ShowHud;
+    }
+
+    void FrameStatisticsMonitor::QueryAssessment()
+    {
+        m_assessmentInProgress = true;
+        m_connection->QueryServerPerformanceAssessmentAsync(
+            [this, generation = m_generation](RR::Status status, RR::PerformanceAssessment result)
+            {
+                if (generation != m_generation)
+                {
+                    return;
+                }
+
+                m_assessmentInProgress = false;
+                if (status == RR::Status::OK)
+                {
+                    m_assessment = result;
+                }
+            });
+    }
+
+    void FrameStatisticsMonitor::WriteCsvRow(double nowInSeconds, const RR::FrameStatistics& statistics)
+    {
+        if (!m_csvFile.is_open() && !OpenCsvFile())
+        {
+            return;
+        }
+
+        char row[512];
+        int length = sprintf_s(row, "%.3f,%s,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%u,%u,%u,%u,",
+            nowInSeconds,
+            m_options.Label.c_str(),
+            statistics.LatencyPoseToReceive * MillisecondsPerSecond,
+            statistics.LatencyReceiveToPresent * MillisecondsPerSecond,
+            statistics.LatencyPresentToDisplay * MillisecondsPerSecond,
+            statistics.TimeSinceLastPresent * MillisecondsPerSecond,
+            statistics.VideoFrameMinDelta * MillisecondsPerSecond,
+            statistics.VideoFrameMaxDelta * MillisecondsPerSecond,
+            statistics.VideoFramesReceived,
+            statistics.VideoFramesReused,
+            statistics.VideoFramesSkipped,
+            statistics.VideoFramesDiscarded);
+        if (m_assessment.has_value())
+        {
+            // The assessment columns repeat the latest result until the next query completes.
+            const RR::PerformanceAssessment& assessment = m_assessment.value();
+            sprintf_s(row + length, sizeof(row) - length, "%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f\n",
+                assessment.TimeCPU.Aggregate,
+                assessment.TimeGPU.Aggregate,
+                assessment.UtilizationCPU.Aggregate,
+                assessment.UtilizationGPU.Aggregate,
+                assessment.MemoryCPU.Aggregate,
+                assessment.MemoryGPU.Aggregate,
+                assessment.NetworkLatency.Aggregate,
+                assessment.PolygonsRendered.Aggregate);
+        }
+        else
+        {
+            sprintf_s(row + length, sizeof(row) - length, ",,,,,,,\n");
+        }
+
+        m_csvFile << row;
+        m_csvFile.flush();
+
+        if (static_cast<size_t>(m_csvFile.tellp()) >= m_options.MaxCsvFileSizeInBytes)
+        {
+            m_csvFile.close();
+        }
+    }
+
+    bool FrameStatisticsMonitor::OpenCsvFile()
+    {
+        if (m_csvFailed)
+        {
+            return false;
+        }
+
+        if (m_csvFolder.empty())
+        {
+            m_csvFolder = winrt::Windows::Storage::ApplicationData::Current().LocalFolder().Path();
+        }
+
+        // Every run and every full file starts a new file, the previous ones are kept as FrameStatistics.N.csv.
+        RotateCsvFiles();
+        m_csvFile.open(GetCsvFilePath(0), std::ios::out | std::ios::trunc);
+        if (!m_csvFile.is_open())
+        {
+            m_csvFailed = true;
+            OutputDebugStringA("FrameStatisticsMonitor: Failed to open the CSV log, logging is disabled.\n");
+            return false;
+        }
+
+        m_csvFile << CsvHeader;
+        return true;
+    }
+
+    void FrameStatisticsMonitor::RotateCsvFiles()
+    {
+        _wremove(GetCsvFilePath(m_options.MaxCsvFileCount - 1).c_str());
+        for (int index = m_options.MaxCsvFileCount - 2; index >= 0; index--)
+        {
+            _wrename(GetCsvFilePath(index).c_str(), GetCsvFilePath(index + 1).c_str());
+        }
+    }
+
+    std::wstring FrameStatisticsMonitor::GetCsvFilePath(int index) const
+    {
+        if (index == 0)
+        {
+            return m_csvFolder + L"\\FrameStatistics.csv";
+        }
+        return m_csvFolder + L"\\FrameStatistics." + std::to_wstring(index) + L".csv";
+    }
+}
+#endif
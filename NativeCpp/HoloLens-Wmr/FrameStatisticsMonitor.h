@@ -0,0 +1,109 @@
+#pragma once
+
+#ifdef USE_REMOTE_RENDERING
+#include <fstream>
+#include <string>
+
+namespace HolographicApp
+{
+    // The remote frame statistics as shown by the performance HUD. Values are quantized, so that the HUD text is only
+    // rebuilt when a change is visible.
+    struct FrameStatisticsSummary
+    {
+        static constexpr float LatencyStepInMilliseconds = 1.0f;
+        static constexpr float ServerFrameTimeStepInMilliseconds = 0.5f;
+
+        int LatencyPoseToReceive = 0;       // In LatencyStepInMilliseconds.
+        int LatencyReceiveToPresent = 0;    // In LatencyStepInMilliseconds.
+        int LatencyPresentToDisplay = 0;    // In LatencyStepInMilliseconds.
+        int FrameJitter = 0;                // Max - min time between received frames, in LatencyStepInMilliseconds.
+        int FramesReceived = 0;
+        int FramesReused = 0;
+        int FramesSkipped = 0;
+        int FramesDiscarded = 0;
+
+        bool HasAssessment = false;
+        int ServerTimeCPU = 0;              // In ServerFrameTimeStepInMilliseconds.
+        int ServerTimeGPU = 0;              // In ServerFrameTimeStepInMilliseconds.
+        int NetworkLatency = 0;             // In LatencyStepInMilliseconds.
+        RR::PerformanceRating Rating = RR::PerformanceRating::Unknown; // The worst rating of the values above.
+
+        static int Quantize(float milliseconds, float stepInMilliseconds)
+        {
+            return static_cast<int>(milliseconds / stepInMilliseconds + 0.5f);
+        }
+
+        bool operator==(const FrameStatisticsSummary& other) const
+        {
+            return LatencyPoseToReceive == other.LatencyPoseToReceive && LatencyReceiveToPresent == other.LatencyReceiveToPresent &&
+                LatencyPresentToDisplay == other.LatencyPresentToDisplay && FrameJitter == other.FrameJitter &&
+                FramesReceived == other.FramesReceived && FramesReused == other.FramesReused && FramesSkipped == other.FramesSkipped &&
+                FramesDiscarded == other.FramesDiscarded && HasAssessment == other.HasAssessment && ServerTimeCPU == other.ServerTimeCPU &&
+                ServerTimeGPU == other.ServerTimeGPU && NetworkLatency == other.NetworkLatency &&
+                Rating == other.Rating;
+        }
+
+        bool operator!=(const FrameStatisticsSummary& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    // Polls the frame statistics of the graphics binding and the server performance assessment of a connection, for the
+    // performance HUD and an optional CSV log.
+    //
+    // The frame statistics are aggregated by ARR over the last second, so they are sampled once per SampleIntervalInSeconds
+    // rather than every frame. Performance assessments are queried asynchronously, one at a time. Every sample is appended
+    // as a row to <LocalFolder>\FrameStatistics.csv; once the file exceeds MaxCsvFileSizeInBytes it is rotated to
+    // FrameStatistics.1.csv and so on, keeping MaxCsvFileCount files. The Label column identifies the build or region of
+    // a run, so logs of different runs can be compared.
+    class FrameStatisticsMonitor
+    {
+    public:
+        struct Options
+        {
+            double SampleIntervalInSeconds = 1.0;
+            double AssessmentIntervalInSeconds = 5.0;
+            bool ShowHud = true;
+            bool LogToCsv = true;
+            size_t MaxCsvFileSizeInBytes = 1024 * 1024;
+            int MaxCsvFileCount = 4;
+            std::string Label;
+        };
+
+        void SetOptions(Options options);
+        const Options& GetOptions() const { return m_options; }
+
+        // Starts monitoring a connection. Passing null stops monitoring, e.g. on disconnect.
+        void Reset(RR::ApiHandle<RR::RenderingConnection> connection, RR::ApiHandle<RR::GraphicsBindingWmrD3d11> graphicsBinding);
+
+        // Samples the statistics when due. Returns true if the HUD has to show a new summary. Call once per frame.
+        bool Update(double nowInSeconds);
+
+        // The latest summary, or none if nothing was sampled since the last Reset.
+        const std::optional<FrameStatisticsSummary>& GetSummary() const { return m_summary; }
+
+    private:
+        void QueryAssessment();
+        void WriteCsvRow(double nowInSeconds, const RR::FrameStatistics& statistics);
+        bool OpenCsvFile();
+        void RotateCsvFiles();
+        std::wstring GetCsvFilePath(int index) const;
+
+        Options                                                     m_options;
+        RR::ApiHandle<RR::RenderingConnection>                      m_connection;
+        RR::ApiHandle<RR::GraphicsBindingWmrD3d11>                  m_graphicsBinding;
+        std::optional<FrameStatisticsSummary>                       m_summary;
+        std::optional<RR::PerformanceAssessment>                    m_assessment;
+        bool                                                        m_assessmentInProgress = false;
+        double                                                      m_nextSampleTime = 0;
+        double                                                      m_nextAssessmentTime = 0;
+        uint64_t                                                    m_generation = 0;
+
+        // CSV log:
+        std::wstring                                                m_csvFolder;
+        std::ofstream                                               m_csvFile;
+        bool                                                        m_csvFailed = false;
+    };
+}
+#endif
@@ -0,0 +1,134 @@
+#include "pch.h"
+
+#include "GpuMemoryGovernor.h"
+
+namespace HolographicApp
+{
+    namespace
+    {
+        constexpr double BytesPerMegabyte = 1024.0 * 1024.0;
+    }
+
+    GpuMemoryGovernor::GpuMemoryGovernor(std::shared_ptr<DX::DeviceResources> deviceResources, const Options& options) :
+        m_options(options),
+        m_deviceResources(std::move(deviceResources))
+    {
+        // Without the notification the usage is still polled.
+        m_budgetChangedEvent.attach(CreateEventEx(nullptr, nullptr, 0, EVENT_MODIFY_STATE | SYNCHRONIZE));
+    }
+
+    GpuMemoryGovernor::~GpuMemoryGovernor()
+    {
+        UnregisterBudgetChangeNotification();
+    }
+
+    bool GpuMemoryGovernor::Update()
+    {
+        // Null until the device is created, and replaced when the device is recreated.
+        IDXGIAdapter3* adapter = m_deviceResources->GetDXGIAdapter();
+        if (adapter == nullptr)
+        {
+            return false;
+        }
+        if (adapter != m_adapter.Get())
+        {
+            RegisterBudgetChangeNotification(adapter);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const bool budgetChanged = m_budgetChangeRegistered && WaitForSingleObject(m_budgetChangedEvent.get(), 0) == WAIT_OBJECT_0;
+        if (!budgetChanged && now < m_nextPollTime)
+        {
+            return false;
+        }
+        m_nextPollTime = now + m_options.PollInterval;
+
+        if (FAILED(adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &m_memoryInfo)) || m_memoryInfo.Budget == 0)
+        {
+            return false;
+        }
+
+        const double usage = static_cast<double>(m_memoryInfo.CurrentUsage) / static_cast<double>(m_memoryInfo.Budget);
+        if (usage > m_options.StepDownThreshold)
+        {
+            m_belowStepUpThresholdSince.reset();
+            if (now - m_lastTrimTime < m_options.SettleTime)
+            {
+                return false;
+            }
+
+            // Trimming releases the driver's internal allocations, and is repeated while the usage stays high.
+            m_deviceResources->Trim();
+            m_lastTrimTime = now;
+            if (m_level == Level::Reduced)
+            {
+                Report("still over budget, trimmed");
+                return false;
+            }
+
+            m_level = Level::Reduced;
+            Report("over budget");
+            return true;
+        }
+
+        if (usage >= m_options.StepUpThreshold || m_level == Level::Normal)
+        {
+            m_belowStepUpThresholdSince.reset();
+            return false;
+        }
+
+        if (!m_belowStepUpThresholdSince.has_value())
+        {
+            m_belowStepUpThresholdSince = now;
+        }
+        else if (now - m_belowStepUpThresholdSince.value() >= m_options.StepUpDelay)
+        {
+            m_level = Level::Normal;
+            m_belowStepUpThresholdSince.reset();
+            Report("within budget");
+            return true;
+        }
+        return false;
+    }
+
+    const char* GpuMemoryGovernor::ToString(Level level)
+    {
+        switch (level)
+        {
+        case Level::Normal:
+            return "Normal";
+        case Level::Reduced:
+            return "Reduced";
+        }
+        return "Unknown";
+    }
+
+    void GpuMemoryGovernor::RegisterBudgetChangeNotification(IDXGIAdapter3* adapter)
+    {
+        UnregisterBudgetChangeNotification();
+        m_adapter = adapter;
+        m_budgetChangeRegistered = m_budgetChangedEvent &&
+            SUCCEEDED(m_adapter->RegisterVideoMemoryBudgetChangeNotificationEvent(m_budgetChangedEvent.get(), &m_budgetChangedCookie));
+    }
+
+    void GpuMemoryGovernor::UnregisterBudgetChangeNotification()
+    {
+        if (m_budgetChangeRegistered)
+        {
+            m_adapter->UnregisterVideoMemoryBudgetChangeNotification(m_budgetChangedCookie);
+            m_budgetChangeRegistered = false;
+        }
+        m_adapter.Reset();
+    }
+
+    void GpuMemoryGovernor::Report(const char* reason) const
+    {
+        char message[256];
+        sprintf_s(message, "GPU memory %s: %.1f of %.1f MB used, level %s.\n",
+            reason,
+            m_memoryInfo.CurrentUsage / BytesPerMegabyte,
+            m_memoryInfo.Budget / BytesPerMegabyte,
+            ToString(m_level));
+        OutputDebugStringA(message);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <optional>
+
+#include "Common/DeviceResources.h"
+
+namespace HolographicApp
+{
+    // Watches the local video memory budget of the adapter, so that the app steps down to cheaper modes before the OS
+    // terminates it for exceeding the budget, e.g. when the decode surfaces of the remote frames grow.
+    //
+    // The usage is queried with IDXGIAdapter3::QueryVideoMemoryInfo every PollInterval, and right away when the OS signals a
+    // budget change. Above StepDownThreshold of the budget, the governor trims the device and lowers the level; it waits
+    // SettleTime before it trims again, so the app has time to release memory. The level goes back up only after the usage
+    // stayed below StepUpThreshold for StepUpDelay. The adapter is looked up on every poll, so a recreated device is
+    // picked up without any notification.
+    class GpuMemoryGovernor
+    {
+    public:
+        enum class Level
+        {
+            Normal,
+            Reduced, // Smaller textures.
+        };
+
+        struct Options
+        {
+            std::chrono::milliseconds PollInterval{ 1000 };
+            std::chrono::milliseconds SettleTime{ 3000 };
+            std::chrono::milliseconds StepUpDelay{ 10000 };
+            float StepDownThreshold = 0.9f; // Fractions of the budget.
+            float StepUpThreshold = 0.7f;
+        };
+
+        explicit GpuMemoryGovernor(std::shared_ptr<DX::DeviceResources> deviceResources, const Options& options = {});
+        ~GpuMemoryGovernor();
+
+        GpuMemoryGovernor(const GpuMemoryGovernor&) = delete;
+        GpuMemoryGovernor& operator=(const GpuMemoryGovernor&) = delete;
+
+        // Queries the usage if due. Returns true if the level changed. Call at the start of a frame, since trimming clears the
+        // state of the immediate context.
+        bool Update();
+
+        Level GetLevel() const { return m_level; }
+
+        static const char* ToString(Level level);
+
+    private:
+        void RegisterBudgetChangeNotification(IDXGIAdapter3* adapter);
+        void UnregisterBudgetChangeNotification();
+        void Report(const char* reason) const;
+
+        const Options                                               m_options;
+        std::shared_ptr<DX::DeviceResources>                        m_deviceResources;
+        Microsoft::WRL::ComPtr<IDXGIAdapter3>                       m_adapter; // The adapter the notification is registered with.
+        winrt::handle                                               m_budgetChangedEvent;
+        DWORD                                                       m_budgetChangedCookie = 0;
+        bool                                                        m_budgetChangeRegistered = false;
+
+        Level                                                       m_level = Level::Normal;
+        DXGI_QUERY_VIDEO_MEMORY_INFO                                m_memoryInfo = {};
+        std::chrono::steady_clock::time_point                       m_nextPollTime = {};
+        std::chrono::steady_clock::time_point                       m_lastTrimTime = {};
+        std::optional<std::chrono::steady_clock::time_point>        m_belowStepUpThresholdSince;
+    };
+}
@@ -28,7 +28,8 @@ using namespace winrt::Windows::Foundation::Metadata;
 
 // Loads and initializes application assets when the application is loaded.
 HolographicAppMain::HolographicAppMain(std::shared_ptr<DX::DeviceResources> const& deviceResources) :
-    m_deviceResources(deviceResources)
+    m_deviceResources(deviceResources),
+    m_gpuMemoryGovernor(deviceResources)
 {
 #ifdef USE_REMOTE_RENDERING
     // 1. One time initialization
@@ -49,57 +50,14 @@ HolographicAppMain::HolographicAppMain(std::shared_ptr<DX::DeviceResources> cons
     }
 
 
-    // 2. Create Client
-    {
-        // Users need to fill out the following with their account data and model
-        RR::SessionConfiguration init;
-        init.AccountId = "00000000-0000-0000-0000-000000000000";
-        init.AccountKey = "<account key>";
-        init.RemoteRenderingDomain = "westus2.mixedreality.azure.com"; // <change to the region that the rendering session should be created in>
-        init.AccountDomain = "westus2.mixedreality.azure.com"; // <change to the region the account was created in>
-        m_modelURI = "builtin://Engine";
-        m_sessionOverride = ""; // If there is a valid session ID to re-use, put it here. Otherwise a new one is created
-        m_client = RR::ApiHandle(RR::RemoteRenderingClient(init));
-    }
-
-    // 3. Open/create rendering session
-    {
-        auto SessionHandler = [&](RR::Status status, RR::ApiHandle<RR::CreateRenderingSessionResult> result)
-        {
-            if (status == RR::Status::OK)
-            {
-                auto ctx = result->GetContext();
-                if (ctx.Result == RR::Result::Success)
-                {
-                    SetNewSession(result->GetSession());
-                }
-                else
-                {
-                    SetNewState(AppConnectionStatus::ConnectionFailed, ctx.ErrorMessage.c_str());
-                }
-            }
-            else
-            {
-                SetNewState(AppConnectionStatus::ConnectionFailed, "failed");
-            }
-        };
-
-        // If we had an old (valid) session that we can recycle, we call async function m_client->OpenRenderingSessionAsync
-        if (!m_sessionOverride.empty())
-        {
-            m_client->OpenRenderingSessionAsync(m_sessionOverride, SessionHandler);
-            SetNewState(AppConnectionStatus::CreatingSession, nullptr);
-        }
-        else
+    // 2. Create client and 3. open/create rendering session
+    // Probing the regions, creating the client and finding a rendering session only talk to the network, so they run on a
+    // worker thread instead of delaying the first frame. Their results are handed to the main thread, see PostToMainThread.
+    m_arrStartup = std::async(std::launch::async, [this]
         {
-            // create a new session
-            RR::RenderingSessionCreationOptions init;
-            init.MaxLeaseInMinutes = 10; // session is leased for 10 minutes
-            init.Size = RR::RenderingSessionVmSize::Standard;
-            m_client->CreateNewRenderingSessionAsync(init, SessionHandler);
-            SetNewState(AppConnectionStatus::CreatingSession, nullptr);
-        }
-    }
+            CreateARRClient(RegionProbe().SelectRegion());
+            AcquireARRSession();
+        });
 
 #endif
 
@@ -119,6 +77,20 @@ HolographicAppMain::HolographicAppMain(std::shared_ptr<DX::DeviceResources> cons
     m_canGetDefaultHolographicDisplay = ApiInformation::IsMethodPresent(winrt::name_of<HolographicDisplay>(), L"GetDefault");
     m_canCommitDirect3D11DepthBuffer = ApiInformation::IsMethodPresent(winrt::name_of<HolographicCameraRenderingParameters>(), L"CommitDirect3D11DepthBuffer");
     m_canUseWaitForNextFrameReadyAPI = ApiInformation::IsMethodPresent(winrt::name_of<HolographicSpace>(), L"WaitForNextFrameReady");
+    m_canUseWaitForNextFrameReadyWithHeadStartAPI = ApiInformation::IsMethodPresent(winrt::name_of<HolographicSpace>(), L"WaitForNextFrameReadyWithHeadStart");
+
+    if (m_framePacingMode == FramePacingMode::WaitForNextFrameReadyWithHeadStart && !m_canUseWaitForNextFrameReadyWithHeadStartAPI)
+    {
+        m_framePacingMode = FramePacingMode::WaitForNextFrameReady;
+    }
+    if (m_framePacingMode == FramePacingMode::WaitForNextFrameReady && !m_canUseWaitForNextFrameReadyAPI)
+    {
+        m_framePacingMode = FramePacingMode::WaitForFrameToFinish;
+    }
+    m_framePacingStats.SetMode(m_framePacingMode);
+
+    // The app waits at the start of each frame, right before its pose-dependent work, so Present never needs to block.
+    m_deviceResources->SetPresentWaitBehavior(HolographicFramePresentWaitBehavior::DoNotWaitForFrameToFinish);
 
     if (m_canGetDefaultHolographicDisplay)
     {
@@ -154,11 +126,25 @@ void HolographicAppMain::OnConnectionStatusChanged(RR::ConnectionStatus status,
         {
             SetNewState(AppConnectionStatus::ConnectionFailed, asString);
         }
-        m_modelLoadTriggered = m_modelLoadFinished = false;
+        m_modelLoadTriggered = false;
+        m_modelLoadQueue.Reset(nullptr);
         m_isConnected = error == RR::Result::Success;
+        m_frameStatisticsMonitor.Reset(m_isConnected ? m_api : nullptr, m_isConnected ? m_graphicsBinding : nullptr);
+        m_connectionProfileSelector.Reset(m_isConnected ? m_graphicsBinding : nullptr);
         break;
     case RR::ConnectionStatus::Disconnected:
-        if (error == RR::Result::Success)
+        m_modelLoadTriggered = false;
+        m_modelLoadQueue.Reset(nullptr);
+        m_isConnected = false;
+        m_frameStatisticsMonitor.Reset(nullptr, nullptr);
+        m_connectionProfileSelector.Reset(nullptr);
+        if (m_reconnectPending)
+        {
+            // The old connection is gone, so no later event of it can overwrite the state of the new one.
+            m_reconnectPending = false;
+            ConnectToSession();
+        }
+        else if (error == RR::Result::Success)
         {
             SetNewState(AppConnectionStatus::Disconnected, asString);
         }
@@ -166,8 +152,6 @@ void HolographicAppMain::OnConnectionStatusChanged(RR::ConnectionStatus status,
         {
             SetNewState(AppConnectionStatus::ConnectionFailed, asString);
         }
-        m_modelLoadTriggered = m_modelLoadFinished = false;
-        m_isConnected = false;
         break;
     default:
         break;
@@ -197,6 +181,11 @@ void HolographicAppMain::SetHolographicSpace(HolographicSpace const& holographic
     m_spatialInputHandler = std::make_unique<SpatialInputHandler>();
 #endif
 
+    if (m_simulationMode == SimulationMode::SimulationThread)
+    {
+        m_simulation.Start();
+    }
+
     // Respond to camera added events by creating any resources that are specific
     // to that camera, such as the back buffer render target view.
     // When we add an event handler for CameraAdded, the API layer will avoid putting
@@ -243,8 +232,127 @@ void HolographicAppMain::UnregisterHolographicEventHandlers()
     }
 }
 
+#ifdef USE_REMOTE_RENDERING
+// Creates the client for the rendering domain of the region.
+void HolographicAppMain::CreateARRClient(const std::string& region)
+{
+    // Users need to fill out the following with their account data and model
+    RR::SessionConfiguration init;
+    init.AccountId = "00000000-0000-0000-0000-000000000000";
+    init.AccountKey = "<account key>";
+    // The session is created in the region with the lowest round trip from this network, see RegionProbe.
+    init.RemoteRenderingDomain = RegionProbe::GetDomain(region);
+    init.AccountDomain = "westus2.mixedreality.azure.com"; // <change to the region the account was created in>
+    m_modelURIs = { "builtin://Engine" }; // <add all parts of the scene here, they are loaded in parallel>
+    m_coarseModelURIs = {}; // <optionally add decimated conversions of the parts, they are shown first>
+    m_sessionOverride = ""; // If there is a valid session ID to re-use, put it here. Otherwise a new one is created
+    m_client = RR::ApiHandle(RR::RemoteRenderingClient(init));
+
+    // The performance HUD shows the remote frame statistics once the model is loaded. The CSV log in the app's
+    // local folder is labeled with the region, so runs against different regions can be compared.
+    FrameStatisticsMonitor::Options statisticsOptions;
+    statisticsOptions.ShowHud = true;
+    statisticsOptions.LogToCsv = true;
+    statisticsOptions.Label = init.RemoteRenderingDomain;
+    m_frameStatisticsMonitor.SetOptions(std::move(statisticsOptions));
+
+    // The VM size is chosen from the expected polygon count of the scene, the render mode is stepped down on
+    // reconnects when the link can't keep up.
+    ConnectionProfileSelector::Options profileOptions;
+    profileOptions.ExpectedPolygonCount = 0; // <set to the polygon count of the scene, so that large models get a Premium VM>
+    m_connectionProfileSelector = ConnectionProfileSelector(std::move(profileOptions));
+}
+
+// Opens or creates the rendering session.
+// Runs on the startup worker, and the ARR callbacks may arrive on other threads as well, so the status and the session are
+// handed to the main thread, which owns them.
+void HolographicAppMain::AcquireARRSession()
+{
+    auto SessionHandler = [this](RR::Status status, RR::ApiHandle<RR::CreateRenderingSessionResult> result)
+    {
+        PostToMainThread([this, status, result]()
+            {
+                if (status == RR::Status::OK)
+                {
+                    auto ctx = result->GetContext();
+                    if (ctx.Result == RR::Result::Success)
+                    {
+                        SetNewSession(result->GetSession());
+                    }
+                    else
+                    {
+                        SetNewState(AppConnectionStatus::ConnectionFailed, ctx.ErrorMessage.c_str());
+                    }
+                }
+                else
+                {
+                    SetNewState(AppConnectionStatus::ConnectionFailed, "failed");
+                }
+            });
+    };
+
+    PostToMainThread([this]()
+        {
+            SetNewState(AppConnectionStatus::CreatingSession, nullptr);
+        });
+
+    // If we had an old (valid) session that we can recycle, we call async function m_client->OpenRenderingSessionAsync
+    if (!m_sessionOverride.empty())
+    {
+        m_client->OpenRenderingSessionAsync(m_sessionOverride, SessionHandler);
+    }
+    else
+    {
+        // reuse a running session this app created if possible, otherwise create a new one
+        SessionPool::Options poolOptions;
+        poolOptions.LeaseInMinutes = 10; // session is leased for 10 minutes
+        poolOptions.Size = m_connectionProfileSelector.GetVmSize();
+        poolOptions.KeepWarmStandby = false; // set to true to keep a second (billed) session ready for reconnects
+        poolOptions.OwnedSessionIds = SessionPool::LoadOwnedSessionIds(); // sessions created by earlier launches
+        poolOptions.OwnedSessionIdsChanged = &SessionPool::StoreOwnedSessionIds;
+        m_sessionPool = std::make_unique<SessionPool>(m_client, poolOptions);
+        m_sessionPool->AcquireSessionAsync([this](RR::ApiHandle<RR::RenderingSession> session, const char* errorMessage)
+            {
+                PostToMainThread([this, session, errorMessage = std::string(errorMessage ? errorMessage : "")]()
+                    {
+                        if (session != nullptr)
+                        {
+                            SetNewSession(session);
+                        }
+                        else
+                        {
+                            SetNewState(AppConnectionStatus::ConnectionFailed, errorMessage.c_str());
+                        }
+                    });
+            });
+    }
+}
+
+// Queues work for the next Update on the main thread. Can be called from any thread.
+void HolographicAppMain::PostToMainThread(std::function<void()> work)
+{
+    std::scoped_lock lock(m_mainThreadWorkMutex);
+    m_mainThreadWork.push_back(std::move(work));
+}
+
+void HolographicAppMain::RunMainThreadWork()
+{
+    std::vector<std::function<void()>> work;
+    {
+        std::scoped_lock lock(m_mainThreadWorkMutex);
+        work.swap(m_mainThreadWork);
+    }
+    for (const std::function<void()>& item : work)
+    {
+        item();
+    }
+}
+#endif
+
 HolographicAppMain::~HolographicAppMain()
 {
+    m_simulation.Stop();
+
     // Deregister device notification.
     m_deviceResources->RegisterDeviceNotify(nullptr);
 
@@ -255,8 +363,17 @@ HolographicAppMain::~HolographicAppMain()
     HolographicSpace::IsAvailableChanged(m_holographicDisplayIsAvailableChangedEventToken);
 
 #ifdef USE_REMOTE_RENDERING
+    if (m_arrStartup.valid())
+    {
+        // The startup worker uses the members below.
+        m_arrStartup.wait();
+    }
+    m_sessionReadinessWatcher.Stop();
+    m_sessionPool = nullptr;
+    m_frameStatisticsMonitor.Reset(nullptr, nullptr);
     if (m_session != nullptr)
     {
+        m_reconnectPending = false;
         m_session->Disconnect();
         m_session = nullptr;
     }
@@ -270,78 +387,67 @@ HolographicAppMain::~HolographicAppMain()
 // Updates the application state once per frame.
 HolographicFrame HolographicAppMain::Update(HolographicFrame const& previousFrame)
 {
+    DX::FrameProfiler& frameProfiler = m_deviceResources->GetFrameProfiler();
+    frameProfiler.BeginStage(DX::FrameStage::Update);
+
+    // Before anything binds state for this frame, since trimming clears the state of the immediate context.
+    if (m_gpuMemoryGovernor.Update())
+    {
+#ifdef USE_REMOTE_RENDERING
+        // The remote frames are sized by ARR, so the status text is the local texture that can be made smaller.
+        if (m_statusDisplay != nullptr)
+        {
+            m_statusDisplay->SetTextTextureScale(m_gpuMemoryGovernor.GetLevel() == GpuMemoryGovernor::Level::Normal ? 1.0f : 0.5f);
+        }
+#endif
+    }
+
     // TODO: Put CPU work that does not depend on the HolographicCameraPose here.
 
 #ifdef USE_REMOTE_RENDERING
+    if (m_arrStartup.valid() && m_arrStartup.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        // The client and the session pool belong to the main thread from now on. Rethrows if the startup failed.
+        m_arrStartup.get();
+    }
+
+    RunMainThreadWork();
+
+    if (!m_arrStartup.valid() && m_sessionPool)
+    {
+        // Keep the leases of the pooled sessions alive
+        m_sessionPool->Update(m_timer.GetTotalSeconds());
+    }
+
     if (m_session != nullptr)
     {
         // Tick the client to receive messages
         m_api->Update();
 
-        if (!m_sessionStarted)
+        if (m_sessionReadinessWatcher.IsWatching())
         {
-            // Important: To avoid server-side throttling of the requests, we should call GetPropertiesAsync very infrequently:
-            const double delayBetweenRESTCalls = 10.0;
-
             m_needsStatusUpdate = true; // Info text should update more frequently
 
-            // query session status periodically until we reach 'session started'
-            if (!m_sessionPropertiesQueryInProgress && m_timer.GetTotalSeconds() - m_timeAtLastRESTCall > delayBetweenRESTCalls)
-            {
-                m_timeAtLastRESTCall = m_timer.GetTotalSeconds();
-                m_sessionPropertiesQueryInProgress = true;
-                m_session->GetPropertiesAsync([this](RR::Status status, RR::ApiHandle<RR::RenderingSessionPropertiesResult> propertiesResult)
-                    {
-                        if (status == RR::Status::OK)
-                        {
-                            auto ctx = propertiesResult->GetContext();
-                            if (ctx.Result == RR::Result::Success)
-                            {
-                                auto res = propertiesResult->GetSessionProperties();
-                                switch (res.Status)
-                                {
-                                case RR::RenderingSessionStatus::Ready:
-                                {
-                                    // The following ConnectAsync is async, but we'll get notifications via OnConnectionStatusChanged
-                                    m_sessionStarted = true;
-                                    SetNewState(AppConnectionStatus::Connecting, nullptr);
-                                    RR::RendererInitOptions init;
-                                    init.IgnoreCertificateValidation = false;
-                                    init.RenderMode = RR::ServiceRenderMode::Default;
-                                    m_session->ConnectAsync(init, [](RR::Status, RR::ConnectionStatus) {});
-                                }
-                                break;
-                                case RR::RenderingSessionStatus::Error:
-                                    SetNewState(AppConnectionStatus::ConnectionFailed, "Session error");
-                                    break;
-                                case RR::RenderingSessionStatus::Stopped:
-                                    SetNewState(AppConnectionStatus::ConnectionFailed, "Session stopped");
-                                    break;
-                                case RR::RenderingSessionStatus::Expired:
-                                    SetNewState(AppConnectionStatus::ConnectionFailed, "Session expired");
-                                    break;
-                                }
-                            }
-                            else
-                            {
-                                SetNewState(AppConnectionStatus::ConnectionFailed, ctx.ErrorMessage.c_str());
-                            }
-                        }
-                        else
-                        {
-                            SetNewState(AppConnectionStatus::ConnectionFailed, "Failed to retrieve session status");
-                        }
-                        m_sessionPropertiesQueryInProgress = false; // next try
-                    });
-            }
+            // Query the session status until it is ready, then connect right away.
+            m_sessionReadinessWatcher.Update(m_timer.GetTotalSeconds());
         }
 
-
         if (m_isConnected && !m_modelLoadTriggered)
         {
             m_modelLoadTriggered = true;
             StartModelLoading();
         }
+
+        if (m_frameStatisticsMonitor.Update(m_timer.GetTotalSeconds()))
+        {
+            m_needsStatusUpdate = true;
+        }
+
+        if (m_connectionProfileSelector.Update(m_timer.GetTotalSeconds()))
+        {
+            // The session stays, only the connection is re-established with the cheaper profile.
+            ReconnectToSession();
+        }
     }
 
     if (m_needsStatusUpdate)
@@ -364,33 +470,11 @@ HolographicFrame HolographicAppMain::Update(HolographicFrame const& previousFram
 
 #endif
 
-    // Apps should wait for the optimal time to begin pose-dependent work.
-    // The platform will automatically adjust the wakeup time to get
-    // the lowest possible latency at high frame rates. For manual
-    // control over latency, use the WaitForNextFrameReadyWithHeadStart 
-    // API.
-    // WaitForNextFrameReady and WaitForNextFrameReadyWithHeadStart are the
-    // preferred frame synchronization APIs for Windows Mixed Reality. When 
-    // running on older versions of the OS that do not include support for
-    // these APIs, your app can use the WaitForFrameToFinish API for similar 
-    // (but not as optimal) behavior.
-    if (m_canUseWaitForNextFrameReadyAPI)
-    {
-        try
-        {
-            m_holographicSpace.WaitForNextFrameReady();
-        }
-        catch (winrt::hresult_not_implemented const& /*ex*/)
-        {
-            // Catch a specific case where WaitForNextFrameReady() is present but not implemented
-            // and default back to WaitForFrameToFinish() in that case.
-            m_canUseWaitForNextFrameReadyAPI = false;
-        }
-    }
-    else if (previousFrame)
-    {
-        previousFrame.WaitForFrameToFinish();
-    }
+    // All work above does not depend on the camera pose. Wait as long as possible before
+    // starting the pose-dependent work, so that input and poses are as fresh as possible.
+    frameProfiler.EndStage(DX::FrameStage::Update);
+    WaitForNextFrame(previousFrame);
+    frameProfiler.BeginStage(DX::FrameStage::Update);
 
     // Before doing the timer update, there is some work to do per-frame
     // to maintain holographic rendering. First, we will get information
@@ -441,15 +525,46 @@ HolographicFrame HolographicAppMain::Update(HolographicFrame const& previousFram
     }
 #endif
 
+    SimulationInput simulationInput;
+#ifdef DRAW_SAMPLE_CONTENT
+    simulationInput.cubeRadiansPerSecond = m_spinningCubeRenderer->GetRadiansPerSecond();
+#endif
+
 #ifdef USE_REMOTE_RENDERING
     // Position the status text
-    if (m_statusDisplay != nullptr)
+    if (m_statusDisplay != nullptr && m_stationaryReferenceFrame != nullptr)
     {
-        if (m_stationaryReferenceFrame != nullptr)
+        SpatialPointerPose statusPose = SpatialPointerPose::TryGetAtTimestamp(m_stationaryReferenceFrame.CoordinateSystem(), prediction.Timestamp());
+        if (m_simulationMode == SimulationMode::StepTimer)
         {
-            SpatialPointerPose statusPose = SpatialPointerPose::TryGetAtTimestamp(m_stationaryReferenceFrame.CoordinateSystem(), prediction.Timestamp());
             m_statusDisplay->PositionDisplay(deltaTimeInSeconds, statusPose);
         }
+        else
+        {
+            simulationInput.statusPose = statusPose;
+        }
+    }
+#endif
+
+    if (m_simulationMode == SimulationMode::SimulationThread)
+    {
+        // The simulation runs ahead at its own rate, so a slow frame samples a later state instead of catching up.
+        m_simulation.SetInput(std::move(simulationInput));
+        const SimulationState state = m_simulation.Sample(prediction.Timestamp().TargetTime());
+#ifdef DRAW_SAMPLE_CONTENT
+        m_spinningCubeRenderer->Update(state.cubeRotationRadians);
+#endif
+#ifdef USE_REMOTE_RENDERING
+        if (m_statusDisplay != nullptr)
+        {
+            m_statusDisplay->SetPositions(state.statusPositions);
+        }
+#endif
+    }
+
+#ifdef USE_REMOTE_RENDERING
+    if (m_statusDisplay != nullptr)
+    {
         m_statusDisplay->Update(deltaTimeInSeconds);
     }
 #endif
@@ -465,7 +580,10 @@ HolographicFrame HolographicAppMain::Update(HolographicFrame const& previousFram
             //
 
 #ifdef DRAW_SAMPLE_CONTENT
-            m_spinningCubeRenderer->Update(m_timer);
+            if (m_simulationMode == SimulationMode::StepTimer)
+            {
+                m_spinningCubeRenderer->Update(m_timer);
+            }
 #endif
         });
 
@@ -523,6 +641,8 @@ HolographicFrame HolographicAppMain::Update(HolographicFrame const& previousFram
     }
 #endif
 
+    frameProfiler.EndStage(DX::FrameStage::Update);
+
     // The holographic frame will be used to get up-to-date view and projection matrices and
     // to present the swap chain.
     return holographicFrame;
@@ -532,30 +652,58 @@ HolographicFrame HolographicAppMain::Update(HolographicFrame const& previousFram
 
 void HolographicApp::HolographicAppMain::StartModelLoading()
 {
-    m_modelLoadingProgress = 0.f;
-
-    RR::LoadModelFromSasOptions params;
-    params.ModelUri = m_modelURI.c_str();
-    params.Parent = nullptr;
-
-    // start the async model loading
-    m_api->LoadModelFromSasAsync(params,
-        // completed callback
-        [this](RR::Status status, RR::ApiHandle<RR::LoadModelResult> result)
+    m_modelLoadQueue.Reset(m_api, [this]()
         {
-            m_modelLoadResult = RR::StatusToResult(status);
-            m_modelLoadFinished = true; // successful if m_modelLoadResult==RR::Result::Success
+            m_needsStatusUpdate = true;
         },
-        // progress update callback
-            [this](float progress)
+        [](const ModelLoadQueue::ModelLoad& load, bool coarse)
         {
-            // progress callback
-            m_modelLoadingProgress = progress;
-            m_needsStatusUpdate = true;
+            // <parts can be placed or made interactive here, before the rest of the scene has loaded>
+            OutputDebugStringA(("Model " + load.Request.ModelUri + (coarse ? " is shown at coarse detail\n" : " is shown\n")).c_str());
         });
+    for (size_t i = 0; i < m_modelURIs.size(); i++)
+    {
+        ModelLoadQueue::ModelRequest request;
+        request.ModelUri = m_modelURIs[i];
+        if (i < m_coarseModelURIs.size())
+        {
+            request.CoarseModelUri = m_coarseModelURIs[i];
+        }
+        m_modelLoadQueue.Enqueue(std::move(request));
+    }
 }
 
 
+// Captures the current connection and loading state in the form shown by the status display.
+AppStatus HolographicApp::HolographicAppMain::GetAppStatus() const
+{
+    AppStatus status;
+    status.ConnectionStatus = m_currentStatus;
+    status.ModelLoadTriggered = m_modelLoadTriggered;
+    status.ModelLoadFinished = m_modelLoadTriggered && m_modelLoadQueue.IsFinished();
+    if (m_currentStatus == AppConnectionStatus::ConnectionFailed)
+    {
+        status.ErrorMessage = m_statusMsg;
+    }
+    if (m_currentStatus == AppConnectionStatus::StartingSession)
+    {
+        status.SessionStartingSeconds = (int)(m_timer.GetTotalSeconds() - m_sessionStartingTime);
+    }
+    if (m_modelLoadTriggered)
+    {
+        status.ModelLoadResult = status.ModelLoadFinished ? m_modelLoadQueue.GetResult() : RR::Result::Success;
+        status.ModelLoadPercentage = AppStatus::QuantizeModelLoadProgress(m_modelLoadQueue.GetProgress());
+        status.ModelCount = static_cast<int>(m_modelLoadQueue.GetModelLoads().size());
+        status.ModelsLoaded = static_cast<int>(m_modelLoadQueue.GetFinishedCount());
+        status.ModelsVisible = static_cast<int>(m_modelLoadQueue.GetVisibleCount());
+    }
+    if (m_isConnected && m_frameStatisticsMonitor.GetOptions().ShowHud)
+    {
+        status.FrameStatistics = m_frameStatisticsMonitor.GetSummary();
+    }
+    return status;
+}
+
 void HolographicApp::HolographicAppMain::UpdateStatusText()
 {
     if (m_statusDisplay == nullptr)
@@ -563,69 +711,127 @@ void HolographicApp::HolographicAppMain::UpdateStatusText()
         return;
     }
 
+    // Only produce new text when something visible changed.
+    AppStatus status = GetAppStatus();
+    if (m_displayedStatus.has_value() && m_displayedStatus.value() == status)
+    {
+        return;
+    }
+
     m_statusDisplay->SetImageEnabled(false);
-    m_statusDisplay->ClearLines();
-    if (m_modelLoadFinished && m_modelLoadResult == RR::Result::Success)
+
+    wchar_t txtBuffer[1024];
+    std::array<StatusDisplay::Line, 6> lines;
+    size_t lineCount = 0;
+    auto AddLine = [&](std::wstring text, StatusDisplay::TextFormat format, StatusDisplay::TextColor color)
     {
-        // nothing to show anymore
-        m_statusDisplay->SetTextEnabled(false);
+        lines[lineCount++] = StatusDisplay::Line{ std::move(text), format, color, 1.2f };
+    };
+
+    // The performance HUD, shown below the status or on its own once the model is loaded.
+    auto AddFrameStatisticsLines = [&](const FrameStatisticsSummary& statistics)
+    {
+        swprintf_s(txtBuffer, L"Remote frames/s: %i received, %i reused, %i skipped, %i discarded",
+            statistics.FramesReceived, statistics.FramesReused, statistics.FramesSkipped, statistics.FramesDiscarded);
+        AddLine(txtBuffer, StatusDisplay::Small, statistics.FramesReused > statistics.FramesReceived ? StatusDisplay::Yellow : StatusDisplay::White);
+
+        swprintf_s(txtBuffer, L"Latency: %i ms pose to receive, %i ms receive to present, %i ms jitter",
+            statistics.LatencyPoseToReceive, statistics.LatencyReceiveToPresent, statistics.FrameJitter);
+        AddLine(txtBuffer, StatusDisplay::Small, StatusDisplay::White);
+
+        if (statistics.HasAssessment)
+        {
+            swprintf_s(txtBuffer, L"Server: %.1f ms CPU, %.1f ms GPU, network %i ms",
+                statistics.ServerTimeCPU * FrameStatisticsSummary::ServerFrameTimeStepInMilliseconds,
+                statistics.ServerTimeGPU * FrameStatisticsSummary::ServerFrameTimeStepInMilliseconds,
+                statistics.NetworkLatency);
+            const StatusDisplay::TextColor color = statistics.Rating == RR::PerformanceRating::Bad ? StatusDisplay::Red
+                : statistics.Rating == RR::PerformanceRating::Good ? StatusDisplay::Yellow : StatusDisplay::Green;
+            AddLine(txtBuffer, StatusDisplay::Small, color);
+        }
+    };
+
+    if (status.ModelLoadFinished && status.ModelLoadResult == RR::Result::Success)
+    {
+        if (!status.FrameStatistics.has_value())
+        {
+            // nothing to show anymore
+            m_statusDisplay->ClearLines();
+            m_statusDisplay->SetTextEnabled(false);
+            m_displayedStatus = std::move(status);
+            return;
+        }
+
+        m_statusDisplay->SetTextEnabled(true);
+        AddFrameStatisticsLines(status.FrameStatistics.value());
+        m_statusDisplay->SetLines(winrt::array_view<StatusDisplay::Line>(lines.data(), lines.data() + lineCount));
+        m_displayedStatus = std::move(status);
         return;
     }
 
     m_statusDisplay->SetTextEnabled(true);
 
-    char txtBuffer[1024];
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t> toWChar;
-
-    switch (m_currentStatus)
+    switch (status.ConnectionStatus)
     {
     case AppConnectionStatus::CreatingSession:
-        sprintf(txtBuffer, "Creating session...");
-        m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::White, 1.2f });
+        AddLine(L"Creating session...", StatusDisplay::LargeBold, StatusDisplay::White);
         break;
     case AppConnectionStatus::StartingSession:
-    {
-        sprintf(txtBuffer, "Starting session...");
-        m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::White, 1.2f });
-        int elapsedSecs = (int)(m_timer.GetTotalSeconds() - m_sessionStartingTime);
-        sprintf(txtBuffer, "...this may take a while. Elapsed time: %ds", elapsedSecs);
-        m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::Small, StatusDisplay::White, 1.2f });
+        AddLine(L"Starting session...", StatusDisplay::LargeBold, StatusDisplay::White);
+        swprintf_s(txtBuffer, L"...this may take a while. Elapsed time: %ds", status.SessionStartingSeconds);
+        AddLine(txtBuffer, StatusDisplay::Small, StatusDisplay::White);
         break;
-    }
     case AppConnectionStatus::Connecting:
-        sprintf(txtBuffer, "Connecting...");
-        m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::White, 1.2f });
+        AddLine(L"Connecting...", StatusDisplay::LargeBold, StatusDisplay::White);
         break;
     case AppConnectionStatus::Connected:
-        sprintf(txtBuffer, "Connected");
-        m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::Green, 1.2f });
+        AddLine(L"Connected", StatusDisplay::LargeBold, StatusDisplay::Green);
         break;
     case AppConnectionStatus::ConnectionFailed:
-        sprintf(txtBuffer, "Failed to connect");
-        m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::Red, 1.2f });
-        sprintf(txtBuffer, "Error: %s", m_statusMsg.c_str());
-        m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::Red, 1.2f });
+    {
+        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t> toWChar;
+        AddLine(L"Failed to connect", StatusDisplay::LargeBold, StatusDisplay::Red);
+        AddLine(L"Error: " + toWChar.from_bytes(status.ErrorMessage), StatusDisplay::LargeBold, StatusDisplay::Red);
         break;
+    }
     case AppConnectionStatus::Disconnected:
-        m_statusDisplay->AddLine(StatusDisplay::Line{ L"Disconnected", StatusDisplay::LargeBold, StatusDisplay::Yellow, 1.2f });
+        AddLine(L"Disconnected", StatusDisplay::LargeBold, StatusDisplay::Yellow);
         break;
     }
 
     // add additional lines for model loading progress
-    if (m_modelLoadTriggered)
+    if (status.ModelLoadTriggered)
     {
-        if (m_modelLoadFinished && m_modelLoadResult != RR::Result::Success)
+        if (status.ModelLoadFinished && status.ModelLoadResult != RR::Result::Success)
         {
-            sprintf(txtBuffer, "Failed to load model: %s", RR::ResultToString(m_modelLoadResult));
-            m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::Red, 1.2f });
+            swprintf_s(txtBuffer, L"Failed to load model: %hs", RR::ResultToString(status.ModelLoadResult));
+            AddLine(txtBuffer, StatusDisplay::LargeBold, StatusDisplay::Red);
+        }
+        else if (status.ModelCount > 1)
+        {
+            swprintf_s(txtBuffer, L"Loading models %i/%i (%i%%)", status.ModelsLoaded, status.ModelCount, status.ModelLoadPercentage);
+            AddLine(txtBuffer, StatusDisplay::LargeBold, StatusDisplay::White);
+            if (status.ModelsVisible > status.ModelsLoaded)
+            {
+                swprintf_s(txtBuffer, L"%i/%i shown at coarse detail", status.ModelsVisible - status.ModelsLoaded, status.ModelCount);
+                AddLine(txtBuffer, StatusDisplay::Small, StatusDisplay::White);
+            }
         }
         else
         {
-            int percentage = (int)(m_modelLoadingProgress * 100.0f);
-            sprintf(txtBuffer, "Loading model (%i%%)", percentage);
-            m_statusDisplay->AddLine(StatusDisplay::Line{ toWChar.from_bytes(txtBuffer), StatusDisplay::LargeBold, StatusDisplay::White, 1.2f });
+            swprintf_s(txtBuffer, status.ModelsVisible > status.ModelsLoaded ? L"Refining model (%i%%)" : L"Loading model (%i%%)", status.ModelLoadPercentage);
+            AddLine(txtBuffer, StatusDisplay::LargeBold, StatusDisplay::White);
         }
     }
+
+    if (status.FrameStatistics.has_value())
+    {
+        AddFrameStatisticsLines(status.FrameStatistics.value());
+    }
+
+    // SetLines keeps the text layouts of lines whose text didn't change.
+    m_statusDisplay->SetLines(winrt::array_view<StatusDisplay::Line>(lines.data(), lines.data() + lineCount));
+    m_displayedStatus = std::move(status);
 }
 
 void HolographicApp::HolographicAppMain::SetNewState(AppConnectionStatus state, const char* statusMsg)
@@ -639,7 +845,7 @@ void HolographicAppMain::SetNewSession(RR::ApiHandle<RR::RenderingSession> newSe
 {
     SetNewState(AppConnectionStatus::StartingSession, nullptr);
 
-    m_sessionStartingTime = m_timeAtLastRESTCall = m_timer.GetTotalSeconds();
+    m_sessionStartingTime = m_timer.GetTotalSeconds();
     m_session = newSession;
     m_api = m_session->Connection();
     m_graphicsBinding = m_session->GetGraphicsBinding().as<RR::GraphicsBindingWmrD3d11>();
@@ -648,8 +854,42 @@ void HolographicAppMain::SetNewSession(RR::ApiHandle<RR::RenderingSession> newSe
             OnConnectionStatusChanged(status, error);
         });
 
+    m_sessionReadinessWatcher.Start(m_session, m_sessionStartingTime,
+        [this]()
+        {
+            ConnectToSession();
+        },
+        [this](const char* reason)
+        {
+            SetNewState(AppConnectionStatus::ConnectionFailed, reason);
+        });
+
 };
 
+void HolographicAppMain::ConnectToSession()
+{
+    // The following ConnectAsync is async, but we'll get notifications via OnConnectionStatusChanged
+    SetNewState(AppConnectionStatus::Connecting, nullptr);
+
+    // Fetch the binding again, so that a reconnect after a device loss doesn't keep the one of the old connection.
+    m_graphicsBinding = m_session->GetGraphicsBinding().as<RR::GraphicsBindingWmrD3d11>();
+    m_needsCoordinateSystemUpdate = true;
+
+    RR::RendererInitOptions init;
+    init.IgnoreCertificateValidation = false;
+    m_connectionProfileSelector.ApplyProfile(init);
+    m_session->ConnectAsync(init, [](RR::Status, RR::ConnectionStatus) {});
+}
+
+// Disconnects and connects again once the Disconnected event arrived, so that the events of the old connection
+// can't be mistaken for the new one. The rendering session keeps running.
+void HolographicAppMain::ReconnectToSession()
+{
+    m_reconnectPending = true;
+    SetNewState(AppConnectionStatus::Connecting, nullptr);
+    m_session->Disconnect();
+}
+
 #endif
 
 // Renders the current frame to each holographic camera, according to the
@@ -671,21 +911,34 @@ bool HolographicAppMain::Render(HolographicFrame const& holographicFrame)
     // matrix, such as lighting maps.
     //
 
-    // Lock the set of holographic camera resources, then draw to each camera
+    const DX::FrameProfiler::ScopedStage renderStage(m_deviceResources->GetFrameProfiler(), DX::FrameStage::Render);
+
+    // All shader constants of this frame are allocated from the constant buffer ring after this.
+    m_deviceResources->GetConstantBufferRing().BeginFrame();
+
+    // Access the set of holographic camera resources, then draw to each camera
     // in this frame.
-    return m_deviceResources->UseHolographicCameraResources<bool>(
-        [this, holographicFrame](std::map<UINT32, std::unique_ptr<DX::CameraResources>>& cameraResourceMap)
+    const bool rendered = m_deviceResources->UseHolographicCameraResources<bool>(
+        [this, holographicFrame](DX::CameraResourceTable const& cameraResources)
         {
             // Up-to-date frame predictions enhance the effectiveness of image stablization and
             // allow more accurate positioning of holograms.
+            // This is the last update before the remote frame is blitted and the depth buffer is committed, so nothing
+            // that doesn't depend on the poses should happen between here and Present. Updating the prediction again
+            // per camera would render the cameras of one frame with inconsistent poses.
             holographicFrame.UpdateCurrentPrediction();
             HolographicFramePrediction prediction = holographicFrame.CurrentPrediction();
+            m_framePacingStats.OnPoseLatched(prediction);
 
             bool atLeastOneCameraRendered = false;
             for (HolographicCameraPose const& cameraPose : prediction.CameraPoses())
             {
                 // This represents the device-based resources for a HolographicCamera.
-                DX::CameraResources* pCameraResources = cameraResourceMap[cameraPose.HolographicCamera().Id()].get();
+                DX::CameraResources* pCameraResources = cameraResources.Find(cameraPose.HolographicCamera().Id());
+                if (pCameraResources == nullptr)
+                {
+                    continue;
+                }
 
                 // Get the device context.
                 const auto context = m_deviceResources->GetD3DDeviceContext();
@@ -743,15 +996,17 @@ bool HolographicAppMain::Render(HolographicFrame const& holographicFrame)
                     // We do the blitting after the Clear and viewport setup, and before our rendering.
                     if (m_isConnected)
                     {
+                        const DX::FrameProfiler::ScopedStage blitStage(m_deviceResources->GetFrameProfiler(), DX::FrameStage::BlitRemoteFrame);
                         m_graphicsBinding->BlitRemoteFrame();
                     }
 
                     // Show a status text during connection, while loading or when an error occurred
-                    if (!m_isConnected || !m_modelLoadFinished || m_modelLoadResult != RR::Result::Success)
+                    if (!m_isConnected || !m_modelLoadTriggered || !m_modelLoadQueue.IsFinished() || m_modelLoadQueue.GetResult() != RR::Result::Success)
                     {
                         if (m_statusDisplay != nullptr)
                         {
                             // Draw connection/progress/error status
+                            const DX::FrameProfiler::ScopedStage statusStage(m_deviceResources->GetFrameProfiler(), DX::FrameStage::StatusDisplay);
                             m_statusDisplay->Render();
                         }
                     }
@@ -785,6 +1040,80 @@ bool HolographicAppMain::Render(HolographicFrame const& holographicFrame)
 
             return atLeastOneCameraRendered;
         });
+
+    if (rendered)
+    {
+        m_framePacingStats.OnFrameSubmitted();
+    }
+    return rendered;
+}
+
+void HolographicAppMain::WaitForNextFrame(HolographicFrame const& previousFrame)
+{
+    // Apps should wait for the optimal time to begin pose-dependent work.
+    // The platform will automatically adjust the wakeup time to get
+    // the lowest possible latency at high frame rates. For manual
+    // control over latency, use the WaitForNextFrameReadyWithHeadStart 
+    // API.
+    // WaitForNextFrameReady and WaitForNextFrameReadyWithHeadStart are the
+    // preferred frame synchronization APIs for Windows Mixed Reality. When 
+    // running on older versions of the OS that do not include support for
+    // these APIs, your app can use the WaitForFrameToFinish API for similar 
+    // (but not as optimal) behavior.
+    const DX::FrameProfiler::ScopedStage waitStage(m_deviceResources->GetFrameProfiler(), DX::FrameStage::WaitForFrame);
+    m_framePacingStats.OnWaitStarted();
+    try
+    {
+        switch (m_framePacingMode)
+        {
+        case FramePacingMode::WaitForNextFrameReadyWithHeadStart:
+            m_holographicSpace.WaitForNextFrameReadyWithHeadStart(m_frameHeadStart);
+            break;
+        case FramePacingMode::WaitForNextFrameReady:
+            m_holographicSpace.WaitForNextFrameReady();
+            break;
+        case FramePacingMode::WaitForFrameToFinish:
+            if (previousFrame)
+            {
+                previousFrame.WaitForFrameToFinish();
+            }
+            break;
+        }
+    }
+    catch (winrt::hresult_not_implemented const& /*ex*/)
+    {
+        // Catch a specific case where WaitForNextFrameReady() is present but not implemented
+        // and default back to WaitForFrameToFinish() in that case.
+        m_canUseWaitForNextFrameReadyAPI = false;
+        m_canUseWaitForNextFrameReadyWithHeadStartAPI = false;
+        m_framePacingMode = FramePacingMode::WaitForFrameToFinish;
+        m_framePacingStats.SetMode(m_framePacingMode);
+        if (previousFrame)
+        {
+            previousFrame.WaitForFrameToFinish();
+        }
+    }
+    m_framePacingStats.OnWaitFinished();
+}
+
+void HolographicAppMain::StepSimulation(SimulationState& state, const SimulationInput& input, float stepSeconds)
+{
+    state.cubeRotationRadians = fmodf(state.cubeRotationRadians + input.cubeRadiansPerSecond * stepSeconds, DirectX::XM_2PI);
+    state.statusPositions = StatusDisplay::FollowGaze(state.statusPositions, stepSeconds, input.statusPose);
+}
+
+HolographicAppMain::SimulationState HolographicAppMain::InterpolateSimulation(
+    const SimulationState& from, const SimulationState& to, float amount)
+{
+    // The rotation wraps around at 2 pi, so interpolate along the shortest signed angle between the two states. This works for
+    // either direction of rotation, as long as one step turns the cube by less than half a revolution.
+    const float deltaRadians = remainderf(to.cubeRotationRadians - from.cubeRotationRadians, DirectX::XM_2PI);
+
+    SimulationState state;
+    state.cubeRotationRadians = fmodf(from.cubeRotationRadians + deltaRadians * amount, DirectX::XM_2PI);
+    state.statusPositions.image = lerp(from.statusPositions.image, to.statusPositions.image, amount);
+    state.statusPositions.text = lerp(from.statusPositions.text, to.statusPositions.text, amount);
+    return state;
 }
 
 void HolographicAppMain::SaveAppState()
@@ -814,6 +1143,8 @@ void HolographicAppMain::OnPointerPressed()
 
 // Notifies classes that use Direct3D device resources that the device resources
 // need to be released before this method returns.
+// The rendering session doesn't depend on the local device, so it is kept, since starting
+// a new one would take minutes. OnDeviceRestored only re-establishes the connection.
 void HolographicAppMain::OnDeviceLost()
 {
 #ifdef DRAW_SAMPLE_CONTENT
@@ -830,6 +1161,8 @@ void HolographicAppMain::OnDeviceLost()
 
 // Notifies classes that use Direct3D device resources that the device resources
 // may now be recreated.
+// Both renderers create their resources on background tasks, so they are rebuilt in
+// parallel and each draws again as soon as its own resources are loaded.
 void HolographicAppMain::OnDeviceRestored()
 {
 #ifdef DRAW_SAMPLE_CONTENT
@@ -841,6 +1174,15 @@ void HolographicAppMain::OnDeviceRestored()
     {
         m_statusDisplay->CreateDeviceDependentResources();
     }
+
+    if (m_session != nullptr && (m_isConnected || m_currentStatus == AppConnectionStatus::Connecting))
+    {
+        // The graphics binding was set up for the lost device, and ARR has no call that moves it
+        // to the new one. So the connection is re-established instead. The rendering session keeps
+        // running, so this takes seconds instead of the minutes a new session would take, but the
+        // models are loaded again.
+        ReconnectToSession();
+    }
 #endif
 }
 
@@ -923,7 +1265,7 @@ void HolographicAppMain::OnCameraRemoved(
     // Before letting this callback return, ensure that all references to the back buffer 
     // are released.
     // Since this function may be called at any time, the RemoveHolographicCamera function
-    // waits until it can get a lock on the set of holographic camera resources before
+    // waits until the render thread is done with the holographic camera resources before
     // deallocating resources for this camera. At 60 frames per second this wait should
     // not take long.
     m_deviceResources->RemoveHolographicCamera(args.Camera());
@@ -11,8 +11,11 @@
 #define DRAW_SAMPLE_CONTENT
 
 #include "Common/DeviceResources.h"
+#include "Common/SimulationThread.h"
 #include "Common/StepTimer.h"
 #include "Content/StatusDisplay.h"
+#include "FramePacing.h"
+#include "GpuMemoryGovernor.h"
 
 #ifdef DRAW_SAMPLE_CONTENT
 #include "Content/SpinningCubeRenderer.h"
@@ -24,12 +27,28 @@
 #undef max
 #include <AzureRemoteRendering.h>
 namespace RR = Microsoft::Azure::RemoteRendering;
+#include "ConnectionProfileSelector.h"
+#include "FrameStatisticsMonitor.h"
+#include "ModelLoadQueue.h"
+#include "RegionProbe.h"
+#include "SessionPool.h"
+#include "SessionReadinessWatcher.h"
 #endif
 
 
 // Updates, renders, and presents holographic content using Direct3D.
 namespace HolographicApp
 {
+    // How the time-based updates of the content are scheduled.
+    enum class SimulationMode
+    {
+        // Update the content in m_timer.Tick, once per frame, or as many times as needed in fixed timestep mode.
+        StepTimer,
+
+        // Update the content at a fixed rate on a thread of its own and sample it at the predicted display time of each frame.
+        SimulationThread,
+    };
+
     // Our application's possible states:
     enum class AppConnectionStatus
     {
@@ -44,6 +63,47 @@ namespace HolographicApp
         ConnectionFailed,
     };
 
+#ifdef USE_REMOTE_RENDERING
+    // Everything the status display shows. The status text is only rebuilt when one of these fields changes.
+    struct AppStatus
+    {
+        // Model loading progress is shown in whole percent, so that small progress updates don't rebuild the text.
+        static constexpr int ModelLoadPercentageStep = 1;
+
+        AppConnectionStatus ConnectionStatus = AppConnectionStatus::Disconnected;
+        std::string ErrorMessage;
+        int SessionStartingSeconds = 0;
+        bool ModelLoadTriggered = false;
+        bool ModelLoadFinished = false;
+        RR::Result ModelLoadResult = RR::Result::Success;
+        int ModelLoadPercentage = 0;
+        int ModelCount = 0;
+        int ModelsLoaded = 0;
+        int ModelsVisible = 0; // Models of which the coarse or the full version is shown.
+        std::optional<FrameStatisticsSummary> FrameStatistics; // Only set while the performance HUD is shown.
+
+        static int QuantizeModelLoadProgress(float progress)
+        {
+            const int percentage = static_cast<int>(progress * 100.0f);
+            return percentage - percentage % ModelLoadPercentageStep;
+        }
+
+        bool operator==(const AppStatus& other) const
+        {
+            return ConnectionStatus == other.ConnectionStatus && ErrorMessage == other.ErrorMessage &&
+                SessionStartingSeconds == other.SessionStartingSeconds && ModelLoadTriggered == other.ModelLoadTriggered &&
+                ModelLoadFinished == other.ModelLoadFinished && ModelLoadResult == other.ModelLoadResult &&
+                ModelLoadPercentage == other.ModelLoadPercentage && ModelCount == other.ModelCount && ModelsLoaded == other.ModelsLoaded &&
+                ModelsVisible == other.ModelsVisible && FrameStatistics == other.FrameStatistics;
+        }
+
+        bool operator!=(const AppStatus& other) const
+        {
+            return !(*this == other);
+        }
+    };
+#endif
+
     class HolographicAppMain : public DX::IDeviceNotify
     {
     public:
@@ -72,10 +132,17 @@ namespace HolographicApp
         void OnDeviceRestored() override;
 
     #ifdef USE_REMOTE_RENDERING
+        void CreateARRClient(const std::string& region);
+        void AcquireARRSession();
+        void PostToMainThread(std::function<void()> work);
+        void RunMainThreadWork();
         void OnConnectionStatusChanged(RR::ConnectionStatus status, RR::Result error);
         void SetNewState(AppConnectionStatus state, const char* statusMsg);
         void SetNewSession(RR::ApiHandle<RR::RenderingSession> newSession);
+        void ConnectToSession();
+        void ReconnectToSession();
         void StartModelLoading();
+        AppStatus GetAppStatus() const;
         void UpdateStatusText();
     #endif
 
@@ -105,6 +172,26 @@ namespace HolographicApp
         // Used to respond to changes to the default spatial locator.
         void OnHolographicDisplayIsAvailableChanged(winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
 
+        // Blocks until it is time to start the next frame, as configured by m_framePacingMode.
+        void WaitForNextFrame(winrt::Windows::Graphics::Holographic::HolographicFrame const& previousFrame);
+
+        // The content state simulated by m_simulation, and the input the render thread simulates it with.
+        struct SimulationState
+        {
+            float cubeRotationRadians = 0.f;
+            StatusDisplay::DisplayPositions statusPositions;
+        };
+
+        struct SimulationInput
+        {
+            float cubeRadiansPerSecond = 0.f;
+            winrt::Windows::UI::Input::Spatial::SpatialPointerPose statusPose = nullptr;
+        };
+
+        // Run on the simulation thread, so they only use their arguments.
+        static void StepSimulation(SimulationState& state, const SimulationInput& input, float stepSeconds);
+        static SimulationState InterpolateSimulation(const SimulationState& from, const SimulationState& to, float amount);
+
         // Clears event registration state. Used when changing to a new HolographicSpace
         // and when tearing down AppMain.
         void UnregisterHolographicEventHandlers();
@@ -121,9 +208,17 @@ namespace HolographicApp
         // Cached pointer to device resources.
         std::shared_ptr<DX::DeviceResources>                        m_deviceResources;
 
+        // Trims the device and shrinks the status text texture when the video memory budget runs out.
+        GpuMemoryGovernor                                           m_gpuMemoryGovernor;
+
         // Render loop timer.
         DX::StepTimer                                               m_timer;
 
+        // Scheduling of the time-based content updates. With the simulation thread, m_timer only counts the frames.
+        // Set to SimulationMode::SimulationThread to opt in to the fixed rate updates on a thread of their own.
+        SimulationMode                                              m_simulationMode = SimulationMode::StepTimer;
+        DX::SimulationThread<SimulationState, SimulationInput>      m_simulation{ {}, &StepSimulation, &InterpolateSimulation };
+
         // Represents the holographic space around the user.
         winrt::Windows::Graphics::Holographic::HolographicSpace     m_holographicSpace = nullptr;
 
@@ -163,36 +258,53 @@ namespace HolographicApp
         // Cache whether or not the HolographicFrame.WaitForNextFrameReady() method can be called.
         bool                                                        m_canUseWaitForNextFrameReadyAPI = false;
 
+        // Cache whether or not the HolographicSpace.WaitForNextFrameReadyWithHeadStart() method can be called.
+        bool                                                        m_canUseWaitForNextFrameReadyWithHeadStartAPI = false;
+
+        // Frame pacing. The mode falls back to the best one the OS supports.
+        FramePacingMode                                             m_framePacingMode = FramePacingMode::WaitForNextFrameReady;
+        winrt::Windows::Foundation::TimeSpan                        m_frameHeadStart = std::chrono::milliseconds(2);
+        FramePacingStats                                            m_framePacingStats;
+
 #ifdef USE_REMOTE_RENDERING
         // Session related:
+        std::future<void> m_arrStartup; // Creates the client and acquires the session on a worker thread.
+        std::mutex m_mainThreadWorkMutex;
+        std::vector<std::function<void()>> m_mainThreadWork; // Posted by the startup worker and the ARR callbacks.
         std::string m_sessionOverride;
         RR::ApiHandle<RR::RemoteRenderingClient> m_client;
         RR::ApiHandle<RR::RenderingSession> m_session;
         RR::ApiHandle<RR::RenderingConnection> m_api;
         RR::ApiHandle<RR::GraphicsBindingWmrD3d11> m_graphicsBinding;
+        SessionReadinessWatcher m_sessionReadinessWatcher;
+        std::unique_ptr<SessionPool> m_sessionPool;
 
         // Model loading:
-        std::string m_modelURI;
+        std::vector<std::string> m_modelURIs;
+        std::vector<std::string> m_coarseModelURIs; // Optional low detail versions of m_modelURIs, in the same order.
+        ModelLoadQueue m_modelLoadQueue;
 
         // Connection state machine:
         AppConnectionStatus m_currentStatus = AppConnectionStatus::Disconnected;
         std::string m_statusMsg;
         RR::Result m_connectionResult = RR::Result::Success;
-        RR::Result m_modelLoadResult = RR::Result::Success;
         bool m_isConnected = false;
-        bool m_sessionStarted = false;
+        bool m_reconnectPending = false; // Connect again as soon as the current connection reports Disconnected.
         bool m_modelLoadTriggered = false;
-        bool m_sessionPropertiesQueryInProgress = false;
-        float m_modelLoadingProgress = 0.f;
-        bool m_modelLoadFinished = false;
         bool m_needsStatusUpdate = true;
         bool m_needsCoordinateSystemUpdate = true;
-        double m_timeAtLastRESTCall = 0;
 
         // Status text:
         double m_lastTime = -1;
         double m_sessionStartingTime = 0.0;
         std::unique_ptr<StatusDisplay> m_statusDisplay;
+        std::optional<AppStatus> m_displayedStatus;
+
+        // Performance HUD and CSV log of the remote frame statistics:
+        FrameStatisticsMonitor m_frameStatisticsMonitor;
+
+        // Render mode and VM size, downgraded when the remote frames degrade:
+        ConnectionProfileSelector m_connectionProfileSelector;
 
 #endif
 
@@ -0,0 +1,84 @@
+#pragma once
+
+#ifdef USE_REMOTE_RENDERING
+#include <functional>
+
+namespace HolographicApp
+{
+    // Loads the parts of a scene with a bounded number of LoadModelFromSasAsync calls in flight, by priority and then nearest
+    // first. The coarse versions of all models are loaded first and each is shown until its full model has loaded.
+    class ModelLoadQueue
+    {
+    public:
+        struct ModelRequest
+        {
+            std::string ModelUri;
+            std::string CoarseModelUri; // Optional, shown until ModelUri has loaded.
+            int Priority = 0; // Higher priorities are loaded first.
+            RR::Double3 Position{ 0.0, 0.0, 0.0 };
+            RR::ApiHandle<RR::Entity> Parent;
+        };
+
+        struct ModelLoad
+        {
+            ModelRequest Request;
+            bool Started = false;
+            bool Finished = false;
+            float Progress = 0.f;
+            RR::Result Result = RR::Result::Success;
+            RR::ApiHandle<RR::Entity> Root;
+            bool CoarseStarted = false;
+            bool CoarseFinished = false;
+            RR::ApiHandle<RR::Entity> CoarseRoot; // Only set while the coarse version is shown.
+        };
+
+        // Invoked whenever the progress or the result of any model changes.
+        using ChangedCallback = std::function<void()>;
+
+        // Invoked when the coarse or the full version of a model has loaded and is positioned, so that the application can
+        // place or interact with the part before the rest of the scene has loaded.
+        using LoadedCallback = std::function<void(const ModelLoad& load, bool coarse)>;
+
+        explicit ModelLoadQueue(uint32_t maxConcurrentLoads = 4);
+
+        // Drops all models and in-flight results, and loads subsequently queued models through the given connection.
+        void Reset(RR::ApiHandle<RR::RenderingConnection> connection, ChangedCallback onChanged = nullptr, LoadedCallback onLoaded = nullptr);
+
+        // Queues a model and starts loading it right away if there is a free slot.
+        void Enqueue(ModelRequest request);
+
+        // Used to order pending models that have the same priority.
+        void SetViewerPosition(const RR::Double3& position)         { m_viewerPosition = position;                             }
+
+        const std::vector<ModelLoad>& GetModelLoads() const         { return m_models;                                         }
+        size_t GetFinishedCount() const                             { return m_finishedCount;                                  }
+        bool IsFinished() const                                     { return m_finishedCount == m_models.size();               }
+
+        // Number of models of which the coarse or the full version is shown.
+        size_t GetVisibleCount() const                              { return m_visibleCount;                                   }
+
+        // Progress of all queued models combined, in [0, 1].
+        float GetProgress() const;
+
+        // The result of the first model that failed to load, or Success.
+        RR::Result GetResult() const;
+
+    private:
+        void StartPendingLoads();
+        size_t SelectNextPending(bool coarse) const;
+        void StartLoad(size_t index, bool coarse);
+        void OnLoadCompleted(size_t index, bool coarse, RR::Status status, RR::ApiHandle<RR::LoadModelResult> result);
+
+        RR::ApiHandle<RR::RenderingConnection>                      m_connection;
+        ChangedCallback                                             m_onChanged;
+        LoadedCallback                                              m_onLoaded;
+        uint32_t                                                    m_maxConcurrentLoads;
+        uint32_t                                                    m_loadsInFlight = 0;
+        size_t                                                      m_finishedCount = 0;
+        size_t                                                      m_visibleCount = 0;
+        std::vector<ModelLoad>                                      m_models;
+        RR::Double3                                                 m_viewerPosition{ 0.0, 0.0, 0.0 };
+        uint64_t                                                    m_generation = 0;
+    };
+}
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifdef USE_REMOTE_RENDERING
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace HolographicApp
+{
+    // Picks the ARR region with the lowest round trip time from the device, since every remote frame pays the round trip to
+    // the rendering VM.
+    //
+    // The round trip is measured as the time of a TCP connect to the session endpoint of each region, the same endpoints that
+    // Scripts/ARRUtils.ps1 lists. All regions are probed in parallel, each a few times so that a single slow handshake doesn't
+    // decide. The results are cached per network, so a device only probes again when it is moved to another network or the
+    // cached results are older than the cache lifetime.
+    class RegionProbe
+    {
+    public:
+        struct Options
+        {
+            std::vector<std::string> Regions{ "australiaeast", "eastus", "eastus2", "japaneast", "northeurope",
+                                              "southcentralus", "southeastasia", "uksouth", "westeurope", "westus2" };
+            std::string FallbackRegion{ "westus2" }; // Used when no region could be reached.
+            std::chrono::milliseconds ConnectTimeout{ 1000 };
+            uint32_t SamplesPerRegion = 3;
+            std::chrono::hours CacheLifetime{ 24 };
+            std::filesystem::path CacheFolder; // Defaults to the RegionLatency folder in the app's temporary folder.
+        };
+
+        struct Latency
+        {
+            std::string Region;
+            std::optional<std::chrono::microseconds> RoundTrip; // Not set if the region couldn't be reached.
+        };
+
+        RegionProbe();
+        explicit RegionProbe(Options options);
+
+        // Returns the region with the lowest round trip on the current network, probing the regions unless valid results are
+        // cached. Blocks for up to SamplesPerRegion connect timeouts when probing.
+        std::string SelectRegion();
+
+        // Returns the remote rendering domain of the region, e.g. "westus2.mixedreality.azure.com".
+        static std::string GetDomain(const std::string& region);
+
+    private:
+        std::vector<Latency> Probe() const;
+        std::optional<std::vector<Latency>> ReadCache(const std::filesystem::path& path) const;
+        void WriteCache(const std::filesystem::path& path, const std::vector<Latency>& latencies) const;
+
+        Options m_options;
+    };
+}
+#endif
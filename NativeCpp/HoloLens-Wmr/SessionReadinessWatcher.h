@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#ifdef USE_REMOTE_RENDERING
+#include <algorithm>
+#include <functional>
+#include <random>
+
+namespace HolographicApp
+{
+    // Polls a rendering session until it is ready to connect to, every 10 seconds to stay clear of the service throttling.
+    // OnReady is invoked from the properties callback itself.
+    class SessionReadinessWatcher
+    {
+    public:
+        struct Options
+        {
+            double InitialDelayInSeconds = 10.0; // Don't go lower, the service throttles more frequent requests.
+            double MaxDelayInSeconds = 10.0;     // Each polling interval delays the connect by up to this much.
+            double BackoffFactor = 1.5;
+            double JitterFraction = 0.2; // Each delay is randomized by +/- this fraction, within the limits above.
+        };
+
+        using ReadyCallback = std::function<void()>;
+        using FailedCallback = std::function<void(const char* reason)>;
+
+        SessionReadinessWatcher() = default;
+        explicit SessionReadinessWatcher(Options options)
+            : m_options(options)
+        {
+        }
+
+        // Starts watching the session. The first properties query is sent on the next Update.
+        void Start(RR::ApiHandle<RR::RenderingSession> session, double nowInSeconds, ReadyCallback onReady, FailedCallback onFailed)
+        {
+            m_session = std::move(session);
+            m_onReady = std::move(onReady);
+            m_onFailed = std::move(onFailed);
+            m_currentDelay = m_options.InitialDelayInSeconds;
+            m_nextQueryTime = nowInSeconds;
+            m_queryInProgress = false;
+            m_generation++;
+        }
+
+        // Stops watching. Results of queries that are still in flight are ignored.
+        void Stop()
+        {
+            m_session = nullptr;
+            m_onReady = nullptr;
+            m_onFailed = nullptr;
+            m_generation++;
+        }
+
+        bool IsWatching() const
+        {
+            return m_session != nullptr;
+        }
+
+        // Sends the next properties query when it is due. Call once per frame.
+        void Update(double nowInSeconds)
+        {
+            if (m_session == nullptr || m_queryInProgress || nowInSeconds < m_nextQueryTime)
+            {
+                return;
+            }
+
+            m_queryInProgress = true;
+            m_nextQueryTime = nowInSeconds + NextDelay();
+
+            m_session->GetPropertiesAsync([this, generation = m_generation](RR::Status status, RR::ApiHandle<RR::RenderingSessionPropertiesResult> propertiesResult)
+                {
+                    if (generation != m_generation)
+                    {
+                        return; // Stopped or restarted while this query was in flight.
+                    }
+                    m_queryInProgress = false;
+
+                    if (status != RR::Status::OK)
+                    {
+                        Fail("Failed to retrieve session status");
+                        return;
+                    }
+
+                    auto ctx = propertiesResult->GetContext();
+                    if (ctx.Result != RR::Result::Success)
+                    {
+                        Fail(ctx.ErrorMessage.c_str());
+                        return;
+                    }
+
+                    switch (propertiesResult->GetSessionProperties().Status)
+                    {
+                    case RR::RenderingSessionStatus::Ready:
+                    {
+                        ReadyCallback onReady = std::move(m_onReady);
+                        Stop();
+                        onReady();
+                    }
+                    break;
+                    case RR::RenderingSessionStatus::Error:
+                        Fail("Session error");
+                        break;
+                    case RR::RenderingSessionStatus::Stopped:
+                        Fail("Session stopped");
+                        break;
+                    case RR::RenderingSessionStatus::Expired:
+                        Fail("Session expired");
+                        break;
+                    default:
+                        break; // Still starting, keep polling.
+                    }
+                });
+        }
+
+    private:
+        double NextDelay()
+        {
+            std::uniform_real_distribution<double> jitter(1.0 - m_options.JitterFraction, 1.0 + m_options.JitterFraction);
+            const double delay =
+                std::clamp(m_currentDelay * jitter(m_random), m_options.InitialDelayInSeconds, m_options.MaxDelayInSeconds);
+            m_currentDelay = std::min(m_currentDelay * m_options.BackoffFactor, m_options.MaxDelayInSeconds);
+            return delay;
+        }
+
+        void Fail(const char* reason)
+        {
+            FailedCallback onFailed = std::move(m_onFailed);
+            Stop();
+            onFailed(reason);
+        }
+
+        Options                                                     m_options;
+        RR::ApiHandle<RR::RenderingSession>                         m_session;
+        ReadyCallback                                               m_onReady;
+        FailedCallback                                              m_onFailed;
+        double                                                      m_currentDelay = 0;
+        double                                                      m_nextQueryTime = 0;
+        bool                                                        m_queryInProgress = false;
+        uint64_t                                                    m_generation = 0;
+        std::minstd_rand                                            m_random{ std::random_device{}() };
+    };
+}
+#endif
@@ -1,6 +1,11 @@
 #pragma once
 
+// Before any header that includes <windows.h>, which would otherwise pull in the older <winsock.h> that RegionProbe can't use.
+#include <winsock2.h>
+
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <d2d1_2.h>
 #include <d3d11_4.h>
 #include <DirectXColors.h>
@@ -8,6 +13,7 @@
 #include <future>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <vector>
 #include <wincodec.h>
 #include <WindowsNumerics.h>
@@ -26,6 +26,39 @@ $ARRAvailableVMSizes = @{
     premium  = $true
 }
 
+# Vertex format presets for the "vertex" section of <asset>.ConversionSettings.json
+# default:    the formats the conversion service uses if the section is missing
+# compact:    half precision positions and texture coordinates, no binormals and second color and texture coordinate set.
+#             Half precision positions are only exact to ~1/1000 of the distance from the origin, so combine this with
+#             recenterToOrigin for models that are far from the origin or large compared to the required precision.
+# untextured: compact without tangent frame and texture coordinates, for models which only use vertex colors and plain materials
+$VertexFormatPresets = [ordered]@{
+    default    = [ordered]@{ position = "32_32_32_FLOAT";    color0 = "8_8_8_8_UNSIGNED_NORMALIZED"; color1 = "NONE"; normal = "8_8_8_8_SIGNED_NORMALIZED"; tangent = "8_8_8_8_SIGNED_NORMALIZED"; binormal = "8_8_8_8_SIGNED_NORMALIZED"; texcoord0 = "32_32_FLOAT"; texcoord1 = "32_32_FLOAT" }
+    compact    = [ordered]@{ position = "16_16_16_16_FLOAT"; color0 = "8_8_8_8_UNSIGNED_NORMALIZED"; color1 = "NONE"; normal = "8_8_8_8_SIGNED_NORMALIZED"; tangent = "8_8_8_8_SIGNED_NORMALIZED"; binormal = "NONE";                      texcoord0 = "16_16_FLOAT"; texcoord1 = "NONE" }
+    untextured = [ordered]@{ position = "16_16_16_16_FLOAT"; color0 = "8_8_8_8_UNSIGNED_NORMALIZED"; color1 = "NONE"; normal = "8_8_8_8_SIGNED_NORMALIZED"; tangent = "NONE";                      binormal = "NONE";                      texcoord0 = "NONE";        texcoord1 = "NONE" }
+}
+
+# bytes per vertex of the vertex attribute formats
+$VertexFormatSizes = @{
+    "NONE"                        = 0
+    "32_32_32_FLOAT"              = 12
+    "16_16_16_16_FLOAT"           = 8
+    "8_8_8_8_UNSIGNED_NORMALIZED" = 4
+    "8_8_8_8_SIGNED_NORMALIZED"   = 4
+    "32_32_FLOAT"                 = 8
+    "16_16_FLOAT"                 = 4
+}
+
+# Returns the effective vertex formats of a parsed ConversionSettings.json (or $null) - attributes it does not set keep their default
+function GetEffectiveVertexFormat($conversionSettings) {
+    $vertexFormat = [ordered]@{}
+    $VertexFormatPresets.default.Keys | ForEach-Object { $vertexFormat[$_] = $VertexFormatPresets.default[$_] }
+    if ($null -ne $conversionSettings -and $null -ne $conversionSettings.PSObject.Properties["vertex"]) {
+        $conversionSettings.vertex.PSObject.Properties | ForEach-Object { $vertexFormat[$_.Name] = $_.Value }
+    }
+    return $vertexFormat
+}
+
 $docsAvailableString = "Documentation is available at https://docs.microsoft.com/en-us/azure/remote-rendering/samples/powershell-example-scripts"
 function CheckPrerequisites()
 {
@@ -126,11 +159,133 @@ function GetResponseBody($response) {
     return $responseBody
 }
 
+# Names the networks the machine is connected to the internet through, so that region latencies are cached per network
+function GetNetworkName() {
+    try {
+        $profiles = Get-NetConnectionProfile -ErrorAction Stop | Where-Object { $_.IPv4Connectivity -eq "Internet" -or $_.IPv6Connectivity -eq "Internet" }
+        $names = $profiles | ForEach-Object { "$($_.InterfaceAlias)|$($_.Name)" } | Sort-Object
+        if ($null -ne $names) {
+            return $names -join ";"
+        }
+    }
+    catch {
+        # Get-NetConnectionProfile is only available on Windows
+    }
+    return "default"
+}
+
+# Measures the round trip to the session endpoint of every region in $ARRServiceEndpoints as the time of a TCP connect.
+# All regions are connected to in parallel, $Samples times each, and the fastest connect counts.
+# Returns a hashtable of region to round trip in milliseconds, $null for regions that could not be reached within $TimeoutMs.
+function MeasureRegionLatencies([int] $Samples, [int] $TimeoutMs) {
+    # resolve the names up front, so that the measurement only contains the handshake
+    $addresses = @{}
+    $latencies = @{}
+    foreach ($region in $ARRServiceEndpoints.Keys) {
+        $latencies[$region] = $null
+        try {
+            $addresses[$region] = [System.Net.Dns]::GetHostAddresses(([Uri]$ARRServiceEndpoints[$region]).Host)[0]
+        }
+        catch {
+            WriteInformation("Could not resolve the endpoint of region $region")
+        }
+    }
+
+    for ($i = 0; $i -lt $Samples; $i++) {
+        $clients = @{}
+        $tasks = @{}
+        $started = @{}
+        $stopwatch = [System.Diagnostics.Stopwatch]::StartNew()
+        foreach ($region in $addresses.Keys) {
+            $clients[$region] = New-Object System.Net.Sockets.TcpClient($addresses[$region].AddressFamily)
+            $started[$region] = $stopwatch.Elapsed.TotalMilliseconds
+            $tasks[$region] = $clients[$region].ConnectAsync($addresses[$region], 443)
+        }
+
+        # WaitAny returns as soon as the next connect finished, so every region gets its own time
+        $pending = [System.Collections.ArrayList]@($tasks.Keys)
+        while ($pending.Count -gt 0) {
+            $remaining = $TimeoutMs - $stopwatch.ElapsedMilliseconds
+            if ($remaining -le 0) {
+                break
+            }
+            $index = [System.Threading.Tasks.Task]::WaitAny([System.Threading.Tasks.Task[]]@($pending | ForEach-Object { $tasks[$_] }), [int]$remaining)
+            if ($index -lt 0) {
+                break
+            }
+            $region = $pending[$index]
+            $pending.RemoveAt($index)
+            if ($tasks[$region].Status -eq [System.Threading.Tasks.TaskStatus]::RanToCompletion) {
+                $roundTrip = [Math]::Round($stopwatch.Elapsed.TotalMilliseconds - $started[$region], 1)
+                if ($null -eq $latencies[$region] -or $roundTrip -lt $latencies[$region]) {
+                    $latencies[$region] = $roundTrip
+                }
+            }
+        }
+        $clients.Values | ForEach-Object { $_.Dispose() }
+    }
+    return $latencies
+}
+
+# Returns the region with the lowest round trip from this machine, or $null if no region could be reached.
+# The measured round trips are cached per network for $CacheLifetimeHours in the temp folder, so the regions are only probed again
+# on another network or once the results are outdated.
+function SelectLowestLatencyRegion([int] $Samples = 3, [int] $TimeoutMs = 1000, [int] $CacheLifetimeHours = 24) {
+    $cacheFile = Join-Path ([System.IO.Path]::GetTempPath()) "ARRRegionLatency.json"
+    $network = GetNetworkName
+    $now = [DateTimeOffset]::UtcNow.ToUnixTimeSeconds()
+
+    $cache = @{}
+    if (Test-Path $cacheFile) {
+        try {
+            (Get-Content -Path $cacheFile -Raw | ConvertFrom-Json).psobject.properties | ForEach-Object { $cache[$_.Name] = $_.Value }
+        }
+        catch {
+            WriteInformation("Ignoring the invalid region latency cache at $cacheFile")
+            $cache = @{}
+        }
+    }
+
+    $latencies = @{}
+    $cached = $cache[$network]
+    $measured = $null -eq $cached -or ($now - $cached.measuredAt) -ge $CacheLifetimeHours * 3600
+    if (-Not $measured) {
+        $cached.latencies.psobject.properties | ForEach-Object { $latencies[$_.Name] = $_.Value }
+        WriteInformation("Using the region round trips measured on network '$network'")
+    }
+    else {
+        WriteInformation("Measuring the round trip to all regions on network '$network' ...")
+        $latencies = MeasureRegionLatencies -Samples $Samples -TimeoutMs $TimeoutMs
+    }
+
+    $reachable = $latencies.GetEnumerator() | Where-Object { $null -ne $_.Value } | Sort-Object -Property Value
+    if ($null -eq $reachable) {
+        WriteError("None of the regions could be reached - select a region in accountSettings.region")
+        return $null
+    }
+    $reachable | ForEach-Object { WriteInformation(("  {0,-16} {1,8:N1} ms" -f $_.Key, $_.Value)) }
+
+    # only results with a reachable region are cached, so that a failed probe is repeated on the next run
+    if ($measured) {
+        $cache[$network] = @{ measuredAt = $now; latencies = $latencies }
+        try {
+            $cache | ConvertTo-Json -Depth 3 | Set-Content -Path $cacheFile
+        }
+        catch {
+            WriteInformation("Could not write the region latency cache at $cacheFile")
+        }
+    }
+
+    $best = @($reachable)[0]
+    WriteSuccess("Selected region $($best.Key) with a round trip of $($best.Value) ms")
+    return $best.Key
+}
+
 $defaultConfigContent = '{
     "accountSettings": {
       "arrAccountId": "<fill in the account ID from the Azure Portal>",
       "arrAccountKey": "<fill in the account key from the Azure Portal>",
-      "region": "<select from available regions: australiaeast, eastus, eastus2, japaneast, northeurope, southcentralus, southeastasia, uksouth, westeurope, westus2>",
+      "region": "<select from available regions: australiaeast, eastus, eastus2, japaneast, northeurope, southcentralus, southeastasia, uksouth, westeurope, westus2, or auto for the region with the lowest round trip>",
       "authenticationEndpoint": null,
       "serviceEndpoint": null
     },
@@ -267,6 +422,14 @@ function LoadConfig(
         $config.accountSettings.arrAccountKey = $ArrAccountKey
     }
 
+    # "auto" picks the region with the lowest round trip from this machine, see SelectLowestLatencyRegion
+    if ($config.accountSettings.region -eq "auto" -and [string]::IsNullOrEmpty($ServiceEndpoint) -and [string]::IsNullOrEmpty($config.accountSettings.serviceEndpoint)) {
+        $selectedRegion = SelectLowestLatencyRegion
+        if ($null -ne $selectedRegion) {
+            $config.accountSettings.region = $selectedRegion
+        }
+    }
+
     if ([string]::IsNullOrEmpty($config.accountSettings.authenticationEndpoint)) {
         $config.accountSettings.authenticationEndpoint = $ARRAuthenticationEndpoint
     }
@@ -528,216 +691,3 @@ function GetAuthenticationToken([string]$authenticationEndpoint, [GUID]$accountI
         }
     }
 }
-
-# SIG # Begin signature block
-# MIInOAYJKoZIhvcNAQcCoIInKTCCJyUCAQExDzANBglghkgBZQMEAgEFADB5Bgor
-# BgEEAYI3AgEEoGswaTA0BgorBgEEAYI3AgEeMCYCAwEAAAQQH8w7YFlLCE63JNLG
-# KX7zUQIBAAIBAAIBAAIBAAIBADAxMA0GCWCGSAFlAwQCAQUABCBQ3SbaUdwqI3h+
-# 2y66YT4RwMe+quCdpgSlPHOl2ynxwKCCEWUwggh3MIIHX6ADAgECAhM2AAABOXjG
-# OfXldyfqAAEAAAE5MA0GCSqGSIb3DQEBCwUAMEExEzARBgoJkiaJk/IsZAEZFgNH
-# QkwxEzARBgoJkiaJk/IsZAEZFgNBTUUxFTATBgNVBAMTDEFNRSBDUyBDQSAwMTAe
-# Fw0yMDEwMjEyMDM5MDZaFw0yMTA5MTUyMTQzMDNaMCQxIjAgBgNVBAMTGU1pY3Jv
-# c29mdCBBenVyZSBDb2RlIFNpZ24wggEiMA0GCSqGSIb3DQEBAQUAA4IBDwAwggEK
-# AoIBAQCvtf6RG9X1bFXLQOzLuA06k5gBhizLWQ3/m6nIKOwoNsu9N+s9yt+ZGRpb
-# ZbDtBmtAeoi3c2XK9vf0x3sq32GWPPv+px6a7u55tQ9lq4evX6QNxPhrH++ltlUt
-# siiVmV934/+F5B/71sJ1Nxr89OsExV1b5Ey7LiKkEwxpTRxlOyUXf4OiQvTDzG0I
-# 7AseJ4RxOy23tLnh8268pkucY2PbSLFYoRIG1ZGNgchcprL+uiRLuCz4vZXfidQo
-# Wus3ThY8+mYulD8AaQ5ZtnuwzSHtzxYm/g6OeSDsf4xFep0DYLA3zNiKO4CvmzNR
-# jJbcg1Bm7OpDe/CSLSWG5aoqW+X5AgMBAAGjggWDMIIFfzApBgkrBgEEAYI3FQoE
-# HDAaMAwGCisGAQQBgjdbAQEwCgYIKwYBBQUHAwMwPQYJKwYBBAGCNxUHBDAwLgYm
-# KwYBBAGCNxUIhpDjDYTVtHiE8Ys+hZvdFs6dEoFgg93NZoaUjDICAWQCAQwwggJ2
-# BggrBgEFBQcBAQSCAmgwggJkMGIGCCsGAQUFBzAChlZodHRwOi8vY3JsLm1pY3Jv
-# c29mdC5jb20vcGtpaW5mcmEvQ2VydHMvQlkyUEtJQ1NDQTAxLkFNRS5HQkxfQU1F
-# JTIwQ1MlMjBDQSUyMDAxKDEpLmNydDBSBggrBgEFBQcwAoZGaHR0cDovL2NybDEu
-# YW1lLmdibC9haWEvQlkyUEtJQ1NDQTAxLkFNRS5HQkxfQU1FJTIwQ1MlMjBDQSUy
-# MDAxKDEpLmNydDBSBggrBgEFBQcwAoZGaHR0cDovL2NybDIuYW1lLmdibC9haWEv
-# QlkyUEtJQ1NDQTAxLkFNRS5HQkxfQU1FJTIwQ1MlMjBDQSUyMDAxKDEpLmNydDBS
-# BggrBgEFBQcwAoZGaHR0cDovL2NybDMuYW1lLmdibC9haWEvQlkyUEtJQ1NDQTAx
-# LkFNRS5HQkxfQU1FJTIwQ1MlMjBDQSUyMDAxKDEpLmNydDBSBggrBgEFBQcwAoZG
-# aHR0cDovL2NybDQuYW1lLmdibC9haWEvQlkyUEtJQ1NDQTAxLkFNRS5HQkxfQU1F
-# JTIwQ1MlMjBDQSUyMDAxKDEpLmNydDCBrQYIKwYBBQUHMAKGgaBsZGFwOi8vL0NO
-# PUFNRSUyMENTJTIwQ0ElMjAwMSxDTj1BSUEsQ049UHVibGljJTIwS2V5JTIwU2Vy
-# dmljZXMsQ049U2VydmljZXMsQ049Q29uZmlndXJhdGlvbixEQz1BTUUsREM9R0JM
-# P2NBQ2VydGlmaWNhdGU/YmFzZT9vYmplY3RDbGFzcz1jZXJ0aWZpY2F0aW9uQXV0
-# aG9yaXR5MB0GA1UdDgQWBBRQasfWFuGWZ4TjHj7E0G+JYLldgzAOBgNVHQ8BAf8E
-# BAMCB4AwUAYDVR0RBEkwR6RFMEMxKTAnBgNVBAsTIE1pY3Jvc29mdCBPcGVyYXRp
-# b25zIFB1ZXJ0byBSaWNvMRYwFAYDVQQFEw0yMzYxNjcrNDYyNTE2MIIB1AYDVR0f
-# BIIByzCCAccwggHDoIIBv6CCAbuGPGh0dHA6Ly9jcmwubWljcm9zb2Z0LmNvbS9w
-# a2lpbmZyYS9DUkwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIYuaHR0cDovL2NybDEu
-# YW1lLmdibC9jcmwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIYuaHR0cDovL2NybDIu
-# YW1lLmdibC9jcmwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIYuaHR0cDovL2NybDMu
-# YW1lLmdibC9jcmwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIYuaHR0cDovL2NybDQu
-# YW1lLmdibC9jcmwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIaBumxkYXA6Ly8vQ049
-# QU1FJTIwQ1MlMjBDQSUyMDAxLENOPUJZMlBLSUNTQ0EwMSxDTj1DRFAsQ049UHVi
-# bGljJTIwS2V5JTIwU2VydmljZXMsQ049U2VydmljZXMsQ049Q29uZmlndXJhdGlv
-# bixEQz1BTUUsREM9R0JMP2NlcnRpZmljYXRlUmV2b2NhdGlvbkxpc3Q/YmFzZT9v
-# YmplY3RDbGFzcz1jUkxEaXN0cmlidXRpb25Qb2ludDAfBgNVHSMEGDAWgBQbZqIZ
-# /JvrpdqEjxiY6RCkw3uSvTAfBgNVHSUEGDAWBgorBgEEAYI3WwEBBggrBgEFBQcD
-# AzANBgkqhkiG9w0BAQsFAAOCAQEArFNMfAJStrd/3V4hInTdjEo/CLYAY8YX/foG
-# Amyk6NrjEx3uFN0sJmR3qR0iBggS3SBiUi4oZ+Xk8+DjVnnJFn9Fhmu/kB2wT4ZK
-# jjjZeWROPcTsUnRgs1+OhKTWbX2Eng8oH3Cq0qR9LaOT/ES5Ejd98S1jq6WZ8B8K
-# dNHg0d+VGAtwts+E3uu8MkUM5rUukmPHW7BC8ttmgKeXZiIiLV4T1KzxBMMNg0lY
-# 7iFbQ5fkj5hLa1E0WvsGMcMGOMwRUVwVwl6F8OL8aUY5i7tpAuz54XVS4W1grPyT
-# JDae1qB19H5JvqTwPPNm30JrFGpR/X/SGQhROsoD4V1tvCJ8tDCCCOYwggbOoAMC
-# AQICEx8AAAAUtMUfxvKAvnEAAAAAABQwDQYJKoZIhvcNAQELBQAwPDETMBEGCgmS
-# JomT8ixkARkWA0dCTDETMBEGCgmSJomT8ixkARkWA0FNRTEQMA4GA1UEAxMHYW1l
-# cm9vdDAeFw0xNjA5MTUyMTMzMDNaFw0yMTA5MTUyMTQzMDNaMEExEzARBgoJkiaJ
-# k/IsZAEZFgNHQkwxEzARBgoJkiaJk/IsZAEZFgNBTUUxFTATBgNVBAMTDEFNRSBD
-# UyBDQSAwMTCCASIwDQYJKoZIhvcNAQEBBQADggEPADCCAQoCggEBANVXgQLW+frQ
-# 9xuAud03zSTcZmH84YlyrSkM0hsbmr+utG00tVRHgw40pxYbJp5W+hpDwnmJgicF
-# oGRrPt6FifMmnd//1aD/fW1xvGs80yZk9jxTNcisVF1CYIuyPctwuJZfwE3wcGxh
-# kVw/tj3ZHZVacSls3jRD1cGwrcVo1IR6+hHMvUejtt4/tv0UmUoH82HLQ8w1oTX9
-# D7xj35Zt9T0pOPqM3Gt9+/zs7tPp2gyoOYv8xR4X0iWZKuXTzxugvMA63YsB4ehu
-# SBqzHdkF55rxH47aT6hPhvDHlm7M2lsZcRI0CUAujwcJ/vELeFapXNGpt2d3wcPJ
-# M0bpzrPDJ/8CAwEAAaOCBNowggTWMBAGCSsGAQQBgjcVAQQDAgEBMCMGCSsGAQQB
-# gjcVAgQWBBSR/DPOQp72k+bifVTXCBi7uNdxZTAdBgNVHQ4EFgQUG2aiGfyb66Xa
-# hI8YmOkQpMN7kr0wggEEBgNVHSUEgfwwgfkGBysGAQUCAwUGCCsGAQUFBwMBBggr
-# BgEFBQcDAgYKKwYBBAGCNxQCAQYJKwYBBAGCNxUGBgorBgEEAYI3CgMMBgkrBgEE
-# AYI3FQYGCCsGAQUFBwMJBggrBgEFBQgCAgYKKwYBBAGCN0ABAQYLKwYBBAGCNwoD
-# BAEGCisGAQQBgjcKAwQGCSsGAQQBgjcVBQYKKwYBBAGCNxQCAgYKKwYBBAGCNxQC
-# AwYIKwYBBQUHAwMGCisGAQQBgjdbAQEGCisGAQQBgjdbAgEGCisGAQQBgjdbAwEG
-# CisGAQQBgjdbBQEGCisGAQQBgjdbBAEGCisGAQQBgjdbBAIwGQYJKwYBBAGCNxQC
-# BAweCgBTAHUAYgBDAEEwCwYDVR0PBAQDAgGGMBIGA1UdEwEB/wQIMAYBAf8CAQAw
-# HwYDVR0jBBgwFoAUKV5RXmSuNLnrrJwNp4x1AdEJCygwggFoBgNVHR8EggFfMIIB
-# WzCCAVegggFToIIBT4YjaHR0cDovL2NybDEuYW1lLmdibC9jcmwvYW1lcm9vdC5j
-# cmyGMWh0dHA6Ly9jcmwubWljcm9zb2Z0LmNvbS9wa2lpbmZyYS9jcmwvYW1lcm9v
-# dC5jcmyGI2h0dHA6Ly9jcmwyLmFtZS5nYmwvY3JsL2FtZXJvb3QuY3JshiNodHRw
-# Oi8vY3JsMy5hbWUuZ2JsL2NybC9hbWVyb290LmNybIaBqmxkYXA6Ly8vQ049YW1l
-# cm9vdCxDTj1BTUVST09ULENOPUNEUCxDTj1QdWJsaWMlMjBLZXklMjBTZXJ2aWNl
-# cyxDTj1TZXJ2aWNlcyxDTj1Db25maWd1cmF0aW9uLERDPUFNRSxEQz1HQkw/Y2Vy
-# dGlmaWNhdGVSZXZvY2F0aW9uTGlzdD9iYXNlP29iamVjdENsYXNzPWNSTERpc3Ry
-# aWJ1dGlvblBvaW50MIIBqwYIKwYBBQUHAQEEggGdMIIBmTA3BggrBgEFBQcwAoYr
-# aHR0cDovL2NybDEuYW1lLmdibC9haWEvQU1FUk9PVF9hbWVyb290LmNydDBHBggr
-# BgEFBQcwAoY7aHR0cDovL2NybC5taWNyb3NvZnQuY29tL3BraWluZnJhL2NlcnRz
-# L0FNRVJPT1RfYW1lcm9vdC5jcnQwNwYIKwYBBQUHMAKGK2h0dHA6Ly9jcmwyLmFt
-# ZS5nYmwvYWlhL0FNRVJPT1RfYW1lcm9vdC5jcnQwNwYIKwYBBQUHMAKGK2h0dHA6
-# Ly9jcmwzLmFtZS5nYmwvYWlhL0FNRVJPT1RfYW1lcm9vdC5jcnQwgaIGCCsGAQUF
-# BzAChoGVbGRhcDovLy9DTj1hbWVyb290LENOPUFJQSxDTj1QdWJsaWMlMjBLZXkl
-# MjBTZXJ2aWNlcyxDTj1TZXJ2aWNlcyxDTj1Db25maWd1cmF0aW9uLERDPUFNRSxE
-# Qz1HQkw/Y0FDZXJ0aWZpY2F0ZT9iYXNlP29iamVjdENsYXNzPWNlcnRpZmljYXRp
-# b25BdXRob3JpdHkwDQYJKoZIhvcNAQELBQADggIBACi3Soaajx+kAWjNwgDqkIvK
-# AOFkHmS1t0DlzZlpu1ANNfA0BGtck6hEG7g+TpUdVrvxdvPQ5lzU3bGTOBkyhGmX
-# oSIlWjKC7xCbbuYegk8n1qj3rTcjiakdbBqqHdF8J+fxv83E2EsZ+StzfCnZXA62
-# QCMn6t8mhCWBxpwPXif39Ua32yYHqP0QISAnLTjjcH6bAV3IIk7k5pQ/5NA6qIL8
-# yYD6vRjpCMl/3cZOyJD81/5+POLNMx0eCClOfFNxtaD0kJmeThwL4B2hAEpHTeRN
-# tB8ib+cze3bvkGNPHyPlSHIuqWoC31x2Gk192SfzFDPV1PqFOcuKjC8049SSBtC1
-# X7hyvMqAe4dop8k3u25+odhvDcWdNmimdMWvp/yZ6FyjbGlTxtUqE7iLTLF1eaUL
-# SEobAap16hY2N2yTJTISKHzHI4rjsEQlvqa2fj6GLxNj/jC+4LNy+uRmfQXShd30
-# lt075qTroz0Nt680pXvVhsRSdNnzW2hfQu2xuOLg8zKGVOD/rr0GgeyhODjKgL2G
-# Hxctbb9XaVSDf6ocdB//aDYjiabmWd/WYmy7fQ127KuasMh5nSV2orMcAed8CbIV
-# I3NYu+sahT1DRm/BGUN2hSpdsPQeO73wYvp1N7DdLaZyz7XsOCx1quCwQ+bojWVQ
-# TmKLGegSoUpZNfmP9MtSMYIVKTCCFSUCAQEwWDBBMRMwEQYKCZImiZPyLGQBGRYD
-# R0JMMRMwEQYKCZImiZPyLGQBGRYDQU1FMRUwEwYDVQQDEwxBTUUgQ1MgQ0EgMDEC
-# EzYAAAE5eMY59eV3J+oAAQAAATkwDQYJYIZIAWUDBAIBBQCgga4wGQYJKoZIhvcN
-# AQkDMQwGCisGAQQBgjcCAQQwHAYKKwYBBAGCNwIBCzEOMAwGCisGAQQBgjcCARUw
-# LwYJKoZIhvcNAQkEMSIEIL2DFhZBEBxJX4ptY3dBgwl/ZrzlBGSBtAPZHDaS55af
-# MEIGCisGAQQBgjcCAQwxNDAyoBSAEgBNAGkAYwByAG8AcwBvAGYAdKEagBhodHRw
-# Oi8vd3d3Lm1pY3Jvc29mdC5jb20wDQYJKoZIhvcNAQEBBQAEggEAWqmDHgnzuHTq
-# EpO98UEf4T3rdeYqw6Fk5PFKnriBrwZrVvytAYyIUP4vFirEddy512EPwuvK/3EQ
-# KODWu05pLy0qBenGenjKdpQjej/T1Fub3vY1YmneTIzLZYdLkLkUpjOq9at/IzTt
-# 1NvfHQ1LD2T1PVZMqn/PqPsmzbtEiyjWEgWnvtq6yccpKqYav8TEEMQ31lOhXA6O
-# O2P2y5CUz11TBa/ObVTBKOMNqeIDT96qlhUXwhY9kbnzuLE82jVYJCpzW62fjoFb
-# 2Jctr6bJc6lEXp+b6wMOa71i7UAG/4XFJf4UMG2jTA5jnR2La9baDw/uBr4LiXDM
-# KZ3cihWLUKGCEvEwghLtBgorBgEEAYI3AwMBMYIS3TCCEtkGCSqGSIb3DQEHAqCC
-# EsowghLGAgEDMQ8wDQYJYIZIAWUDBAIBBQAwggFVBgsqhkiG9w0BCRABBKCCAUQE
-# ggFAMIIBPAIBAQYKKwYBBAGEWQoDATAxMA0GCWCGSAFlAwQCAQUABCBsbK5lSl3O
-# CD7CKIUNUySXfcpzUrO9Jh3fXnmrIHMD7wIGYNOgr1gzGBMyMDIxMDcwNzEwMzky
-# MC4zMDJaMASAAgH0oIHUpIHRMIHOMQswCQYDVQQGEwJVUzETMBEGA1UECBMKV2Fz
-# aGluZ3RvbjEQMA4GA1UEBxMHUmVkbW9uZDEeMBwGA1UEChMVTWljcm9zb2Z0IENv
-# cnBvcmF0aW9uMSkwJwYDVQQLEyBNaWNyb3NvZnQgT3BlcmF0aW9ucyBQdWVydG8g
-# UmljbzEmMCQGA1UECxMdVGhhbGVzIFRTUyBFU046NDYyRi1FMzE5LTNGMjAxJTAj
-# BgNVBAMTHE1pY3Jvc29mdCBUaW1lLVN0YW1wIFNlcnZpY2Wggg5EMIIE9TCCA92g
-# AwIBAgITMwAAAVhwWiL3vpbmAwAAAAABWDANBgkqhkiG9w0BAQsFADB8MQswCQYD
-# VQQGEwJVUzETMBEGA1UECBMKV2FzaGluZ3RvbjEQMA4GA1UEBxMHUmVkbW9uZDEe
-# MBwGA1UEChMVTWljcm9zb2Z0IENvcnBvcmF0aW9uMSYwJAYDVQQDEx1NaWNyb3Nv
-# ZnQgVGltZS1TdGFtcCBQQ0EgMjAxMDAeFw0yMTAxMTQxOTAyMTRaFw0yMjA0MTEx
-# OTAyMTRaMIHOMQswCQYDVQQGEwJVUzETMBEGA1UECBMKV2FzaGluZ3RvbjEQMA4G
-# A1UEBxMHUmVkbW9uZDEeMBwGA1UEChMVTWljcm9zb2Z0IENvcnBvcmF0aW9uMSkw
-# JwYDVQQLEyBNaWNyb3NvZnQgT3BlcmF0aW9ucyBQdWVydG8gUmljbzEmMCQGA1UE
-# CxMdVGhhbGVzIFRTUyBFU046NDYyRi1FMzE5LTNGMjAxJTAjBgNVBAMTHE1pY3Jv
-# c29mdCBUaW1lLVN0YW1wIFNlcnZpY2UwggEiMA0GCSqGSIb3DQEBAQUAA4IBDwAw
-# ggEKAoIBAQChHwuXYPWrsNCgBRsL9e8jBRvEn6oFFBQvA88GvJq6bNHsoUUNjb/S
-# u/7M/31RNaP9X2aeKuEhorXLIzxrTp41seOVSBUyDUKXaDoZrD3Zxct4AV6TBrU3
-# 16i551BOPlZigtrwITmdOlOr7eQnNHCaKhCbczlkcBGs/AaF9pwl9UQV5B9z4gLu
-# 7Vib91fM4UUjyxZnoifgiMGstOAFIJq8FxEB7yR4G+j4iwsYBNlQAQgzU+Qlconj
-# WqXGYisdekGw5XuyjsJIzBCCpHMUft9nQzLcwraSFA4KysZo8fhpveIx4nqITh1L
-# oZd7t4ZQGH79kgP/Ok9VDQIgUIN1rvcbAgMBAAGjggEbMIIBFzAdBgNVHQ4EFgQU
-# S3DZG32dHBgf7ud+oHuTJ9Oi+VgwHwYDVR0jBBgwFoAU1WM6XIoxkPNDe3xGG8Uz
-# aFqFbVUwVgYDVR0fBE8wTTBLoEmgR4ZFaHR0cDovL2NybC5taWNyb3NvZnQuY29t
-# L3BraS9jcmwvcHJvZHVjdHMvTWljVGltU3RhUENBXzIwMTAtMDctMDEuY3JsMFoG
-# CCsGAQUFBwEBBE4wTDBKBggrBgEFBQcwAoY+aHR0cDovL3d3dy5taWNyb3NvZnQu
-# Y29tL3BraS9jZXJ0cy9NaWNUaW1TdGFQQ0FfMjAxMC0wNy0wMS5jcnQwDAYDVR0T
-# AQH/BAIwADATBgNVHSUEDDAKBggrBgEFBQcDCDANBgkqhkiG9w0BAQsFAAOCAQEA
-# Od8oA1qL0K4fH7pYjV1tAlAU83wOEpeIfiDxIeZTXa4Qxcuk+DAPY7qdc85RZKWK
-# 1HNLE30AgDpwI5rpz4J5mkuW0n9lR/DIN+FNqoDyyJzAJBmgbPwc2myeuWCntT+S
-# CmTe1o9m0XwitNxEvJEu4OmEB+u4sTAkAiw63lgyiWLDbNHITaSTgM8iXhn8kVHv
-# k1FGxcI7Av9fCpmDg1YKUUmGcdFu46xqpSVRHobsKUiLBjmAgTJyQzXSpz/tdwoO
-# vHFbQjV+pCXb1BR9GYrjzJQWA+xqwj6gEZUp/r8X3zIr7tgzCSS5HssMUnw+drA1
-# fjQX+SJ4rihXBPctJvZtozCCBnEwggRZoAMCAQICCmEJgSoAAAAAAAIwDQYJKoZI
-# hvcNAQELBQAwgYgxCzAJBgNVBAYTAlVTMRMwEQYDVQQIEwpXYXNoaW5ndG9uMRAw
-# DgYDVQQHEwdSZWRtb25kMR4wHAYDVQQKExVNaWNyb3NvZnQgQ29ycG9yYXRpb24x
-# MjAwBgNVBAMTKU1pY3Jvc29mdCBSb290IENlcnRpZmljYXRlIEF1dGhvcml0eSAy
-# MDEwMB4XDTEwMDcwMTIxMzY1NVoXDTI1MDcwMTIxNDY1NVowfDELMAkGA1UEBhMC
-# VVMxEzARBgNVBAgTCldhc2hpbmd0b24xEDAOBgNVBAcTB1JlZG1vbmQxHjAcBgNV
-# BAoTFU1pY3Jvc29mdCBDb3Jwb3JhdGlvbjEmMCQGA1UEAxMdTWljcm9zb2Z0IFRp
-# bWUtU3RhbXAgUENBIDIwMTAwggEiMA0GCSqGSIb3DQEBAQUAA4IBDwAwggEKAoIB
-# AQCpHQ28dxGKOiDs/BOX9fp/aZRrdFQQ1aUKAIKF++18aEssX8XD5WHCdrc+Zitb
-# 8BVTJwQxH0EbGpUdzgkTjnxhMFmxMEQP8WCIhFRDDNdNuDgIs0Ldk6zWczBXJoKj
-# RQ3Q6vVHgc2/JGAyWGBG8lhHhjKEHnRhZ5FfgVSxz5NMksHEpl3RYRNuKMYa+YaA
-# u99h/EbBJx0kZxJyGiGKr0tkiVBisV39dx898Fd1rL2KQk1AUdEPnAY+Z3/1ZsAD
-# lkR+79BL/W7lmsqxqPJ6Kgox8NpOBpG2iAg16HgcsOmZzTznL0S6p/TcZL2kAcEg
-# CZN4zfy8wMlEXV4WnAEFTyJNAgMBAAGjggHmMIIB4jAQBgkrBgEEAYI3FQEEAwIB
-# ADAdBgNVHQ4EFgQU1WM6XIoxkPNDe3xGG8UzaFqFbVUwGQYJKwYBBAGCNxQCBAwe
-# CgBTAHUAYgBDAEEwCwYDVR0PBAQDAgGGMA8GA1UdEwEB/wQFMAMBAf8wHwYDVR0j
-# BBgwFoAU1fZWy4/oolxiaNE9lJBb186aGMQwVgYDVR0fBE8wTTBLoEmgR4ZFaHR0
-# cDovL2NybC5taWNyb3NvZnQuY29tL3BraS9jcmwvcHJvZHVjdHMvTWljUm9vQ2Vy
-# QXV0XzIwMTAtMDYtMjMuY3JsMFoGCCsGAQUFBwEBBE4wTDBKBggrBgEFBQcwAoY+
-# aHR0cDovL3d3dy5taWNyb3NvZnQuY29tL3BraS9jZXJ0cy9NaWNSb29DZXJBdXRf
-# MjAxMC0wNi0yMy5jcnQwgaAGA1UdIAEB/wSBlTCBkjCBjwYJKwYBBAGCNy4DMIGB
-# MD0GCCsGAQUFBwIBFjFodHRwOi8vd3d3Lm1pY3Jvc29mdC5jb20vUEtJL2RvY3Mv
-# Q1BTL2RlZmF1bHQuaHRtMEAGCCsGAQUFBwICMDQeMiAdAEwAZQBnAGEAbABfAFAA
-# bwBsAGkAYwB5AF8AUwB0AGEAdABlAG0AZQBuAHQALiAdMA0GCSqGSIb3DQEBCwUA
-# A4ICAQAH5ohRDeLG4Jg/gXEDPZ2joSFvs+umzPUxvs8F4qn++ldtGTCzwsVmyWrf
-# 9efweL3HqJ4l4/m87WtUVwgrUYJEEvu5U4zM9GASinbMQEBBm9xcF/9c+V4XNZgk
-# Vkt070IQyK+/f8Z/8jd9Wj8c8pl5SpFSAK84Dxf1L3mBZdmptWvkx872ynoAb0sw
-# RCQiPM/tA6WWj1kpvLb9BOFwnzJKJ/1Vry/+tuWOM7tiX5rbV0Dp8c6ZZpCM/2pi
-# f93FSguRJuI57BlKcWOdeyFtw5yjojz6f32WapB4pm3S4Zz5Hfw42JT0xqUKloak
-# vZ4argRCg7i1gJsiOCC1JeVk7Pf0v35jWSUPei45V3aicaoGig+JFrphpxHLmtgO
-# R5qAxdDNp9DvfYPw4TtxCd9ddJgiCGHasFAeb73x4QDf5zEHpJM692VHeOj4qEir
-# 995yfmFrb3epgcunCaw5u+zGy9iCtHLNHfS4hQEegPsbiSpUObJb2sgNVZl6h3M7
-# COaYLeqN4DMuEin1wC9UJyH3yKxO2ii4sanblrKnQqLJzxlBTeCG+SqaoxFmMNO7
-# dDJL32N79ZmKLxvHIa9Zta7cRDyXUHHXodLFVeNp3lfB0d4wwP3M5k37Db9dT+md
-# Hhk4L7zPWAUu7w2gUDXa7wknHNWzfjUeCLraNtvTX4/edIhJEqGCAtIwggI7AgEB
-# MIH8oYHUpIHRMIHOMQswCQYDVQQGEwJVUzETMBEGA1UECBMKV2FzaGluZ3RvbjEQ
-# MA4GA1UEBxMHUmVkbW9uZDEeMBwGA1UEChMVTWljcm9zb2Z0IENvcnBvcmF0aW9u
-# MSkwJwYDVQQLEyBNaWNyb3NvZnQgT3BlcmF0aW9ucyBQdWVydG8gUmljbzEmMCQG
-# A1UECxMdVGhhbGVzIFRTUyBFU046NDYyRi1FMzE5LTNGMjAxJTAjBgNVBAMTHE1p
-# Y3Jvc29mdCBUaW1lLVN0YW1wIFNlcnZpY2WiIwoBATAHBgUrDgMCGgMVAKnJK3Ma
-# 59ELIabqM46fpfg0nzS/oIGDMIGApH4wfDELMAkGA1UEBhMCVVMxEzARBgNVBAgT
-# Cldhc2hpbmd0b24xEDAOBgNVBAcTB1JlZG1vbmQxHjAcBgNVBAoTFU1pY3Jvc29m
-# dCBDb3Jwb3JhdGlvbjEmMCQGA1UEAxMdTWljcm9zb2Z0IFRpbWUtU3RhbXAgUENB
-# IDIwMTAwDQYJKoZIhvcNAQEFBQACBQDkj+sbMCIYDzIwMjEwNzA3MTI1ODAzWhgP
-# MjAyMTA3MDgxMjU4MDNaMHcwPQYKKwYBBAGEWQoEATEvMC0wCgIFAOSP6xsCAQAw
-# CgIBAAICHlkCAf8wBwIBAAICEU0wCgIFAOSRPJsCAQAwNgYKKwYBBAGEWQoEAjEo
-# MCYwDAYKKwYBBAGEWQoDAqAKMAgCAQACAwehIKEKMAgCAQACAwGGoDANBgkqhkiG
-# 9w0BAQUFAAOBgQBePj6ONtpXukth7EmxV4k+jOfB007RHfYuuN4olu76D7FCuEI3
-# vY29IgIzGZ0NtWxP2GVRjukVc07A+LIX2AFsWs3Z7VSMD/RkjYey0mpm2EhuLEOr
-# O63ezsvaQZ/6/IpdM1lzUY2/Y262czH1MMY75tB7IkA0TRJYJ6UY6uLb3zGCAw0w
-# ggMJAgEBMIGTMHwxCzAJBgNVBAYTAlVTMRMwEQYDVQQIEwpXYXNoaW5ndG9uMRAw
-# DgYDVQQHEwdSZWRtb25kMR4wHAYDVQQKExVNaWNyb3NvZnQgQ29ycG9yYXRpb24x
-# JjAkBgNVBAMTHU1pY3Jvc29mdCBUaW1lLVN0YW1wIFBDQSAyMDEwAhMzAAABWHBa
-# Ive+luYDAAAAAAFYMA0GCWCGSAFlAwQCAQUAoIIBSjAaBgkqhkiG9w0BCQMxDQYL
-# KoZIhvcNAQkQAQQwLwYJKoZIhvcNAQkEMSIEIAH4kVikYhBYGM1ih8jqEd22/c7K
-# e+Rh+EFvfX4M15eFMIH6BgsqhkiG9w0BCRACLzGB6jCB5zCB5DCBvQQg8kozjWyG
-# NZdsyk+G2uLAiOFpAQurCH0fbklTVcdw0wcwgZgwgYCkfjB8MQswCQYDVQQGEwJV
-# UzETMBEGA1UECBMKV2FzaGluZ3RvbjEQMA4GA1UEBxMHUmVkbW9uZDEeMBwGA1UE
-# ChMVTWljcm9zb2Z0IENvcnBvcmF0aW9uMSYwJAYDVQQDEx1NaWNyb3NvZnQgVGlt
-# ZS1TdGFtcCBQQ0EgMjAxMAITMwAAAVhwWiL3vpbmAwAAAAABWDAiBCAfQkargMv9
-# Sch1ItQtDs1T88FXpK/HGNMWtHLZa1QjuDANBgkqhkiG9w0BAQsFAASCAQBdgEuc
-# 3R/MnaCwnDmmCwa3AGu+Z0GjbFBLOH792QPlfszoMEY5UveVpllhdK7nAR1qyRP0
-# w0fgIWTbi9AuPZ6EhqNTY0BK5Q4yLeJ9D9j+bGwcFv+3dfhpJZsRWZb0mNq9vaiD
-# HIakW/SyJLCye+GCfbGVbYyRzpakcAihttfoInlI1iSPoK3Eqv2cuxwi7+taUAVq
-# JZeGYCZzv6mOKOrTdJyKNBb9hBydRgHxGLEi1UT7nQtzeVbuw9zQJiU8+vrJRdaw
-# lgoYavWDs2Kcoo7wzqY9OWam/GGu1xjAGQg1VNIF3EvSdwjMkYbNAl1ywj3Vuea2
-# gIobBp81Qe3cDTsb
-# SIG # End signature block
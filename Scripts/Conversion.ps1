@@ -14,6 +14,8 @@
 #      using the provided storage account.
 #   - Start a conversion using the ARR Conversion REST API and retrieves a conversion Id
 #   - Poll the conversion status until the conversion succeeded or failed
+#   - Skip the conversion if the input container content and conversion settings match the last successful conversion
+#      to the same output asset (see Conversion cache below, disable with -NoConversionCache)
 
 # Conversion.ps1 -UseContainerSas [-ConfigFile <pathtoconfig>]
 #   The -UseContainerSas will convert the input asset using the conversions/createWithSharedAccessSignature REST API.
@@ -24,6 +26,8 @@
 # The individual stages -Upload -ConvertAsset and -GetConversionStatus can be executed individually like:
 # Conversion.ps1 -Upload
 #   Only executes the Upload of the asset directory to the input storage container and terminates
+#   Files are uploaded in parallel (-MaxParallelUploads, default 8). Files which already exist in the input container with the
+#   same content are skipped, so an interrupted upload can be resumed by running the script again. -ForceUpload uploads all files.
 
 # Conversion.ps1 -ConvertAsset
 #  Only executes the convert asset step
@@ -32,6 +36,14 @@
 #   Retrieves the status of the conversion with the provided conversion id.
 #   -Poll will poll the conversion with given id until the conversion succeeds or fails
 
+# Conversion.ps1 -BatchManifest <pathtomanifest> [-MaxConcurrentConversions <count>] [-Upload]
+#   Converts all assets listed in the manifest, running up to -MaxConcurrentConversions (default 4) conversions at the same time.
+#   Writes a summary with the status and duration of every conversion to <manifest>.summary.csv or -BatchSummaryFile.
+
+# Conversion.ps1 -VertexPreset <default|compact|untextured> [-SizeReport]
+#   Writes the vertex formats of the preset into <asset>.ConversionSettings.json in the local asset directory before the upload.
+#   -SizeReport reports the .arrAsset size and the GPU memory per vertex attribute after the conversion.
+
 # Optional parameters:
 # individual settings in the config file can be overridden on the command line:
 
@@ -55,6 +67,14 @@ Param(
     [string] $OutputFolderPath, # optional override for the path in output container, conversion result will be copied there
     [string] $OutputAssetFileName, # optional filename of the outputAssetFileName of assetConversionSettings in config file. needs to end in .arrAsset
     [string] $LocalAssetDirectoryPath, # Path to directory containing all input asset data (e.g. fbx and textures referenced by it)
+    [int] $MaxParallelUploads = 8, # number of files uploaded to the input container at the same time
+    [switch] $ForceUpload, # if set all files are uploaded, even if an identical blob already exists in the input container
+    [switch] $NoConversionCache, # if set the asset is converted even if the output container holds a conversion of identical input
+    [string] $BatchManifest, # optional path to a JSON manifest listing many assets to convert, see Batch conversion below
+    [int] $MaxConcurrentConversions = 4, # number of conversions running at the same time in batch mode
+    [string] $BatchSummaryFile, # optional path of the CSV summary written in batch mode, defaults to <manifest>.summary.csv
+    [string] $VertexPreset, # optional vertex format preset (default, compact, untextured) written to <asset>.ConversionSettings.json before upload
+    [switch] $SizeReport, # if set a size report of the converted asset is written after the conversion
     [string] $AuthenticationEndpoint,
     [string] $ServiceEndpoint,
     [hashtable] $AdditionalParameters
@@ -75,6 +95,12 @@ if (-Not $LoggedIn) {
     exit 1
 }
 
+if ($BatchManifest) {
+    # batch mode converts and polls all assets of the manifest, -Upload can still be used to upload the asset directory first
+    $ConvertAsset = $true
+    $GetConversionStatus = $false
+}
+
 if (-Not ($Upload -or $ConvertAsset -or $GetConversionStatus )) {
     # if none of the three stages is explicitly asked for execute all stages and poll for conversion status until finished
     $Upload = $true
@@ -83,8 +109,59 @@ if (-Not ($Upload -or $ConvertAsset -or $GetConversionStatus )) {
     $Poll = $true
 }
 
+# Returns the base64 encoded MD5 hash of a local file, in the format Azure Storage uses for the Content-MD5 blob property
+function GetFileContentMD5([string] $path) {
+    $hexHash = (Get-FileHash -Path $path -Algorithm MD5).Hash
+    $hashBytes = [byte[]]::new($hexHash.Length / 2)
+    for ($i = 0; $i -lt $hashBytes.Length; $i++) {
+        $hashBytes[$i] = [Convert]::ToByte($hexHash.Substring($i * 2, 2), 16)
+    }
+    return [Convert]::ToBase64String($hashBytes)
+}
+
+# Returns the base64 encoded Content-MD5 of a listed blob or $null if the blob has none
+# Newer Az.Storage versions expose it as BlobProperties.ContentHash, older ones as ICloudBlob.Properties.ContentMD5
+function GetBlobContentMD5($blob) {
+    if ($null -ne $blob.PSObject.Properties["BlobProperties"] -and $null -ne $blob.BlobProperties -and $null -ne $blob.BlobProperties.ContentHash) {
+        return [Convert]::ToBase64String($blob.BlobProperties.ContentHash)
+    }
+    if ($null -ne $blob.PSObject.Properties["ICloudBlob"] -and $null -ne $blob.ICloudBlob) {
+        return $blob.ICloudBlob.Properties.ContentMD5
+    }
+    return $null
+}
+
+# Uploads a list of files to the input container, one after the other. Runs as a background job, so the storage context is
+# recreated from its connection string. Writes one result object per file.
+$UploadFiles = {
+    param($connectionString, $containerName, $files, $retryCount)
+
+    Import-Module Az.Storage
+    $storageContext = New-AzStorageContext -ConnectionString $connectionString
+
+    foreach ($file in $files) {
+        $errorMessage = $null
+        for ($attempt = 1; $attempt -le $retryCount; $attempt++) {
+            try {
+                $blob = Set-AzStorageBlobContent -File $file.Path -Container $containerName -Context $storageContext -Blob $file.Blob -Properties @{ "ContentMD5" = $file.ContentMD5 } -Force -ErrorAction Stop
+                if ($null -ne $blob) {
+                    $errorMessage = $null
+                    break
+                }
+                $errorMessage = "No blob returned"
+            }
+            catch {
+                $errorMessage = $_.Exception.Message
+            }
+        }
+        [PSCustomObject]@{ Path = $file.Path; Succeeded = ($null -eq $errorMessage); Error = $errorMessage }
+    }
+}
+
 # Upload asset directory to the configured azure blob storage account and input container under given inputFolder
-function UploadAssetDirectory($assetSettings) {
+# Files whose blob already exists with the same size and Content-MD5 are skipped, so re-running the upload after a partial
+# failure only uploads the files that are missing or changed. The remaining files are uploaded by $maxParallelUploads jobs.
+function UploadAssetDirectory($assetSettings, [int] $maxParallelUploads, [switch] $forceUpload) {
     $localAssetFile = Join-Path -Path $assetSettings.localAssetDirectoryPath -ChildPath $assetSettings.inputAssetPath
     $assetFileExistsLocally = Test-Path $localAssetFile
     if(!$assetFileExistsLocally)
@@ -106,30 +183,89 @@ function UploadAssetDirectory($assetSettings) {
         return $false
     }
 
-    $filesToUpload = @(Get-ChildItem -Path $assetSettings.localAssetDirectoryPath -File -Recurse)
+    $filesInDirectory = @(Get-ChildItem -Path $assetSettings.localAssetDirectoryPath -File -Recurse)
 
-    if (0 -eq $filesToUpload.Length) {
+    if (0 -eq $filesInDirectory.Length) {
         WriteError("Unable to upload files from asset directory $($assetSettings.localAssetDirectoryPath). Directory is empty.")
     }
 
-    WriteInformation ("Uploading $($filesToUpload.Length) files to input storage container")
-    $filesUploaded = 0
+    # List the blobs which are already in the input container, to skip uploading files which did not change
+    $existingBlobs = @{}
+    if (-not $forceUpload) {
+        $blobs = Get-AzStorageBlob -Container $assetSettings.blobInputContainerName -Context $assetSettings.storageContext -Prefix $assetSettings.inputFolderPath -ErrorAction SilentlyContinue
+        foreach ($blob in @($blobs)) {
+            if ($null -ne $blob) {
+                $existingBlobs[$blob.Name] = $blob
+            }
+        }
+    }
 
-    foreach ($fileToUpload in $filesToUpload) {
-        $relativePathInFolder = $fileToUpload.FullName.Substring($assetSettings.localAssetDirectoryPath.Length).Replace("\", "/")
+    $filesToUpload = @()
+    $filesSkipped = 0
+    foreach ($fileInDirectory in $filesInDirectory) {
+        $relativePathInFolder = $fileInDirectory.FullName.Substring($assetSettings.localAssetDirectoryPath.Length).Replace("\", "/")
         $remoteBlobpath = $assetSettings.inputFolderPath + $relativePathInFolder
+        $contentMD5 = GetFileContentMD5 $fileInDirectory.FullName
 
-        WriteSuccess ("Uploading file $($fileToUpload.FullName) to input blob storage container")
-        $blob = Set-AzStorageBlobContent -File $fileToUpload.FullName -Container $assetSettings.blobInputContainerName -Context $assetSettings.storageContext -Blob $remoteBlobpath -Force
-        $filesUploaded++
-        if ($null -ne $blob ) {
-            WriteSuccess ("Uploaded file $filesUploaded/$($filesToUpload.Length) $($fileToUpload.FullName) to blob storage ...")
+        $existingBlob = $existingBlobs[$remoteBlobpath]
+        if ($null -ne $existingBlob -and $existingBlob.Length -eq $fileInDirectory.Length -and (GetBlobContentMD5 $existingBlob) -eq $contentMD5) {
+            $filesSkipped++
+            continue
         }
-        else {
-            WriteError("Unable to upload file $fileToUpload from local asset directory location $($assetSettings.localAssetDirectoryPath) ...")
-            return $false
+        $filesToUpload += [PSCustomObject]@{ Path = $fileInDirectory.FullName; Blob = $remoteBlobpath; ContentMD5 = $contentMD5 }
+    }
+
+    if ($filesSkipped -gt 0) {
+        WriteInformation ("Skipping $filesSkipped files which are already up to date in the input storage container")
+    }
+    if (0 -eq $filesToUpload.Length) {
+        WriteSuccess ("Uploaded asset directory to input storage container")
+        return $true
+    }
+
+    # Distribute the files round-robin over the jobs, so large and small files of the same folder end up in different jobs
+    $jobCount = [Math]::Max(1, [Math]::Min($maxParallelUploads, $filesToUpload.Length))
+    WriteInformation ("Uploading $($filesToUpload.Length) files to input storage container using $jobCount parallel uploads")
+    $jobs = @()
+    for ($jobIndex = 0; $jobIndex -lt $jobCount; $jobIndex++) {
+        $jobFiles = @(for ($i = $jobIndex; $i -lt $filesToUpload.Length; $i += $jobCount) { $filesToUpload[$i] })
+        $jobs += Start-Job -ScriptBlock $UploadFiles -ArgumentList @($assetSettings.storageContext.ConnectionString, $assetSettings.blobInputContainerName, $jobFiles, 3)
+    }
+
+    $filesUploaded = 0
+    $failedFiles = @()
+    do {
+        Start-Sleep -milliseconds 250
+
+        foreach ($result in @($jobs | Receive-Job)) {
+            if ($result.Succeeded) {
+                $filesUploaded++
+                WriteSuccess ("Uploaded file $($filesUploaded + $failedFiles.Length)/$($filesToUpload.Length) $($result.Path) to blob storage ...")
+            }
+            else {
+                $failedFiles += $result
+                WriteError("Unable to upload file $($result.Path) from local asset directory location $($assetSettings.localAssetDirectoryPath): $($result.Error)")
+            }
+        }
+        $filesDone = $filesUploaded + $failedFiles.Length
+        Write-Progress -Id 0 -Activity "Uploading asset directory" -Status "$filesDone/$($filesToUpload.Length) files" -PercentComplete (100 * $filesDone / $filesToUpload.Length)
+        $running = @($jobs | Where-Object { $_.State -eq 'Running' -or $_.HasMoreData })
+    } while ($running.Count -gt 0)
+    Write-Progress -Id 0 -Activity "Uploading asset directory" -Completed
+
+    foreach ($job in $jobs) {
+        if ($job.State -eq 'Failed') {
+            WriteError("Upload job failed: $($job.ChildJobs[0].JobStateInfo.Reason)")
         }
     }
+    $jobs | Remove-Job -Force
+
+    if ($filesUploaded -ne $filesToUpload.Length) {
+        WriteError("Uploaded $filesUploaded/$($filesToUpload.Length) files, $($filesToUpload.Length - $filesUploaded) files failed.")
+        WriteError("Run the upload again to upload the remaining files. Files which are already uploaded will be skipped.")
+        return $false
+    }
+
     WriteSuccess ("Uploaded asset directory to input storage container")
     return $true
 }
@@ -225,14 +361,16 @@ function ConvertAsset(
 
 # calls the conversion status ARR REST API "<endPoint>/accounts/<accountId>/conversions/<conversionId>"
 # returns the conversion process state
-function GetConversionStatus($authenticationEndpoint, $serviceEndpoint, $accountId, $accountKey, $conversionId) {
+function GetConversionStatus($authenticationEndpoint, $serviceEndpoint, $accountId, $accountKey, $conversionId, [switch] $quiet) {
     try {
         $url = "$serviceEndpoint/accounts/$accountId/conversions/${conversionId}?api-version=2021-01-01-preview"
 
         $token = GetAuthenticationToken -authenticationEndpoint $authenticationEndpoint -accountId $accountId -accountKey $accountKey
         $response = Invoke-WebRequest -UseBasicParsing -Uri $url -Method GET -ContentType "application/json" -Headers @{ Authorization = "Bearer $token" }
 
-        WriteSuccessResponse($response.RawContent)
+        if (-not $quiet) {
+            WriteSuccessResponse($response.RawContent)
+        }
         return $response
     }
     catch {
@@ -288,6 +426,394 @@ function PollConversionStatus($authenticationEndpoint, $serviceEndpoint, $accoun
     return $conversionResponse
 }
 
+# Conversion cache
+# A successful conversion stores a key next to the output .arrAsset as <outputAssetFileName>.conversionkey. The key is a SHA256
+# hash over the Content-MD5 of every blob under the input folder and the effective conversion settings. When the key of a new
+# conversion matches the stored key and the .arrAsset still exists, the conversion is skipped and the existing output is used.
+function GetOutputAssetBlobPath($assetConversionSettings) {
+    $outputAssetFileName = $assetConversionSettings.outputAssetFileName
+    if ([string]::IsNullOrEmpty($outputAssetFileName)) {
+        # the conversion service names the output after the input asset if no name is given
+        $outputAssetFileName = [System.IO.Path]::GetFileNameWithoutExtension($assetConversionSettings.inputAssetPath) + ".arrAsset"
+    }
+    return "$($assetConversionSettings.outputFolderPath)$outputAssetFileName"
+}
+
+# Returns the conversion cache key for the current input container content and settings, or $null if an input blob
+# has no Content-MD5 (e.g. because it was not uploaded by this script) and the key cannot be computed
+function GetConversionCacheKey($assetConversionSettings, $additionalParameters) {
+    $inputFolderPath = $assetConversionSettings.inputFolderPath
+    $blobs = @(Get-AzStorageBlob -Container $assetConversionSettings.blobInputContainerName -Context $assetConversionSettings.storageContext -Prefix $inputFolderPath -ErrorAction SilentlyContinue)
+
+    $keyLines = [System.Collections.Generic.List[string]]::new()
+    foreach ($blob in ($blobs | Where-Object { $null -ne $_ } | Sort-Object -Property Name)) {
+        $contentMD5 = GetBlobContentMD5 $blob
+        if ([string]::IsNullOrEmpty($contentMD5)) {
+            WriteInformation("Input blob $($blob.Name) has no Content-MD5 - the conversion cache is not used.")
+            return $null
+        }
+        $keyLines.Add("$($blob.Name.Substring($inputFolderPath.Length))`t$($blob.Length)`t$contentMD5")
+    }
+
+    # The input asset and any additional conversion settings change the output, the output location does not
+    $keyLines.Add("relativeInputAssetPath`t$($assetConversionSettings.inputAssetPath)")
+    if ($additionalParameters) {
+        foreach ($key in ($additionalParameters.Keys | Sort-Object)) {
+            $keyLines.Add("$key`t$($additionalParameters[$key] | ConvertTo-Json -Depth 10 -Compress)")
+        }
+    }
+
+    $sha256 = [System.Security.Cryptography.SHA256]::Create()
+    try {
+        $hash = $sha256.ComputeHash([System.Text.Encoding]::UTF8.GetBytes($keyLines -join "`n"))
+    }
+    finally {
+        $sha256.Dispose()
+    }
+    return [System.BitConverter]::ToString($hash).Replace("-", "").ToLowerInvariant()
+}
+
+# Returns $true if the output container holds a converted asset which was created with the given cache key
+function FindCachedConversion($assetConversionSettings, [string] $cacheKey) {
+    $outputAssetBlobPath = GetOutputAssetBlobPath $assetConversionSettings
+    $container = $assetConversionSettings.blobOutputContainerName
+    $context = $assetConversionSettings.storageContext
+
+    $outputAsset = Get-AzStorageBlob -Container $container -Context $context -Blob $outputAssetBlobPath -ErrorAction SilentlyContinue
+    if ($null -eq $outputAsset) {
+        return $false
+    }
+
+    $keyFile = [System.IO.Path]::GetTempFileName()
+    try {
+        $keyBlob = Get-AzStorageBlobContent -Container $container -Context $context -Blob "$outputAssetBlobPath.conversionkey" -Destination $keyFile -Force -ErrorAction SilentlyContinue
+        if ($null -eq $keyBlob) {
+            return $false
+        }
+        return $cacheKey -eq (Get-Content -Path $keyFile -Raw).Trim()
+    }
+    finally {
+        Remove-Item -Path $keyFile -ErrorAction SilentlyContinue
+    }
+}
+
+# Stores the cache key next to the converted asset. Failing to store it only means the next run converts again.
+function WriteConversionCacheKey($assetConversionSettings, [string] $cacheKey) {
+    $outputAssetBlobPath = GetOutputAssetBlobPath $assetConversionSettings
+
+    $keyFile = [System.IO.Path]::GetTempFileName()
+    try {
+        Set-Content -Path $keyFile -Value $cacheKey -NoNewline
+        $keyBlob = Set-AzStorageBlobContent -File $keyFile -Container $assetConversionSettings.blobOutputContainerName -Context $assetConversionSettings.storageContext -Blob "$outputAssetBlobPath.conversionkey" -Force -ErrorAction SilentlyContinue
+        if ($null -eq $keyBlob) {
+            WriteError("Unable to store the conversion cache key next to $outputAssetBlobPath - the next run will convert the asset again.")
+        }
+    }
+    finally {
+        Remove-Item -Path $keyFile -ErrorAction SilentlyContinue
+    }
+}
+
+# Vertex format presets and size report
+
+# Returns the path of <asset>.ConversionSettings.json relative to the asset directory or input folder
+function GetConversionSettingsFilePath($assetConversionSettings) {
+    $inputAssetPath = $assetConversionSettings.inputAssetPath
+    return $inputAssetPath.Substring(0, $inputAssetPath.Length - [System.IO.Path]::GetExtension($inputAssetPath).Length) + ".ConversionSettings.json"
+}
+
+# Writes the vertex formats of a preset into <asset>.ConversionSettings.json in the local asset directory, keeping all other settings
+function ApplyVertexPreset($assetConversionSettings, [string] $presetName) {
+    $settingsFile = Join-Path -Path $assetConversionSettings.localAssetDirectoryPath -ChildPath (GetConversionSettingsFilePath $assetConversionSettings)
+    $conversionSettings = if (Test-Path -Path $settingsFile -PathType Leaf) { Get-Content -Path $settingsFile -Raw | ConvertFrom-Json } else { [PSCustomObject]@{} }
+
+    $conversionSettings | Add-Member -MemberType NoteProperty -Name "vertex" -Value ([PSCustomObject]$VertexFormatPresets[$presetName]) -Force
+    $conversionSettings | ConvertTo-Json -Depth 10 | Set-Content -Path $settingsFile
+    WriteSuccess("Applied vertex preset '$presetName' to $settingsFile")
+}
+
+# Downloads a json blob and returns it parsed, or $null if the blob does not exist
+function GetBlobJson([string] $container, [string] $blobPath, $storageContext) {
+    $jsonFile = [System.IO.Path]::GetTempFileName()
+    try {
+        $blob = Get-AzStorageBlobContent -Container $container -Context $storageContext -Blob $blobPath -Destination $jsonFile -Force -ErrorAction SilentlyContinue
+        if ($null -eq $blob) {
+            return $null
+        }
+        return Get-Content -Path $jsonFile -Raw | ConvertFrom-Json
+    }
+    finally {
+        Remove-Item -Path $jsonFile -ErrorAction SilentlyContinue
+    }
+}
+
+function GetVertexBytes($vertexFormat) {
+    $bytes = 0
+    $vertexFormat.Keys | ForEach-Object { $bytes += $VertexFormatSizes[$vertexFormat[$_]] }
+    return $bytes
+}
+
+# Reports the size of the converted asset and the GPU memory of its vertex attributes, and what the presets would use instead.
+# The vertex count comes from the <asset>.result.json the conversion writes next to the asset. If it only lists the face count,
+# the vertex count is estimated as equal to it, which is typical for meshes with normal and texture coordinate seams.
+function WriteConversionSizeReport($assetConversionSettings) {
+    $outputAssetBlobPath = GetOutputAssetBlobPath $assetConversionSettings
+    $outputContainer = $assetConversionSettings.blobOutputContainerName
+    $storageContext = $assetConversionSettings.storageContext
+
+    $outputAsset = Get-AzStorageBlob -Container $outputContainer -Context $storageContext -Blob $outputAssetBlobPath -ErrorAction SilentlyContinue
+    $resultBlobPath = $outputAssetBlobPath.Substring(0, $outputAssetBlobPath.Length - [System.IO.Path]::GetExtension($outputAssetBlobPath).Length) + ".result.json"
+    $result = GetBlobJson $outputContainer $resultBlobPath $storageContext
+    if ($null -eq $outputAsset -or $null -eq $result) {
+        WriteInformation("No converted asset or conversion result found at $outputAssetBlobPath - skipping the size report.")
+        return
+    }
+
+    $vertexCount = $null
+    $vertexCountIsEstimate = $false
+    foreach ($statistics in "outputStatistics", "inputStatistics") {
+        if ($null -eq $vertexCount -and $null -ne $result.PSObject.Properties[$statistics]) {
+            if ($null -ne $result.$statistics.PSObject.Properties["numVertices"]) {
+                $vertexCount = [long]$result.$statistics.numVertices
+            }
+            elseif ($null -ne $result.$statistics.PSObject.Properties["numFaces"]) {
+                $vertexCount = [long]$result.$statistics.numFaces
+                $vertexCountIsEstimate = $true
+            }
+        }
+    }
+
+    $settingsBlobPath = $assetConversionSettings.inputFolderPath + (GetConversionSettingsFilePath $assetConversionSettings).Replace("\", "/")
+    $vertexFormat = GetEffectiveVertexFormat (GetBlobJson $assetConversionSettings.blobInputContainerName $settingsBlobPath $storageContext)
+
+    WriteLine
+    WriteInformation("Size report for $outputAssetBlobPath")
+    WriteInformation("  .arrAsset size: $([Math]::Round($outputAsset.Length / 1MB, 2)) MB")
+    if ($null -eq $vertexCount) {
+        WriteInformation("  The conversion result has no vertex or face count - no GPU memory estimate available.")
+        return
+    }
+
+    $estimateNote = if ($vertexCountIsEstimate) { " (estimated from the face count)" } else { "" }
+    WriteInformation("  vertices: $vertexCount$estimateNote")
+    $attributes = $vertexFormat.Keys | ForEach-Object {
+        [PSCustomObject]@{
+            Attribute      = $_
+            Format         = $vertexFormat[$_]
+            BytesPerVertex = $VertexFormatSizes[$vertexFormat[$_]]
+            GpuMemoryMB    = [Math]::Round($vertexCount * $VertexFormatSizes[$vertexFormat[$_]] / 1MB, 2)
+        }
+    }
+    WriteInformation($attributes | Format-Table -AutoSize | Out-String)
+    WriteInformation("  vertex data: $([Math]::Round($vertexCount * (GetVertexBytes $vertexFormat) / 1MB, 2)) MB")
+    foreach ($presetName in $VertexFormatPresets.Keys) {
+        WriteInformation("  vertex data with preset '$presetName': $([Math]::Round($vertexCount * (GetVertexBytes $VertexFormatPresets[$presetName]) / 1MB, 2)) MB")
+    }
+}
+
+# Batch conversion
+# Converts all assets listed in a manifest file. The manifest is a JSON array with one object per asset:
+#   [ { "inputAssetPath": "engine/engine.fbx", "outputAssetFileName": "engine.arrAsset" }, ... ]
+# inputAssetPath is required. inputFolderPath, outputFolderPath, outputAssetFileName and additionalParameters are optional
+# and default to the assetConversionSettings of the config file and the -AdditionalParameters of the command line.
+# Up to $maxConcurrentConversions conversions run at the same time. All running conversions are polled in one loop; the
+# poll interval starts short and grows while no conversion finishes.
+function GetManifestValue($entry, [string] $name, $defaultValue) {
+    $property = $entry.PSObject.Properties[$name]
+    if ($null -eq $property -or $null -eq $property.Value) {
+        return $defaultValue
+    }
+    return $property.Value
+}
+
+function LoadConversionManifest([string] $manifestFile, $additionalParameters) {
+    if (-Not (Test-Path -Path $manifestFile -PathType Leaf)) {
+        WriteError("Batch manifest $manifestFile does not exist.")
+        return $null
+    }
+
+    $manifest = Get-Content -Path $manifestFile -Raw | ConvertFrom-Json
+    $conversions = @()
+    foreach ($entry in $manifest) {
+        $inputAssetPath = GetManifestValue $entry "inputAssetPath" $null
+        if ([string]::IsNullOrEmpty($inputAssetPath)) {
+            WriteError("Every entry of the batch manifest $manifestFile needs an inputAssetPath.")
+            return $null
+        }
+        $extension = [System.IO.Path]::GetExtension($inputAssetPath).ToLower()
+        if (!$SupportedFileFormats.Contains($extension)) {
+            WriteError("inputAssetPath '$inputAssetPath' in the batch manifest has unsupported file extension '$extension'")
+            return $null
+        }
+
+        # a $null folder path means the folder path of the config file is used
+        $folderPaths = @{}
+        foreach ($folder in "inputFolderPath", "outputFolderPath") {
+            $folderPaths[$folder] = GetManifestValue $entry $folder $null
+            if (([string]::IsNullOrEmpty($folderPaths[$folder]) -eq $False) -And $folderPaths[$folder] -notmatch '/$') {
+                $folderPaths[$folder] += '/'
+            }
+        }
+
+        $parameters = @{}
+        if ($additionalParameters) {
+            $additionalParameters.Keys | ForEach-Object { $parameters[$_] = $additionalParameters[$_] }
+        }
+        $entryParameters = GetManifestValue $entry "additionalParameters" $null
+        if ($null -ne $entryParameters) {
+            $entryParameters.PSObject.Properties | ForEach-Object { $parameters[$_.Name] = $_.Value }
+        }
+
+        $conversions += [PSCustomObject]@{
+            Asset               = $inputAssetPath
+            InputFolderPath     = $folderPaths["inputFolderPath"]
+            OutputFolderPath    = $folderPaths["outputFolderPath"]
+            OutputAssetFileName = GetManifestValue $entry "outputAssetFileName" ""
+            Parameters          = $parameters
+            Settings            = $null
+            CacheKey            = $null
+            Id                  = $null
+            Status              = "Queued"
+            Submissions         = 0
+            StartTime           = $null
+            Duration            = $null
+            OutputUri           = $null
+            Error               = $null
+        }
+    }
+
+    if (0 -eq $conversions.Length) {
+        WriteError("Batch manifest $manifestFile does not list any asset.")
+        return $null
+    }
+    return ,$conversions
+}
+
+function ConvertAssetBatch($accountSettings, $assetConversionSettings, $conversions, [int] $maxConcurrentConversions, [switch] $useContainerSas, [switch] $noConversionCache) {
+    $minPollInterval = 5
+    $maxPollInterval = 60
+    $maxSubmissions = 3
+    $pollInterval = $minPollInterval
+    $batchStartTime = Get-Date
+
+    foreach ($conversion in $conversions) {
+        $conversion.Settings = $assetConversionSettings.PSObject.Copy()
+        $conversion.Settings.inputAssetPath = $conversion.Asset
+        $conversion.Settings.outputAssetFileName = $conversion.OutputAssetFileName
+        if ($null -ne $conversion.InputFolderPath) {
+            $conversion.Settings.inputFolderPath = $conversion.InputFolderPath
+        }
+        if ($null -ne $conversion.OutputFolderPath) {
+            $conversion.Settings.outputFolderPath = $conversion.OutputFolderPath
+        }
+
+        if (-not $noConversionCache) {
+            $conversion.CacheKey = GetConversionCacheKey $conversion.Settings $conversion.Parameters
+            if ($null -ne $conversion.CacheKey -and (FindCachedConversion $conversion.Settings $conversion.CacheKey)) {
+                $conversion.Status = "Cached"
+                $conversion.Duration = [TimeSpan]::Zero
+                $conversion.OutputUri = "$($conversion.Settings.storageContext.BlobEndPoint)$($conversion.Settings.blobOutputContainerName)/$(GetOutputAssetBlobPath $conversion.Settings)"
+            }
+        }
+    }
+
+    while ($true) {
+        # Submit queued conversions until the concurrency limit is reached
+        $running = @($conversions | Where-Object { $_.Status -eq "Running" })
+        foreach ($conversion in @($conversions | Where-Object { $_.Status -eq "Queued" })) {
+            if ($running.Length -ge $maxConcurrentConversions) {
+                break
+            }
+            $conversion.Submissions++
+            try {
+                $conversion.Id = ConvertAsset -authenticationEndpoint $accountSettings.authenticationEndpoint -serviceEndpoint $accountSettings.serviceEndpoint -accountId $accountSettings.arrAccountId -accountKey $accountSettings.arrAccountKey -assetConversionSettings $conversion.Settings -useContainerSas:$useContainerSas -additionalParameters $conversion.Parameters
+                $conversion.Status = "Running"
+                $conversion.StartTime = Get-Date
+                $running += $conversion
+            }
+            catch {
+                # e.g. the account's concurrent conversion limit is lower than $maxConcurrentConversions - retry in a later round
+                $conversion.Error = $_.Exception.Message
+                if ($conversion.Submissions -ge $maxSubmissions) {
+                    $conversion.Status = "Failed"
+                }
+                break
+            }
+        }
+
+        $queued = @($conversions | Where-Object { $_.Status -eq "Queued" })
+        if (0 -eq $running.Length -and 0 -eq $queued.Length) {
+            break
+        }
+
+        $done = @($conversions | Where-Object { $_.Status -notin "Queued", "Running" })
+        WriteProgress -activity "Batch conversion of $($conversions.Length) assets" -status "$($done.Length) done, $($running.Length) running, $($queued.Length) queued - since $([int]((Get-Date) - $batchStartTime).TotalSeconds) seconds"
+        Start-Sleep -Seconds $pollInterval
+
+        $anyFinished = $false
+        foreach ($conversion in $running) {
+            try {
+                $response = GetConversionStatus $accountSettings.authenticationEndpoint $accountSettings.serviceEndpoint $accountSettings.arrAccountId $accountSettings.arrAccountKey $conversion.Id -quiet
+            }
+            catch {
+                # transient errors while polling are retried in the next round
+                continue
+            }
+            $responseJson = ($response.Content | ConvertFrom-Json)
+            if ("succeeded" -ieq $responseJson.status) {
+                $conversion.Status = "Succeeded"
+                $conversion.OutputUri = $responseJson.output.outputAssetUri
+            }
+            elseif ($responseJson.status -iin "failed", "cancelled") {
+                $conversion.Status = $responseJson.status
+                $conversion.Error = ($responseJson.error | ConvertTo-Json -Compress)
+            }
+            else {
+                continue
+            }
+
+            $anyFinished = $true
+            $conversion.Duration = (Get-Date) - $conversion.StartTime
+            if ("Succeeded" -eq $conversion.Status) {
+                WriteSuccess("Converted $($conversion.Asset) in $([int]$conversion.Duration.TotalSeconds) seconds")
+                if ($null -ne $conversion.CacheKey) {
+                    WriteConversionCacheKey $conversion.Settings $conversion.CacheKey
+                }
+            }
+            else {
+                WriteError("Conversion of $($conversion.Asset) $($conversion.Status): $($conversion.Error)")
+            }
+        }
+
+        # Poll quickly while conversions finish or start, back off while all of them are still running
+        $pollInterval = if ($anyFinished) { $minPollInterval } else { [Math]::Min($maxPollInterval, [int]($pollInterval * 1.5)) }
+    }
+    WriteProgress -activity "Batch conversion of $($conversions.Length) assets" -status "Completed..."
+
+    return (Get-Date) - $batchStartTime
+}
+
+function WriteBatchSummary($conversions, [TimeSpan] $totalDuration, [string] $summaryFile) {
+    WriteLine
+    $summary = $conversions | ForEach-Object {
+        [PSCustomObject]@{
+            Asset           = $_.Asset
+            Status          = $_.Status
+            DurationSeconds = if ($null -ne $_.Duration) { [int]$_.Duration.TotalSeconds } else { $null }
+            ConversionId    = $_.Id
+            OutputUri       = $_.OutputUri
+            Error           = $_.Error
+        }
+    }
+    WriteInformation($summary | Format-Table -Property Asset, Status, DurationSeconds, ConversionId -AutoSize | Out-String)
+    $summary | Export-Csv -Path $summaryFile -NoTypeInformation
+    WriteInformation("Batch summary written to $summaryFile")
+
+    $succeeded = @($conversions | Where-Object { $_.Status -in "Succeeded", "Cached" }).Length
+    WriteInformation("$succeeded/$($conversions.Length) assets converted in $([int]$totalDuration.TotalSeconds) seconds")
+    return $succeeded -eq $conversions.Length
+}
+
 # Execution of script starts here
 
 if ([string]::IsNullOrEmpty($ConfigFile)) {
@@ -323,6 +849,19 @@ if ($false -eq $accountOkay) {
     exit 1
 }
 
+$batchConversions = $null
+if ($BatchManifest) {
+    $batchConversions = LoadConversionManifest $BatchManifest $AdditionalParameters
+    if ($null -eq $batchConversions) {
+        WriteError("Error reading batch manifest $BatchManifest - Exiting.")
+        exit 1
+    }
+    if ($config.assetConversionSettings.inputAssetPath -eq $defaultConfig.assetConversionSettings.inputAssetPath) {
+        # the config file does not need to name an asset in batch mode
+        $config.assetConversionSettings.inputAssetPath = $batchConversions[0].Asset
+    }
+}
+
 if ($ConvertAsset -or $Upload -or $UseContainerSas) {
     $storageSettingsOkay = VerifyStorageSettings $config $defaultConfig
     if ($false -eq $storageSettingsOkay) {
@@ -347,14 +886,57 @@ if ($ConvertAsset -or $Upload -or $UseContainerSas) {
     }
 }
 
+if ($VertexPreset) {
+    if (-not $VertexFormatPresets.Contains($VertexPreset)) {
+        WriteError("Unknown vertex preset '$VertexPreset' - available presets: $($VertexFormatPresets.Keys -join ", ")")
+        exit 1
+    }
+    if (-not $Upload) {
+        WriteError("-VertexPreset changes the local asset directory and requires the upload stage - Exiting.")
+        exit 1
+    }
+    ApplyVertexPreset $config.assetConversionSettings $VertexPreset
+}
+
 if ($Upload) {
-    $uploadSuccessful = UploadAssetDirectory $config.assetConversionSettings
+    $uploadSuccessful = UploadAssetDirectory $config.assetConversionSettings $MaxParallelUploads -forceUpload:$ForceUpload
     if ($false -eq $uploadSuccessful) {
         WriteError("Upload failed - Exiting.")
         exit 1
     }
 }
 
+if ($BatchManifest) {
+    if ($UseContainerSas) {
+        $config.assetConversionSettings.inputContainerSAS = GenerateInputContainerSAS $config.assetConversionSettings.storageContext.BlobEndPoint $config.assetConversionSettings.blobInputContainerName $config.assetConversionSettings.storageContext
+        $config.assetConversionSettings.outputContainerSAS = GenerateOutputContainerSAS -blobEndPoint $config.assetConversionSettings.storageContext.blobEndPoint -blobContainerName $config.assetConversionSettings.blobOutputContainerName -storageContext $config.assetConversionSettings.storageContext
+    }
+
+    $totalDuration = ConvertAssetBatch $config.accountSettings $config.assetConversionSettings $batchConversions $MaxConcurrentConversions -useContainerSas:$UseContainerSas -noConversionCache:$NoConversionCache
+    if ([string]::IsNullOrEmpty($BatchSummaryFile)) {
+        $BatchSummaryFile = [System.IO.Path]::ChangeExtension($BatchManifest, ".summary.csv")
+    }
+    $batchSucceeded = WriteBatchSummary $batchConversions $totalDuration $BatchSummaryFile
+    if (-not $batchSucceeded) {
+        exit 1
+    }
+    exit 0
+}
+
+$conversionCacheKey = $null
+$cachedConversion = $false
+if ($ConvertAsset -and -not $NoConversionCache) {
+    $conversionCacheKey = GetConversionCacheKey $config.assetConversionSettings $AdditionalParameters
+    if ($null -ne $conversionCacheKey) {
+        $cachedConversion = FindCachedConversion $config.assetConversionSettings $conversionCacheKey
+    }
+    if ($cachedConversion) {
+        WriteSuccess("Input and conversion settings are unchanged since the last conversion - skipping the conversion.")
+        $ConvertAsset = $false
+        $GetConversionStatus = $false
+    }
+}
+
 if ($ConvertAsset) {
     if ($UseContainerSas) {
         # Generate SAS and provide it in rest call - this is used if your storage account is not connected with your ARR account
@@ -392,6 +974,17 @@ if ($GetConversionStatus) {
     }
 }
 
+if ($null -ne $conversionResponse -and $null -ne $conversionCacheKey) {
+    WriteConversionCacheKey $config.assetConversionSettings $conversionCacheKey
+}
+
+if ($cachedConversion) {
+    $blobPath = GetOutputAssetBlobPath $config.assetConversionSettings
+    WriteSuccess("Converted asset uri: $($config.assetConversionSettings.storageContext.BlobEndPoint)$($config.assetConversionSettings.blobOutputContainerName)/$blobPath")
+    $sasUrl = GenerateOutputmodelSASUrl $config.assetConversionSettings.blobOutputContainerName $blobPath $config.assetConversionSettings.storageContext
+    WriteInformation("model SAS URI: $sasUrl")
+}
+
 if ($null -ne $conversionResponse) {
     WriteSuccess("Successfully converted asset.")
     WriteSuccess("Converted asset uri: $($conversionResponse.output.outputAssetUri)")
@@ -404,215 +997,6 @@ if ($null -ne $conversionResponse) {
     }
 }
 
-# SIG # Begin signature block
-# MIInOAYJKoZIhvcNAQcCoIInKTCCJyUCAQExDzANBglghkgBZQMEAgEFADB5Bgor
-# BgEEAYI3AgEEoGswaTA0BgorBgEEAYI3AgEeMCYCAwEAAAQQH8w7YFlLCE63JNLG
-# KX7zUQIBAAIBAAIBAAIBAAIBADAxMA0GCWCGSAFlAwQCAQUABCBfmBcjSMtn6PcK
-# GATx1yyChPUHBC5xUVtEwi1BGixwnKCCEWUwggh3MIIHX6ADAgECAhM2AAABOXjG
-# OfXldyfqAAEAAAE5MA0GCSqGSIb3DQEBCwUAMEExEzARBgoJkiaJk/IsZAEZFgNH
-# QkwxEzARBgoJkiaJk/IsZAEZFgNBTUUxFTATBgNVBAMTDEFNRSBDUyBDQSAwMTAe
-# Fw0yMDEwMjEyMDM5MDZaFw0yMTA5MTUyMTQzMDNaMCQxIjAgBgNVBAMTGU1pY3Jv
-# c29mdCBBenVyZSBDb2RlIFNpZ24wggEiMA0GCSqGSIb3DQEBAQUAA4IBDwAwggEK
-# AoIBAQCvtf6RG9X1bFXLQOzLuA06k5gBhizLWQ3/m6nIKOwoNsu9N+s9yt+ZGRpb
-# ZbDtBmtAeoi3c2XK9vf0x3sq32GWPPv+px6a7u55tQ9lq4evX6QNxPhrH++ltlUt
-# siiVmV934/+F5B/71sJ1Nxr89OsExV1b5Ey7LiKkEwxpTRxlOyUXf4OiQvTDzG0I
-# 7AseJ4RxOy23tLnh8268pkucY2PbSLFYoRIG1ZGNgchcprL+uiRLuCz4vZXfidQo
-# Wus3ThY8+mYulD8AaQ5ZtnuwzSHtzxYm/g6OeSDsf4xFep0DYLA3zNiKO4CvmzNR
-# jJbcg1Bm7OpDe/CSLSWG5aoqW+X5AgMBAAGjggWDMIIFfzApBgkrBgEEAYI3FQoE
-# HDAaMAwGCisGAQQBgjdbAQEwCgYIKwYBBQUHAwMwPQYJKwYBBAGCNxUHBDAwLgYm
-# KwYBBAGCNxUIhpDjDYTVtHiE8Ys+hZvdFs6dEoFgg93NZoaUjDICAWQCAQwwggJ2
-# BggrBgEFBQcBAQSCAmgwggJkMGIGCCsGAQUFBzAChlZodHRwOi8vY3JsLm1pY3Jv
-# c29mdC5jb20vcGtpaW5mcmEvQ2VydHMvQlkyUEtJQ1NDQTAxLkFNRS5HQkxfQU1F
-# JTIwQ1MlMjBDQSUyMDAxKDEpLmNydDBSBggrBgEFBQcwAoZGaHR0cDovL2NybDEu
-# YW1lLmdibC9haWEvQlkyUEtJQ1NDQTAxLkFNRS5HQkxfQU1FJTIwQ1MlMjBDQSUy
-# MDAxKDEpLmNydDBSBggrBgEFBQcwAoZGaHR0cDovL2NybDIuYW1lLmdibC9haWEv
-# QlkyUEtJQ1NDQTAxLkFNRS5HQkxfQU1FJTIwQ1MlMjBDQSUyMDAxKDEpLmNydDBS
-# BggrBgEFBQcwAoZGaHR0cDovL2NybDMuYW1lLmdibC9haWEvQlkyUEtJQ1NDQTAx
-# LkFNRS5HQkxfQU1FJTIwQ1MlMjBDQSUyMDAxKDEpLmNydDBSBggrBgEFBQcwAoZG
-# aHR0cDovL2NybDQuYW1lLmdibC9haWEvQlkyUEtJQ1NDQTAxLkFNRS5HQkxfQU1F
-# JTIwQ1MlMjBDQSUyMDAxKDEpLmNydDCBrQYIKwYBBQUHMAKGgaBsZGFwOi8vL0NO
-# PUFNRSUyMENTJTIwQ0ElMjAwMSxDTj1BSUEsQ049UHVibGljJTIwS2V5JTIwU2Vy
-# dmljZXMsQ049U2VydmljZXMsQ049Q29uZmlndXJhdGlvbixEQz1BTUUsREM9R0JM
-# P2NBQ2VydGlmaWNhdGU/YmFzZT9vYmplY3RDbGFzcz1jZXJ0aWZpY2F0aW9uQXV0
-# aG9yaXR5MB0GA1UdDgQWBBRQasfWFuGWZ4TjHj7E0G+JYLldgzAOBgNVHQ8BAf8E
-# BAMCB4AwUAYDVR0RBEkwR6RFMEMxKTAnBgNVBAsTIE1pY3Jvc29mdCBPcGVyYXRp
-# b25zIFB1ZXJ0byBSaWNvMRYwFAYDVQQFEw0yMzYxNjcrNDYyNTE2MIIB1AYDVR0f
-# BIIByzCCAccwggHDoIIBv6CCAbuGPGh0dHA6Ly9jcmwubWljcm9zb2Z0LmNvbS9w
-# a2lpbmZyYS9DUkwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIYuaHR0cDovL2NybDEu
-# YW1lLmdibC9jcmwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIYuaHR0cDovL2NybDIu
-# YW1lLmdibC9jcmwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIYuaHR0cDovL2NybDMu
-# YW1lLmdibC9jcmwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIYuaHR0cDovL2NybDQu
-# YW1lLmdibC9jcmwvQU1FJTIwQ1MlMjBDQSUyMDAxLmNybIaBumxkYXA6Ly8vQ049
-# QU1FJTIwQ1MlMjBDQSUyMDAxLENOPUJZMlBLSUNTQ0EwMSxDTj1DRFAsQ049UHVi
-# bGljJTIwS2V5JTIwU2VydmljZXMsQ049U2VydmljZXMsQ049Q29uZmlndXJhdGlv
-# bixEQz1BTUUsREM9R0JMP2NlcnRpZmljYXRlUmV2b2NhdGlvbkxpc3Q/YmFzZT9v
-# YmplY3RDbGFzcz1jUkxEaXN0cmlidXRpb25Qb2ludDAfBgNVHSMEGDAWgBQbZqIZ
-# /JvrpdqEjxiY6RCkw3uSvTAfBgNVHSUEGDAWBgorBgEEAYI3WwEBBggrBgEFBQcD
-# AzANBgkqhkiG9w0BAQsFAAOCAQEArFNMfAJStrd/3V4hInTdjEo/CLYAY8YX/foG
-# Amyk6NrjEx3uFN0sJmR3qR0iBggS3SBiUi4oZ+Xk8+DjVnnJFn9Fhmu/kB2wT4ZK
-# jjjZeWROPcTsUnRgs1+OhKTWbX2Eng8oH3Cq0qR9LaOT/ES5Ejd98S1jq6WZ8B8K
-# dNHg0d+VGAtwts+E3uu8MkUM5rUukmPHW7BC8ttmgKeXZiIiLV4T1KzxBMMNg0lY
-# 7iFbQ5fkj5hLa1E0WvsGMcMGOMwRUVwVwl6F8OL8aUY5i7tpAuz54XVS4W1grPyT
-# JDae1qB19H5JvqTwPPNm30JrFGpR/X/SGQhROsoD4V1tvCJ8tDCCCOYwggbOoAMC
-# AQICEx8AAAAUtMUfxvKAvnEAAAAAABQwDQYJKoZIhvcNAQELBQAwPDETMBEGCgmS
-# JomT8ixkARkWA0dCTDETMBEGCgmSJomT8ixkARkWA0FNRTEQMA4GA1UEAxMHYW1l
-# cm9vdDAeFw0xNjA5MTUyMTMzMDNaFw0yMTA5MTUyMTQzMDNaMEExEzARBgoJkiaJ
-# k/IsZAEZFgNHQkwxEzARBgoJkiaJk/IsZAEZFgNBTUUxFTATBgNVBAMTDEFNRSBD
-# UyBDQSAwMTCCASIwDQYJKoZIhvcNAQEBBQADggEPADCCAQoCggEBANVXgQLW+frQ
-# 9xuAud03zSTcZmH84YlyrSkM0hsbmr+utG00tVRHgw40pxYbJp5W+hpDwnmJgicF
-# oGRrPt6FifMmnd//1aD/fW1xvGs80yZk9jxTNcisVF1CYIuyPctwuJZfwE3wcGxh
-# kVw/tj3ZHZVacSls3jRD1cGwrcVo1IR6+hHMvUejtt4/tv0UmUoH82HLQ8w1oTX9
-# D7xj35Zt9T0pOPqM3Gt9+/zs7tPp2gyoOYv8xR4X0iWZKuXTzxugvMA63YsB4ehu
-# SBqzHdkF55rxH47aT6hPhvDHlm7M2lsZcRI0CUAujwcJ/vELeFapXNGpt2d3wcPJ
-# M0bpzrPDJ/8CAwEAAaOCBNowggTWMBAGCSsGAQQBgjcVAQQDAgEBMCMGCSsGAQQB
-# gjcVAgQWBBSR/DPOQp72k+bifVTXCBi7uNdxZTAdBgNVHQ4EFgQUG2aiGfyb66Xa
-# hI8YmOkQpMN7kr0wggEEBgNVHSUEgfwwgfkGBysGAQUCAwUGCCsGAQUFBwMBBggr
-# BgEFBQcDAgYKKwYBBAGCNxQCAQYJKwYBBAGCNxUGBgorBgEEAYI3CgMMBgkrBgEE
-# AYI3FQYGCCsGAQUFBwMJBggrBgEFBQgCAgYKKwYBBAGCN0ABAQYLKwYBBAGCNwoD
-# BAEGCisGAQQBgjcKAwQGCSsGAQQBgjcVBQYKKwYBBAGCNxQCAgYKKwYBBAGCNxQC
-# AwYIKwYBBQUHAwMGCisGAQQBgjdbAQEGCisGAQQBgjdbAgEGCisGAQQBgjdbAwEG
-# CisGAQQBgjdbBQEGCisGAQQBgjdbBAEGCisGAQQBgjdbBAIwGQYJKwYBBAGCNxQC
-# BAweCgBTAHUAYgBDAEEwCwYDVR0PBAQDAgGGMBIGA1UdEwEB/wQIMAYBAf8CAQAw
-# HwYDVR0jBBgwFoAUKV5RXmSuNLnrrJwNp4x1AdEJCygwggFoBgNVHR8EggFfMIIB
-# WzCCAVegggFToIIBT4YjaHR0cDovL2NybDEuYW1lLmdibC9jcmwvYW1lcm9vdC5j
-# cmyGMWh0dHA6Ly9jcmwubWljcm9zb2Z0LmNvbS9wa2lpbmZyYS9jcmwvYW1lcm9v
-# dC5jcmyGI2h0dHA6Ly9jcmwyLmFtZS5nYmwvY3JsL2FtZXJvb3QuY3JshiNodHRw
-# Oi8vY3JsMy5hbWUuZ2JsL2NybC9hbWVyb290LmNybIaBqmxkYXA6Ly8vQ049YW1l
-# cm9vdCxDTj1BTUVST09ULENOPUNEUCxDTj1QdWJsaWMlMjBLZXklMjBTZXJ2aWNl
-# cyxDTj1TZXJ2aWNlcyxDTj1Db25maWd1cmF0aW9uLERDPUFNRSxEQz1HQkw/Y2Vy
-# dGlmaWNhdGVSZXZvY2F0aW9uTGlzdD9iYXNlP29iamVjdENsYXNzPWNSTERpc3Ry
-# aWJ1dGlvblBvaW50MIIBqwYIKwYBBQUHAQEEggGdMIIBmTA3BggrBgEFBQcwAoYr
-# aHR0cDovL2NybDEuYW1lLmdibC9haWEvQU1FUk9PVF9hbWVyb290LmNydDBHBggr
-# BgEFBQcwAoY7aHR0cDovL2NybC5taWNyb3NvZnQuY29tL3BraWluZnJhL2NlcnRz
-# L0FNRVJPT1RfYW1lcm9vdC5jcnQwNwYIKwYBBQUHMAKGK2h0dHA6Ly9jcmwyLmFt
-# ZS5nYmwvYWlhL0FNRVJPT1RfYW1lcm9vdC5jcnQwNwYIKwYBBQUHMAKGK2h0dHA6
-# Ly9jcmwzLmFtZS5nYmwvYWlhL0FNRVJPT1RfYW1lcm9vdC5jcnQwgaIGCCsGAQUF
-# BzAChoGVbGRhcDovLy9DTj1hbWVyb290LENOPUFJQSxDTj1QdWJsaWMlMjBLZXkl
-# MjBTZXJ2aWNlcyxDTj1TZXJ2aWNlcyxDTj1Db25maWd1cmF0aW9uLERDPUFNRSxE
-# Qz1HQkw/Y0FDZXJ0aWZpY2F0ZT9iYXNlP29iamVjdENsYXNzPWNlcnRpZmljYXRp
-# b25BdXRob3JpdHkwDQYJKoZIhvcNAQELBQADggIBACi3Soaajx+kAWjNwgDqkIvK
-# AOFkHmS1t0DlzZlpu1ANNfA0BGtck6hEG7g+TpUdVrvxdvPQ5lzU3bGTOBkyhGmX
-# oSIlWjKC7xCbbuYegk8n1qj3rTcjiakdbBqqHdF8J+fxv83E2EsZ+StzfCnZXA62
-# QCMn6t8mhCWBxpwPXif39Ua32yYHqP0QISAnLTjjcH6bAV3IIk7k5pQ/5NA6qIL8
-# yYD6vRjpCMl/3cZOyJD81/5+POLNMx0eCClOfFNxtaD0kJmeThwL4B2hAEpHTeRN
-# tB8ib+cze3bvkGNPHyPlSHIuqWoC31x2Gk192SfzFDPV1PqFOcuKjC8049SSBtC1
-# X7hyvMqAe4dop8k3u25+odhvDcWdNmimdMWvp/yZ6FyjbGlTxtUqE7iLTLF1eaUL
-# SEobAap16hY2N2yTJTISKHzHI4rjsEQlvqa2fj6GLxNj/jC+4LNy+uRmfQXShd30
-# lt075qTroz0Nt680pXvVhsRSdNnzW2hfQu2xuOLg8zKGVOD/rr0GgeyhODjKgL2G
-# Hxctbb9XaVSDf6ocdB//aDYjiabmWd/WYmy7fQ127KuasMh5nSV2orMcAed8CbIV
-# I3NYu+sahT1DRm/BGUN2hSpdsPQeO73wYvp1N7DdLaZyz7XsOCx1quCwQ+bojWVQ
-# TmKLGegSoUpZNfmP9MtSMYIVKTCCFSUCAQEwWDBBMRMwEQYKCZImiZPyLGQBGRYD
-# R0JMMRMwEQYKCZImiZPyLGQBGRYDQU1FMRUwEwYDVQQDEwxBTUUgQ1MgQ0EgMDEC
-# EzYAAAE5eMY59eV3J+oAAQAAATkwDQYJYIZIAWUDBAIBBQCgga4wGQYJKoZIhvcN
-# AQkDMQwGCisGAQQBgjcCAQQwHAYKKwYBBAGCNwIBCzEOMAwGCisGAQQBgjcCARUw
-# LwYJKoZIhvcNAQkEMSIEIHxiDvLOJ6hW1K7mL0eLRGlQuuAZaosNP5jcYKoC8nUN
-# MEIGCisGAQQBgjcCAQwxNDAyoBSAEgBNAGkAYwByAG8AcwBvAGYAdKEagBhodHRw
-# Oi8vd3d3Lm1pY3Jvc29mdC5jb20wDQYJKoZIhvcNAQEBBQAEggEAKrtXsKuzfM/Q
-# MzhUOrp0CxZtSjj2us4VdGNaTpX4bHDmgSUo41CvuHcMdtSffxotTPDOYfsBlF3D
-# NAidey95zuzcccavkJn75GfWKmLGVCRawdGQmGtrkolpAuVBtdMj4JFvBiDVcBGD
-# xvqAdQXDA1hZamdnF5JFiyLGWe4wnfNdLHsrBlKcUbUw+rDLqz1HrJS+vhrypRTe
-# e3B9i8wL0qyMZCSEhCdoa7Cd3/5g//Fq+T42c+YetTIzHGjiRUBpBocuMvXqRCLZ
-# 4Cm3K78JD+TxAHgpLCAq42aFK7bWbjOOdwYT3IWlt2flgxdV8mGTeyT74rsE45vE
-# XypZPGydcKGCEvEwghLtBgorBgEEAYI3AwMBMYIS3TCCEtkGCSqGSIb3DQEHAqCC
-# EsowghLGAgEDMQ8wDQYJYIZIAWUDBAIBBQAwggFVBgsqhkiG9w0BCRABBKCCAUQE
-# ggFAMIIBPAIBAQYKKwYBBAGEWQoDATAxMA0GCWCGSAFlAwQCAQUABCCjtMbQQsON
-# 8l2DUKMFRWLlbYMHguWapVPujEUGf5R2iAIGYNOgr1gpGBMyMDIxMDcwNzEwMzkx
-# OS45NTNaMASAAgH0oIHUpIHRMIHOMQswCQYDVQQGEwJVUzETMBEGA1UECBMKV2Fz
-# aGluZ3RvbjEQMA4GA1UEBxMHUmVkbW9uZDEeMBwGA1UEChMVTWljcm9zb2Z0IENv
-# cnBvcmF0aW9uMSkwJwYDVQQLEyBNaWNyb3NvZnQgT3BlcmF0aW9ucyBQdWVydG8g
-# UmljbzEmMCQGA1UECxMdVGhhbGVzIFRTUyBFU046NDYyRi1FMzE5LTNGMjAxJTAj
-# BgNVBAMTHE1pY3Jvc29mdCBUaW1lLVN0YW1wIFNlcnZpY2Wggg5EMIIE9TCCA92g
-# AwIBAgITMwAAAVhwWiL3vpbmAwAAAAABWDANBgkqhkiG9w0BAQsFADB8MQswCQYD
-# VQQGEwJVUzETMBEGA1UECBMKV2FzaGluZ3RvbjEQMA4GA1UEBxMHUmVkbW9uZDEe
-# MBwGA1UEChMVTWljcm9zb2Z0IENvcnBvcmF0aW9uMSYwJAYDVQQDEx1NaWNyb3Nv
-# ZnQgVGltZS1TdGFtcCBQQ0EgMjAxMDAeFw0yMTAxMTQxOTAyMTRaFw0yMjA0MTEx
-# OTAyMTRaMIHOMQswCQYDVQQGEwJVUzETMBEGA1UECBMKV2FzaGluZ3RvbjEQMA4G
-# A1UEBxMHUmVkbW9uZDEeMBwGA1UEChMVTWljcm9zb2Z0IENvcnBvcmF0aW9uMSkw
-# JwYDVQQLEyBNaWNyb3NvZnQgT3BlcmF0aW9ucyBQdWVydG8gUmljbzEmMCQGA1UE
-# CxMdVGhhbGVzIFRTUyBFU046NDYyRi1FMzE5LTNGMjAxJTAjBgNVBAMTHE1pY3Jv
-# c29mdCBUaW1lLVN0YW1wIFNlcnZpY2UwggEiMA0GCSqGSIb3DQEBAQUAA4IBDwAw
-# ggEKAoIBAQChHwuXYPWrsNCgBRsL9e8jBRvEn6oFFBQvA88GvJq6bNHsoUUNjb/S
-# u/7M/31RNaP9X2aeKuEhorXLIzxrTp41seOVSBUyDUKXaDoZrD3Zxct4AV6TBrU3
-# 16i551BOPlZigtrwITmdOlOr7eQnNHCaKhCbczlkcBGs/AaF9pwl9UQV5B9z4gLu
-# 7Vib91fM4UUjyxZnoifgiMGstOAFIJq8FxEB7yR4G+j4iwsYBNlQAQgzU+Qlconj
-# WqXGYisdekGw5XuyjsJIzBCCpHMUft9nQzLcwraSFA4KysZo8fhpveIx4nqITh1L
-# oZd7t4ZQGH79kgP/Ok9VDQIgUIN1rvcbAgMBAAGjggEbMIIBFzAdBgNVHQ4EFgQU
-# S3DZG32dHBgf7ud+oHuTJ9Oi+VgwHwYDVR0jBBgwFoAU1WM6XIoxkPNDe3xGG8Uz
-# aFqFbVUwVgYDVR0fBE8wTTBLoEmgR4ZFaHR0cDovL2NybC5taWNyb3NvZnQuY29t
-# L3BraS9jcmwvcHJvZHVjdHMvTWljVGltU3RhUENBXzIwMTAtMDctMDEuY3JsMFoG
-# CCsGAQUFBwEBBE4wTDBKBggrBgEFBQcwAoY+aHR0cDovL3d3dy5taWNyb3NvZnQu
-# Y29tL3BraS9jZXJ0cy9NaWNUaW1TdGFQQ0FfMjAxMC0wNy0wMS5jcnQwDAYDVR0T
-# AQH/BAIwADATBgNVHSUEDDAKBggrBgEFBQcDCDANBgkqhkiG9w0BAQsFAAOCAQEA
-# Od8oA1qL0K4fH7pYjV1tAlAU83wOEpeIfiDxIeZTXa4Qxcuk+DAPY7qdc85RZKWK
-# 1HNLE30AgDpwI5rpz4J5mkuW0n9lR/DIN+FNqoDyyJzAJBmgbPwc2myeuWCntT+S
-# CmTe1o9m0XwitNxEvJEu4OmEB+u4sTAkAiw63lgyiWLDbNHITaSTgM8iXhn8kVHv
-# k1FGxcI7Av9fCpmDg1YKUUmGcdFu46xqpSVRHobsKUiLBjmAgTJyQzXSpz/tdwoO
-# vHFbQjV+pCXb1BR9GYrjzJQWA+xqwj6gEZUp/r8X3zIr7tgzCSS5HssMUnw+drA1
-# fjQX+SJ4rihXBPctJvZtozCCBnEwggRZoAMCAQICCmEJgSoAAAAAAAIwDQYJKoZI
-# hvcNAQELBQAwgYgxCzAJBgNVBAYTAlVTMRMwEQYDVQQIEwpXYXNoaW5ndG9uMRAw
-# DgYDVQQHEwdSZWRtb25kMR4wHAYDVQQKExVNaWNyb3NvZnQgQ29ycG9yYXRpb24x
-# MjAwBgNVBAMTKU1pY3Jvc29mdCBSb290IENlcnRpZmljYXRlIEF1dGhvcml0eSAy
-# MDEwMB4XDTEwMDcwMTIxMzY1NVoXDTI1MDcwMTIxNDY1NVowfDELMAkGA1UEBhMC
-# VVMxEzARBgNVBAgTCldhc2hpbmd0b24xEDAOBgNVBAcTB1JlZG1vbmQxHjAcBgNV
-# BAoTFU1pY3Jvc29mdCBDb3Jwb3JhdGlvbjEmMCQGA1UEAxMdTWljcm9zb2Z0IFRp
-# bWUtU3RhbXAgUENBIDIwMTAwggEiMA0GCSqGSIb3DQEBAQUAA4IBDwAwggEKAoIB
-# AQCpHQ28dxGKOiDs/BOX9fp/aZRrdFQQ1aUKAIKF++18aEssX8XD5WHCdrc+Zitb
-# 8BVTJwQxH0EbGpUdzgkTjnxhMFmxMEQP8WCIhFRDDNdNuDgIs0Ldk6zWczBXJoKj
-# RQ3Q6vVHgc2/JGAyWGBG8lhHhjKEHnRhZ5FfgVSxz5NMksHEpl3RYRNuKMYa+YaA
-# u99h/EbBJx0kZxJyGiGKr0tkiVBisV39dx898Fd1rL2KQk1AUdEPnAY+Z3/1ZsAD
-# lkR+79BL/W7lmsqxqPJ6Kgox8NpOBpG2iAg16HgcsOmZzTznL0S6p/TcZL2kAcEg
-# CZN4zfy8wMlEXV4WnAEFTyJNAgMBAAGjggHmMIIB4jAQBgkrBgEEAYI3FQEEAwIB
-# ADAdBgNVHQ4EFgQU1WM6XIoxkPNDe3xGG8UzaFqFbVUwGQYJKwYBBAGCNxQCBAwe
-# CgBTAHUAYgBDAEEwCwYDVR0PBAQDAgGGMA8GA1UdEwEB/wQFMAMBAf8wHwYDVR0j
-# BBgwFoAU1fZWy4/oolxiaNE9lJBb186aGMQwVgYDVR0fBE8wTTBLoEmgR4ZFaHR0
-# cDovL2NybC5taWNyb3NvZnQuY29tL3BraS9jcmwvcHJvZHVjdHMvTWljUm9vQ2Vy
-# QXV0XzIwMTAtMDYtMjMuY3JsMFoGCCsGAQUFBwEBBE4wTDBKBggrBgEFBQcwAoY+
-# aHR0cDovL3d3dy5taWNyb3NvZnQuY29tL3BraS9jZXJ0cy9NaWNSb29DZXJBdXRf
-# MjAxMC0wNi0yMy5jcnQwgaAGA1UdIAEB/wSBlTCBkjCBjwYJKwYBBAGCNy4DMIGB
-# MD0GCCsGAQUFBwIBFjFodHRwOi8vd3d3Lm1pY3Jvc29mdC5jb20vUEtJL2RvY3Mv
-# Q1BTL2RlZmF1bHQuaHRtMEAGCCsGAQUFBwICMDQeMiAdAEwAZQBnAGEAbABfAFAA
-# bwBsAGkAYwB5AF8AUwB0AGEAdABlAG0AZQBuAHQALiAdMA0GCSqGSIb3DQEBCwUA
-# A4ICAQAH5ohRDeLG4Jg/gXEDPZ2joSFvs+umzPUxvs8F4qn++ldtGTCzwsVmyWrf
-# 9efweL3HqJ4l4/m87WtUVwgrUYJEEvu5U4zM9GASinbMQEBBm9xcF/9c+V4XNZgk
-# Vkt070IQyK+/f8Z/8jd9Wj8c8pl5SpFSAK84Dxf1L3mBZdmptWvkx872ynoAb0sw
-# RCQiPM/tA6WWj1kpvLb9BOFwnzJKJ/1Vry/+tuWOM7tiX5rbV0Dp8c6ZZpCM/2pi
-# f93FSguRJuI57BlKcWOdeyFtw5yjojz6f32WapB4pm3S4Zz5Hfw42JT0xqUKloak
-# vZ4argRCg7i1gJsiOCC1JeVk7Pf0v35jWSUPei45V3aicaoGig+JFrphpxHLmtgO
-# R5qAxdDNp9DvfYPw4TtxCd9ddJgiCGHasFAeb73x4QDf5zEHpJM692VHeOj4qEir
-# 995yfmFrb3epgcunCaw5u+zGy9iCtHLNHfS4hQEegPsbiSpUObJb2sgNVZl6h3M7
-# COaYLeqN4DMuEin1wC9UJyH3yKxO2ii4sanblrKnQqLJzxlBTeCG+SqaoxFmMNO7
-# dDJL32N79ZmKLxvHIa9Zta7cRDyXUHHXodLFVeNp3lfB0d4wwP3M5k37Db9dT+md
-# Hhk4L7zPWAUu7w2gUDXa7wknHNWzfjUeCLraNtvTX4/edIhJEqGCAtIwggI7AgEB
-# MIH8oYHUpIHRMIHOMQswCQYDVQQGEwJVUzETMBEGA1UECBMKV2FzaGluZ3RvbjEQ
-# MA4GA1UEBxMHUmVkbW9uZDEeMBwGA1UEChMVTWljcm9zb2Z0IENvcnBvcmF0aW9u
-# MSkwJwYDVQQLEyBNaWNyb3NvZnQgT3BlcmF0aW9ucyBQdWVydG8gUmljbzEmMCQG
-# A1UECxMdVGhhbGVzIFRTUyBFU046NDYyRi1FMzE5LTNGMjAxJTAjBgNVBAMTHE1p
-# Y3Jvc29mdCBUaW1lLVN0YW1wIFNlcnZpY2WiIwoBATAHBgUrDgMCGgMVAKnJK3Ma
-# 59ELIabqM46fpfg0nzS/oIGDMIGApH4wfDELMAkGA1UEBhMCVVMxEzARBgNVBAgT
-# Cldhc2hpbmd0b24xEDAOBgNVBAcTB1JlZG1vbmQxHjAcBgNVBAoTFU1pY3Jvc29m
-# dCBDb3Jwb3JhdGlvbjEmMCQGA1UEAxMdTWljcm9zb2Z0IFRpbWUtU3RhbXAgUENB
-# IDIwMTAwDQYJKoZIhvcNAQEFBQACBQDkj+sbMCIYDzIwMjEwNzA3MTI1ODAzWhgP
-# MjAyMTA3MDgxMjU4MDNaMHcwPQYKKwYBBAGEWQoEATEvMC0wCgIFAOSP6xsCAQAw
-# CgIBAAICHlkCAf8wBwIBAAICEU0wCgIFAOSRPJsCAQAwNgYKKwYBBAGEWQoEAjEo
-# MCYwDAYKKwYBBAGEWQoDAqAKMAgCAQACAwehIKEKMAgCAQACAwGGoDANBgkqhkiG
-# 9w0BAQUFAAOBgQBePj6ONtpXukth7EmxV4k+jOfB007RHfYuuN4olu76D7FCuEI3
-# vY29IgIzGZ0NtWxP2GVRjukVc07A+LIX2AFsWs3Z7VSMD/RkjYey0mpm2EhuLEOr
-# O63ezsvaQZ/6/IpdM1lzUY2/Y262czH1MMY75tB7IkA0TRJYJ6UY6uLb3zGCAw0w
-# ggMJAgEBMIGTMHwxCzAJBgNVBAYTAlVTMRMwEQYDVQQIEwpXYXNoaW5ndG9uMRAw
-# DgYDVQQHEwdSZWRtb25kMR4wHAYDVQQKExVNaWNyb3NvZnQgQ29ycG9yYXRpb24x
-# JjAkBgNVBAMTHU1pY3Jvc29mdCBUaW1lLVN0YW1wIFBDQSAyMDEwAhMzAAABWHBa
-# Ive+luYDAAAAAAFYMA0GCWCGSAFlAwQCAQUAoIIBSjAaBgkqhkiG9w0BCQMxDQYL
-# KoZIhvcNAQkQAQQwLwYJKoZIhvcNAQkEMSIEIF3pZsPvLvcpvII7u2WNRv43yglz
-# yuFlAftiy8q+rYRgMIH6BgsqhkiG9w0BCRACLzGB6jCB5zCB5DCBvQQg8kozjWyG
-# NZdsyk+G2uLAiOFpAQurCH0fbklTVcdw0wcwgZgwgYCkfjB8MQswCQYDVQQGEwJV
-# UzETMBEGA1UECBMKV2FzaGluZ3RvbjEQMA4GA1UEBxMHUmVkbW9uZDEeMBwGA1UE
-# ChMVTWljcm9zb2Z0IENvcnBvcmF0aW9uMSYwJAYDVQQDEx1NaWNyb3NvZnQgVGlt
-# ZS1TdGFtcCBQQ0EgMjAxMAITMwAAAVhwWiL3vpbmAwAAAAABWDAiBCAfQkargMv9
-# Sch1ItQtDs1T88FXpK/HGNMWtHLZa1QjuDANBgkqhkiG9w0BAQsFAASCAQBdyn5p
-# Rq1FA/X01kUCVfs47Rcx/AhpNnfux/0nTUDb5Ek5tTjWvIyrhvhYrBXu4IpsHcc8
-# HumRk7StGDMF43cRykD9ZL/y2a234bHLeSQpoQQEzih1txpah2LF0KlzNoxfoNpc
-# 19ezHHDP+7u09OvH5j3xpm62dZOUW1RIVqGNCDfvwkUcmg3iqGh1ilCrFEz6a8To
-# k/+biNcChb49j1yhM81rkCtM9u7NSYZxC+C5qdU0gLeN4u6+XE9q4FzMC/BtMgWK
-# 8T2eaeZpPvr+y7SA61zuAex+LHKKfbliXg0pJTPGeuX72uCxZ4ror50MdyWYriod
-# qFB7rgYYtXllrHc/
-# SIG # End signature block
+if ($SizeReport -and ($cachedConversion -or $null -ne $conversionResponse)) {
+    WriteConversionSizeReport $config.assetConversionSettings
+}